@@ -0,0 +1,1123 @@
+#ifndef MYSTL_HANDMADE_ALGORITHM_H_
+#define MYSTL_HANDMADE_ALGORITHM_H_
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+
+#if !defined(MYSTL_SORT_PORTABLE) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "construct.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+namespace detail {
+// True when assigning *InIt to *OutIt (by move if Move is set) may be done with memmove. The
+// assignment itself has to be trivial: a trivially copyable type may still delete it.
+template <typename InIt, typename OutIt, bool Move = false,
+          typename T = remove_cvref_t<decltype(*mystl::declval<OutIt>())>>
+inline constexpr bool is_memmove_assignable_v =
+    is_pointer_v<InIt> && is_pointer_v<OutIt> &&
+    is_same_v<remove_cvref_t<decltype(*mystl::declval<InIt>())>, T> &&
+    is_trivially_copyable_v<T> &&
+    (Move ? is_trivially_move_assignable_v<T> : is_trivially_copy_assignable_v<T>) &&
+    !is_volatile_v<remove_reference_t<decltype(*mystl::declval<OutIt>())>>;
+
+template <typename It>
+concept random_access_iter = requires(It a, It b, std::ptrdiff_t n) {
+    a + n;
+    a - b;
+    a[n];
+};
+
+struct less_op {
+    template <typename T, typename U>
+    constexpr bool operator()(const T& a, const U& b) const {
+        return a < b;
+    }
+};
+}  // namespace detail
+
+template <typename InputIt, typename OutputIt>
+constexpr OutputIt copy(InputIt first, InputIt last, OutputIt d_first) {
+    if constexpr (detail::is_memmove_assignable_v<InputIt, OutputIt>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memmove(d_first, first, n * sizeof(*first));
+            }
+            return d_first + n;
+        }
+    }
+    for (; first != last; ++first, (void)++d_first) {
+        *d_first = *first;
+    }
+    return d_first;
+}
+
+template <typename InputIt, typename Size, typename OutputIt>
+constexpr OutputIt copy_n(InputIt first, Size n, OutputIt d_first) {
+    if constexpr (detail::is_memmove_assignable_v<InputIt, OutputIt>) {
+        return n > 0 ? mystl::copy(first, first + n, d_first) : d_first;
+    } else {
+        for (; n > 0; ++first, (void)++d_first, --n) {
+            *d_first = *first;
+        }
+        return d_first;
+    }
+}
+
+template <typename InputIt, typename OutputIt>
+constexpr OutputIt move(InputIt first, InputIt last, OutputIt d_first) {
+    if constexpr (detail::is_memmove_assignable_v<InputIt, OutputIt, true>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memmove(d_first, first, n * sizeof(*first));
+            }
+            return d_first + n;
+        }
+    }
+    for (; first != last; ++first, (void)++d_first) {
+        *d_first = mystl::move(*first);
+    }
+    return d_first;
+}
+
+template <typename BidirIt1, typename BidirIt2>
+constexpr BidirIt2 move_backward(BidirIt1 first, BidirIt1 last, BidirIt2 d_last) {
+    if constexpr (detail::is_memmove_assignable_v<BidirIt1, BidirIt2, true>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memmove(d_last - n, first, n * sizeof(*first));
+            }
+            return d_last - n;
+        }
+    }
+    while (first != last) {
+        *--d_last = mystl::move(*--last);
+    }
+    return d_last;
+}
+
+template <typename OutputIt, typename Size, typename T>
+constexpr OutputIt fill_n(OutputIt first, Size n, const T& value) {
+    for (; n > 0; ++first, (void)--n) {
+        *first = value;
+    }
+    return first;
+}
+
+template <typename ForwardIt, typename T>
+constexpr void fill(ForwardIt first, ForwardIt last, const T& value) {
+    for (; first != last; ++first) {
+        *first = value;
+    }
+}
+
+template <typename InputIt, typename F>
+    requires invocable<F&, decltype(*mystl::declval<InputIt&>())>
+constexpr F for_each(InputIt first, InputIt last, F f) {
+    for (; first != last; ++first) {
+        mystl::invoke(f, *first);
+    }
+    return f;
+}
+
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+    requires invocable<UnaryOp&, decltype(*mystl::declval<InputIt&>())>
+constexpr OutputIt transform(InputIt first, InputIt last, OutputIt d_first, UnaryOp op) {
+    for (; first != last; ++first, (void)++d_first) {
+        *d_first = mystl::invoke(op, *first);
+    }
+    return d_first;
+}
+
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename BinaryOp>
+    requires invocable<BinaryOp&, decltype(*mystl::declval<InputIt1&>()),
+                       decltype(*mystl::declval<InputIt2&>())>
+constexpr OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt d_first,
+                             BinaryOp op) {
+    for (; first1 != last1; ++first1, (void)++first2, (void)++d_first) {
+        *d_first = mystl::invoke(op, *first1, *first2);
+    }
+    return d_first;
+}
+
+template <typename InputIt1, typename InputIt2>
+constexpr bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+    for (; first1 != last1; ++first1, (void)++first2) {
+        if (!(*first1 == *first2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ForwardIt1, typename ForwardIt2>
+constexpr void iter_swap(ForwardIt1 a, ForwardIt2 b) {
+    using mystl::swap;
+    swap(*a, *b);
+}
+
+template <typename BidirIt>
+constexpr void reverse(BidirIt first, BidirIt last) {
+    while (first != last && first != --last) {
+        mystl::iter_swap(first, last);
+        ++first;
+    }
+}
+
+// Iterative, so the depth does not grow with the range when the tail is short. Random-access
+// ranges use three reversals; forward ranges swap blocks until the two halves line up.
+template <typename ForwardIt>
+constexpr ForwardIt rotate(ForwardIt first, ForwardIt middle, ForwardIt last) {
+    if (first == middle) {
+        return last;
+    }
+    if (middle == last) {
+        return first;
+    }
+    if constexpr (detail::random_access_iter<ForwardIt>) {
+        mystl::reverse(first, middle);
+        mystl::reverse(middle, last);
+        mystl::reverse(first, last);
+        return first + (last - middle);
+    } else {
+        // After the first pass, first is where the old front element ends up; the remaining
+        // passes rotate whatever is still out of place.
+        ForwardIt read = middle;
+        do {
+            mystl::iter_swap(first, read);
+            ++first;
+            ++read;
+            if (first == middle) {
+                middle = read;
+            }
+        } while (read != last);
+        const ForwardIt result = first;
+        read = middle;
+        while (read != last) {
+            mystl::iter_swap(first, read);
+            ++first;
+            ++read;
+            if (first == middle) {
+                middle = read;
+            } else if (read == last) {
+                read = middle;
+            }
+        }
+        return result;
+    }
+}
+
+// Binary search without a data-dependent branch: the loop runs exactly ceil(log2(n)) times and
+// each step is a conditional move, so lookups do not pay for mispredictions.
+template <typename RandomIt, typename T, typename Compare>
+    requires detail::random_access_iter<RandomIt>
+constexpr RandomIt lower_bound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    auto len = last - first;
+    if (len == 0) {
+        return first;
+    }
+    while (len > 1) {
+        const auto half = len / 2;
+        first = comp(first[half], value) ? first + half : first;
+        len -= half;
+    }
+    return comp(*first, value) ? first + 1 : first;
+}
+
+template <typename RandomIt, typename T>
+    requires detail::random_access_iter<RandomIt>
+constexpr RandomIt lower_bound(RandomIt first, RandomIt last, const T& value) {
+    return mystl::lower_bound(first, last, value, detail::less_op{});
+}
+
+template <typename RandomIt, typename T, typename Compare>
+    requires detail::random_access_iter<RandomIt>
+constexpr RandomIt upper_bound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    auto len = last - first;
+    if (len == 0) {
+        return first;
+    }
+    while (len > 1) {
+        const auto half = len / 2;
+        first = comp(value, first[half]) ? first : first + half;
+        len -= half;
+    }
+    return comp(value, *first) ? first : first + 1;
+}
+
+template <typename RandomIt, typename T>
+    requires detail::random_access_iter<RandomIt>
+constexpr RandomIt upper_bound(RandomIt first, RandomIt last, const T& value) {
+    return mystl::upper_bound(first, last, value, detail::less_op{});
+}
+
+template <typename ForwardIt, typename Compare>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last, Compare comp) {
+    if (first == last) {
+        return true;
+    }
+    for (ForwardIt next = first; ++next != last; first = next) {
+        if (comp(*next, *first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ForwardIt>
+constexpr bool is_sorted(ForwardIt first, ForwardIt last) {
+    return mystl::is_sorted(first, last, detail::less_op{});
+}
+
+namespace detail {
+template <typename It>
+using iter_value_t = remove_cvref_t<decltype(*mystl::declval<It&>())>;
+
+template <typename RandomIt, typename Compare>
+concept sortable = random_access_iter<RandomIt> &&
+                   strict_weak_order<Compare&, decltype(*mystl::declval<RandomIt&>()),
+                                     decltype(*mystl::declval<RandomIt&>())>;
+
+// Orderings whose result for arithmetic keys is a plain `<` or `>`, so they can be evaluated
+// without branches and, for `<`, by the vector kernels below.
+template <typename Compare, typename T>
+inline constexpr bool is_default_less_v =
+    is_same_v<Compare, less_op> || is_same_v<Compare, std::less<T>> || is_same_v<Compare, std::less<>>;
+
+template <typename Compare, typename T>
+inline constexpr bool is_branchless_order_v =
+    is_arithmetic_v<T> && (is_default_less_v<Compare, T> || is_same_v<Compare, std::greater<T>> ||
+                           is_same_v<Compare, std::greater<>>);
+
+template <typename RandomIt, typename Compare>
+constexpr void insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+    if (first == last) {
+        return;
+    }
+    for (RandomIt i = first + 1; i != last; ++i) {
+        if (comp(*i, *(i - 1))) {
+            auto tmp = mystl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = mystl::move(*(j - 1));
+                --j;
+            } while (j != first && comp(tmp, *(j - 1)));
+            *j = mystl::move(tmp);
+        }
+    }
+}
+
+// Insertion sort without the lower bound check. Precondition: *(first - 1) is not greater than
+// any element of [first, last).
+template <typename RandomIt, typename Compare>
+constexpr void unguarded_insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+    if (first == last) {
+        return;
+    }
+    for (RandomIt i = first + 1; i != last; ++i) {
+        if (comp(*i, *(i - 1))) {
+            auto tmp = mystl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = mystl::move(*(j - 1));
+                --j;
+            } while (comp(tmp, *(j - 1)));
+            *j = mystl::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up once it has moved more than `limit` elements. Returns true if the
+// range ended up sorted; used to finish off ranges that partitioning found nearly sorted.
+template <typename RandomIt, typename Compare>
+constexpr bool partial_insertion_sort(RandomIt first, RandomIt last, Compare& comp) {
+    constexpr std::ptrdiff_t limit = 8;
+    if (first == last) {
+        return true;
+    }
+    std::ptrdiff_t moved = 0;
+    for (RandomIt i = first + 1; i != last; ++i) {
+        if (comp(*i, *(i - 1))) {
+            auto tmp = mystl::move(*i);
+            RandomIt j = i;
+            do {
+                *j = mystl::move(*(j - 1));
+                --j;
+            } while (j != first && comp(tmp, *(j - 1)));
+            *j = mystl::move(tmp);
+            moved += i - j;
+        }
+        if (moved > limit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void sift_down(RandomIt first, std::ptrdiff_t len, std::ptrdiff_t hole, Compare& comp) {
+    auto value = mystl::move(first[hole]);
+    for (std::ptrdiff_t child = 2 * hole + 1; child < len; child = 2 * hole + 1) {
+        if (child + 1 < len && comp(first[child], first[child + 1])) {
+            ++child;
+        }
+        if (!comp(value, first[child])) {
+            break;
+        }
+        first[hole] = mystl::move(first[child]);
+        hole = child;
+    }
+    first[hole] = mystl::move(value);
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void make_heap(RandomIt first, RandomIt last, Compare& comp) {
+    const std::ptrdiff_t len = last - first;
+    for (std::ptrdiff_t i = len / 2; i-- > 0;) {
+        detail::sift_down(first, len, i, comp);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void sort_heap(RandomIt first, RandomIt last, Compare& comp) {
+    for (std::ptrdiff_t len = last - first; len > 1; --len) {
+        mystl::iter_swap(first, first + (len - 1));
+        detail::sift_down(first, len - 1, 0, comp);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void sort2(RandomIt a, RandomIt b, Compare& comp) {
+    if (comp(*b, *a)) {
+        mystl::iter_swap(a, b);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void sort3(RandomIt a, RandomIt b, RandomIt c, Compare& comp) {
+    detail::sort2(a, b, comp);
+    detail::sort2(b, c, comp);
+    detail::sort2(a, b, comp);
+}
+
+#if !defined(MYSTL_SORT_PORTABLE) && defined(__AVX2__)
+// Bitonic sorting networks for up to 16 32-bit keys held in two AVX2 registers. Each step pairs
+// lane i with lane i ^ J and keeps the minimum or maximum depending on the block of size K it
+// lies in; the whole sort is branch-free and takes 10 compare-exchange steps per register.
+template <int K, int J>
+constexpr int bitonic_max_mask() {
+    int mask = 0;
+    for (int i = 0; i < 8; ++i) {
+        const bool ascending = (i & K) == 0;
+        if ((i > (i ^ J)) == ascending) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
+
+inline __m256i bitonic_partner(int j) {
+    return _mm256_setr_epi32(0 ^ j, 1 ^ j, 2 ^ j, 3 ^ j, 4 ^ j, 5 ^ j, 6 ^ j, 7 ^ j);
+}
+
+template <typename T>
+struct sort_network_ops;
+
+template <>
+struct sort_network_ops<int> {
+    using reg = __m256i;
+    static reg load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg permute(reg v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    template <int Mask>
+    static reg blend(reg a, reg b) {
+        return _mm256_blend_epi32(a, b, Mask);
+    }
+};
+
+template <>
+struct sort_network_ops<unsigned int> {
+    using reg = __m256i;
+    static reg load(const unsigned int* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static void store(unsigned int* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg permute(reg v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    static reg min(reg a, reg b) { return _mm256_min_epu32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epu32(a, b); }
+    template <int Mask>
+    static reg blend(reg a, reg b) {
+        return _mm256_blend_epi32(a, b, Mask);
+    }
+};
+
+// vminps/vmaxps return their second operand when both inputs are zero, which would turn
+// {-0.0, +0.0} into {+0.0, +0.0}. Selecting on strict comparisons keeps each lane's own value
+// unless the partner is strictly better, so equal keys are preserved bit for bit.
+template <>
+struct sort_network_ops<float> {
+    using reg = __m256;
+    static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg permute(reg v, __m256i idx) { return _mm256_permutevar8x32_ps(v, idx); }
+    static reg min(reg a, reg b) { return _mm256_blendv_ps(a, b, _mm256_cmp_ps(b, a, _CMP_LT_OQ)); }
+    static reg max(reg a, reg b) { return _mm256_blendv_ps(a, b, _mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    template <int Mask>
+    static reg blend(reg a, reg b) {
+        return _mm256_blend_ps(a, b, Mask);
+    }
+};
+
+template <typename Ops, int K, int J>
+inline typename Ops::reg bitonic_step(typename Ops::reg v) {
+    const typename Ops::reg p = Ops::permute(v, detail::bitonic_partner(J));
+    return Ops::template blend<detail::bitonic_max_mask<K, J>()>(Ops::min(v, p), Ops::max(v, p));
+}
+
+template <typename Ops>
+inline typename Ops::reg bitonic_merge8(typename Ops::reg v) {
+    v = detail::bitonic_step<Ops, 8, 4>(v);
+    v = detail::bitonic_step<Ops, 8, 2>(v);
+    return detail::bitonic_step<Ops, 8, 1>(v);
+}
+
+template <typename Ops>
+inline typename Ops::reg bitonic_sort8(typename Ops::reg v) {
+    v = detail::bitonic_step<Ops, 2, 1>(v);
+    v = detail::bitonic_step<Ops, 4, 2>(v);
+    v = detail::bitonic_step<Ops, 4, 1>(v);
+    return detail::bitonic_merge8<Ops>(v);
+}
+
+template <typename T>
+inline constexpr bool has_sort_network_v =
+    is_same_v<T, int> || is_same_v<T, unsigned int> || is_same_v<T, float>;
+
+inline constexpr std::ptrdiff_t sort_network_max = 16;
+
+// Sorts n <= 16 keys. They are copied into a scratch array padded with the largest key, which
+// sorts to the back and is never copied out.
+template <typename RandomIt>
+inline void sort_network(RandomIt first, std::ptrdiff_t n) {
+    using T = iter_value_t<RandomIt>;
+    using Ops = sort_network_ops<T>;
+    alignas(32) T buf[16];
+    for (std::ptrdiff_t i = 0; i < 16; ++i) {
+        buf[i] = i < n ? first[i] : std::numeric_limits<T>::has_infinity
+                                        ? std::numeric_limits<T>::infinity()
+                                        : std::numeric_limits<T>::max();
+    }
+    typename Ops::reg lo = detail::bitonic_sort8<Ops>(Ops::load(buf));
+    typename Ops::reg hi = detail::bitonic_sort8<Ops>(Ops::load(buf + 8));
+    hi = Ops::permute(hi, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    const typename Ops::reg mn = Ops::min(lo, hi);
+    // max takes hi first so that on ties mn keeps lo's lane and mx keeps hi's, not lo's twice.
+    const typename Ops::reg mx = Ops::max(hi, lo);
+    Ops::store(buf, detail::bitonic_merge8<Ops>(mn));
+    Ops::store(buf + 8, detail::bitonic_merge8<Ops>(mx));
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        first[i] = buf[i];
+    }
+}
+#else
+template <typename T>
+inline constexpr bool has_sort_network_v = false;
+
+inline constexpr std::ptrdiff_t sort_network_max = 0;
+
+template <typename RandomIt>
+inline void sort_network(RandomIt, std::ptrdiff_t) {}
+#endif
+
+// Partitions [first, last) around *first, putting elements equal to the pivot on the right.
+// Returns the pivot's final position and whether the range was already partitioned.
+template <typename RandomIt, typename Compare>
+pair<RandomIt, bool> partition_right(RandomIt first, RandomIt last, Compare& comp) {
+    auto pivot = mystl::move(*first);
+    RandomIt l = first;
+    RandomIt r = last;
+    while (comp(*++l, pivot)) {
+    }
+    if (l - 1 == first) {
+        while (l < r && !comp(*--r, pivot)) {
+        }
+    } else {
+        while (!comp(*--r, pivot)) {
+        }
+    }
+    const bool already_partitioned = l >= r;
+    while (l < r) {
+        mystl::iter_swap(l, r);
+        while (comp(*++l, pivot)) {
+        }
+        while (!comp(*--r, pivot)) {
+        }
+    }
+    RandomIt pivot_pos = l - 1;
+    *first = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+inline constexpr std::ptrdiff_t partition_block = 64;
+
+template <typename RandomIt>
+void swap_offsets(RandomIt first, RandomIt last, const unsigned char* offsets_l,
+                  const unsigned char* offsets_r, size_t num, bool use_swaps) {
+    if (use_swaps) {
+        // Equal counts on both sides: a pure swap keeps the cyclic permutation below from
+        // touching an element twice.
+        for (size_t i = 0; i < num; ++i) {
+            mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    } else if (num > 0) {
+        RandomIt l = first + offsets_l[0];
+        RandomIt r = last - offsets_r[0];
+        auto tmp = mystl::move(*l);
+        *l = mystl::move(*r);
+        for (size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = mystl::move(*l);
+            r = last - offsets_r[i];
+            *l = mystl::move(*r);
+        }
+        *r = mystl::move(tmp);
+    }
+}
+
+// Block partitioning (Edelkamp and Weiss, "BlockQuicksort"): comparisons fill offset buffers
+// with no data-dependent branch, then misplaced elements are swapped in bulk. Same contract as
+// partition_right; only worth it when comparisons are cheap and branch-free themselves.
+template <typename RandomIt, typename Compare>
+pair<RandomIt, bool> partition_right_branchless(RandomIt first, RandomIt last, Compare& comp) {
+    auto pivot = mystl::move(*first);
+    RandomIt l = first;
+    RandomIt r = last;
+    while (comp(*++l, pivot)) {
+    }
+    if (l - 1 == first) {
+        while (l < r && !comp(*--r, pivot)) {
+        }
+    } else {
+        while (!comp(*--r, pivot)) {
+        }
+    }
+    const bool already_partitioned = l >= r;
+    if (!already_partitioned) {
+        mystl::iter_swap(l, r);
+        ++l;
+
+        alignas(64) unsigned char offsets_l[partition_block];
+        alignas(64) unsigned char offsets_r[partition_block];
+        RandomIt base_l = l;
+        RandomIt base_r = r;
+        size_t num_l = 0;
+        size_t num_r = 0;
+        size_t start_l = 0;
+        size_t start_r = 0;
+        while (l < r) {
+            const size_t unknown = static_cast<size_t>(r - l);
+            const size_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+            const size_t split_r = num_r == 0 ? unknown - split_l : 0;
+            const size_t block_l = split_l < partition_block ? split_l : partition_block;
+            const size_t block_r = split_r < partition_block ? split_r : partition_block;
+            for (size_t i = 0; i < block_l; ++i) {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !comp(*l, pivot);
+                ++l;
+            }
+            for (size_t i = 0; i < block_r;) {
+                offsets_r[num_r] = static_cast<unsigned char>(++i);
+                num_r += comp(*--r, pivot);
+            }
+
+            const size_t num = num_l < num_r ? num_l : num_r;
+            detail::swap_offsets(base_l, base_r, offsets_l + start_l, offsets_r + start_r, num,
+                                 num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                start_l = 0;
+                base_l = l;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                base_r = r;
+            }
+        }
+
+        // At most one side has leftovers; move them next to the boundary.
+        if (num_l) {
+            while (num_l--) {
+                mystl::iter_swap(base_l + offsets_l[start_l + num_l], --r);
+            }
+            l = r;
+        }
+        if (num_r) {
+            while (num_r--) {
+                mystl::iter_swap(base_r - offsets_r[start_r + num_r], l);
+                ++l;
+            }
+            r = l;
+        }
+    }
+    RandomIt pivot_pos = l - 1;
+    *first = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+// Partitions around *first with elements equal to the pivot on the left. Used when the pivot
+// equals the element before the range, so the whole left side is one run of equal keys that
+// needs no further sorting.
+template <typename RandomIt, typename Compare>
+RandomIt partition_left(RandomIt first, RandomIt last, Compare& comp) {
+    auto pivot = mystl::move(*first);
+    RandomIt l = first;
+    RandomIt r = last;
+    while (comp(pivot, *--r)) {
+    }
+    if (r + 1 == last) {
+        while (l < r && !comp(pivot, *++l)) {
+        }
+    } else {
+        while (!comp(pivot, *++l)) {
+        }
+    }
+    while (l < r) {
+        mystl::iter_swap(l, r);
+        while (comp(pivot, *--r)) {
+        }
+        while (!comp(pivot, *++l)) {
+        }
+    }
+    *first = mystl::move(*r);
+    *r = mystl::move(pivot);
+    return r;
+}
+
+inline constexpr std::ptrdiff_t pdq_insertion_threshold = 24;
+inline constexpr std::ptrdiff_t pdq_ninther_threshold = 128;
+
+// Pattern-defeating quicksort (Peters, 2021). Introsort that additionally
+//  - picks the median of three, or the ninther for large ranges, as pivot;
+//  - detects ranges that partitioning left untouched and finishes them with a bounded
+//    insertion sort, making sorted and reverse-sorted inputs linear;
+//  - groups keys equal to an earlier pivot on the left, making many duplicates linear;
+//  - shuffles a few elements after an unbalanced partition, and after log2(n) of those falls
+//    back to heapsort, so the worst case stays O(n log n).
+template <bool Branchless, typename RandomIt, typename Compare>
+void pdqsort_loop(RandomIt first, RandomIt last, Compare& comp, int bad_allowed, bool leftmost) {
+    using T = iter_value_t<RandomIt>;
+    while (true) {
+        const std::ptrdiff_t size = last - first;
+        if constexpr (has_sort_network_v<T> && is_default_less_v<Compare, T>) {
+            if (size <= sort_network_max) {
+                detail::sort_network(first, size);
+                return;
+            }
+        }
+        if (size < pdq_insertion_threshold) {
+            if (leftmost) {
+                detail::insertion_sort(first, last, comp);
+            } else {
+                detail::unguarded_insertion_sort(first, last, comp);
+            }
+            return;
+        }
+
+        const std::ptrdiff_t half = size / 2;
+        if (size > pdq_ninther_threshold) {
+            detail::sort3(first, first + half, last - 1, comp);
+            detail::sort3(first + 1, first + (half - 1), last - 2, comp);
+            detail::sort3(first + 2, first + (half + 1), last - 3, comp);
+            detail::sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            mystl::iter_swap(first, first + half);
+        } else {
+            detail::sort3(first + half, first, last - 1, comp);
+        }
+
+        // The element before this range was a pivot, so nothing here is smaller than it. If
+        // the new pivot is not greater either, every key equal to it can be set aside at once.
+        if (!leftmost && !comp(*(first - 1), *first)) {
+            first = detail::partition_left(first, last, comp) + 1;
+            continue;
+        }
+
+        const auto [pivot_pos, already_partitioned] =
+            Branchless ? detail::partition_right_branchless(first, last, comp)
+                       : detail::partition_right(first, last, comp);
+
+        const std::ptrdiff_t l_size = pivot_pos - first;
+        const std::ptrdiff_t r_size = last - (pivot_pos + 1);
+        if (l_size < size / 8 || r_size < size / 8) {
+            if (--bad_allowed == 0) {
+                detail::make_heap(first, last, comp);
+                detail::sort_heap(first, last, comp);
+                return;
+            }
+            if (l_size >= pdq_insertion_threshold) {
+                mystl::iter_swap(first, first + l_size / 4);
+                mystl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > pdq_ninther_threshold) {
+                    mystl::iter_swap(first + 1, first + (l_size / 4 + 1));
+                    mystl::iter_swap(first + 2, first + (l_size / 4 + 2));
+                    mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= pdq_insertion_threshold) {
+                mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                mystl::iter_swap(last - 1, last - r_size / 4);
+                if (r_size > pdq_ninther_threshold) {
+                    mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    mystl::iter_swap(last - 2, last - (1 + r_size / 4));
+                    mystl::iter_swap(last - 3, last - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned && detail::partial_insertion_sort(first, pivot_pos, comp) &&
+                   detail::partial_insertion_sort(pivot_pos + 1, last, comp)) {
+            return;
+        }
+
+        detail::pdqsort_loop<Branchless>(first, pivot_pos, comp, bad_allowed, leftmost);
+        first = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+// Top-down merge sort: only the left half of each merge is moved out, so buf needs room for
+// half of the range.
+template <typename RandomIt, typename T, typename Compare>
+void merge_sort_with_buffer(RandomIt first, RandomIt last, T* buf, Compare& comp) {
+    const auto len = last - first;
+    if (len <= 16) {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+    const RandomIt mid = first + len / 2;
+    detail::merge_sort_with_buffer(first, mid, buf, comp);
+    detail::merge_sort_with_buffer(mid, last, buf, comp);
+    if (!comp(*mid, *(mid - 1))) {
+        return;
+    }
+    T* const buf_end = mystl::uninitialized_move(first, mid, buf);
+    T* b = buf;
+    RandomIt r = mid;
+    RandomIt out = first;
+    try {
+        while (b != buf_end && r != last) {
+            if (comp(*r, *b)) {
+                *out = mystl::move(*r);
+                ++r;
+            } else {
+                *out = mystl::move(*b);
+                ++b;
+            }
+            ++out;
+        }
+    } catch (...) {
+        mystl::move(b, buf_end, out);
+        mystl::destroy(buf, buf_end);
+        throw;
+    }
+    mystl::move(b, buf_end, out);
+    mystl::destroy(buf, buf_end);
+}
+
+// Merges the sorted runs [first, mid) and [mid, last) in place by rotations: O(n log n) moves,
+// no memory. Only used when stable_sort cannot get its buffer.
+template <typename RandomIt, typename Compare>
+void merge_without_buffer(RandomIt first, RandomIt mid, RandomIt last, Compare& comp) {
+    while (first != mid && mid != last) {
+        if (last - first == 2) {
+            detail::sort2(first, mid, comp);
+            return;
+        }
+        RandomIt cut_l;
+        RandomIt cut_r;
+        if (mid - first > last - mid) {
+            cut_l = first + (mid - first) / 2;
+            cut_r = mystl::lower_bound(mid, last, *cut_l, comp);
+        } else {
+            cut_r = mid + (last - mid) / 2;
+            cut_l = mystl::upper_bound(first, mid, *cut_r, comp);
+        }
+        const RandomIt new_mid = mystl::rotate(cut_l, mid, cut_r);
+        // Recurse into the smaller side to bound the stack depth.
+        if ((new_mid - first) < (last - new_mid)) {
+            detail::merge_without_buffer(first, cut_l, new_mid, comp);
+            first = new_mid;
+            mid = cut_r;
+        } else {
+            detail::merge_without_buffer(new_mid, cut_r, last, comp);
+            last = new_mid;
+            mid = cut_l;
+        }
+    }
+}
+
+template <typename RandomIt, typename Compare>
+void merge_sort_without_buffer(RandomIt first, RandomIt last, Compare& comp) {
+    const auto len = last - first;
+    if (len <= 16) {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+    const RandomIt mid = first + len / 2;
+    detail::merge_sort_without_buffer(first, mid, comp);
+    detail::merge_sort_without_buffer(mid, last, comp);
+    detail::merge_without_buffer(first, mid, last, comp);
+}
+}  // namespace detail
+
+// Unstable sort, O(n log n) worst case; see detail::pdqsort_loop. Arithmetic keys under `<` or
+// `>` use branchless block partitioning, and with AVX2 small int/unsigned/float partitions under
+// `<` finish in a sorting network. Define MYSTL_SORT_PORTABLE to disable the vector kernels.
+template <typename RandomIt, typename Compare>
+    requires detail::sortable<RandomIt, Compare>
+void sort(RandomIt first, RandomIt last, Compare comp) {
+    using T = detail::iter_value_t<RandomIt>;
+    const std::ptrdiff_t len = last - first;
+    if (len < 2) {
+        return;
+    }
+    const int bad_allowed = std::bit_width(static_cast<size_t>(len)) - 1;
+    detail::pdqsort_loop<detail::is_branchless_order_v<Compare, T>>(first, last, comp, bad_allowed,
+                                                                     true);
+}
+
+template <typename RandomIt>
+    requires detail::sortable<RandomIt, detail::less_op>
+void sort(RandomIt first, RandomIt last) {
+    mystl::sort(first, last, detail::less_op{});
+}
+
+// Stable merge sort using a buffer of half the range; if that cannot be allocated it falls
+// back to merging in place. Integral keys under `<` or `>` cannot tell equal elements apart, so
+// they take the faster unstable path.
+template <typename RandomIt, typename Compare>
+    requires detail::sortable<RandomIt, Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp) {
+    using T = detail::iter_value_t<RandomIt>;
+    if constexpr (is_integral_v<T> && detail::is_branchless_order_v<Compare, T>) {
+        mystl::sort(first, last, comp);
+    } else {
+        const auto len = last - first;
+        if (len <= 16) {
+            detail::insertion_sort(first, last, comp);
+            return;
+        }
+        allocator<T> alloc;
+        const size_t buf_len = static_cast<size_t>(len - len / 2);
+        T* buf = nullptr;
+        try {
+            buf = alloc.allocate(buf_len);
+        } catch (const std::bad_alloc&) {
+            detail::merge_sort_without_buffer(first, last, comp);
+            return;
+        }
+        try {
+            detail::merge_sort_with_buffer(first, last, buf, comp);
+        } catch (...) {
+            alloc.deallocate(buf, buf_len);
+            throw;
+        }
+        alloc.deallocate(buf, buf_len);
+    }
+}
+
+template <typename RandomIt>
+    requires detail::sortable<RandomIt, detail::less_op>
+void stable_sort(RandomIt first, RandomIt last) {
+    mystl::stable_sort(first, last, detail::less_op{});
+}
+
+// Places the middle - first smallest elements, sorted, in [first, middle). The rest end up in
+// [middle, last) in unspecified order. O((last - first) log (middle - first)) via a max-heap.
+template <typename RandomIt, typename Compare>
+    requires detail::sortable<RandomIt, Compare>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    if (first == middle) {
+        return;
+    }
+    const std::ptrdiff_t len = middle - first;
+    detail::make_heap(first, middle, comp);
+    for (RandomIt i = middle; i != last; ++i) {
+        if (comp(*i, *first)) {
+            mystl::iter_swap(i, first);
+            detail::sift_down(first, len, 0, comp);
+        }
+    }
+    detail::sort_heap(first, middle, comp);
+}
+
+template <typename RandomIt>
+    requires detail::sortable<RandomIt, detail::less_op>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last) {
+    mystl::partial_sort(first, middle, last, detail::less_op{});
+}
+
+namespace detail {
+template <typename T>
+concept radix_key_type = (is_integral_v<T> && !is_same_v<T, bool>) ||
+                         (is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8) &&
+                          std::numeric_limits<T>::is_iec559);
+
+template <typename T>
+using radix_unsigned_t =
+    conditional_t<is_floating_point_v<T>, conditional_t<sizeof(T) == 4, uint32_t, uint64_t>,
+                  make_unsigned_t<conditional_t<is_floating_point_v<T>, int, T>>>;
+
+// Maps a key to an unsigned integer with the same order. Signed integers flip the sign bit.
+// Floats flip the sign bit when positive and all bits when negative, which orders them as
+// -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN.
+template <radix_key_type T>
+constexpr radix_unsigned_t<T> radix_key(T value) noexcept {
+    using U = radix_unsigned_t<T>;
+    constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+    if constexpr (is_floating_point_v<T>) {
+        const U bits = std::bit_cast<U>(value);
+        return (bits & sign) ? U(~bits) : U(bits | sign);
+    } else if constexpr (is_signed_v<T>) {
+        return static_cast<U>(value) ^ sign;
+    } else {
+        return value;
+    }
+}
+
+// Default projection: the element itself, or `first` for pairs so that `second` rides along
+// as payload.
+struct radix_default_key {
+    template <typename T>
+    constexpr decltype(auto) operator()(const T& value) const noexcept {
+        if constexpr (is_pair_v<T>) {
+            return (value.first);
+        } else {
+            return (value);
+        }
+    }
+};
+
+template <typename It, typename Proj>
+using radix_projected_t =
+    remove_cvref_t<decltype(mystl::invoke(mystl::declval<Proj&>(), *mystl::declval<It&>()))>;
+
+inline constexpr std::ptrdiff_t radix_min_size = 64;
+}  // namespace detail
+
+// Stable LSD radix sort on the key proj(element), which must be a non-bool integral type or an
+// IEEE float/double. One pass over the data fills the byte histograms of every digit; digits
+// on which all keys agree are skipped, so e.g. 64-bit keys that fit in 20 bits take three
+// scatter passes. Needs a scratch buffer of n elements; if it cannot be allocated this falls
+// back to stable_sort. Ranges below 64 elements also use stable_sort.
+template <typename RandomIt, typename Proj = detail::radix_default_key>
+    requires(detail::random_access_iter<RandomIt> &&
+             detail::radix_key_type<detail::radix_projected_t<RandomIt, Proj>> &&
+             is_nothrow_move_constructible_v<detail::iter_value_t<RandomIt>> &&
+             is_nothrow_move_assignable_v<detail::iter_value_t<RandomIt>>)
+void radix_sort(RandomIt first, RandomIt last, Proj proj = {}) {
+    using T = detail::iter_value_t<RandomIt>;
+    using K = detail::radix_projected_t<RandomIt, Proj>;
+    using U = detail::radix_unsigned_t<K>;
+    constexpr int digits = sizeof(U);
+
+    auto key_of = [&proj](const T& value) {
+        return detail::radix_key(static_cast<K>(mystl::invoke(proj, value)));
+    };
+    auto key_less = [&key_of](const T& a, const T& b) { return key_of(a) < key_of(b); };
+
+    const std::ptrdiff_t n = last - first;
+    if (n < detail::radix_min_size) {
+        mystl::stable_sort(first, last, key_less);
+        return;
+    }
+
+    size_t counts[digits][256] = {};
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        const U key = key_of(first[i]);
+        for (int d = 0; d < digits; ++d) {
+            ++counts[d][(key >> (d * 8)) & 0xff];
+        }
+    }
+
+    const U first_key = key_of(*first);
+    int active[digits];
+    int num_active = 0;
+    for (int d = 0; d < digits; ++d) {
+        if (counts[d][(first_key >> (d * 8)) & 0xff] != static_cast<size_t>(n)) {
+            active[num_active++] = d;
+        }
+    }
+    if (num_active == 0) {
+        return;
+    }
+
+    allocator<T> alloc;
+    T* buf = nullptr;
+    try {
+        buf = alloc.allocate(static_cast<size_t>(n));
+    } catch (const std::bad_alloc&) {
+        mystl::stable_sort(first, last, key_less);
+        return;
+    }
+
+    // Passes alternate between the range and the buffer. The first pass constructs into the raw
+    // buffer; later ones assign, since both sides then hold live (possibly moved-from) objects.
+    bool in_buffer = false;
+    for (int a = 0; a < num_active; ++a) {
+        const int d = active[a];
+        const int shift = d * 8;
+        size_t offsets[256];
+        size_t sum = 0;
+        for (int b = 0; b < 256; ++b) {
+            offsets[b] = sum;
+            sum += counts[d][b];
+        }
+        if (!in_buffer) {
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+                T& value = first[i];
+                const size_t dst = offsets[(key_of(value) >> shift) & 0xff]++;
+                if (a == 0) {
+                    mystl::construct_at(buf + dst, mystl::move(value));
+                } else {
+                    buf[dst] = mystl::move(value);
+                }
+            }
+        } else {
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+                T& value = buf[i];
+                first[static_cast<std::ptrdiff_t>(offsets[(key_of(value) >> shift) & 0xff]++)] =
+                    mystl::move(value);
+            }
+        }
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer) {
+        mystl::move(buf, buf + n, first);
+    }
+    mystl::destroy(buf, buf + n);
+    alloc.deallocate(buf, static_cast<size_t>(n));
+}
+
+}  // namespace mystl
+
+#endif
@@ -72,9 +72,6 @@ concept copyable = copy_constructible<T> && movable<T> && assignable_from<T&, T&
 template <typename T>
 concept semiregular = copyable<T> && default_initializable<T>;
 
-template <typename T>
-concept regular = semiregular<T> && equality_comparable<T>;
-
 namespace detail {
 template <typename T>
 concept boolean_testable_impl = convertible_to<T, bool>;
@@ -97,6 +94,9 @@ concept weakly_equality_comparable_with =
 template <typename T>
 concept equality_comparable = weakly_equality_comparable_with<T, T>;
 
+template <typename T>
+concept regular = semiregular<T> && equality_comparable<T>;
+
 template <typename T>
 concept totally_ordered =
     equality_comparable<T> && requires(const remove_reference_t<T>& a, remove_reference_t<T>& b) {
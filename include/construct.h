@@ -1,5 +1,333 @@
-#pragma once
+#ifndef MYSTL_HANDMADE_CONSTRUCT_H_
+#define MYSTL_HANDMADE_CONSTRUCT_H_
 
+#include <cstring>
+#include <memory>
 #include <new>
-#include <utility>
- 
\ No newline at end of file
+
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+// Placement new cannot begin an object's lifetime in a constant expression; std::construct_at
+// is the one function allowed to, so constant evaluation goes through it.
+template <typename T, typename... Args>
+    requires requires(void* p, Args&&... args) { ::new (p) T(mystl::forward<Args>(args)...); }
+constexpr T* construct_at(T* p, Args&&... args) noexcept(is_nothrow_constructible_v<T, Args...>) {
+    if consteval {
+        return std::construct_at(p, mystl::forward<Args>(args)...);
+    }
+    return ::new (static_cast<void*>(p)) T(mystl::forward<Args>(args)...);
+}
+
+template <typename T>
+constexpr void destroy_at(T* p) noexcept {
+    if constexpr (is_array_v<T>) {
+        for (size_t i = 0; i < sizeof(T) / sizeof(**p); ++i) {
+            mystl::destroy_at(*p + i);
+        }
+    } else if constexpr (!is_trivially_destructible_v<T>) {
+        p->~T();
+    }
+}
+
+namespace detail {
+
+template <typename It>
+using iter_value_t = remove_cvref_t<decltype(*mystl::declval<It&>())>;
+
+template <typename It>
+using iter_reference_t = decltype(*mystl::declval<It&>());
+
+template <typename It>
+inline constexpr bool is_contiguous_pointer_v =
+    is_pointer_v<It> && !is_volatile_v<remove_reference_t<iter_reference_t<It>>>;
+
+// Constructing a T from `Ref` can be done with memmove when both ranges are raw pointers to the
+// same trivially copyable type and the selected constructor is trivial.
+template <typename InIt, typename OutIt, typename Ref>
+inline constexpr bool is_bitwise_constructible_v =
+    is_contiguous_pointer_v<InIt> && is_contiguous_pointer_v<OutIt> &&
+    !is_const_v<remove_reference_t<iter_reference_t<OutIt>>> &&
+    is_same_v<iter_value_t<InIt>, iter_value_t<OutIt>> &&
+    is_trivially_copyable_v<iter_value_t<OutIt>> &&
+    is_trivially_constructible_v<iter_value_t<OutIt>, Ref>;
+
+// Scalars whose zero value is the all-zero bit pattern. Member pointers are excluded because the
+// Itanium ABI represents a null data member pointer as -1.
+template <typename T>
+inline constexpr bool is_zero_bits_value_initializable_v =
+    is_arithmetic_v<T> || is_pointer_v<T> || is_enum_v<T> || is_null_pointer_v<T>;
+
+template <typename T>
+inline bool has_zero_bits(const T& value) noexcept {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, mystl::addressof(value), sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        if (bytes[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+inline T* bitwise_copy_n(const T* first, size_t n, T* d_first) noexcept {
+    if (n != 0) {
+        std::memmove(d_first, first, n * sizeof(T));
+    }
+    return d_first + n;
+}
+
+template <typename T>
+inline T* bitwise_zero_n(T* first, size_t n) noexcept {
+    if (n != 0) {
+        std::memset(first, 0, n * sizeof(T));
+    }
+    return first + n;
+}
+
+// Fills [first, first + n) with `value` using memset when every byte of `value` is identical,
+// which covers one-byte types and the common "fill with zero" case. Returns nullptr otherwise.
+template <typename T>
+inline T* try_bitwise_fill_n(T* first, size_t n, const T& value) noexcept {
+    if constexpr (sizeof(T) == 1) {
+        unsigned char byte;
+        std::memcpy(&byte, mystl::addressof(value), 1);
+        if (n != 0) {
+            std::memset(first, byte, n);
+        }
+        return first + n;
+    } else if constexpr (is_zero_bits_value_initializable_v<T>) {
+        if (detail::has_zero_bits(value)) {
+            return detail::bitwise_zero_n(first, n);
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace detail
+
+template <typename ForwardIt>
+constexpr void destroy(ForwardIt first, ForwardIt last) noexcept {
+    if constexpr (!is_trivially_destructible_v<detail::iter_value_t<ForwardIt>>) {
+        for (; first != last; ++first) {
+            mystl::destroy_at(mystl::addressof(*first));
+        }
+    }
+}
+
+template <typename ForwardIt, typename Size>
+constexpr ForwardIt destroy_n(ForwardIt first, Size n) noexcept {
+    if constexpr (is_trivially_destructible_v<detail::iter_value_t<ForwardIt>> &&
+                  is_pointer_v<ForwardIt>) {
+        return first + n;
+    } else {
+        for (; n > 0; (void)++first, --n) {
+            mystl::destroy_at(mystl::addressof(*first));
+        }
+        return first;
+    }
+}
+
+template <typename InputIt, typename ForwardIt>
+constexpr ForwardIt uninitialized_copy(InputIt first, InputIt last, ForwardIt d_first) {
+    if constexpr (detail::is_bitwise_constructible_v<InputIt, ForwardIt,
+                                                     detail::iter_reference_t<InputIt>>) {
+        if (!mystl::is_constant_evaluated()) {
+            return detail::bitwise_copy_n(first, static_cast<size_t>(last - first), d_first);
+        }
+    }
+    ForwardIt current = d_first;
+    try {
+        for (; first != last; ++first, (void)++current) {
+            mystl::construct_at(mystl::addressof(*current), *first);
+        }
+        return current;
+    } catch (...) {
+        mystl::destroy(d_first, current);
+        throw;
+    }
+}
+
+template <typename InputIt, typename Size, typename ForwardIt>
+constexpr ForwardIt uninitialized_copy_n(InputIt first, Size n, ForwardIt d_first) {
+    if constexpr (detail::is_bitwise_constructible_v<InputIt, ForwardIt,
+                                                     detail::iter_reference_t<InputIt>>) {
+        if (!mystl::is_constant_evaluated()) {
+            return detail::bitwise_copy_n(first, n > 0 ? static_cast<size_t>(n) : 0, d_first);
+        }
+    }
+    ForwardIt current = d_first;
+    try {
+        for (; n > 0; ++first, (void)++current, --n) {
+            mystl::construct_at(mystl::addressof(*current), *first);
+        }
+        return current;
+    } catch (...) {
+        mystl::destroy(d_first, current);
+        throw;
+    }
+}
+
+template <typename InputIt, typename ForwardIt>
+constexpr ForwardIt uninitialized_move(InputIt first, InputIt last, ForwardIt d_first) {
+    using rvalue_t = remove_reference_t<detail::iter_reference_t<InputIt>>&&;
+    if constexpr (detail::is_bitwise_constructible_v<InputIt, ForwardIt, rvalue_t>) {
+        if (!mystl::is_constant_evaluated()) {
+            return detail::bitwise_copy_n(first, static_cast<size_t>(last - first), d_first);
+        }
+    }
+    ForwardIt current = d_first;
+    try {
+        for (; first != last; ++first, (void)++current) {
+            mystl::construct_at(mystl::addressof(*current), mystl::move(*first));
+        }
+        return current;
+    } catch (...) {
+        mystl::destroy(d_first, current);
+        throw;
+    }
+}
+
+template <typename InputIt, typename Size, typename ForwardIt>
+constexpr pair<InputIt, ForwardIt> uninitialized_move_n(InputIt first, Size n,
+                                                        ForwardIt d_first) {
+    using rvalue_t = remove_reference_t<detail::iter_reference_t<InputIt>>&&;
+    if constexpr (detail::is_bitwise_constructible_v<InputIt, ForwardIt, rvalue_t>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t count = n > 0 ? static_cast<size_t>(n) : 0;
+            return {first + count, detail::bitwise_copy_n(first, count, d_first)};
+        }
+    }
+    ForwardIt current = d_first;
+    try {
+        for (; n > 0; ++first, (void)++current, --n) {
+            mystl::construct_at(mystl::addressof(*current), mystl::move(*first));
+        }
+        return {first, current};
+    } catch (...) {
+        mystl::destroy(d_first, current);
+        throw;
+    }
+}
+
+template <typename ForwardIt, typename Size, typename T>
+constexpr ForwardIt uninitialized_fill_n(ForwardIt first, Size n, const T& value) {
+    using value_t = detail::iter_value_t<ForwardIt>;
+    if constexpr (detail::is_bitwise_constructible_v<const value_t*, ForwardIt, const value_t&> &&
+                  is_same_v<remove_cv_t<T>, value_t>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t count = n > 0 ? static_cast<size_t>(n) : 0;
+            if (value_t* end = detail::try_bitwise_fill_n(first, count, value)) {
+                return end;
+            }
+        }
+    }
+    ForwardIt current = first;
+    try {
+        for (; n > 0; (void)++current, --n) {
+            mystl::construct_at(mystl::addressof(*current), value);
+        }
+        return current;
+    } catch (...) {
+        mystl::destroy(first, current);
+        throw;
+    }
+}
+
+template <typename ForwardIt, typename T>
+constexpr void uninitialized_fill(ForwardIt first, ForwardIt last, const T& value) {
+    if constexpr (is_pointer_v<ForwardIt>) {
+        mystl::uninitialized_fill_n(first, last - first, value);
+    } else {
+        ForwardIt current = first;
+        try {
+            for (; current != last; ++current) {
+                mystl::construct_at(mystl::addressof(*current), value);
+            }
+        } catch (...) {
+            mystl::destroy(first, current);
+            throw;
+        }
+    }
+}
+
+template <typename ForwardIt, typename Size>
+constexpr ForwardIt uninitialized_value_construct_n(ForwardIt first, Size n) {
+    using value_t = detail::iter_value_t<ForwardIt>;
+    if constexpr (detail::is_contiguous_pointer_v<ForwardIt> &&
+                  detail::is_zero_bits_value_initializable_v<value_t>) {
+        if (!mystl::is_constant_evaluated()) {
+            return detail::bitwise_zero_n(first, n > 0 ? static_cast<size_t>(n) : 0);
+        }
+    }
+    ForwardIt current = first;
+    try {
+        for (; n > 0; (void)++current, --n) {
+            ::new (static_cast<void*>(mystl::addressof(*current))) value_t();
+        }
+        return current;
+    } catch (...) {
+        mystl::destroy(first, current);
+        throw;
+    }
+}
+
+template <typename ForwardIt>
+constexpr void uninitialized_value_construct(ForwardIt first, ForwardIt last) {
+    if constexpr (is_pointer_v<ForwardIt>) {
+        mystl::uninitialized_value_construct_n(first, last - first);
+    } else {
+        using value_t = detail::iter_value_t<ForwardIt>;
+        ForwardIt current = first;
+        try {
+            for (; current != last; ++current) {
+                ::new (static_cast<void*>(mystl::addressof(*current))) value_t();
+            }
+        } catch (...) {
+            mystl::destroy(first, current);
+            throw;
+        }
+    }
+}
+
+template <typename ForwardIt, typename Size>
+constexpr ForwardIt uninitialized_default_construct_n(ForwardIt first, Size n) {
+    using value_t = detail::iter_value_t<ForwardIt>;
+    if constexpr (is_trivially_default_constructible_v<value_t> && is_pointer_v<ForwardIt>) {
+        return first + (n > 0 ? n : 0);
+    } else {
+        ForwardIt current = first;
+        try {
+            for (; n > 0; (void)++current, --n) {
+                ::new (static_cast<void*>(mystl::addressof(*current))) value_t;
+            }
+            return current;
+        } catch (...) {
+            mystl::destroy(first, current);
+            throw;
+        }
+    }
+}
+
+template <typename ForwardIt>
+constexpr void uninitialized_default_construct(ForwardIt first, ForwardIt last) {
+    using value_t = detail::iter_value_t<ForwardIt>;
+    if constexpr (!is_trivially_default_constructible_v<value_t>) {
+        ForwardIt current = first;
+        try {
+            for (; current != last; ++current) {
+                ::new (static_cast<void*>(mystl::addressof(*current))) value_t;
+            }
+        } catch (...) {
+            mystl::destroy(first, current);
+            throw;
+        }
+    }
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,445 @@
+#ifndef MYSTL_HANDMADE_EXECUTION_H_
+#define MYSTL_HANDMADE_EXECUTION_H_
+
+#include <cstddef>
+#include <functional>
+
+#include "algorithm.h"
+#include "construct.h"
+#include "memory.h"
+#include "numeric.h"
+#include "scheduler.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace execution {
+
+class sequenced_policy {};
+class parallel_policy {};
+class parallel_unsequenced_policy {};
+class unsequenced_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+inline constexpr unsequenced_policy unseq{};
+
+}  // namespace execution
+
+template <typename T>
+struct is_execution_policy : false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::unsequenced_policy> : true_type {};
+
+template <typename T>
+inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+namespace detail {
+    template <typename Policy>
+    concept execution_policy = is_execution_policy_v<remove_cvref_t<Policy>>;
+
+    // Only par and par_unseq over random-access ranges go to the scheduler. seq and unseq run the
+    // plain loops; unseq adds nothing the optimizer does not already do at -O2.
+    template <typename Policy, typename... Its>
+    inline constexpr bool runs_parallel_v =
+        (is_same_v<remove_cvref_t<Policy>, execution::parallel_policy> ||
+         is_same_v<remove_cvref_t<Policy>, execution::parallel_unsequenced_policy>) &&
+        (random_access_iter<Its> && ...);
+
+    // Fewer elements than this per chunk and the hand-off costs more than it saves.
+    inline constexpr size_t parallel_grain = 4096;
+
+    // Number of chunks to split n elements into: a few per thread so that uneven chunks
+    // balance out, and none smaller than parallel_grain.
+    inline size_t parallel_chunk_count(size_t n) {
+        const size_t by_threads = (scheduler::default_scheduler().size() + 1) * 4;
+        const size_t by_grain = (n + parallel_grain - 1) / parallel_grain;
+        return by_threads < by_grain ? by_threads : by_grain;
+    }
+
+    // Calls f(c, begin, end) for each of `chunks` contiguous slices of [0, n).
+    template <typename F>
+    void parallel_for_chunks(size_t n, size_t chunks, F&& f) {
+        scheduler::default_scheduler().parallel_for(chunks, [&](size_t c) {
+            f(c, n * c / chunks, n * (c + 1) / chunks);
+        });
+    }
+
+    template <typename RandomIt, typename OutputIt, typename Compare>
+    OutputIt move_merge(RandomIt first1, RandomIt last1, RandomIt first2, RandomIt last2,
+                        OutputIt out, Compare& comp) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *out = mystl::move(*first2);
+                ++first2;
+            } else {
+                *out = mystl::move(*first1);
+                ++first1;
+            }
+            ++out;
+        }
+        out = mystl::move(first1, last1, out);
+        return mystl::move(first2, last2, out);
+    }
+
+    // One round of the parallel merge sort: merges adjacent sorted runs of length `width` from
+    // src into dst. Each pair of runs is cut into `parts` independent sub-merges at splitters
+    // taken from the left run, so the last rounds, with few long runs, still use every thread.
+    template <typename SrcIt, typename DstIt, typename Compare>
+    void parallel_merge_round(SrcIt src, DstIt dst, size_t n, size_t width, size_t threads,
+                              Compare& comp) {
+        struct segment {
+            size_t a_begin, a_end, b_begin, b_end, out;
+        };
+        vector<segment> segments;
+        const size_t pairs = (n + 2 * width - 1) / (2 * width);
+        const size_t parts = threads > pairs ? (threads + pairs - 1) / pairs : 1;
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            const size_t mid = lo + width < n ? lo + width : n;
+            const size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+            size_t a = lo;
+            size_t b = mid;
+            for (size_t p = 1; p <= parts; ++p) {
+                size_t a_cut = mid;
+                size_t b_cut = hi;
+                if (p != parts) {
+                    a_cut = lo + (mid - lo) * p / parts;
+                    b_cut = a_cut == mid ? hi
+                                         : static_cast<size_t>(
+                                               mystl::lower_bound(src + mid, src + hi,
+                                                                  src[a_cut], comp) - src);
+                }
+                segments.push_back({a, a_cut, b, b_cut, lo + (a - lo) + (b - mid)});
+                a = a_cut;
+                b = b_cut;
+            }
+        }
+        scheduler::default_scheduler().parallel_for(segments.size(), [&](size_t i) {
+            const segment& s = segments[i];
+            detail::move_merge(src + s.a_begin, src + s.a_end, src + s.b_begin, src + s.b_end,
+                               dst + s.out, comp);
+        });
+    }
+}  // namespace detail
+
+template <typename Policy, typename ForwardIt, typename F>
+    requires(detail::execution_policy<Policy> &&
+             invocable<F&, decltype(*mystl::declval<ForwardIt&>())>)
+void for_each(Policy&&, ForwardIt first, ForwardIt last, F f) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt>) {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                    [&](size_t, size_t b, size_t e) {
+                                        for (size_t i = b; i < e; ++i) {
+                                            mystl::invoke(f, first[i]);
+                                        }
+                                    });
+    } else {
+        mystl::for_each(first, last, mystl::move(f));
+    }
+}
+
+template <typename Policy, typename ForwardIt, typename OutputIt, typename UnaryOp>
+    requires(detail::execution_policy<Policy> &&
+             invocable<UnaryOp&, decltype(*mystl::declval<ForwardIt&>())>)
+OutputIt transform(Policy&&, ForwardIt first, ForwardIt last, OutputIt d_first, UnaryOp op) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt, OutputIt>) {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                    [&](size_t, size_t b, size_t e) {
+                                        for (size_t i = b; i < e; ++i) {
+                                            d_first[i] = mystl::invoke(op, first[i]);
+                                        }
+                                    });
+        return d_first + static_cast<std::ptrdiff_t>(n);
+    } else {
+        return mystl::transform(first, last, d_first, mystl::move(op));
+    }
+}
+
+template <typename Policy, typename ForwardIt1, typename ForwardIt2, typename OutputIt,
+          typename BinaryOp>
+    requires(detail::execution_policy<Policy> &&
+             invocable<BinaryOp&, decltype(*mystl::declval<ForwardIt1&>()),
+                       decltype(*mystl::declval<ForwardIt2&>())>)
+OutputIt transform(Policy&&, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2,
+                   OutputIt d_first, BinaryOp op) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt1, ForwardIt2, OutputIt>) {
+        const size_t n = static_cast<size_t>(last1 - first1);
+        detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                    [&](size_t, size_t b, size_t e) {
+                                        for (size_t i = b; i < e; ++i) {
+                                            d_first[i] = mystl::invoke(op, first1[i], first2[i]);
+                                        }
+                                    });
+        return d_first + static_cast<std::ptrdiff_t>(n);
+    } else {
+        return mystl::transform(first1, last1, first2, d_first, mystl::move(op));
+    }
+}
+
+template <typename Policy, typename ForwardIt, typename OutputIt>
+    requires detail::execution_policy<Policy>
+OutputIt copy(Policy&&, ForwardIt first, ForwardIt last, OutputIt d_first) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt, OutputIt>) {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                    [&](size_t, size_t b, size_t e) {
+                                        mystl::copy(first + b, first + e, d_first + b);
+                                    });
+        return d_first + static_cast<std::ptrdiff_t>(n);
+    } else {
+        return mystl::copy(first, last, d_first);
+    }
+}
+
+template <typename Policy, typename ForwardIt, typename T>
+    requires detail::execution_policy<Policy>
+void fill(Policy&&, ForwardIt first, ForwardIt last, const T& value) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt>) {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                    [&](size_t, size_t b, size_t e) {
+                                        mystl::fill(first + b, first + e, value);
+                                    });
+    } else {
+        mystl::fill(first, last, value);
+    }
+}
+
+// Each chunk folds its own elements starting from transform(first element); the partial
+// results are then folded into init in chunk order.
+template <typename Policy, typename ForwardIt, typename T, typename ReduceOp,
+          typename TransformOp>
+    requires(detail::execution_policy<Policy> &&
+             invocable<TransformOp&, decltype(*mystl::declval<ForwardIt&>())>)
+T transform_reduce(Policy&&, ForwardIt first, ForwardIt last, T init, ReduceOp reduce,
+                   TransformOp transform) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt>) {
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t chunks = detail::parallel_chunk_count(n);
+        if (chunks <= 1) {
+            return mystl::transform_reduce(first, last, mystl::move(init), reduce, transform);
+        }
+        vector<T> partials(chunks, init);
+        detail::parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e) {
+            T acc = mystl::invoke(transform, first[b]);
+            for (size_t i = b + 1; i < e; ++i) {
+                acc = mystl::invoke(reduce, mystl::move(acc), mystl::invoke(transform, first[i]));
+            }
+            partials[c] = mystl::move(acc);
+        });
+        for (T& partial : partials) {
+            init = mystl::invoke(reduce, mystl::move(init), mystl::move(partial));
+        }
+        return init;
+    } else {
+        return mystl::transform_reduce(first, last, mystl::move(init), mystl::move(reduce),
+                                       mystl::move(transform));
+    }
+}
+
+template <typename Policy, typename ForwardIt1, typename ForwardIt2, typename T,
+          typename ReduceOp, typename TransformOp>
+    requires(detail::execution_policy<Policy> &&
+             invocable<TransformOp&, decltype(*mystl::declval<ForwardIt1&>()),
+                       decltype(*mystl::declval<ForwardIt2&>())>)
+T transform_reduce(Policy&&, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, T init,
+                   ReduceOp reduce, TransformOp transform) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt1, ForwardIt2>) {
+        const size_t n = static_cast<size_t>(last1 - first1);
+        const size_t chunks = detail::parallel_chunk_count(n);
+        if (chunks <= 1) {
+            return mystl::transform_reduce(first1, last1, first2, mystl::move(init), reduce,
+                                           transform);
+        }
+        vector<T> partials(chunks, init);
+        detail::parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e) {
+            T acc = mystl::invoke(transform, first1[b], first2[b]);
+            for (size_t i = b + 1; i < e; ++i) {
+                acc = mystl::invoke(reduce, mystl::move(acc),
+                                    mystl::invoke(transform, first1[i], first2[i]));
+            }
+            partials[c] = mystl::move(acc);
+        });
+        for (T& partial : partials) {
+            init = mystl::invoke(reduce, mystl::move(init), mystl::move(partial));
+        }
+        return init;
+    } else {
+        return mystl::transform_reduce(first1, last1, first2, mystl::move(init),
+                                       mystl::move(reduce), mystl::move(transform));
+    }
+}
+
+template <typename Policy, typename ForwardIt1, typename ForwardIt2, typename T>
+    requires detail::execution_policy<Policy>
+T transform_reduce(Policy&& policy, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2,
+                   T init) {
+    return mystl::transform_reduce(mystl::forward<Policy>(policy), first1, last1, first2,
+                                   mystl::move(init), std::plus<>(), std::multiplies<>());
+}
+
+template <typename Policy, typename ForwardIt, typename T, typename BinaryOp>
+    requires detail::execution_policy<Policy>
+T reduce(Policy&& policy, ForwardIt first, ForwardIt last, T init, BinaryOp op) {
+    return mystl::transform_reduce(mystl::forward<Policy>(policy), first, last,
+                                   mystl::move(init), mystl::move(op), std::identity());
+}
+
+template <typename Policy, typename ForwardIt, typename T>
+    requires detail::execution_policy<Policy>
+T reduce(Policy&& policy, ForwardIt first, ForwardIt last, T init) {
+    return mystl::reduce(mystl::forward<Policy>(policy), first, last, mystl::move(init),
+                         std::plus<>());
+}
+
+template <typename Policy, typename ForwardIt>
+    requires detail::execution_policy<Policy>
+detail::numeric_value_t<ForwardIt> reduce(Policy&& policy, ForwardIt first, ForwardIt last) {
+    return mystl::reduce(mystl::forward<Policy>(policy), first, last,
+                         detail::numeric_value_t<ForwardIt>(), std::plus<>());
+}
+
+namespace detail {
+    // Two passes: every chunk but the last computes its total in parallel, a serial scan over
+    // the totals gives each chunk its carry-in, and then all chunks scan in parallel.
+    template <typename ForwardIt, typename OutputIt, typename BinaryOp, typename T>
+    OutputIt parallel_inclusive_scan(ForwardIt first, ForwardIt last, OutputIt d_first,
+                                     BinaryOp& op, const T* init) {
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t chunks = detail::parallel_chunk_count(n);
+        if (chunks <= 1) {
+            return init ? mystl::inclusive_scan(first, last, d_first, op, *init)
+                        : mystl::inclusive_scan(first, last, d_first, op);
+        }
+        vector<T> carry(chunks, T(*first));
+        scheduler::default_scheduler().parallel_for(chunks - 1, [&](size_t c) {
+            const size_t b = n * c / chunks;
+            const size_t e = n * (c + 1) / chunks;
+            T acc = first[b];
+            for (size_t i = b + 1; i < e; ++i) {
+                acc = mystl::invoke(op, mystl::move(acc), first[i]);
+            }
+            carry[c + 1] = mystl::move(acc);
+        });
+        if (init) {
+            carry[0] = *init;
+        }
+        for (size_t c = 1; c < chunks; ++c) {
+            if (c == 1 && !init) {
+                continue;
+            }
+            carry[c] = mystl::invoke(op, carry[c - 1], mystl::move(carry[c]));
+        }
+        detail::parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e) {
+            if (c == 0 && !init) {
+                mystl::inclusive_scan(first + b, first + e, d_first + b, op);
+            } else {
+                mystl::inclusive_scan(first + b, first + e, d_first + b, op, carry[c]);
+            }
+        });
+        return d_first + static_cast<std::ptrdiff_t>(n);
+    }
+}  // namespace detail
+
+template <typename Policy, typename ForwardIt, typename OutputIt, typename BinaryOp, typename T>
+    requires(detail::execution_policy<Policy> &&
+             invocable<BinaryOp&, T, decltype(*mystl::declval<ForwardIt&>())>)
+OutputIt inclusive_scan(Policy&&, ForwardIt first, ForwardIt last, OutputIt d_first, BinaryOp op,
+                        T init) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt, OutputIt>) {
+        return detail::parallel_inclusive_scan(first, last, d_first, op, &init);
+    } else {
+        return mystl::inclusive_scan(first, last, d_first, mystl::move(op), mystl::move(init));
+    }
+}
+
+template <typename Policy, typename ForwardIt, typename OutputIt, typename BinaryOp>
+    requires detail::execution_policy<Policy>
+OutputIt inclusive_scan(Policy&&, ForwardIt first, ForwardIt last, OutputIt d_first, BinaryOp op) {
+    if constexpr (detail::runs_parallel_v<Policy, ForwardIt, OutputIt>) {
+        return detail::parallel_inclusive_scan(
+            first, last, d_first, op, static_cast<const detail::numeric_value_t<ForwardIt>*>(nullptr));
+    } else {
+        return mystl::inclusive_scan(first, last, d_first, mystl::move(op));
+    }
+}
+
+template <typename Policy, typename ForwardIt, typename OutputIt>
+    requires detail::execution_policy<Policy>
+OutputIt inclusive_scan(Policy&& policy, ForwardIt first, ForwardIt last, OutputIt d_first) {
+    return mystl::inclusive_scan(mystl::forward<Policy>(policy), first, last, d_first,
+                                 std::plus<>());
+}
+
+// Parallel merge sort: chunks are sorted with mystl::sort and moved into a scratch buffer in
+// one parallel pass, then merged in rounds that alternate between the buffer and the range.
+template <typename Policy, typename RandomIt, typename Compare>
+    requires(detail::execution_policy<Policy> && detail::sortable<RandomIt, Compare>)
+void sort(Policy&&, RandomIt first, RandomIt last, Compare comp) {
+    if constexpr (detail::runs_parallel_v<Policy, RandomIt>) {
+        using T = detail::iter_value_t<RandomIt>;
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t threads = scheduler::default_scheduler().size() + 1;
+        size_t chunks = n / detail::parallel_grain < threads ? n / detail::parallel_grain : threads;
+        if (chunks <= 1) {
+            mystl::sort(first, last, comp);
+            return;
+        }
+        // Equal-width runs, so that merge round k merges runs of width << k.
+        const size_t width = (n + chunks - 1) / chunks;
+        chunks = (n + width - 1) / width;
+
+        allocator<T> alloc;
+        T* buf = alloc.allocate(n);
+        scheduler::default_scheduler().parallel_for(chunks, [&](size_t c) {
+            const size_t b = c * width;
+            const size_t e = b + width < n ? b + width : n;
+            mystl::sort(first + b, first + e, comp);
+            mystl::uninitialized_move(first + b, first + e, buf + b);
+        });
+        bool in_buffer = true;
+        for (size_t w = width; w < n; w *= 2) {
+            if (in_buffer) {
+                detail::parallel_merge_round(buf, first, n, w, threads, comp);
+            } else {
+                detail::parallel_merge_round(first, buf, n, w, threads, comp);
+            }
+            in_buffer = !in_buffer;
+        }
+        if (in_buffer) {
+            detail::parallel_for_chunks(n, detail::parallel_chunk_count(n),
+                                        [&](size_t, size_t b, size_t e) {
+                                            mystl::move(buf + b, buf + e, first + b);
+                                        });
+        }
+        mystl::destroy(buf, buf + n);
+        alloc.deallocate(buf, n);
+    } else {
+        mystl::sort(first, last, mystl::move(comp));
+    }
+}
+
+template <typename Policy, typename RandomIt>
+    requires(detail::execution_policy<Policy> && detail::sortable<RandomIt, detail::less_op>)
+void sort(Policy&& policy, RandomIt first, RandomIt last) {
+    mystl::sort(mystl::forward<Policy>(policy), first, last, detail::less_op{});
+}
+
+}  // namespace mystl
+
+#endif
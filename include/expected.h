@@ -0,0 +1,1156 @@
+#ifndef MYSTL_HANDMADE_EXPECTED_H_
+#define MYSTL_HANDMADE_EXPECTED_H_
+
+#include <cstdlib>
+#include <exception>
+#include <initializer_list>
+#include <new>
+
+#include "construct.h"
+#include "optional.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+template <typename E>
+class unexpected;
+
+template <typename T, typename E>
+class expected;
+
+struct unexpect_t {
+    explicit unexpect_t() = default;
+};
+
+inline constexpr unexpect_t unexpect{};
+
+template <typename E>
+class bad_expected_access;
+
+template <>
+class bad_expected_access<void> : public std::exception {
+public:
+    const char* what() const noexcept override { return "mystl::bad_expected_access"; }
+
+protected:
+    bad_expected_access() noexcept = default;
+};
+
+template <typename E>
+class bad_expected_access : public bad_expected_access<void> {
+public:
+    explicit bad_expected_access(E error) : error_(mystl::move(error)) {}
+
+    E& error() & noexcept { return error_; }
+    const E& error() const& noexcept { return error_; }
+    E&& error() && noexcept { return mystl::move(error_); }
+    const E&& error() const&& noexcept { return mystl::move(error_); }
+
+private:
+    E error_;
+};
+
+namespace detail {
+    template <typename T>
+    inline constexpr bool is_unexpected_v = false;
+
+    template <typename E>
+    inline constexpr bool is_unexpected_v<unexpected<E>> = true;
+
+    template <typename T>
+    inline constexpr bool is_expected_v = false;
+
+    template <typename T, typename E>
+    inline constexpr bool is_expected_v<expected<T, E>> = true;
+
+    // value() on an error throws bad_expected_access, or terminates when exceptions are
+    // disabled, so the header builds with -fno-exceptions.
+    template <typename E>
+    [[noreturn]] void throw_bad_expected_access(E&& error) {
+#if defined(__cpp_exceptions)
+        throw bad_expected_access<decay_t<E>>(mystl::forward<E>(error));
+#else
+        static_cast<void>(error);
+        std::abort();
+#endif
+    }
+
+    // Moves *saved back into the slot it was taken from unless disarmed. The expected
+    // operations below use it instead of try/catch, so a throwing constructor leaves the old
+    // contents in place with or without exception support.
+    template <typename T>
+    struct expected_restore {
+        T* slot;
+        T* saved;
+        bool armed = true;
+
+        constexpr ~expected_restore() {
+            if (armed) {
+                mystl::construct_at(slot, mystl::move(*saved));
+            }
+        }
+    };
+
+    // Replaces old_val by a New built from args; both are members of one union. If building
+    // New throws, old_val is alive again afterwards. Needs New built without throwing, or New
+    // or Old moved without throwing.
+    template <typename New, typename Old, typename... Args>
+    constexpr void expected_reinit(New& new_val, Old& old_val, Args&&... args) {
+        if constexpr (is_nothrow_constructible_v<New, Args...>) {
+            mystl::destroy_at(mystl::addressof(old_val));
+            mystl::construct_at(mystl::addressof(new_val), mystl::forward<Args>(args)...);
+        } else if constexpr (is_nothrow_move_constructible_v<New>) {
+            New tmp(mystl::forward<Args>(args)...);
+            mystl::destroy_at(mystl::addressof(old_val));
+            mystl::construct_at(mystl::addressof(new_val), mystl::move(tmp));
+        } else {
+            static_assert(is_nothrow_move_constructible_v<Old>);
+            Old saved(mystl::move(old_val));
+            mystl::destroy_at(mystl::addressof(old_val));
+            expected_restore<Old> restore{mystl::addressof(old_val), mystl::addressof(saved)};
+            mystl::construct_at(mystl::addressof(new_val), mystl::forward<Args>(args)...);
+            restore.armed = false;
+        }
+    }
+
+    // Constructs the value, or the error, from invoke(f, args...); transform() and
+    // transform_error() rely on these for types that cannot be moved.
+    struct expected_invoke_t {
+        explicit expected_invoke_t() = default;
+    };
+
+    struct expected_invoke_error_t {
+        explicit expected_invoke_error_t() = default;
+    };
+
+    // Copies or moves the state of another expected, possibly with other value and error types.
+    struct expected_from_t {
+        explicit expected_from_t() = default;
+    };
+
+    template <typename T>
+    concept expected_trivial_copy = is_trivially_copy_constructible_v<T> &&
+                                    is_trivially_copy_assignable_v<T> &&
+                                    is_trivially_destructible_v<T>;
+
+    template <typename T>
+    concept expected_trivial_move = is_trivially_move_constructible_v<T> &&
+                                    is_trivially_move_assignable_v<T> &&
+                                    is_trivially_destructible_v<T>;
+
+    template <typename T, typename E>
+    concept expected_reinit_safe =
+        is_nothrow_move_constructible_v<T> || is_nothrow_move_constructible_v<E>;
+
+    // T or unexpected<E> can be built from an expected<U, G> itself; such conversions bypass
+    // the converting constructors of expected.
+    template <typename T, typename E, typename U, typename G>
+    concept expected_converts_from =
+        (!is_same_v<remove_cv_t<T>, bool> &&
+         (is_constructible_v<T, expected<U, G>&> || is_constructible_v<T, expected<U, G>> ||
+          is_constructible_v<T, const expected<U, G>&> ||
+          is_constructible_v<T, const expected<U, G>> || is_convertible_v<expected<U, G>&, T> ||
+          is_convertible_v<expected<U, G>, T> || is_convertible_v<const expected<U, G>&, T> ||
+          is_convertible_v<const expected<U, G>, T>)) ||
+        is_constructible_v<unexpected<E>, expected<U, G>&> ||
+        is_constructible_v<unexpected<E>, expected<U, G>> ||
+        is_constructible_v<unexpected<E>, const expected<U, G>&> ||
+        is_constructible_v<unexpected<E>, const expected<U, G>>;
+
+    // Value and error share a union; the flag says which one is alive.
+    template <typename T, typename E>
+    struct expected_storage {
+        union {
+            remove_cv_t<T> val_;
+            E unex_;
+        };
+        bool has_val_;
+
+        template <typename... Args>
+        constexpr explicit expected_storage(in_place_t, Args&&... args)
+            : val_(mystl::forward<Args>(args)...), has_val_(true) {}
+
+        template <typename... Args>
+        constexpr explicit expected_storage(unexpect_t, Args&&... args)
+            : unex_(mystl::forward<Args>(args)...), has_val_(false) {}
+
+        template <typename F, typename... Args>
+        constexpr expected_storage(expected_invoke_t, F&& f, Args&&... args)
+            : val_(mystl::invoke(mystl::forward<F>(f), mystl::forward<Args>(args)...)),
+              has_val_(true) {}
+
+        template <typename F, typename Arg>
+        constexpr expected_storage(expected_invoke_error_t, F&& f, Arg&& arg)
+            : unex_(mystl::invoke(mystl::forward<F>(f), mystl::forward<Arg>(arg))),
+              has_val_(false) {}
+
+        // No member is alive if the body throws, and none is destroyed.
+        template <typename Other>
+        constexpr expected_storage(expected_from_t, Other&& other) : has_val_(other.has_value()) {
+            if (has_val_) {
+                mystl::construct_at(mystl::addressof(val_), *mystl::forward<Other>(other));
+            } else {
+                mystl::construct_at(mystl::addressof(unex_), mystl::forward<Other>(other).error());
+            }
+        }
+
+        constexpr ~expected_storage()
+            requires(is_trivially_destructible_v<T> && is_trivially_destructible_v<E>)
+        = default;
+
+        constexpr ~expected_storage() { destroy_(); }
+
+        constexpr void destroy_() noexcept {
+            if (has_val_) {
+                mystl::destroy_at(mystl::addressof(val_));
+            } else {
+                mystl::destroy_at(mystl::addressof(unex_));
+            }
+        }
+    };
+
+    // expected<void, E>: the error beside a flag, with no room reserved for a value.
+    template <typename E, bool = has_niche<E>>
+    struct expected_void_storage {
+        union {
+            char empty_;
+            E unex_;
+        };
+        bool has_val_;
+
+        constexpr expected_void_storage() noexcept : empty_(), has_val_(true) {}
+
+        template <typename... Args>
+        constexpr explicit expected_void_storage(unexpect_t, Args&&... args)
+            : unex_(mystl::forward<Args>(args)...), has_val_(false) {}
+
+        template <typename F, typename Arg>
+        constexpr expected_void_storage(expected_invoke_error_t, F&& f, Arg&& arg)
+            : unex_(mystl::invoke(mystl::forward<F>(f), mystl::forward<Arg>(arg))),
+              has_val_(false) {}
+
+        constexpr ~expected_void_storage()
+            requires is_trivially_destructible_v<E>
+        = default;
+
+        constexpr ~expected_void_storage() {
+            if (!has_val_) {
+                mystl::destroy_at(mystl::addressof(unex_));
+            }
+        }
+
+        constexpr bool has_value_() const noexcept { return has_val_; }
+        constexpr E& error_() noexcept { return unex_; }
+        constexpr const E& error_() const noexcept { return unex_; }
+
+        template <typename... Args>
+        constexpr void construct_error_(Args&&... args) {
+            mystl::construct_at(mystl::addressof(unex_), mystl::forward<Args>(args)...);
+            has_val_ = false;
+        }
+
+        constexpr void destroy_error_() noexcept {
+            mystl::destroy_at(mystl::addressof(unex_));
+            has_val_ = true;
+        }
+    };
+
+    // Just the bytes of an E; success is E's niche (see niche_traits), so an error code with a
+    // reserved "ok" value makes expected<void, E> exactly sizeof(E).
+    template <typename E>
+    struct expected_void_storage<E, true> {
+        static_assert(is_trivially_copyable_v<E>, "a type with a niche must be trivially copyable");
+
+        using traits = niche_traits<E>;
+
+        alignas(E) unsigned char bytes_[sizeof(E)];
+
+        expected_void_storage() noexcept { traits::set_empty(bytes_); }
+
+        template <typename... Args>
+        explicit expected_void_storage(unexpect_t, Args&&... args) {
+            mystl::construct_at(reinterpret_cast<E*>(bytes_), mystl::forward<Args>(args)...);
+        }
+
+        template <typename F, typename Arg>
+        expected_void_storage(expected_invoke_error_t, F&& f, Arg&& arg) {
+            mystl::construct_at(reinterpret_cast<E*>(bytes_),
+                                mystl::invoke(mystl::forward<F>(f), mystl::forward<Arg>(arg)));
+        }
+
+        bool has_value_() const noexcept { return traits::is_empty(bytes_); }
+        E& error_() noexcept { return *std::launder(reinterpret_cast<E*>(bytes_)); }
+        const E& error_() const noexcept {
+            return *std::launder(reinterpret_cast<const E*>(bytes_));
+        }
+
+        template <typename... Args>
+        void construct_error_(Args&&... args) {
+            mystl::construct_at(reinterpret_cast<E*>(bytes_), mystl::forward<Args>(args)...);
+        }
+
+        void destroy_error_() noexcept { traits::set_empty(bytes_); }
+    };
+}  // namespace detail
+
+// The error alternative of an expected, wrapped so that it cannot be mistaken for a value.
+template <typename E>
+class unexpected {
+    static_assert(is_object_v<E> && !is_array_v<E> && !is_const_v<E> && !is_volatile_v<E> &&
+                      !detail::is_unexpected_v<E>,
+                  "unexpected requires a non-array, non-cv object type");
+
+public:
+    constexpr unexpected(const unexpected&) = default;
+    constexpr unexpected(unexpected&&) = default;
+
+    template <typename Err = E>
+        requires(!is_same_v<remove_cvref_t<Err>, unexpected> &&
+                 !is_same_v<remove_cvref_t<Err>, in_place_t> && is_constructible_v<E, Err>)
+    constexpr explicit unexpected(Err&& error) : error_(mystl::forward<Err>(error)) {}
+
+    template <typename... Args>
+        requires is_constructible_v<E, Args...>
+    constexpr explicit unexpected(in_place_t, Args&&... args)
+        : error_(mystl::forward<Args>(args)...) {}
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<E, std::initializer_list<U>&, Args...>
+    constexpr explicit unexpected(in_place_t, std::initializer_list<U> il, Args&&... args)
+        : error_(il, mystl::forward<Args>(args)...) {}
+
+    constexpr unexpected& operator=(const unexpected&) = default;
+    constexpr unexpected& operator=(unexpected&&) = default;
+
+    constexpr E& error() & noexcept { return error_; }
+    constexpr const E& error() const& noexcept { return error_; }
+    constexpr E&& error() && noexcept { return mystl::move(error_); }
+    constexpr const E&& error() const&& noexcept { return mystl::move(error_); }
+
+    constexpr void swap(unexpected& other) noexcept(is_nothrow_swappable_v<E>) {
+        mystl::swap(error_, other.error_);
+    }
+
+    friend constexpr void swap(unexpected& a, unexpected& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    template <typename G>
+    friend constexpr bool operator==(const unexpected& a, const unexpected<G>& b) {
+        return a.error() == b.error();
+    }
+
+private:
+    E error_;
+};
+
+template <typename E>
+unexpected(E) -> unexpected<E>;
+
+// A T or an error E, for results that are reported without exceptions. Both alternatives live
+// inside the expected and are built with construct_at, so nothing is allocated; copying,
+// moving and destroying are trivial whenever they are for T and E, so an expected of trivially
+// copyable types is itself trivially copyable and is returned in registers.
+template <typename T, typename E>
+class expected : private detail::expected_storage<T, E> {
+    using base = detail::expected_storage<T, E>;
+
+    static_assert(!is_reference_v<T> && !is_array_v<T> && !is_function_v<T>,
+                  "expected requires an object type");
+    static_assert(!is_same_v<remove_cv_t<T>, in_place_t> &&
+                      !is_same_v<remove_cv_t<T>, unexpect_t> &&
+                      !detail::is_unexpected_v<remove_cv_t<T>>,
+                  "expected of in_place_t, unexpect_t or unexpected");
+
+public:
+    using value_type = T;
+    using error_type = E;
+    using unexpected_type = unexpected<E>;
+    using trivially_relocatable =
+        bool_constant<is_trivially_relocatable_v<T> && is_trivially_relocatable_v<E>>;
+
+    template <typename U>
+    using rebind = expected<U, error_type>;
+
+    constexpr expected()
+        requires is_default_constructible_v<T>
+        : base(in_place) {}
+
+    constexpr expected(const expected&)
+        requires(is_trivially_copy_constructible_v<T> && is_trivially_copy_constructible_v<E>)
+    = default;
+
+    constexpr expected(const expected& other)
+        requires(is_copy_constructible_v<T> && is_copy_constructible_v<E> &&
+                 !(is_trivially_copy_constructible_v<T> && is_trivially_copy_constructible_v<E>))
+        : base(detail::expected_from_t{}, other) {}
+
+    constexpr expected(expected&&)
+        requires(is_trivially_move_constructible_v<T> && is_trivially_move_constructible_v<E>)
+    = default;
+
+    constexpr expected(expected&& other) noexcept(is_nothrow_move_constructible_v<T> &&
+                                                  is_nothrow_move_constructible_v<E>)
+        requires(is_move_constructible_v<T> && is_move_constructible_v<E> &&
+                 !(is_trivially_move_constructible_v<T> && is_trivially_move_constructible_v<E>))
+        : base(detail::expected_from_t{}, mystl::move(other)) {}
+
+    template <typename U, typename G>
+        requires(is_constructible_v<T, const U&> && is_constructible_v<E, const G&> &&
+                 !detail::expected_converts_from<T, E, U, G>)
+    constexpr explicit(!is_convertible_v<const U&, T> || !is_convertible_v<const G&, E>)
+        expected(const expected<U, G>& other)
+        : base(detail::expected_from_t{}, other) {}
+
+    template <typename U, typename G>
+        requires(is_constructible_v<T, U> && is_constructible_v<E, G> &&
+                 !detail::expected_converts_from<T, E, U, G>)
+    constexpr explicit(!is_convertible_v<U, T> || !is_convertible_v<G, E>)
+        expected(expected<U, G>&& other)
+        : base(detail::expected_from_t{}, mystl::move(other)) {}
+
+    template <typename U = remove_cv_t<T>>
+        requires(!is_same_v<remove_cvref_t<U>, in_place_t> &&
+                 !is_same_v<remove_cvref_t<U>, unexpect_t> &&
+                 !is_same_v<remove_cvref_t<U>, expected> &&
+                 !detail::is_unexpected_v<remove_cvref_t<U>> && is_constructible_v<T, U> &&
+                 !(is_same_v<remove_cv_t<T>, bool> && detail::is_expected_v<remove_cvref_t<U>>))
+    constexpr explicit(!is_convertible_v<U, T>) expected(U&& value)
+        : base(in_place, mystl::forward<U>(value)) {}
+
+    template <typename G>
+        requires is_constructible_v<E, const G&>
+    constexpr explicit(!is_convertible_v<const G&, E>) expected(const unexpected<G>& error)
+        : base(unexpect, error.error()) {}
+
+    template <typename G>
+        requires is_constructible_v<E, G>
+    constexpr explicit(!is_convertible_v<G, E>) expected(unexpected<G>&& error)
+        : base(unexpect, mystl::move(error).error()) {}
+
+    template <typename... Args>
+        requires is_constructible_v<T, Args...>
+    constexpr explicit expected(in_place_t, Args&&... args)
+        : base(in_place, mystl::forward<Args>(args)...) {}
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<T, std::initializer_list<U>&, Args...>
+    constexpr explicit expected(in_place_t, std::initializer_list<U> il, Args&&... args)
+        : base(in_place, il, mystl::forward<Args>(args)...) {}
+
+    template <typename... Args>
+        requires is_constructible_v<E, Args...>
+    constexpr explicit expected(unexpect_t, Args&&... args)
+        : base(unexpect, mystl::forward<Args>(args)...) {}
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<E, std::initializer_list<U>&, Args...>
+    constexpr explicit expected(unexpect_t, std::initializer_list<U> il, Args&&... args)
+        : base(unexpect, il, mystl::forward<Args>(args)...) {}
+
+    constexpr expected& operator=(const expected&)
+        requires(detail::expected_trivial_copy<T> && detail::expected_trivial_copy<E>)
+    = default;
+
+    constexpr expected& operator=(const expected& other)
+        requires(is_copy_constructible_v<T> && is_copy_assignable_v<T> &&
+                 is_copy_constructible_v<E> && is_copy_assignable_v<E> &&
+                 detail::expected_reinit_safe<T, E> &&
+                 !(detail::expected_trivial_copy<T> && detail::expected_trivial_copy<E>))
+    {
+        assign_(other);
+        return *this;
+    }
+
+    constexpr expected& operator=(expected&&)
+        requires(detail::expected_trivial_move<T> && detail::expected_trivial_move<E>)
+    = default;
+
+    constexpr expected& operator=(expected&& other) noexcept(
+        is_nothrow_move_constructible_v<T> && is_nothrow_move_assignable_v<T> &&
+        is_nothrow_move_constructible_v<E> && is_nothrow_move_assignable_v<E>)
+        requires(is_move_constructible_v<T> && is_move_assignable_v<T> &&
+                 is_move_constructible_v<E> && is_move_assignable_v<E> &&
+                 detail::expected_reinit_safe<T, E> &&
+                 !(detail::expected_trivial_move<T> && detail::expected_trivial_move<E>))
+    {
+        assign_(mystl::move(other));
+        return *this;
+    }
+
+    template <typename U = remove_cv_t<T>>
+        requires(!is_same_v<remove_cvref_t<U>, expected> &&
+                 !detail::is_unexpected_v<remove_cvref_t<U>> && is_constructible_v<T, U> &&
+                 is_assignable_v<T&, U> &&
+                 (is_nothrow_constructible_v<T, U> || detail::expected_reinit_safe<T, E>))
+    constexpr expected& operator=(U&& value) {
+        if (has_value()) {
+            this->val_ = mystl::forward<U>(value);
+        } else {
+            detail::expected_reinit(this->val_, this->unex_, mystl::forward<U>(value));
+            this->has_val_ = true;
+        }
+        return *this;
+    }
+
+    template <typename G>
+        requires(is_constructible_v<E, const G&> && is_assignable_v<E&, const G&> &&
+                 (is_nothrow_constructible_v<E, const G&> || detail::expected_reinit_safe<T, E>))
+    constexpr expected& operator=(const unexpected<G>& error) {
+        assign_error_(error.error());
+        return *this;
+    }
+
+    template <typename G>
+        requires(is_constructible_v<E, G> && is_assignable_v<E&, G> &&
+                 (is_nothrow_constructible_v<E, G> || detail::expected_reinit_safe<T, E>))
+    constexpr expected& operator=(unexpected<G>&& error) {
+        assign_error_(mystl::move(error).error());
+        return *this;
+    }
+
+    template <typename... Args>
+        requires is_nothrow_constructible_v<T, Args...>
+    constexpr T& emplace(Args&&... args) noexcept {
+        this->destroy_();
+        mystl::construct_at(mystl::addressof(this->val_), mystl::forward<Args>(args)...);
+        this->has_val_ = true;
+        return this->val_;
+    }
+
+    template <typename U, typename... Args>
+        requires is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>
+    constexpr T& emplace(std::initializer_list<U> il, Args&&... args) noexcept {
+        this->destroy_();
+        mystl::construct_at(mystl::addressof(this->val_), il, mystl::forward<Args>(args)...);
+        this->has_val_ = true;
+        return this->val_;
+    }
+
+    constexpr void swap(expected& other) noexcept(
+        is_nothrow_move_constructible_v<T> && is_nothrow_swappable_v<T> &&
+        is_nothrow_move_constructible_v<E> && is_nothrow_swappable_v<E>)
+        requires(is_swappable_v<T> && is_swappable_v<E> && is_move_constructible_v<T> &&
+                 is_move_constructible_v<E> && detail::expected_reinit_safe<T, E>)
+    {
+        if (has_value() && other.has_value()) {
+            mystl::swap(this->val_, other.val_);
+        } else if (!has_value() && !other.has_value()) {
+            mystl::swap(this->unex_, other.unex_);
+        } else if (has_value()) {
+            swap_mixed_(other);
+        } else {
+            other.swap_mixed_(*this);
+        }
+    }
+
+    friend constexpr void swap(expected& a, expected& b) noexcept(noexcept(a.swap(b)))
+        requires requires { a.swap(b); }
+    {
+        a.swap(b);
+    }
+
+    constexpr bool has_value() const noexcept { return this->has_val_; }
+    constexpr explicit operator bool() const noexcept { return this->has_val_; }
+
+    constexpr T* operator->() noexcept { return mystl::addressof(this->val_); }
+    constexpr const T* operator->() const noexcept { return mystl::addressof(this->val_); }
+
+    constexpr T& operator*() & noexcept { return this->val_; }
+    constexpr const T& operator*() const& noexcept { return this->val_; }
+    constexpr T&& operator*() && noexcept { return mystl::move(this->val_); }
+    constexpr const T&& operator*() const&& noexcept { return mystl::move(this->val_); }
+
+    constexpr T& value() & {
+        check_(mystl::as_const(this->unex_));
+        return this->val_;
+    }
+
+    constexpr const T& value() const& {
+        check_(this->unex_);
+        return this->val_;
+    }
+
+    constexpr T&& value() && {
+        check_(mystl::move(this->unex_));
+        return mystl::move(this->val_);
+    }
+
+    constexpr const T&& value() const&& {
+        check_(mystl::move(this->unex_));
+        return mystl::move(this->val_);
+    }
+
+    constexpr E& error() & noexcept { return this->unex_; }
+    constexpr const E& error() const& noexcept { return this->unex_; }
+    constexpr E&& error() && noexcept { return mystl::move(this->unex_); }
+    constexpr const E&& error() const&& noexcept { return mystl::move(this->unex_); }
+
+    template <typename U>
+    constexpr T value_or(U&& fallback) const& {
+        return has_value() ? this->val_ : static_cast<T>(mystl::forward<U>(fallback));
+    }
+
+    template <typename U>
+    constexpr T value_or(U&& fallback) && {
+        return has_value() ? mystl::move(this->val_) : static_cast<T>(mystl::forward<U>(fallback));
+    }
+
+    template <typename G = E>
+    constexpr E error_or(G&& fallback) const& {
+        return has_value() ? static_cast<E>(mystl::forward<G>(fallback)) : this->unex_;
+    }
+
+    template <typename G = E>
+    constexpr E error_or(G&& fallback) && {
+        return has_value() ? static_cast<E>(mystl::forward<G>(fallback))
+                           : mystl::move(this->unex_);
+    }
+
+    // f(value) if this holds a value, the error unchanged otherwise. f returns an expected
+    // with the same error type.
+    template <typename F>
+    constexpr auto and_then(F&& f) & { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) const& { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) && {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto and_then(F&& f) const&& {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // The value unchanged if there is one, f(error) otherwise. f returns an expected with the
+    // same value type.
+    template <typename F>
+    constexpr auto or_else(F&& f) & { return or_else_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto or_else(F&& f) const& { return or_else_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto or_else(F&& f) && {
+        return or_else_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto or_else(F&& f) const&& {
+        return or_else_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // expected<U, E> holding f(value), or the error unchanged. The new value is constructed
+    // in place from the call, so it need not be movable; f may also return void.
+    template <typename F>
+    constexpr auto transform(F&& f) & { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) const& { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) && {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform(F&& f) const&& {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // expected<T, G> holding the value unchanged, or f(error) constructed in place.
+    template <typename F>
+    constexpr auto transform_error(F&& f) & {
+        return transform_error_(*this, mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) const& {
+        return transform_error_(*this, mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) && {
+        return transform_error_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) const&& {
+        return transform_error_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+private:
+    template <typename, typename>
+    friend class expected;
+
+    template <typename F, typename... Args>
+    constexpr expected(detail::expected_invoke_t tag, F&& f, Args&&... args)
+        : base(tag, mystl::forward<F>(f), mystl::forward<Args>(args)...) {}
+
+    template <typename F, typename Arg>
+    constexpr expected(detail::expected_invoke_error_t tag, F&& f, Arg&& arg)
+        : base(tag, mystl::forward<F>(f), mystl::forward<Arg>(arg)) {}
+
+    template <typename Error>
+    constexpr void check_(Error&& error) const {
+        if (!has_value()) {
+            detail::throw_bad_expected_access(mystl::forward<Error>(error));
+        }
+    }
+
+    template <typename Other>
+    constexpr void assign_(Other&& other) {
+        if (has_value() && other.has_value()) {
+            this->val_ = *mystl::forward<Other>(other);
+        } else if (has_value()) {
+            detail::expected_reinit(this->unex_, this->val_, mystl::forward<Other>(other).error());
+            this->has_val_ = false;
+        } else if (other.has_value()) {
+            detail::expected_reinit(this->val_, this->unex_, *mystl::forward<Other>(other));
+            this->has_val_ = true;
+        } else {
+            this->unex_ = mystl::forward<Other>(other).error();
+        }
+    }
+
+    template <typename Error>
+    constexpr void assign_error_(Error&& error) {
+        if (has_value()) {
+            detail::expected_reinit(this->unex_, this->val_, mystl::forward<Error>(error));
+            this->has_val_ = false;
+        } else {
+            this->unex_ = mystl::forward<Error>(error);
+        }
+    }
+
+    // This holds a value and other an error. Whichever of the two moves without throwing is
+    // set aside first, so a throw leaves both unchanged.
+    constexpr void swap_mixed_(expected& other) {
+        if constexpr (is_nothrow_move_constructible_v<E>) {
+            E saved(mystl::move(other.unex_));
+            mystl::destroy_at(mystl::addressof(other.unex_));
+            detail::expected_restore<E> restore{mystl::addressof(other.unex_),
+                                                mystl::addressof(saved)};
+            mystl::construct_at(mystl::addressof(other.val_), mystl::move(this->val_));
+            restore.armed = false;
+            mystl::destroy_at(mystl::addressof(this->val_));
+            mystl::construct_at(mystl::addressof(this->unex_), mystl::move(saved));
+        } else {
+            T saved(mystl::move(this->val_));
+            mystl::destroy_at(mystl::addressof(this->val_));
+            detail::expected_restore<T> restore{mystl::addressof(this->val_),
+                                                mystl::addressof(saved)};
+            mystl::construct_at(mystl::addressof(this->unex_), mystl::move(other.unex_));
+            restore.armed = false;
+            mystl::destroy_at(mystl::addressof(other.unex_));
+            mystl::construct_at(mystl::addressof(other.val_), mystl::move(saved));
+        }
+        this->has_val_ = false;
+        other.has_val_ = true;
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto and_then_(Self&& self, F&& f) {
+        using R = remove_cvref_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                        *mystl::forward<Self>(self)))>;
+        static_assert(detail::is_expected_v<R>, "and_then requires a function returning expected");
+        static_assert(is_same_v<typename R::error_type, E>,
+                      "and_then cannot change the error type");
+        if (self.has_value()) {
+            return mystl::invoke(mystl::forward<F>(f), *mystl::forward<Self>(self));
+        }
+        return R(unexpect, mystl::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto or_else_(Self&& self, F&& f) {
+        using R = remove_cvref_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                        mystl::forward<Self>(self).error()))>;
+        static_assert(detail::is_expected_v<R>, "or_else requires a function returning expected");
+        static_assert(is_same_v<typename R::value_type, T>, "or_else cannot change the value type");
+        if (self.has_value()) {
+            return R(in_place, *mystl::forward<Self>(self));
+        }
+        return mystl::invoke(mystl::forward<F>(f), mystl::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_(Self&& self, F&& f) {
+        using U = remove_cv_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                     *mystl::forward<Self>(self)))>;
+        using R = expected<U, E>;
+        if (!self.has_value()) {
+            return R(unexpect, mystl::forward<Self>(self).error());
+        }
+        if constexpr (is_void_v<U>) {
+            mystl::invoke(mystl::forward<F>(f), *mystl::forward<Self>(self));
+            return R();
+        } else {
+            return R(detail::expected_invoke_t{}, mystl::forward<F>(f),
+                     *mystl::forward<Self>(self));
+        }
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_error_(Self&& self, F&& f) {
+        using G = remove_cv_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                     mystl::forward<Self>(self).error()))>;
+        using R = expected<T, G>;
+        if (self.has_value()) {
+            return R(in_place, *mystl::forward<Self>(self));
+        }
+        return R(detail::expected_invoke_error_t{}, mystl::forward<F>(f),
+                 mystl::forward<Self>(self).error());
+    }
+};
+
+// expected<void, E>: success carries no value, so only the error and a flag are stored. If E
+// has a niche (see niche_traits), the flag is folded into E as well and the whole expected is
+// sizeof(E); an error equal to the niche value then reads as success.
+template <typename T, typename E>
+    requires is_void_v<T>
+class expected<T, E> : private detail::expected_void_storage<E> {
+    using base = detail::expected_void_storage<E>;
+
+public:
+    using value_type = T;
+    using error_type = E;
+    using unexpected_type = unexpected<E>;
+    using trivially_relocatable = bool_constant<is_trivially_relocatable_v<E>>;
+
+    template <typename U>
+    using rebind = expected<U, error_type>;
+
+    constexpr expected() noexcept {}
+
+    constexpr expected(const expected&)
+        requires is_trivially_copy_constructible_v<E>
+    = default;
+
+    constexpr expected(const expected& other)
+        requires(is_copy_constructible_v<E> && !is_trivially_copy_constructible_v<E>)
+        : base() {
+        if (!other.has_value()) {
+            this->construct_error_(other.error());
+        }
+    }
+
+    constexpr expected(expected&&)
+        requires is_trivially_move_constructible_v<E>
+    = default;
+
+    constexpr expected(expected&& other) noexcept(is_nothrow_move_constructible_v<E>)
+        requires(is_move_constructible_v<E> && !is_trivially_move_constructible_v<E>)
+        : base() {
+        if (!other.has_value()) {
+            this->construct_error_(mystl::move(other).error());
+        }
+    }
+
+    template <typename U, typename G>
+        requires(is_void_v<U> && is_constructible_v<E, const G&> &&
+                 !is_constructible_v<unexpected<E>, const expected<U, G>&>)
+    constexpr explicit(!is_convertible_v<const G&, E>) expected(const expected<U, G>& other)
+        : base() {
+        if (!other.has_value()) {
+            this->construct_error_(other.error());
+        }
+    }
+
+    template <typename U, typename G>
+        requires(is_void_v<U> && is_constructible_v<E, G> &&
+                 !is_constructible_v<unexpected<E>, expected<U, G>>)
+    constexpr explicit(!is_convertible_v<G, E>) expected(expected<U, G>&& other) : base() {
+        if (!other.has_value()) {
+            this->construct_error_(mystl::move(other).error());
+        }
+    }
+
+    template <typename G>
+        requires is_constructible_v<E, const G&>
+    constexpr explicit(!is_convertible_v<const G&, E>) expected(const unexpected<G>& error)
+        : base(unexpect, error.error()) {}
+
+    template <typename G>
+        requires is_constructible_v<E, G>
+    constexpr explicit(!is_convertible_v<G, E>) expected(unexpected<G>&& error)
+        : base(unexpect, mystl::move(error).error()) {}
+
+    constexpr explicit expected(in_place_t) noexcept {}
+
+    template <typename... Args>
+        requires is_constructible_v<E, Args...>
+    constexpr explicit expected(unexpect_t, Args&&... args)
+        : base(unexpect, mystl::forward<Args>(args)...) {}
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<E, std::initializer_list<U>&, Args...>
+    constexpr explicit expected(unexpect_t, std::initializer_list<U> il, Args&&... args)
+        : base(unexpect, il, mystl::forward<Args>(args)...) {}
+
+    constexpr expected& operator=(const expected&)
+        requires detail::expected_trivial_copy<E>
+    = default;
+
+    constexpr expected& operator=(const expected& other)
+        requires(is_copy_constructible_v<E> && is_copy_assignable_v<E> &&
+                 !detail::expected_trivial_copy<E>)
+    {
+        assign_(other);
+        return *this;
+    }
+
+    constexpr expected& operator=(expected&&)
+        requires detail::expected_trivial_move<E>
+    = default;
+
+    constexpr expected& operator=(expected&& other) noexcept(
+        is_nothrow_move_constructible_v<E> && is_nothrow_move_assignable_v<E>)
+        requires(is_move_constructible_v<E> && is_move_assignable_v<E> &&
+                 !detail::expected_trivial_move<E>)
+    {
+        assign_(mystl::move(other));
+        return *this;
+    }
+
+    template <typename G>
+        requires(is_constructible_v<E, const G&> && is_assignable_v<E&, const G&>)
+    constexpr expected& operator=(const unexpected<G>& error) {
+        assign_error_(error.error());
+        return *this;
+    }
+
+    template <typename G>
+        requires(is_constructible_v<E, G> && is_assignable_v<E&, G>)
+    constexpr expected& operator=(unexpected<G>&& error) {
+        assign_error_(mystl::move(error).error());
+        return *this;
+    }
+
+    constexpr void emplace() noexcept {
+        if (!has_value()) {
+            this->destroy_error_();
+        }
+    }
+
+    constexpr void swap(expected& other) noexcept(is_nothrow_move_constructible_v<E> &&
+                                                  is_nothrow_swappable_v<E>)
+        requires(is_swappable_v<E> && is_move_constructible_v<E>)
+    {
+        if (has_value() && other.has_value()) {
+            return;
+        }
+        if (!has_value() && !other.has_value()) {
+            mystl::swap(this->error_(), other.error_());
+        } else if (has_value()) {
+            this->construct_error_(mystl::move(other.error_()));
+            other.destroy_error_();
+        } else {
+            other.construct_error_(mystl::move(this->error_()));
+            this->destroy_error_();
+        }
+    }
+
+    friend constexpr void swap(expected& a, expected& b) noexcept(noexcept(a.swap(b)))
+        requires requires { a.swap(b); }
+    {
+        a.swap(b);
+    }
+
+    constexpr bool has_value() const noexcept { return this->has_value_(); }
+    constexpr explicit operator bool() const noexcept { return this->has_value_(); }
+
+    constexpr void operator*() const noexcept {}
+
+    constexpr void value() const& {
+        if (!has_value()) {
+            detail::throw_bad_expected_access(this->error_());
+        }
+    }
+
+    constexpr void value() && {
+        if (!has_value()) {
+            detail::throw_bad_expected_access(mystl::move(this->error_()));
+        }
+    }
+
+    constexpr E& error() & noexcept { return this->error_(); }
+    constexpr const E& error() const& noexcept { return this->error_(); }
+    constexpr E&& error() && noexcept { return mystl::move(this->error_()); }
+    constexpr const E&& error() const&& noexcept { return mystl::move(this->error_()); }
+
+    template <typename G = E>
+    constexpr E error_or(G&& fallback) const& {
+        return has_value() ? static_cast<E>(mystl::forward<G>(fallback)) : this->error_();
+    }
+
+    template <typename G = E>
+    constexpr E error_or(G&& fallback) && {
+        return has_value() ? static_cast<E>(mystl::forward<G>(fallback))
+                           : mystl::move(this->error_());
+    }
+
+    // f() on success, the error unchanged otherwise. f returns an expected with the same error
+    // type.
+    template <typename F>
+    constexpr auto and_then(F&& f) & { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) const& { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) && {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto and_then(F&& f) const&& {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // Success unchanged, f(error) otherwise. f returns an expected<void, G>.
+    template <typename F>
+    constexpr auto or_else(F&& f) & { return or_else_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto or_else(F&& f) const& { return or_else_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto or_else(F&& f) && {
+        return or_else_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto or_else(F&& f) const&& {
+        return or_else_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // expected<U, E> holding f() on success, or the error unchanged.
+    template <typename F>
+    constexpr auto transform(F&& f) & { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) const& { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) && {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform(F&& f) const&& {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // Success unchanged, or f(error) constructed in place.
+    template <typename F>
+    constexpr auto transform_error(F&& f) & {
+        return transform_error_(*this, mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) const& {
+        return transform_error_(*this, mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) && {
+        return transform_error_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform_error(F&& f) const&& {
+        return transform_error_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+private:
+    template <typename, typename>
+    friend class expected;
+
+    template <typename F, typename Arg>
+    constexpr expected(detail::expected_invoke_error_t tag, F&& f, Arg&& arg)
+        : base(tag, mystl::forward<F>(f), mystl::forward<Arg>(arg)) {}
+
+    template <typename Other>
+    constexpr void assign_(Other&& other) {
+        if (other.has_value()) {
+            emplace();
+        } else {
+            assign_error_(mystl::forward<Other>(other).error());
+        }
+    }
+
+    template <typename Error>
+    constexpr void assign_error_(Error&& error) {
+        if (has_value()) {
+            this->construct_error_(mystl::forward<Error>(error));
+        } else {
+            this->error_() = mystl::forward<Error>(error);
+        }
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto and_then_(Self&& self, F&& f) {
+        using R = remove_cvref_t<decltype(mystl::invoke(mystl::forward<F>(f)))>;
+        static_assert(detail::is_expected_v<R>, "and_then requires a function returning expected");
+        static_assert(is_same_v<typename R::error_type, E>,
+                      "and_then cannot change the error type");
+        if (self.has_value()) {
+            return mystl::invoke(mystl::forward<F>(f));
+        }
+        return R(unexpect, mystl::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto or_else_(Self&& self, F&& f) {
+        using R = remove_cvref_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                        mystl::forward<Self>(self).error()))>;
+        static_assert(detail::is_expected_v<R>, "or_else requires a function returning expected");
+        static_assert(is_void_v<typename R::value_type>, "or_else cannot change the value type");
+        if (self.has_value()) {
+            return R();
+        }
+        return mystl::invoke(mystl::forward<F>(f), mystl::forward<Self>(self).error());
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_(Self&& self, F&& f) {
+        using U = remove_cv_t<decltype(mystl::invoke(mystl::forward<F>(f)))>;
+        using R = expected<U, E>;
+        if (!self.has_value()) {
+            return R(unexpect, mystl::forward<Self>(self).error());
+        }
+        if constexpr (is_void_v<U>) {
+            mystl::invoke(mystl::forward<F>(f));
+            return R();
+        } else {
+            return R(detail::expected_invoke_t{}, mystl::forward<F>(f));
+        }
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_error_(Self&& self, F&& f) {
+        using G = remove_cv_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                     mystl::forward<Self>(self).error()))>;
+        using R = expected<T, G>;
+        if (self.has_value()) {
+            return R();
+        }
+        return R(detail::expected_invoke_error_t{}, mystl::forward<F>(f),
+                 mystl::forward<Self>(self).error());
+    }
+};
+
+template <typename T, typename E, typename T2, typename E2>
+    requires(is_void_v<T> == is_void_v<T2>)
+constexpr bool operator==(const expected<T, E>& a, const expected<T2, E2>& b) {
+    if (a.has_value() != b.has_value()) {
+        return false;
+    }
+    if (!a.has_value()) {
+        return a.error() == b.error();
+    }
+    if constexpr (is_void_v<T>) {
+        return true;
+    } else {
+        return *a == *b;
+    }
+}
+
+template <typename T, typename E, typename U>
+    requires(!is_void_v<T> && !detail::is_expected_v<U> && !detail::is_unexpected_v<U> &&
+             requires(const T& a, const U& b) {
+                 { a == b } -> convertible_to<bool>;
+             })
+constexpr bool operator==(const expected<T, E>& a, const U& b) {
+    return a.has_value() && *a == b;
+}
+
+template <typename T, typename E, typename G>
+constexpr bool operator==(const expected<T, E>& a, const unexpected<G>& b) {
+    return !a.has_value() && a.error() == b.error();
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,1170 @@
+#ifndef MYSTL_HANDMADE_FLAT_HASH_MAP_H_
+#define MYSTL_HANDMADE_FLAT_HASH_MAP_H_
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+#if !defined(MYSTL_HASH_TABLE_PORTABLE) && (defined(__SSE2__) || defined(__AVX2__))
+#include <immintrin.h>
+#endif
+
+#include "construct.h"
+#include "functional.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+// Open-addressing hash tables in the style of Abseil's Swiss tables.
+//
+// Each slot has a one-byte control word: empty, deleted (a tombstone) or, for a full slot, the
+// low 7 bits of the element's hash ("H2"). Lookups start at the group of control bytes selected
+// by the remaining hash bits ("H1") and compare H2 against a whole group at once (16 bytes with
+// SSE2, 32 with AVX2, 8 with a portable 64-bit fallback), touching element storage only for
+// candidates whose H2 matches. Probing moves between groups triangularly and stops at the first
+// group that contains an empty slot, so erasing writes a tombstone only when some probe
+// sequence may have passed over the slot while its group was full.
+//
+// The capacity is always 2^k - 1; the control array has a sentinel after the last slot and
+// mirrors its first group_width - 1 bytes after that, so a group can be loaded at any slot
+// without wrapping. Elements are stored inline in a single allocation after the control bytes
+// and move when the table grows: pointers and iterators are invalidated by every insertion that
+// rehashes.
+//
+// The default hasher is mystl::hash. Hashers that do not declare `using is_avalanching = ...`
+// with a true value have their result mixed before use, so identity hashes such as
+// std::hash<int> still spread sequential keys.
+namespace detail {
+    using hash_ctrl_t = signed char;
+
+    inline constexpr hash_ctrl_t hash_ctrl_empty = -128;
+    inline constexpr hash_ctrl_t hash_ctrl_deleted = -2;
+    inline constexpr hash_ctrl_t hash_ctrl_sentinel = -1;
+
+    // Set bits of a group match, one per slot. Shift is log2 of the bits used per slot.
+    template <typename Word, int Width, int Shift>
+    class hash_group_bitmask {
+    public:
+        explicit hash_group_bitmask(Word mask) noexcept : mask_(mask) {}
+
+        explicit operator bool() const noexcept { return mask_ != 0; }
+
+        int lowest() const noexcept { return std::countr_zero(mask_) >> Shift; }
+
+        int trailing_zeros() const noexcept { return std::countr_zero(mask_) >> Shift; }
+
+        int leading_zeros() const noexcept {
+            constexpr int unused_bits = static_cast<int>(sizeof(Word) * 8) - (Width << Shift);
+            return std::countl_zero(static_cast<Word>(mask_ << unused_bits)) >> Shift;
+        }
+
+        hash_group_bitmask& operator++() noexcept {
+            mask_ &= mask_ - 1;
+            return *this;
+        }
+
+        int operator*() const noexcept { return lowest(); }
+
+        hash_group_bitmask begin() const noexcept { return *this; }
+        hash_group_bitmask end() const noexcept { return hash_group_bitmask(0); }
+
+        friend bool operator==(const hash_group_bitmask&, const hash_group_bitmask&) = default;
+
+    private:
+        Word mask_;
+    };
+
+#if !defined(MYSTL_HASH_TABLE_PORTABLE) && defined(__AVX2__)
+    struct hash_group {
+        static constexpr size_t width = 32;
+        using bitmask = hash_group_bitmask<uint32_t, 32, 0>;
+
+        explicit hash_group(const hash_ctrl_t* p) noexcept
+            : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+        bitmask match(hash_ctrl_t h2) const noexcept {
+            return bitmask(movemask(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+        }
+
+        bitmask mask_empty() const noexcept { return match(hash_ctrl_empty); }
+
+        bitmask mask_empty_or_deleted() const noexcept {
+            return bitmask(movemask(_mm256_cmpgt_epi8(_mm256_set1_epi8(hash_ctrl_sentinel), ctrl)));
+        }
+
+        size_t count_leading_empty_or_deleted() const noexcept {
+            const uint64_t mask = movemask(
+                _mm256_cmpgt_epi8(_mm256_set1_epi8(hash_ctrl_sentinel), ctrl));
+            return static_cast<size_t>(std::countr_zero(mask + 1));
+        }
+
+        static uint32_t movemask(__m256i v) noexcept {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+        }
+
+        __m256i ctrl;
+    };
+#elif !defined(MYSTL_HASH_TABLE_PORTABLE) && defined(__SSE2__)
+    struct hash_group {
+        static constexpr size_t width = 16;
+        using bitmask = hash_group_bitmask<uint32_t, 16, 0>;
+
+        explicit hash_group(const hash_ctrl_t* p) noexcept
+            : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+        bitmask match(hash_ctrl_t h2) const noexcept {
+            return bitmask(movemask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+
+        bitmask mask_empty() const noexcept { return match(hash_ctrl_empty); }
+
+        bitmask mask_empty_or_deleted() const noexcept {
+            return bitmask(movemask(_mm_cmpgt_epi8(_mm_set1_epi8(hash_ctrl_sentinel), ctrl)));
+        }
+
+        size_t count_leading_empty_or_deleted() const noexcept {
+            const uint32_t mask = movemask(_mm_cmpgt_epi8(_mm_set1_epi8(hash_ctrl_sentinel), ctrl));
+            return static_cast<size_t>(std::countr_zero(mask + 1));
+        }
+
+        static uint32_t movemask(__m128i v) noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(v));
+        }
+
+        __m128i ctrl;
+    };
+#else
+    // Eight control bytes in a 64-bit word; a slot's bit is the top bit of its byte.
+    struct hash_group {
+        static constexpr size_t width = 8;
+        using bitmask = hash_group_bitmask<uint64_t, 8, 3>;
+
+        static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+        static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+        explicit hash_group(const hash_ctrl_t* p) noexcept {
+            std::memcpy(&ctrl, p, sizeof(ctrl));
+            if constexpr (std::endian::native == std::endian::big) {
+                ctrl = mystl::byteswap(ctrl);
+            }
+        }
+
+        // May report a false positive in the byte after a true match; callers compare keys.
+        bitmask match(hash_ctrl_t h2) const noexcept {
+            const uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+            return bitmask((x - lsbs) & ~x & msbs);
+        }
+
+        // Empty is 0b10000000: top bit set, bit 1 clear (deleted and the sentinel have both).
+        bitmask mask_empty() const noexcept { return bitmask(ctrl & ~(ctrl << 6) & msbs); }
+
+        // Empty and deleted have the top bit set and bit 0 clear; the sentinel has bit 0 set.
+        bitmask mask_empty_or_deleted() const noexcept {
+            return bitmask(ctrl & ~(ctrl << 7) & msbs);
+        }
+
+        size_t count_leading_empty_or_deleted() const noexcept {
+            const uint64_t stop = ~(ctrl & ~(ctrl << 7)) & msbs;
+            return stop == 0 ? width : static_cast<size_t>(std::countr_zero(stop) >> 3);
+        }
+
+        uint64_t ctrl;
+    };
+#endif
+
+    inline bool hash_ctrl_is_full(hash_ctrl_t c) noexcept { return c >= 0; }
+
+    // Triangular probing over groups; visits every group when the group count is a power of two.
+    class hash_probe_seq {
+    public:
+        hash_probe_seq(size_t h1, size_t mask) noexcept : mask_(mask), offset_(h1 & mask) {}
+
+        size_t offset() const noexcept { return offset_; }
+        size_t offset(size_t i) const noexcept { return (offset_ + i) & mask_; }
+
+        void next() noexcept {
+            index_ += hash_group::width;
+            offset_ = (offset_ + index_) & mask_;
+        }
+
+    private:
+        size_t mask_;
+        size_t offset_;
+        size_t index_ = 0;
+    };
+
+    template <typename Hash>
+    concept avalanching_hash = requires { requires bool(Hash::is_avalanching::value); };
+
+    template <typename Hash, typename Eq>
+    concept transparent_hash_eq = requires {
+        typename Hash::is_transparent;
+        typename Eq::is_transparent;
+    };
+
+    // key_arg<K> is K for transparent functors and key_type otherwise. It is a member alias of a
+    // non-dependent specialization so that K stays deducible in find(const key_arg<K>&).
+    template <bool Transparent>
+    struct hash_key_arg {
+        template <typename K, typename Key>
+        using type = Key;
+    };
+
+    template <>
+    struct hash_key_arg<true> {
+        template <typename K, typename Key>
+        using type = K;
+    };
+
+    // Converts to T by calling make(), which lets pair(key, hash_deferred_construct{...}) build
+    // the mapped value in place through guaranteed copy elision.
+    template <typename T, typename F>
+    struct hash_deferred_construct {
+        operator T() const { return make(); }
+
+        F make;
+    };
+
+    template <typename T>
+    struct hash_storage_unit {
+        alignas(T) unsigned char bytes[alignof(T)];
+    };
+
+    // The table shared by flat_hash_map and flat_hash_set. Policy supplies key_type, value_type
+    // and key(const value_type&) -> const key_type&, plus transfer(alloc, dst, src), which moves
+    // *src into uninitialized *dst and destroys *src.
+    template <typename Policy, typename Hash, typename Eq, typename Alloc>
+    class raw_hash_table {
+    protected:
+        using alloc_traits = allocator_traits<Alloc>;
+        using ctrl_t = hash_ctrl_t;
+
+        static constexpr bool transparent = transparent_hash_eq<Hash, Eq>;
+
+        template <typename K>
+        using key_arg = typename hash_key_arg<transparent>::template type<K, typename Policy::key_type>;
+
+    public:
+        using key_type               = typename Policy::key_type;
+        using value_type             = typename Policy::value_type;
+        using size_type              = size_t;
+        using difference_type        = std::ptrdiff_t;
+        using hasher                 = Hash;
+        using key_equal              = Eq;
+        using allocator_type         = Alloc;
+        using reference              = value_type&;
+        using const_reference        = const value_type&;
+        using pointer                = typename alloc_traits::pointer;
+        using const_pointer          = typename alloc_traits::const_pointer;
+
+        class const_iterator;
+
+        class iterator {
+            friend class raw_hash_table;
+            friend class const_iterator;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = typename Policy::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = typename Policy::iterator_reference;
+            using pointer           = remove_reference_t<reference>*;
+
+            iterator() noexcept = default;
+
+            reference operator*() const noexcept { return *slot_; }
+            pointer operator->() const noexcept { return slot_; }
+
+            iterator& operator++() noexcept {
+                ++ctrl_;
+                ++slot_;
+                skip_empty_or_deleted_();
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) noexcept {
+                return a.ctrl_ == b.ctrl_;
+            }
+
+        private:
+            iterator(ctrl_t* ctrl, value_type* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+            // The sentinel is neither empty nor deleted, so this stops at end().
+            void skip_empty_or_deleted_() noexcept {
+                while (*ctrl_ < hash_ctrl_sentinel) {
+                    const size_t shift = hash_group(ctrl_).count_leading_empty_or_deleted();
+                    ctrl_ += shift;
+                    slot_ += shift;
+                }
+            }
+
+            ctrl_t* ctrl_ = nullptr;
+            value_type* slot_ = nullptr;
+        };
+
+        class const_iterator {
+            friend class raw_hash_table;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = typename Policy::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = const value_type&;
+            using pointer           = const value_type*;
+
+            const_iterator() noexcept = default;
+            const_iterator(iterator it) noexcept : it_(it) {}
+
+            reference operator*() const noexcept { return *it_; }
+            pointer operator->() const noexcept { return it_.operator->(); }
+
+            const_iterator& operator++() noexcept {
+                ++it_;
+                return *this;
+            }
+
+            const_iterator operator++(int) noexcept {
+                const_iterator tmp = *this;
+                ++it_;
+                return tmp;
+            }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+                return a.it_ == b.it_;
+            }
+
+        private:
+            iterator it_;
+        };
+
+        raw_hash_table() noexcept(noexcept(Hash()) && noexcept(Eq()) && noexcept(Alloc())) = default;
+
+        explicit raw_hash_table(size_type bucket_count, const Hash& hash = Hash(),
+                                const Eq& eq = Eq(), const Alloc& alloc = Alloc())
+            : hash_(hash), eq_(eq), alloc_(alloc) {
+            if (bucket_count != 0) {
+                initialize_(normalize_capacity_(bucket_count));
+            }
+        }
+
+        raw_hash_table(size_type bucket_count, const Alloc& alloc)
+            : raw_hash_table(bucket_count, Hash(), Eq(), alloc) {}
+
+        explicit raw_hash_table(const Alloc& alloc) : alloc_(alloc) {}
+
+        template <typename InputIt>
+        raw_hash_table(InputIt first, InputIt last, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const Eq& eq = Eq(),
+                       const Alloc& alloc = Alloc())
+            : raw_hash_table(bucket_count, hash, eq, alloc) {
+            insert(first, last);
+        }
+
+        raw_hash_table(std::initializer_list<value_type> ilist, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const Eq& eq = Eq(),
+                       const Alloc& alloc = Alloc())
+            : raw_hash_table(ilist.begin(), ilist.end(), bucket_count, hash, eq, alloc) {}
+
+        raw_hash_table(const raw_hash_table& other)
+            : raw_hash_table(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+        raw_hash_table(const raw_hash_table& other, const Alloc& alloc)
+            : hash_(other.hash_), eq_(other.eq_), alloc_(alloc) {
+            if (other.size_ == 0) {
+                return;
+            }
+            initialize_(normalize_capacity_(growth_to_capacity_(other.size_)));
+            try {
+                for (const value_type& v : other) {
+                    const size_t hash = hash_of_(Policy::key(v));
+                    const size_t i = find_first_non_full_(hash);
+                    alloc_traits::construct(alloc_, slots_ + i, v);
+                    set_ctrl_(i, h2_(hash));
+                    ++size_;
+                    --growth_left_;
+                }
+            } catch (...) {
+                destroy_and_deallocate_();
+                throw;
+            }
+        }
+
+        raw_hash_table(raw_hash_table&& other) noexcept
+            : ctrl_(mystl::exchange(other.ctrl_, nullptr)),
+              slots_(mystl::exchange(other.slots_, nullptr)),
+              size_(mystl::exchange(other.size_, 0)),
+              capacity_(mystl::exchange(other.capacity_, 0)),
+              growth_left_(mystl::exchange(other.growth_left_, 0)),
+              hash_(mystl::move(other.hash_)),
+              eq_(mystl::move(other.eq_)),
+              alloc_(mystl::move(other.alloc_)) {}
+
+        ~raw_hash_table() { destroy_and_deallocate_(); }
+
+        raw_hash_table& operator=(const raw_hash_table& other) {
+            if (this != &other) {
+                raw_hash_table tmp(other, alloc_traits::propagate_on_container_copy_assignment::value
+                                              ? other.alloc_
+                                              : alloc_);
+                swap_storage_(tmp);
+                swap_functors_(tmp);
+                // tmp takes the old storage, so it must also take the allocator that owns it.
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    using mystl::swap;
+                    swap(alloc_, tmp.alloc_);
+                }
+            }
+            return *this;
+        }
+
+        raw_hash_table& operator=(raw_hash_table&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+            if (alloc_traits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+                destroy_and_deallocate_();
+                reset_empty_();
+                swap_storage_(other);
+                swap_functors_(other);
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                    alloc_ = mystl::move(other.alloc_);
+                }
+            } else {
+                clear();
+                hash_ = other.hash_;
+                eq_ = other.eq_;
+                reserve(other.size_);
+                for (iterator it = other.begin(); it != other.end(); ++it) {
+                    emplace_unique_(mystl::move(*it.slot_));
+                }
+                other.clear();
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const noexcept { return alloc_; }
+        hasher hash_function() const { return hash_; }
+        key_equal key_eq() const { return eq_; }
+
+        iterator begin() noexcept {
+            if (size_ == 0) {
+                return end();
+            }
+            iterator it(ctrl_, slots_);
+            it.skip_empty_or_deleted_();
+            return it;
+        }
+
+        const_iterator begin() const noexcept { return const_cast<raw_hash_table*>(this)->begin(); }
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        iterator end() noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+        const_iterator end() const noexcept { return const_cast<raw_hash_table*>(this)->end(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        size_type size() const noexcept { return size_; }
+        size_type capacity() const noexcept { return capacity_; }
+
+        size_type max_size() const noexcept {
+            return (size_type(-1) >> 8) / (sizeof(value_type) + 1);
+        }
+
+        float load_factor() const noexcept {
+            return capacity_ == 0 ? 0.0f
+                                  : static_cast<float>(size_) / static_cast<float>(capacity_);
+        }
+
+        // Fixed at 7/8.
+        float max_load_factor() const noexcept { return 0.875f; }
+        void max_load_factor(float) noexcept {}
+
+        void clear() noexcept {
+            if (capacity_ == 0) {
+                return;
+            }
+            destroy_slots_();
+            reset_ctrl_();
+            size_ = 0;
+            growth_left_ = capacity_to_growth_(capacity_);
+        }
+
+        pair<iterator, bool> insert(const value_type& value) { return emplace_key_(Policy::key(value), value); }
+
+        pair<iterator, bool> insert(value_type&& value) {
+            return emplace_key_(Policy::key(value), mystl::move(value));
+        }
+
+        iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+
+        iterator insert(const_iterator, value_type&& value) {
+            return insert(mystl::move(value)).first;
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                emplace(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+        // Looks the key up first when the policy can read it off the arguments, so an existing key
+        // constructs nothing. Otherwise builds the element first, then drops it if its key is
+        // already present.
+        template <typename... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            if constexpr (requires { Policy::key_arg(args...); }) {
+                return emplace_key_(Policy::key_arg(args...), mystl::forward<Args>(args)...);
+            } else {
+                return emplace_built_(mystl::forward<Args>(args)...);
+            }
+        }
+
+        template <typename... Args>
+        iterator emplace_hint(const_iterator, Args&&... args) {
+            return emplace(mystl::forward<Args>(args)...).first;
+        }
+
+        iterator erase(const_iterator pos) {
+            iterator it = pos.it_;
+            erase_at_(static_cast<size_t>(it.slot_ - slots_));
+            ++it;
+            return it;
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            while (first != last) {
+                first = erase(first);
+            }
+            return last.it_;
+        }
+
+        template <typename K = key_type>
+            requires(!is_convertible_v<const K&, const_iterator>)
+        size_type erase(const key_arg<K>& key) {
+            const size_t i = find_index_(key, hash_of_(key));
+            if (i == npos) {
+                return 0;
+            }
+            erase_at_(i);
+            return 1;
+        }
+
+        void swap(raw_hash_table& other) noexcept {
+            swap_storage_(other);
+            swap_functors_(other);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using mystl::swap;
+                swap(alloc_, other.alloc_);
+            }
+        }
+
+        template <typename K = key_type>
+        iterator find(const key_arg<K>& key) {
+            return iterator_or_end_(find_index_(key, hash_of_(key)));
+        }
+
+        template <typename K = key_type>
+        const_iterator find(const key_arg<K>& key) const {
+            return const_cast<raw_hash_table*>(this)->find(key);
+        }
+
+        template <typename K = key_type>
+        bool contains(const key_arg<K>& key) const {
+            return find_index_(key, hash_of_(key)) != npos;
+        }
+
+        template <typename K = key_type>
+        size_type count(const key_arg<K>& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename K = key_type>
+        pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+            iterator it = find(key);
+            if (it == end()) {
+                return {it, it};
+            }
+            iterator next = it;
+            return {it, ++next};
+        }
+
+        // Looks up every key in [first, last) and writes one iterator per key (end() when absent)
+        // to out. Hashes are computed a few keys ahead and the first probe group and slot of each
+        // prefetched, so the cache misses of consecutive lookups overlap.
+        template <typename KeyIt, typename OutIt>
+        OutIt find_many(KeyIt first, KeyIt last, OutIt out) {
+            constexpr size_t distance = 8;
+            size_t hashes[distance];
+            KeyIt lead = first;
+            size_t ahead = 0;
+            for (; ahead < distance && lead != last; ++ahead, (void)++lead) {
+                hashes[ahead] = hash_of_(*lead);
+                prefetch_(hashes[ahead]);
+            }
+            for (size_t n = 0; first != last; ++first, (void)++n, (void)++out) {
+                const size_t hash = hashes[n % distance];
+                if (lead != last) {
+                    hashes[n % distance] = hash_of_(*lead);
+                    prefetch_(hashes[n % distance]);
+                    ++lead;
+                }
+                *out = iterator_or_end_(find_index_(*first, hash));
+            }
+            return out;
+        }
+
+        void rehash(size_type count) {
+            if (count == 0 && size_ == 0) {
+                destroy_and_deallocate_();
+                reset_empty_();
+                return;
+            }
+            const size_t min_capacity = growth_to_capacity_(size_);
+            resize_(normalize_capacity_(count > min_capacity ? count : min_capacity));
+        }
+
+        void reserve(size_type count) {
+            if (count > size_ + growth_left_) {
+                resize_(normalize_capacity_(growth_to_capacity_(count)));
+            }
+        }
+
+        size_type bucket_count() const noexcept { return capacity_; }
+
+        friend bool operator==(const raw_hash_table& a, const raw_hash_table& b) {
+            if (a.size_ != b.size_) {
+                return false;
+            }
+            for (const value_type& v : a) {
+                const size_t i = b.find_index_(Policy::key(v), b.hash_of_(Policy::key(v)));
+                if (i == npos || !(b.slots_[i] == v)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    protected:
+        static constexpr size_t npos = size_t(-1);
+
+        template <typename K>
+        size_t hash_of_(const K& key) const {
+            if constexpr (avalanching_hash<Hash>) {
+                return static_cast<size_t>(hash_(key));
+            } else {
+                return static_cast<size_t>(hash_mix(static_cast<uint64_t>(hash_(key))));
+            }
+        }
+
+        static size_t h1_(size_t hash) noexcept { return hash >> 7; }
+        static ctrl_t h2_(size_t hash) noexcept { return static_cast<ctrl_t>(hash & 0x7F); }
+
+        iterator iterator_at_(size_t i) noexcept { return iterator(ctrl_ + i, slots_ + i); }
+
+        iterator iterator_or_end_(size_t i) noexcept { return i == npos ? end() : iterator_at_(i); }
+
+        template <typename K>
+        size_t find_index_(const K& key, size_t hash) const {
+            if (capacity_ == 0) {
+                return npos;
+            }
+            hash_probe_seq seq(h1_(hash), capacity_);
+            while (true) {
+                hash_group g(ctrl_ + seq.offset());
+                for (int i : g.match(h2_(hash))) {
+                    const size_t idx = seq.offset(static_cast<size_t>(i));
+                    if (eq_(Policy::key(slots_[idx]), key)) [[likely]] {
+                        return idx;
+                    }
+                }
+                if (g.mask_empty()) [[likely]] {
+                    return npos;
+                }
+                seq.next();
+            }
+        }
+
+        // Returns the index of key's slot and whether it still has to be constructed; in that case
+        // the control byte is already set and size_ counts it.
+        template <typename K>
+        pair<size_t, bool> find_or_prepare_insert_(const K& key) {
+            const size_t hash = hash_of_(key);
+            const size_t i = find_index_(key, hash);
+            if (i != npos) {
+                return {i, false};
+            }
+            return {prepare_insert_(hash), true};
+        }
+
+        size_t prepare_insert_(size_t hash) {
+            size_t target = capacity_ == 0 ? npos : find_first_non_full_(hash);
+            if (growth_left_ == 0 && (target == npos || ctrl_[target] != hash_ctrl_deleted)) {
+                grow_();
+                target = find_first_non_full_(hash);
+            }
+            ++size_;
+            growth_left_ -= ctrl_[target] == hash_ctrl_empty ? 1 : 0;
+            set_ctrl_(target, h2_(hash));
+            return target;
+        }
+
+        // Returns key's slot, or inserts the element args builds when key is absent. key and args
+        // may refer into the table: growing would move them, so in that case the element is built
+        // before the table grows.
+        template <typename K, typename... Args>
+        pair<iterator, bool> emplace_key_(const K& key, Args&&... args) {
+            const size_t hash = hash_of_(key);
+            const size_t i = find_index_(key, hash);
+            if (i != npos) {
+                return {iterator_at_(i), false};
+            }
+            if (growth_left_ == 0) {
+                return emplace_built_(mystl::forward<Args>(args)...);
+            }
+            const size_t target = prepare_insert_(hash);
+            construct_prepared_(target, mystl::forward<Args>(args)...);
+            return {iterator_at_(target), true};
+        }
+
+        // Builds the element first, then drops it if its key is already present.
+        template <typename... Args>
+        pair<iterator, bool> emplace_built_(Args&&... args) {
+            alignas(value_type) unsigned char buffer[sizeof(value_type)];
+            value_type* tmp = reinterpret_cast<value_type*>(buffer);
+            alloc_traits::construct(alloc_, tmp, mystl::forward<Args>(args)...);
+            pair<size_t, bool> found;
+            try {
+                found = find_or_prepare_insert_(Policy::key(*tmp));
+                if (found.second) {
+                    construct_prepared_(found.first, mystl::move(*tmp));
+                }
+            } catch (...) {
+                alloc_traits::destroy(alloc_, tmp);
+                throw;
+            }
+            alloc_traits::destroy(alloc_, tmp);
+            return {iterator_at_(found.first), found.second};
+        }
+
+        // Constructs into a slot returned by prepare_insert_, releasing the slot if that throws.
+        template <typename... Args>
+        void construct_prepared_(size_t i, Args&&... args) {
+            try {
+                alloc_traits::construct(alloc_, slots_ + i, mystl::forward<Args>(args)...);
+            } catch (...) {
+                --size_;
+                ++growth_left_;
+                set_ctrl_(i, hash_ctrl_empty);
+                throw;
+            }
+        }
+
+        void emplace_unique_(value_type&& value) {
+            const size_t i = prepare_insert_(hash_of_(Policy::key(value)));
+            construct_prepared_(i, mystl::move(value));
+        }
+
+    private:
+        size_t find_first_non_full_(size_t hash) const noexcept {
+            hash_probe_seq seq(h1_(hash), capacity_);
+            while (true) {
+                const auto mask = hash_group(ctrl_ + seq.offset()).mask_empty_or_deleted();
+                if (mask) {
+                    return seq.offset(static_cast<size_t>(mask.lowest()));
+                }
+                seq.next();
+            }
+        }
+
+        void prefetch_(size_t hash) const noexcept {
+            if (capacity_ != 0) {
+                const size_t i = h1_(hash) & capacity_;
+                __builtin_prefetch(ctrl_ + i);
+                __builtin_prefetch(slots_ + i);
+            }
+        }
+
+        // Writes the control byte for slot i and its mirror past the sentinel.
+        void set_ctrl_(size_t i, ctrl_t h) noexcept {
+            constexpr size_t cloned = hash_group::width - 1;
+            ctrl_[i] = h;
+            ctrl_[((i - cloned) & capacity_) + (cloned & capacity_)] = h;
+        }
+
+        // A tombstone is needed only if the slot sits inside a run of group_width slots with no
+        // empty one; otherwise no probe sequence can have continued past it.
+        void erase_at_(size_t i) noexcept {
+            alloc_traits::destroy(alloc_, slots_ + i);
+            --size_;
+            const size_t before = (i - hash_group::width) & capacity_;
+            const auto empty_after = hash_group(ctrl_ + i).mask_empty();
+            const auto empty_before = hash_group(ctrl_ + before).mask_empty();
+            const bool was_never_full =
+                empty_before && empty_after &&
+                static_cast<size_t>(empty_after.trailing_zeros() + empty_before.leading_zeros()) <
+                    hash_group::width;
+            set_ctrl_(i, was_never_full ? hash_ctrl_empty : hash_ctrl_deleted);
+            growth_left_ += was_never_full ? 1 : 0;
+        }
+
+        // 7/8 of the capacity, always leaving one empty slot so that probing terminates.
+        static size_t capacity_to_growth_(size_t capacity) noexcept {
+            return capacity < 8 ? capacity - 1 : capacity - capacity / 8;
+        }
+
+        static size_t growth_to_capacity_(size_t growth) noexcept {
+            return growth + (growth == 0 ? 0 : (growth - 1) / 7);
+        }
+
+        // Smallest 2^k - 1 that is at least n and at least one full group.
+        static size_t normalize_capacity_(size_t n) noexcept {
+            constexpr size_t min_capacity = hash_group::width - 1;
+            if (n <= min_capacity) {
+                return min_capacity;
+            }
+            return (size_t(-1) >> std::countl_zero(n));
+        }
+
+        // Doubles when the table is mostly live elements and rehashes at the same size when
+        // tombstones are what exhausted growth_left_.
+        void grow_() {
+            if (capacity_ == 0) {
+                resize_(normalize_capacity_(0));
+            } else if (size_ <= capacity_to_growth_(capacity_) / 2) {
+                resize_(capacity_);
+            } else {
+                resize_(capacity_ * 2 + 1);
+            }
+        }
+
+        using storage_unit = hash_storage_unit<value_type>;
+        using unit_alloc = typename alloc_traits::template rebind_alloc<storage_unit>;
+        using unit_traits = allocator_traits<unit_alloc>;
+
+        static size_t slot_offset_(size_t capacity) noexcept {
+            const size_t ctrl_bytes = capacity + hash_group::width;
+            return (ctrl_bytes + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+
+        static size_t alloc_units_(size_t capacity) noexcept {
+            const size_t bytes = slot_offset_(capacity) + capacity * sizeof(value_type);
+            return (bytes + sizeof(storage_unit) - 1) / sizeof(storage_unit);
+        }
+
+        void initialize_(size_t capacity) {
+            unit_alloc a(alloc_);
+            storage_unit* mem = unit_traits::allocate(a, alloc_units_(capacity));
+            ctrl_ = reinterpret_cast<ctrl_t*>(mem);
+            slots_ = reinterpret_cast<value_type*>(reinterpret_cast<unsigned char*>(mem) +
+                                                   slot_offset_(capacity));
+            capacity_ = capacity;
+            size_ = 0;
+            growth_left_ = capacity_to_growth_(capacity);
+            reset_ctrl_();
+        }
+
+        void reset_ctrl_() noexcept {
+            std::memset(ctrl_, static_cast<unsigned char>(hash_ctrl_empty),
+                        capacity_ + hash_group::width);
+            ctrl_[capacity_] = hash_ctrl_sentinel;
+        }
+
+        void resize_(size_t new_capacity) {
+            ctrl_t* old_ctrl = ctrl_;
+            value_type* old_slots = slots_;
+            const size_t old_capacity = capacity_;
+            const size_t old_size = size_;
+            initialize_(new_capacity);
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (hash_ctrl_is_full(old_ctrl[i])) {
+                    const size_t hash = hash_of_(Policy::key(old_slots[i]));
+                    const size_t target = find_first_non_full_(hash);
+                    set_ctrl_(target, h2_(hash));
+                    Policy::transfer(alloc_, slots_ + target, old_slots + i);
+                }
+            }
+            size_ = old_size;
+            growth_left_ -= old_size;
+            if (old_capacity != 0) {
+                unit_alloc a(alloc_);
+                unit_traits::deallocate(a, reinterpret_cast<storage_unit*>(old_ctrl),
+                                        alloc_units_(old_capacity));
+            }
+        }
+
+        void destroy_slots_() noexcept {
+            if constexpr (!is_trivially_destructible_v<value_type> ||
+                          requires(Alloc& a, value_type* p) { a.destroy(p); }) {
+                for (size_t i = 0; i < capacity_; ++i) {
+                    if (hash_ctrl_is_full(ctrl_[i])) {
+                        alloc_traits::destroy(alloc_, slots_ + i);
+                    }
+                }
+            }
+        }
+
+        void destroy_and_deallocate_() noexcept {
+            if (capacity_ == 0) {
+                return;
+            }
+            destroy_slots_();
+            unit_alloc a(alloc_);
+            unit_traits::deallocate(a, reinterpret_cast<storage_unit*>(ctrl_), alloc_units_(capacity_));
+        }
+
+        void reset_empty_() noexcept {
+            ctrl_ = nullptr;
+            slots_ = nullptr;
+            size_ = capacity_ = growth_left_ = 0;
+        }
+
+        void swap_storage_(raw_hash_table& other) noexcept {
+            using mystl::swap;
+            swap(ctrl_, other.ctrl_);
+            swap(slots_, other.slots_);
+            swap(size_, other.size_);
+            swap(capacity_, other.capacity_);
+            swap(growth_left_, other.growth_left_);
+        }
+
+        void swap_functors_(raw_hash_table& other) noexcept {
+            using mystl::swap;
+            swap(hash_, other.hash_);
+            swap(eq_, other.eq_);
+        }
+
+        ctrl_t* ctrl_ = nullptr;
+        value_type* slots_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+        size_t growth_left_ = 0;
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] Eq eq_;
+        [[no_unique_address]] Alloc alloc_;
+    };
+
+    template <typename Key, typename T>
+    struct flat_hash_map_policy {
+        using key_type = Key;
+        using value_type = pair<const Key, T>;
+        using iterator_reference = value_type&;
+
+        static const Key& key(const value_type& v) noexcept { return v.first; }
+
+        // The key of the element emplace(args...) would build, for a key and a mapped value or a
+        // pair whose first member is a key.
+        template <typename K, typename M>
+            requires is_same_v<remove_cvref_t<K>, Key>
+        static const Key& key_arg(const K& key, const M&) noexcept {
+            return key;
+        }
+
+        template <typename P>
+            requires is_same_v<remove_cvref_t<typename remove_cvref_t<P>::first_type>, Key>
+        static const Key& key_arg(const P& p) noexcept {
+            return p.first;
+        }
+
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            using traits = allocator_traits<Alloc>;
+            if constexpr (is_trivially_relocatable_v<value_type> &&
+                          !requires(Alloc& a) { a.construct(dst, mystl::move(*src)); } &&
+                          !requires(Alloc& a) { a.destroy(src); }) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+            } else {
+                // The key is about to be destroyed, so moving out of it is unobservable.
+                traits::construct(alloc, dst, mystl::move(const_cast<Key&>(src->first)),
+                                  mystl::move(src->second));
+                traits::destroy(alloc, src);
+            }
+        }
+    };
+
+    template <typename Key>
+    struct flat_hash_set_policy {
+        using key_type = Key;
+        using value_type = Key;
+        using iterator_reference = const Key&;
+
+        static const Key& key(const value_type& v) noexcept { return v; }
+
+        template <typename K>
+            requires is_same_v<remove_cvref_t<K>, Key>
+        static const Key& key_arg(const K& key) noexcept {
+            return key;
+        }
+
+        template <typename Alloc>
+        static void transfer(Alloc& alloc, value_type* dst, value_type* src) {
+            using traits = allocator_traits<Alloc>;
+            if constexpr (is_trivially_relocatable_v<value_type> &&
+                          !requires(Alloc& a) { a.construct(dst, mystl::move(*src)); } &&
+                          !requires(Alloc& a) { a.destroy(src); }) {
+                std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+            } else {
+                traits::construct(alloc, dst, mystl::move(*src));
+                traits::destroy(alloc, src);
+            }
+        }
+    };
+}  // namespace detail
+
+template <typename Key, typename T, typename Hash = hash<Key>,
+          typename Eq = std::equal_to<Key>, typename Alloc = allocator<pair<const Key, T>>>
+class flat_hash_map
+    : public detail::raw_hash_table<detail::flat_hash_map_policy<Key, T>, Hash, Eq, Alloc> {
+    using base = detail::raw_hash_table<detail::flat_hash_map_policy<Key, T>, Hash, Eq, Alloc>;
+
+    template <typename K>
+    using key_arg = typename base::template key_arg<K>;
+
+public:
+    using mapped_type = T;
+    using typename base::iterator;
+    using typename base::const_iterator;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::size_type;
+
+    using base::base;
+    using base::insert;
+
+    flat_hash_map() = default;
+
+    template <typename P>
+        requires is_constructible_v<value_type, P&&>
+    pair<iterator, bool> insert(P&& value) {
+        return this->emplace(mystl::forward<P>(value));
+    }
+
+    template <typename M>
+    pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        return insert_or_assign_(key, mystl::forward<M>(obj));
+    }
+
+    template <typename M>
+    pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+        return insert_or_assign_(mystl::move(key), mystl::forward<M>(obj));
+    }
+
+    // Unlike emplace, constructs nothing when the key is already present.
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return try_emplace_(key, mystl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return try_emplace_(mystl::move(key), mystl::forward<Args>(args)...);
+    }
+
+    template <typename K = key_type>
+    T& at(const key_arg<K>& key) {
+        iterator it = this->find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("mystl::flat_hash_map::at");
+        }
+        return it->second;
+    }
+
+    template <typename K = key_type>
+    const T& at(const key_arg<K>& key) const {
+        return const_cast<flat_hash_map*>(this)->at(key);
+    }
+
+    T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+    T& operator[](key_type&& key) { return try_emplace(mystl::move(key)).first->second; }
+
+private:
+    // key and args may refer into the map; emplace_key_ builds the element before any growth.
+    template <typename K, typename... Args>
+    pair<iterator, bool> try_emplace_(K&& key, Args&&... args) {
+        if constexpr (sizeof...(Args) == 1 && (is_same_v<remove_cvref_t<Args>, T> && ...)) {
+            return this->emplace_key_(key, mystl::forward<K>(key), mystl::forward<Args>(args)...);
+        } else {
+            auto make = [&args...] { return T(mystl::forward<Args>(args)...); };
+            return this->emplace_key_(key, mystl::forward<K>(key),
+                                      detail::hash_deferred_construct<T, decltype(make)>{make});
+        }
+    }
+
+    template <typename K, typename M>
+    pair<iterator, bool> insert_or_assign_(K&& key, M&& obj) {
+        auto result = this->emplace_key_(key, mystl::forward<K>(key), mystl::forward<M>(obj));
+        if (!result.second) {
+            result.first->second = mystl::forward<M>(obj);
+        }
+        return result;
+    }
+};
+
+template <typename Key, typename Hash = hash<Key>, typename Eq = std::equal_to<Key>,
+          typename Alloc = allocator<Key>>
+class flat_hash_set
+    : public detail::raw_hash_table<detail::flat_hash_set_policy<Key>, Hash, Eq, Alloc> {
+    using base = detail::raw_hash_table<detail::flat_hash_set_policy<Key>, Hash, Eq, Alloc>;
+
+public:
+    using base::base;
+
+    flat_hash_set() = default;
+};
+
+template <typename Key, typename T, typename Hash, typename Eq, typename Alloc>
+void swap(flat_hash_map<Key, T, Hash, Eq, Alloc>& lhs,
+          flat_hash_map<Key, T, Hash, Eq, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename Hash, typename Eq, typename Alloc>
+void swap(flat_hash_set<Key, Hash, Eq, Alloc>& lhs, flat_hash_set<Key, Hash, Eq, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename T, typename Hash, typename Eq, typename Alloc, typename Pred>
+size_t erase_if(flat_hash_map<Key, T, Hash, Eq, Alloc>& m, Pred pred) {
+    const size_t old_size = m.size();
+    for (auto it = m.begin(); it != m.end();) {
+        if (pred(*it)) {
+            it = m.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return old_size - m.size();
+}
+
+template <typename Key, typename Hash, typename Eq, typename Alloc, typename Pred>
+size_t erase_if(flat_hash_set<Key, Hash, Eq, Alloc>& s, Pred pred) {
+    const size_t old_size = s.size();
+    for (auto it = s.begin(); it != s.end();) {
+        if (pred(*it)) {
+            it = s.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return old_size - s.size();
+}
+
+}  // namespace mystl
+
+#endif
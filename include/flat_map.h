@@ -0,0 +1,673 @@
+#ifndef MYSTL_HANDMADE_FLAT_MAP_H_
+#define MYSTL_HANDMADE_FLAT_MAP_H_
+
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+
+#include "algorithm.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace detail {
+    template <typename Compare>
+    concept transparent_compare = requires { typename Compare::is_transparent; };
+
+    // Merges the sorted prefix [0, old_size) of keys with the entries appended after it, visited
+    // in the order given by `order`, into fresh containers. When keys compare equal the entry
+    // already in the prefix wins, then the earlier one in `order`. `take(index)` moves one entry
+    // out; `last_key()` is the key most recently taken.
+    template <typename Keys, typename Compare, typename Take, typename LastKey>
+    void flat_merge_appended(const Keys& keys, size_t old_size, const vector<size_t>& order,
+                             Compare& comp, Take take, LastKey last_key) {
+        bool any = false;
+        auto take_unique = [&](size_t idx) {
+            if (any && !comp(last_key(), keys[idx])) {
+                return;
+            }
+            take(idx);
+            any = true;
+        };
+        size_t i = 0;
+        size_t j = 0;
+        while (i < old_size && j < order.size()) {
+            if (comp(keys[order[j]], keys[i])) {
+                take_unique(order[j++]);
+            } else {
+                take_unique(i++);
+            }
+        }
+        while (i < old_size) {
+            take_unique(i++);
+        }
+        while (j < order.size()) {
+            take_unique(order[j++]);
+        }
+    }
+
+    // Indices [old_size, size) ordered by key, stably, so the first of equal keys stays first.
+    template <typename Keys, typename Compare>
+    vector<size_t> flat_sorted_order(const Keys& keys, size_t old_size, Compare& comp,
+                                     bool already_sorted) {
+        vector<size_t> order(keys.size() - old_size);
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = old_size + i;
+        }
+        if (!already_sorted) {
+            mystl::stable_sort(order.begin(), order.end(),
+                               [&](size_t a, size_t b) { return comp(keys[a], keys[b]); });
+        }
+        return order;
+    }
+}  // namespace detail
+
+// A sorted associative container over two parallel sequence containers, one of keys and one of
+// mapped values. Lookups binary-search the dense key array only; iteration yields
+// pair<const Key&, T&> proxies. Inserting a range appends it, sorts the new entries and merges
+// them into the existing ones in a single pass, so building a map from n entries costs
+// O(n log n) rather than n shifting inserts. Insertion and erasure invalidate all iterators.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename KeyContainer = vector<Key>, typename MappedContainer = vector<T>>
+class flat_map {
+    template <bool Const>
+    class iterator_impl;
+
+public:
+    using key_type               = Key;
+    using mapped_type            = T;
+    using value_type             = pair<Key, T>;
+    using key_compare            = Compare;
+    using reference              = pair<const Key&, T&>;
+    using const_reference        = pair<const Key&, const T&>;
+    using size_type              = size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = iterator_impl<false>;
+    using const_iterator         = iterator_impl<true>;
+    using key_container_type     = KeyContainer;
+    using mapped_container_type  = MappedContainer;
+
+    struct containers {
+        KeyContainer keys;
+        MappedContainer values;
+    };
+
+    class value_compare {
+    public:
+        bool operator()(const_reference a, const_reference b) const { return comp_(a.first, b.first); }
+
+    private:
+        friend class flat_map;
+        explicit value_compare(const Compare& comp) : comp_(comp) {}
+
+        Compare comp_;
+    };
+
+    flat_map() = default;
+
+    explicit flat_map(const Compare& comp) : comp_(comp) {}
+
+    flat_map(KeyContainer keys, MappedContainer values, const Compare& comp = Compare())
+        : c_{mystl::move(keys), mystl::move(values)}, comp_(comp) {
+        check_sizes_();
+        merge_appended_(0, false);
+    }
+
+    flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values,
+             const Compare& comp = Compare())
+        : c_{mystl::move(keys), mystl::move(values)}, comp_(comp) {
+        check_sizes_();
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    flat_map(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp) {
+        insert(first, last);
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    flat_map(sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare())
+        : comp_(comp) {
+        insert(sorted_unique, first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> ilist, const Compare& comp = Compare())
+        : flat_map(ilist.begin(), ilist.end(), comp) {}
+
+    flat_map(sorted_unique_t, std::initializer_list<value_type> ilist,
+             const Compare& comp = Compare())
+        : flat_map(sorted_unique, ilist.begin(), ilist.end(), comp) {}
+
+    flat_map& operator=(std::initializer_list<value_type> ilist) {
+        clear();
+        insert(ilist);
+        return *this;
+    }
+
+    iterator begin() noexcept { return iterator(c_.keys.begin(), c_.values.begin()); }
+    const_iterator begin() const noexcept { return const_iterator(c_.keys.begin(), c_.values.begin()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator(c_.keys.end(), c_.values.end()); }
+    const_iterator end() const noexcept { return const_iterator(c_.keys.end(), c_.values.end()); }
+    const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return c_.keys.empty(); }
+    size_type size() const noexcept { return c_.keys.size(); }
+
+    size_type max_size() const noexcept {
+        const size_type k = c_.keys.max_size();
+        const size_type v = c_.values.max_size();
+        return k < v ? k : v;
+    }
+
+    void reserve(size_type n) {
+        c_.keys.reserve(n);
+        c_.values.reserve(n);
+    }
+
+    T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+    T& operator[](key_type&& key) { return try_emplace(mystl::move(key)).first->second; }
+
+    T& at(const key_type& key) { return at_(key); }
+    const T& at(const key_type& key) const { return const_cast<flat_map*>(this)->at_(key); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    T& at(const K& key) {
+        return at_(key);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const T& at(const K& key) const {
+        return const_cast<flat_map*>(this)->at_(key);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        value_type v(mystl::forward<Args>(args)...);
+        return try_emplace(mystl::move(v.first), mystl::move(v.second));
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(mystl::forward<Args>(args)...).first;
+    }
+
+    pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+    pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(mystl::move(value.first), mystl::move(value.second));
+    }
+
+    iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+
+    iterator insert(const_iterator, value_type&& value) { return insert(mystl::move(value)).first; }
+
+    // Appends the range, sorts the new entries and merges once. Existing keys keep their values;
+    // among new duplicates the first wins.
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    void insert(InputIt first, InputIt last) {
+        const size_type old_size = size();
+        append_(first, last);
+        merge_appended_(old_size, false);
+    }
+
+    // As above, for a range already sorted and free of duplicates: no sort, just the merge.
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        const size_type old_size = size();
+        append_(first, last);
+        merge_appended_(old_size, true);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    void insert(sorted_unique_t, std::initializer_list<value_type> ilist) {
+        insert(sorted_unique, ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        return try_emplace_(key, mystl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+        return try_emplace_(mystl::move(key), mystl::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        return insert_or_assign_(key, mystl::forward<M>(obj));
+    }
+
+    template <typename M>
+    pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+        return insert_or_assign_(mystl::move(key), mystl::forward<M>(obj));
+    }
+
+    // Moves the underlying containers out, leaving the map empty.
+    containers extract() && {
+        containers out{mystl::move(c_.keys), mystl::move(c_.values)};
+        clear();
+        return out;
+    }
+
+    // Adopts containers that are already sorted and free of duplicates, without copying.
+    void replace(KeyContainer&& keys, MappedContainer&& values) {
+        c_.keys = mystl::move(keys);
+        c_.values = mystl::move(values);
+        check_sizes_();
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    iterator erase(const_iterator pos) {
+        const difference_type i = pos.k_ - c_.keys.cbegin();
+        c_.keys.erase(c_.keys.begin() + i);
+        c_.values.erase(c_.values.begin() + i);
+        return iterator(c_.keys.begin() + i, c_.values.begin() + i);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const difference_type i = first.k_ - c_.keys.cbegin();
+        const difference_type j = last.k_ - c_.keys.cbegin();
+        c_.keys.erase(c_.keys.begin() + i, c_.keys.begin() + j);
+        c_.values.erase(c_.values.begin() + i, c_.values.begin() + j);
+        return iterator(c_.keys.begin() + i, c_.values.begin() + i);
+    }
+
+    size_type erase(const key_type& key) { return erase_key_(key); }
+
+    template <typename K>
+        requires(detail::transparent_compare<Compare> && !is_convertible_v<K, iterator> &&
+                 !is_convertible_v<K, const_iterator>)
+    size_type erase(K&& key) {
+        return erase_key_(key);
+    }
+
+    void swap(flat_map& other) noexcept {
+        using mystl::swap;
+        swap(c_.keys, other.c_.keys);
+        swap(c_.values, other.c_.values);
+        swap(comp_, other.comp_);
+    }
+
+    void clear() noexcept {
+        c_.keys.clear();
+        c_.values.clear();
+    }
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return value_compare(comp_); }
+
+    const KeyContainer& keys() const noexcept { return c_.keys; }
+    const MappedContainer& values() const noexcept { return c_.values; }
+
+    iterator find(const key_type& key) { return find_(key); }
+    const_iterator find(const key_type& key) const { return const_cast<flat_map*>(this)->find_(key); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator find(const K& key) {
+        return find_(key);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator find(const K& key) const {
+        return const_cast<flat_map*>(this)->find_(key);
+    }
+
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    bool contains(const key_type& key) const { return find(key) != end(); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    iterator lower_bound(const key_type& key) { return at_index_(lower_index_(key)); }
+    const_iterator lower_bound(const key_type& key) const {
+        return const_cast<flat_map*>(this)->lower_bound(key);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator lower_bound(const K& key) {
+        return at_index_(lower_index_(key));
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator lower_bound(const K& key) const {
+        return const_cast<flat_map*>(this)->lower_bound(key);
+    }
+
+    iterator upper_bound(const key_type& key) { return at_index_(upper_index_(key)); }
+    const_iterator upper_bound(const key_type& key) const {
+        return const_cast<flat_map*>(this)->upper_bound(key);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    iterator upper_bound(const K& key) {
+        return at_index_(upper_index_(key));
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator upper_bound(const K& key) const {
+        return const_cast<flat_map*>(this)->upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    friend bool operator==(const flat_map& a, const flat_map& b) {
+        return a.size() == b.size() &&
+               mystl::equal(a.c_.keys.begin(), a.c_.keys.end(), b.c_.keys.begin()) &&
+               mystl::equal(a.c_.values.begin(), a.c_.values.end(), b.c_.values.begin());
+    }
+
+    friend auto operator<=>(const flat_map& a, const flat_map& b)
+        -> std::common_comparison_category_t<decltype(mystl::declval<const Key&>() <=>
+                                                      mystl::declval<const Key&>()),
+                                             decltype(mystl::declval<const T&>() <=>
+                                                      mystl::declval<const T&>())> {
+        const size_type n = a.size() < b.size() ? a.size() : b.size();
+        for (size_type i = 0; i < n; ++i) {
+            if (auto cmp = a.c_.keys[i] <=> b.c_.keys[i]; cmp != 0) {
+                return cmp;
+            }
+            if (auto cmp = a.c_.values[i] <=> b.c_.values[i]; cmp != 0) {
+                return cmp;
+            }
+        }
+        return a.size() <=> b.size();
+    }
+
+private:
+    template <bool Const>
+    class iterator_impl {
+        friend class flat_map;
+        friend class iterator_impl<!Const>;
+
+        using key_iter = typename KeyContainer::const_iterator;
+        using value_iter = conditional_t<Const, typename MappedContainer::const_iterator,
+                                         typename MappedContainer::iterator>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = pair<Key, T>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = pair<const Key&, conditional_t<Const, const T&, T&>>;
+
+        // operator-> returns the proxy by value; it forwards to a reference pair it owns.
+        struct pointer {
+            reference ref;
+            reference* operator->() noexcept { return &ref; }
+        };
+
+        iterator_impl() = default;
+
+        iterator_impl(const iterator_impl<!Const>& other)
+            requires Const
+            : k_(other.k_), v_(other.v_) {}
+
+        reference operator*() const { return reference(*k_, *v_); }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        iterator_impl& operator++() {
+            ++k_;
+            ++v_;
+            return *this;
+        }
+
+        iterator_impl operator++(int) {
+            iterator_impl tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator_impl& operator--() {
+            --k_;
+            --v_;
+            return *this;
+        }
+
+        iterator_impl operator--(int) {
+            iterator_impl tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        iterator_impl& operator+=(difference_type n) {
+            k_ += n;
+            v_ += n;
+            return *this;
+        }
+
+        iterator_impl& operator-=(difference_type n) { return *this += -n; }
+
+        friend iterator_impl operator+(iterator_impl it, difference_type n) { return it += n; }
+        friend iterator_impl operator+(difference_type n, iterator_impl it) { return it += n; }
+        friend iterator_impl operator-(iterator_impl it, difference_type n) { return it -= n; }
+
+        friend difference_type operator-(const iterator_impl& a, const iterator_impl& b) {
+            return a.k_ - b.k_;
+        }
+
+        friend bool operator==(const iterator_impl& a, const iterator_impl& b) { return a.k_ == b.k_; }
+
+        friend auto operator<=>(const iterator_impl& a, const iterator_impl& b) {
+            return (a.k_ - b.k_) <=> 0;
+        }
+
+    private:
+        iterator_impl(key_iter k, value_iter v) : k_(k), v_(v) {}
+
+        key_iter k_{};
+        value_iter v_{};
+    };
+
+    void check_sizes_() const {
+        if (c_.keys.size() != c_.values.size()) {
+            throw std::invalid_argument("mystl::flat_map: key and value counts differ");
+        }
+    }
+
+    iterator at_index_(size_type i) { return iterator(c_.keys.begin() + i, c_.values.begin() + i); }
+
+    template <typename K>
+    size_type lower_index_(const K& key) const {
+        return static_cast<size_type>(
+            mystl::lower_bound(c_.keys.begin(), c_.keys.end(), key, comp_) - c_.keys.begin());
+    }
+
+    template <typename K>
+    size_type upper_index_(const K& key) const {
+        return static_cast<size_type>(
+            mystl::upper_bound(c_.keys.begin(), c_.keys.end(), key, comp_) - c_.keys.begin());
+    }
+
+    template <typename K>
+    bool found_at_(size_type i, const K& key) const {
+        return i != size() && !comp_(key, c_.keys[i]);
+    }
+
+    template <typename K>
+    iterator find_(const K& key) {
+        const size_type i = lower_index_(key);
+        return found_at_(i, key) ? at_index_(i) : end();
+    }
+
+    template <typename K>
+    T& at_(const K& key) {
+        iterator it = find_(key);
+        if (it == end()) {
+            throw std::out_of_range("mystl::flat_map::at");
+        }
+        return it->second;
+    }
+
+    template <typename K>
+    size_type erase_key_(const K& key) {
+        const size_type i = lower_index_(key);
+        if (!found_at_(i, key)) {
+            return 0;
+        }
+        erase(const_iterator(at_index_(i)));
+        return 1;
+    }
+
+    // Inserts the value, then the key, at index i; if the second insert throws the first is
+    // undone so the containers stay the same length.
+    template <typename K, typename... Args>
+    void insert_at_(size_type i, K&& key, Args&&... args) {
+        c_.values.emplace(c_.values.begin() + i, mystl::forward<Args>(args)...);
+        try {
+            c_.keys.emplace(c_.keys.begin() + i, mystl::forward<K>(key));
+        } catch (...) {
+            c_.values.erase(c_.values.begin() + i);
+            throw;
+        }
+    }
+
+    template <typename K, typename... Args>
+    pair<iterator, bool> try_emplace_(K&& key, Args&&... args) {
+        const size_type i = lower_index_(key);
+        if (found_at_(i, key)) {
+            return {at_index_(i), false};
+        }
+        insert_at_(i, mystl::forward<K>(key), mystl::forward<Args>(args)...);
+        return {at_index_(i), true};
+    }
+
+    template <typename K, typename M>
+    pair<iterator, bool> insert_or_assign_(K&& key, M&& obj) {
+        const size_type i = lower_index_(key);
+        if (found_at_(i, key)) {
+            c_.values[i] = mystl::forward<M>(obj);
+            return {at_index_(i), false};
+        }
+        insert_at_(i, mystl::forward<K>(key), mystl::forward<M>(obj));
+        return {at_index_(i), true};
+    }
+
+    template <typename InputIt>
+    void append_(InputIt first, InputIt last) {
+        const size_type old_size = size();
+        try {
+            for (; first != last; ++first) {
+                const auto& v = *first;
+                c_.keys.emplace_back(v.first);
+                c_.values.emplace_back(v.second);
+            }
+        } catch (...) {
+            c_.keys.erase(c_.keys.begin() + old_size, c_.keys.end());
+            c_.values.erase(c_.values.begin() + old_size, c_.values.end());
+            throw;
+        }
+    }
+
+    // Sorts the entries from old_size on (unless already sorted) and merges them with the
+    // sorted prefix, dropping duplicate keys. If that throws the map is left empty.
+    void merge_appended_(size_type old_size, bool already_sorted) {
+        if (size() == old_size) {
+            return;
+        }
+        try {
+            const vector<size_t> order =
+                detail::flat_sorted_order(c_.keys, old_size, comp_, already_sorted);
+            containers merged;
+            merged.keys.reserve(size());
+            merged.values.reserve(size());
+            detail::flat_merge_appended(
+                c_.keys, old_size, order, comp_,
+                [&](size_t idx) {
+                    merged.keys.push_back(mystl::move(c_.keys[idx]));
+                    merged.values.push_back(mystl::move(c_.values[idx]));
+                },
+                [&]() -> const Key& { return merged.keys.back(); });
+            c_.keys = mystl::move(merged.keys);
+            c_.values = mystl::move(merged.values);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    containers c_;
+    [[no_unique_address]] Compare comp_;
+};
+
+template <typename Key, typename T, typename Compare, typename KeyContainer,
+          typename MappedContainer>
+void swap(flat_map<Key, T, Compare, KeyContainer, MappedContainer>& lhs,
+          flat_map<Key, T, Compare, KeyContainer, MappedContainer>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename T, typename Compare, typename KeyContainer,
+          typename MappedContainer, typename Pred>
+size_t erase_if(flat_map<Key, T, Compare, KeyContainer, MappedContainer>& m, Pred pred) {
+    auto c = mystl::move(m).extract();
+    size_t write = 0;
+    size_t read = 0;
+    bool moving = false;
+    try {
+        for (; read < c.keys.size(); ++read) {
+            if (!pred(pair<const Key&, T&>(c.keys[read], c.values[read]))) {
+                if (write != read) {
+                    moving = true;
+                    c.keys[write] = mystl::move(c.keys[read]);
+                    c.values[write] = mystl::move(c.values[read]);
+                    moving = false;
+                }
+                ++write;
+            }
+        }
+    } catch (...) {
+        // [write, read) holds removed or moved-from elements, and so does read itself if a move
+        // threw. Dropping them leaves sorted, unique keys, so the map gets them back.
+        const size_t stop = moving ? read + 1 : read;
+        c.keys.erase(c.keys.begin() + write, c.keys.begin() + stop);
+        c.values.erase(c.values.begin() + write, c.values.begin() + stop);
+        m.replace(mystl::move(c.keys), mystl::move(c.values));
+        throw;
+    }
+    const size_t removed = c.keys.size() - write;
+    c.keys.erase(c.keys.begin() + write, c.keys.end());
+    c.values.erase(c.values.begin() + write, c.values.end());
+    m.replace(mystl::move(c.keys), mystl::move(c.values));
+    return removed;
+}
+
+}  // namespace mystl
+
+#endif
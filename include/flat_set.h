@@ -0,0 +1,330 @@
+#ifndef MYSTL_HANDMADE_FLAT_SET_H_
+#define MYSTL_HANDMADE_FLAT_SET_H_
+
+#include <compare>
+#include <functional>
+#include <initializer_list>
+
+#include "algorithm.h"
+#include "flat_map.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+// A sorted set stored in one contiguous container. Lookups are branchless binary searches;
+// inserting a range appends it, sorts the new keys and merges them in a single pass.
+// Insertion and erasure invalidate all iterators.
+template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = vector<Key>>
+class flat_set {
+public:
+    using key_type               = Key;
+    using value_type             = Key;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using reference              = Key&;
+    using const_reference        = const Key&;
+    using size_type              = size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = typename KeyContainer::const_iterator;
+    using const_iterator         = typename KeyContainer::const_iterator;
+    using container_type         = KeyContainer;
+
+    flat_set() = default;
+
+    explicit flat_set(const Compare& comp) : comp_(comp) {}
+
+    explicit flat_set(KeyContainer keys, const Compare& comp = Compare())
+        : keys_(mystl::move(keys)), comp_(comp) {
+        merge_appended_(0, false);
+    }
+
+    flat_set(sorted_unique_t, KeyContainer keys, const Compare& comp = Compare())
+        : keys_(mystl::move(keys)), comp_(comp) {}
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp) {
+        insert(first, last);
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    flat_set(sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare())
+        : comp_(comp) {
+        insert(sorted_unique, first, last);
+    }
+
+    flat_set(std::initializer_list<Key> ilist, const Compare& comp = Compare())
+        : flat_set(ilist.begin(), ilist.end(), comp) {}
+
+    flat_set(sorted_unique_t, std::initializer_list<Key> ilist, const Compare& comp = Compare())
+        : flat_set(sorted_unique, ilist.begin(), ilist.end(), comp) {}
+
+    flat_set& operator=(std::initializer_list<Key> ilist) {
+        clear();
+        insert(ilist);
+        return *this;
+    }
+
+    const_iterator begin() const noexcept { return keys_.begin(); }
+    const_iterator cbegin() const noexcept { return keys_.begin(); }
+
+    const_iterator end() const noexcept { return keys_.end(); }
+    const_iterator cend() const noexcept { return keys_.end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+
+    void reserve(size_type n) { keys_.reserve(n); }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return insert_unique_(Key(mystl::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) {
+        return emplace(mystl::forward<Args>(args)...).first;
+    }
+
+    pair<iterator, bool> insert(const Key& key) { return insert_unique_(key); }
+
+    pair<iterator, bool> insert(Key&& key) { return insert_unique_(mystl::move(key)); }
+
+    template <typename K>
+        requires(detail::transparent_compare<Compare> && is_constructible_v<Key, K>)
+    pair<iterator, bool> insert(K&& key) {
+        return insert_unique_(mystl::forward<K>(key));
+    }
+
+    iterator insert(const_iterator, const Key& key) { return insert(key).first; }
+
+    iterator insert(const_iterator, Key&& key) { return insert(mystl::move(key)).first; }
+
+    // Appends the range, sorts the new keys and merges once; among duplicates the key already
+    // present wins, then the first new one.
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    void insert(InputIt first, InputIt last) {
+        const size_type old_size = size();
+        append_(first, last);
+        merge_appended_(old_size, false);
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        const size_type old_size = size();
+        append_(first, last);
+        merge_appended_(old_size, true);
+    }
+
+    void insert(std::initializer_list<Key> ilist) { insert(ilist.begin(), ilist.end()); }
+
+    void insert(sorted_unique_t, std::initializer_list<Key> ilist) {
+        insert(sorted_unique, ilist.begin(), ilist.end());
+    }
+
+    // Moves the underlying container out, leaving the set empty.
+    KeyContainer extract() && {
+        KeyContainer out = mystl::move(keys_);
+        keys_.clear();
+        return out;
+    }
+
+    // Adopts a container that is already sorted and free of duplicates, without copying.
+    void replace(KeyContainer&& keys) { keys_ = mystl::move(keys); }
+
+    iterator erase(const_iterator pos) { return keys_.erase(pos); }
+
+    iterator erase(const_iterator first, const_iterator last) { return keys_.erase(first, last); }
+
+    size_type erase(const Key& key) { return erase_key_(key); }
+
+    template <typename K>
+        requires(detail::transparent_compare<Compare> && !is_convertible_v<K, const_iterator>)
+    size_type erase(K&& key) {
+        return erase_key_(key);
+    }
+
+    void swap(flat_set& other) noexcept {
+        using mystl::swap;
+        swap(keys_, other.keys_);
+        swap(comp_, other.comp_);
+    }
+
+    void clear() noexcept { keys_.clear(); }
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+
+    const_iterator find(const Key& key) const { return find_(key); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator find(const K& key) const {
+        return find_(key);
+    }
+
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    const_iterator lower_bound(const Key& key) const {
+        return mystl::lower_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator lower_bound(const K& key) const {
+        return mystl::lower_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+
+    const_iterator upper_bound(const Key& key) const {
+        return mystl::upper_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+
+    template <typename K>
+        requires detail::transparent_compare<Compare>
+    const_iterator upper_bound(const K& key) const {
+        return mystl::upper_bound(keys_.begin(), keys_.end(), key, comp_);
+    }
+
+    pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    friend bool operator==(const flat_set& a, const flat_set& b) {
+        return a.size() == b.size() && mystl::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend auto operator<=>(const flat_set& a, const flat_set& b)
+        -> decltype(mystl::declval<const Key&>() <=> mystl::declval<const Key&>()) {
+        const size_type n = a.size() < b.size() ? a.size() : b.size();
+        for (size_type i = 0; i < n; ++i) {
+            if (auto cmp = a.keys_[i] <=> b.keys_[i]; cmp != 0) {
+                return cmp;
+            }
+        }
+        return a.size() <=> b.size();
+    }
+
+private:
+    template <typename K>
+    const_iterator find_(const K& key) const {
+        const_iterator it = lower_bound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    template <typename K>
+    size_type erase_key_(const K& key) {
+        const_iterator it = find_(key);
+        if (it == end()) {
+            return 0;
+        }
+        keys_.erase(it);
+        return 1;
+    }
+
+    template <typename K>
+    pair<iterator, bool> insert_unique_(K&& key) {
+        const_iterator it = lower_bound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.emplace(it, mystl::forward<K>(key)), true};
+    }
+
+    template <typename InputIt>
+    void append_(InputIt first, InputIt last) {
+        const size_type old_size = size();
+        try {
+            for (; first != last; ++first) {
+                keys_.emplace_back(*first);
+            }
+        } catch (...) {
+            keys_.erase(keys_.begin() + old_size, keys_.end());
+            throw;
+        }
+    }
+
+    // Sorts the keys from old_size on (unless already sorted) and merges them with the sorted
+    // prefix, dropping duplicates. If that throws the set is left empty.
+    void merge_appended_(size_type old_size, bool already_sorted) {
+        if (size() == old_size) {
+            return;
+        }
+        try {
+            const vector<size_t> order =
+                detail::flat_sorted_order(keys_, old_size, comp_, already_sorted);
+            KeyContainer merged;
+            merged.reserve(size());
+            detail::flat_merge_appended(
+                keys_, old_size, order, comp_,
+                [&](size_t idx) { merged.push_back(mystl::move(keys_[idx])); },
+                [&]() -> const Key& { return merged.back(); });
+            keys_ = mystl::move(merged);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    KeyContainer keys_;
+    [[no_unique_address]] Compare comp_;
+};
+
+template <typename Key, typename Compare, typename KeyContainer>
+void swap(flat_set<Key, Compare, KeyContainer>& lhs,
+          flat_set<Key, Compare, KeyContainer>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename Compare, typename KeyContainer, typename Pred>
+size_t erase_if(flat_set<Key, Compare, KeyContainer>& s, Pred pred) {
+    KeyContainer keys = mystl::move(s).extract();
+    size_t write = 0;
+    size_t read = 0;
+    bool moving = false;
+    try {
+        for (; read < keys.size(); ++read) {
+            if (!pred(static_cast<const Key&>(keys[read]))) {
+                if (write != read) {
+                    moving = true;
+                    keys[write] = mystl::move(keys[read]);
+                    moving = false;
+                }
+                ++write;
+            }
+        }
+    } catch (...) {
+        // [write, read) holds removed or moved-from keys, and so does read itself if the move
+        // threw. Dropping them leaves sorted, unique keys, so the set gets them back.
+        keys.erase(keys.begin() + write, keys.begin() + (moving ? read + 1 : read));
+        s.replace(mystl::move(keys));
+        throw;
+    }
+    const size_t removed = keys.size() - write;
+    keys.erase(keys.begin() + write, keys.end());
+    s.replace(mystl::move(keys));
+    return removed;
+}
+
+}  // namespace mystl
+
+#endif
@@ -1,14 +1,41 @@
 #ifndef MYSTL_HANDMADE_FUNCTIONAL_H_
 #define MYSTL_HANDMADE_FUNCTIONAL_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+
 #include "type_traits.h"
 
 namespace mystl {
 
 namespace detail {
 
+// Whether invoke_impl below is noexcept for a member pointer of type M C::*.
+template <typename C, typename M, typename Obj, typename... Args>
+consteval bool invoke_member_nothrow() {
+    using P = M C::*;
+    if constexpr (is_base_of_v<C, decay_t<Obj>>) {
+        if constexpr (is_member_object_pointer_v<P>) {
+            return true;
+        } else {
+            return noexcept((mystl::declval<Obj>().*mystl::declval<P>())(mystl::declval<Args>()...));
+        }
+    } else if constexpr (is_member_object_pointer_v<P>) {
+        return noexcept(*mystl::declval<Obj>());
+    } else {
+        return noexcept(((*mystl::declval<Obj>()).*mystl::declval<P>())(mystl::declval<Args>()...));
+    }
+}
+
 template <typename C, typename F, typename Obj, typename... Args>
-constexpr decltype(auto) invoke_impl(F C::* f, Obj&& obj, Args&&... args)
+constexpr decltype(auto) invoke_impl(F C::* f, Obj&& obj, Args&&... args) noexcept(
+    invoke_member_nothrow<C, F, Obj, Args...>())
     requires is_member_function_pointer_v<F C::*>
 {
     if constexpr (is_base_of_v<C, decay_t<Obj>>) {
@@ -19,7 +46,8 @@ constexpr decltype(auto) invoke_impl(F C::* f, Obj&& obj, Args&&... args)
 }
 
 template <typename C, typename M, typename Obj>
-constexpr decltype(auto) invoke_impl(M C::* m, Obj&& obj)
+constexpr decltype(auto) invoke_impl(M C::* m, Obj&& obj) noexcept(
+    invoke_member_nothrow<C, M, Obj>())
     requires is_member_object_pointer_v<M C::*>
 {
     if constexpr (is_base_of_v<C, decay_t<Obj>>) {
@@ -30,7 +58,8 @@ constexpr decltype(auto) invoke_impl(M C::* m, Obj&& obj)
 }
 
 template <typename F, typename... Args>
-constexpr decltype(auto) invoke_impl(F&& f, Args&&... args)
+constexpr decltype(auto) invoke_impl(F&& f, Args&&... args) noexcept(
+    noexcept(mystl::declval<F>()(mystl::declval<Args>()...)))
     requires(!is_member_pointer_v<decay_t<F>>)
 {
     return mystl::forward<F>(f)(mystl::forward<Args>(args)...);
@@ -39,10 +68,713 @@ constexpr decltype(auto) invoke_impl(F&& f, Args&&... args)
 }  // namespace detail
 
 template <typename F, typename... Args>
-constexpr decltype(auto) invoke(F&& f, Args&&... args) {
+constexpr decltype(auto) invoke(F&& f, Args&&... args) noexcept(
+    noexcept(detail::invoke_impl(mystl::declval<F>(), mystl::declval<Args>()...))) {
     return detail::invoke_impl(mystl::forward<F>(f), mystl::forward<Args>(args)...);
 }
 
+template <typename T1, typename T2>
+struct pair;
+
+namespace detail {
+
+// 64x64 -> 128-bit multiply, returning the halves folded together. Used by the byte hash and as
+// the avalanche mixer for integers: every input bit affects every output bit.
+inline uint64_t hash_mum_fold(uint64_t a, uint64_t b) noexcept {
+    const __uint128_t m = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64);
+}
+
+inline constexpr uint64_t hash_secret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                            0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+inline constexpr uint64_t hash_default_seed = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t hash_mix(uint64_t v) noexcept {
+    return hash_mum_fold(v ^ hash_secret[0], hash_default_seed);
+}
+
+inline uint64_t hash_read8(const unsigned char* p) noexcept {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t hash_read4(const unsigned char* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1 to 3 bytes: the first, middle and last byte cover every length without a branch.
+inline uint64_t hash_read_small(const unsigned char* p, size_t len) noexcept {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) |
+           p[len - 1];
+}
+
+// wyhash (final version 4): 48 bytes per iteration over three independent multiply lanes,
+// with overlapping loads for the tail so short keys take no loops.
+inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= hash_mum_fold(seed ^ hash_secret[0], hash_secret[1]);
+    uint64_t a;
+    uint64_t b;
+    if (len <= 16) [[likely]] {
+        if (len >= 4) [[likely]] {
+            const size_t mid = (len >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + mid);
+            b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = hash_read_small(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do {
+                seed = hash_mum_fold(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+                see1 = hash_mum_fold(hash_read8(p + 16) ^ hash_secret[2], hash_read8(p + 24) ^ see1);
+                see2 = hash_mum_fold(hash_read8(p + 32) ^ hash_secret[3], hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = hash_mum_fold(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    const __uint128_t m = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(m);
+    b = static_cast<uint64_t>(m >> 64);
+    return hash_mum_fold(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+}  // namespace detail
+
+// Accumulates the hash of a value's parts. Types become hashable by providing an overload
+//
+//     friend void hash_append(mystl::hash_state& h, const T& v) { hash_append(h, v.a, v.b); }
+//
+// found by argument-dependent lookup, listing the same members operator== compares. Types that
+// are uniquely represented (see is_uniquely_represented) are hashed as raw bytes without one.
+class hash_state {
+public:
+    explicit hash_state(uint64_t seed = detail::hash_default_seed) noexcept : state_(seed) {}
+
+    // Mixes in one word.
+    void mix(uint64_t v) noexcept { state_ = detail::hash_mum_fold(state_ + v, detail::hash_default_seed); }
+
+    // Mixes in a byte string; lengths up to 16 take a branch-light path with no loop.
+    void append_bytes(const void* data, size_t len) noexcept {
+        state_ = detail::hash_bytes(data, len, state_);
+    }
+
+    uint64_t finish() const noexcept { return state_; }
+
+private:
+    uint64_t state_;
+};
+
+namespace detail {
+template <typename T>
+concept hash_range = requires(const T& r) {
+    r.begin();
+    r.end();
+    r.size();
+};
+
+}  // namespace detail
+
+template <typename T>
+    requires is_uniquely_represented_v<T>
+void hash_append(hash_state& h, const T& v) noexcept {
+    if constexpr (sizeof(T) <= sizeof(uint64_t) && !is_array_v<T>) {
+        uint64_t word = 0;
+        std::memcpy(&word, &v, sizeof(T));
+        h.mix(word);
+    } else {
+        h.append_bytes(&v, sizeof(T));
+    }
+}
+
+// +0.0 and -0.0 compare equal and so hash equal.
+template <typename T>
+    requires is_floating_point_v<T>
+void hash_append(hash_state& h, T v) noexcept {
+    if (v == T(0)) {
+        v = T(0);
+    }
+    if constexpr (sizeof(T) <= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, &v, sizeof(T));
+        h.mix(word);
+    } else {
+        // Only the value bytes: long double has padding on x86.
+        h.append_bytes(&v, 10 < sizeof(T) ? 10 : sizeof(T));
+    }
+}
+
+inline void hash_append(hash_state& h, std::nullptr_t) noexcept { h.mix(0); }
+
+template <typename CharT, typename Traits>
+void hash_append(hash_state& h, std::basic_string_view<CharT, Traits> s) noexcept {
+    h.append_bytes(s.data(), s.size() * sizeof(CharT));
+    h.mix(s.size());
+}
+
+template <typename CharT, typename Traits, typename Alloc>
+void hash_append(hash_state& h, const std::basic_string<CharT, Traits, Alloc>& s) noexcept {
+    hash_append(h, std::basic_string_view<CharT, Traits>(s));
+}
+
+template <typename T1, typename T2>
+    requires(!is_uniquely_represented_v<pair<T1, T2>>)
+void hash_append(hash_state& h, const pair<T1, T2>& p) {
+    hash_append(h, p.first);
+    hash_append(h, p.second);
+}
+
+// Containers: the elements in order, then the size so that ({1}, {}) and ({}, {1}) differ when
+// nested. Contiguous ranges of uniquely represented elements are hashed as one byte string.
+template <typename R>
+    requires(detail::hash_range<R> && !is_uniquely_represented_v<R>)
+void hash_append(hash_state& h, const R& r) {
+    if constexpr (requires { r.data(); typename R::value_type; } &&
+                  is_uniquely_represented_v<typename R::value_type>) {
+        h.append_bytes(r.data(), r.size() * sizeof(typename R::value_type));
+    } else {
+        for (const auto& elem : r) {
+            hash_append(h, elem);
+        }
+    }
+    h.mix(static_cast<uint64_t>(r.size()));
+}
+
+template <typename T, typename U, typename... Rest>
+void hash_append(hash_state& h, const T& first, const U& second, const Rest&... rest) {
+    hash_append(h, first);
+    hash_append(h, second);
+    (hash_append(h, rest), ...);
+}
+
+namespace detail {
+template <typename T>
+concept has_hash_append = requires(hash_state& h, const T& v) { hash_append(h, v); };
+
+template <typename T>
+concept has_std_hash = requires(const T& v) { std::hash<T>{}(v); };
+
+template <typename T>
+struct hash_transparency {};
+
+template <typename CharT, typename Traits>
+struct hash_transparency<std::basic_string_view<CharT, Traits>> {
+    using is_transparent = void;
+};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct hash_transparency<std::basic_string<CharT, Traits, Alloc>> {
+    using is_transparent = void;
+};
+}  // namespace detail
+
+// Hash function object with full avalanche, unlike std::hash for integers (the identity).
+// Defined for every type with a hash_append overload; types that only have a std::hash
+// specialization get its result mixed. String hashes are transparent: std::string,
+// std::string_view and const char* with the same characters hash equal.
+template <typename T>
+struct hash : detail::hash_transparency<T> {
+    using is_avalanching = true_type;
+
+    size_t operator()(const T& v) const
+        requires detail::has_hash_append<T>
+    {
+        if constexpr (is_integral_v<T> || is_enum_v<T> || is_pointer_v<T>) {
+            return static_cast<size_t>(detail::hash_mix(static_cast<uint64_t>(to_word_(v))));
+        } else {
+            hash_state h;
+            hash_append(h, v);
+            return static_cast<size_t>(h.finish());
+        }
+    }
+
+    size_t operator()(const T& v) const
+        requires(!detail::has_hash_append<T> && detail::has_std_hash<T>)
+    {
+        return static_cast<size_t>(detail::hash_mix(std::hash<T>{}(v)));
+    }
+
+    template <typename S>
+        requires(requires { typename detail::hash_transparency<T>::is_transparent; } &&
+                 !is_same_v<remove_cvref_t<S>, T> &&
+                 is_convertible_v<const S&, std::basic_string_view<typename T::value_type,
+                                                                   typename T::traits_type>>)
+    size_t operator()(const S& s) const noexcept {
+        hash_state h;
+        hash_append(h, std::basic_string_view<typename T::value_type, typename T::traits_type>(s));
+        return static_cast<size_t>(h.finish());
+    }
+
+private:
+    template <typename U>
+    static uint64_t to_word_(U v) noexcept {
+        if constexpr (is_pointer_v<U>) {
+            return reinterpret_cast<uintptr_t>(v);
+        } else {
+            return static_cast<uint64_t>(v);
+        }
+    }
+};
+
+// Mixes the hash of v into seed, as boost::hash_combine does but with full avalanche.
+template <typename T>
+void hash_combine(size_t& seed, const T& v) {
+    seed = static_cast<size_t>(detail::hash_mum_fold(seed + hash<T>{}(v), detail::hash_default_seed));
+}
+
+namespace detail {
+
+// Inline storage of function and move_only_function: enough for a lambda capturing three
+// pointers, which std::function implementations move to the heap.
+inline constexpr size_t function_default_buffer = 3 * sizeof(void*);
+
+template <size_t N>
+struct function_storage {
+    alignas(void*) unsigned char buf[N < sizeof(void*) ? sizeof(void*) : N];
+};
+
+// Callables that would need a throwing move to relocate go to the heap so that moving the wrapper
+// stays noexcept, unless they are trivially relocatable: those move as bytes.
+template <typename F, size_t N>
+inline constexpr bool function_stores_inline =
+    sizeof(F) <= sizeof(function_storage<N>) && alignof(F) <= alignof(void*) &&
+    (is_nothrow_move_constructible_v<F> || is_trivially_relocatable_v<F>);
+
+// One table per stored type. A call is a single indirect jump through `call`; the null entries
+// mean "copy the bytes" (relocate, copy) or "nothing to do" (destroy), so wrappers holding
+// trivial callables or heap pointers move and die without any indirect call.
+template <bool Noexcept, typename R, typename... Args>
+struct function_vtable {
+    R (*call)(void* obj, Args&&... args) noexcept(Noexcept);
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* obj) noexcept;
+    void (*copy)(const void* from, void* to);
+};
+
+template <typename F, bool Inline>
+F* function_target(void* obj) noexcept {
+    if constexpr (Inline) {
+        return std::launder(static_cast<F*>(obj));
+    } else {
+        return *std::launder(static_cast<F**>(obj));
+    }
+}
+
+template <typename F, bool Inline, bool Const, bool Noexcept, typename R, typename... Args>
+R function_call(void* obj, Args&&... args) noexcept(Noexcept) {
+    using target = conditional_t<Const, const F, F>;
+    if constexpr (is_void_v<R>) {
+        mystl::invoke(static_cast<target&>(*function_target<F, Inline>(obj)),
+                      mystl::forward<Args>(args)...);
+    } else {
+        return mystl::invoke(static_cast<target&>(*function_target<F, Inline>(obj)),
+                             mystl::forward<Args>(args)...);
+    }
+}
+
+template <bool Noexcept, typename R, typename... Args>
+[[noreturn]] R function_call_empty(void*, Args&&...) noexcept(Noexcept) {
+    if constexpr (Noexcept) {
+        std::terminate();
+    } else {
+        throw std::bad_function_call();
+    }
+}
+
+template <typename F, bool Inline, bool Copyable, bool Const, bool Noexcept, typename R,
+          typename... Args>
+inline constexpr function_vtable<Noexcept, R, Args...> function_vtable_for = {
+    &function_call<F, Inline, Const, Noexcept, R, Args...>,
+    !Inline || is_trivially_relocatable_v<F>
+        ? nullptr
+        : +[](void* from, void* to) noexcept {
+              F* src = function_target<F, true>(from);
+              ::new (to) F(mystl::move(*src));
+              src->~F();
+          },
+    Inline && is_trivially_destructible_v<F>
+        ? nullptr
+        : +[](void* obj) noexcept {
+              if constexpr (Inline) {
+                  function_target<F, true>(obj)->~F();
+              } else {
+                  delete function_target<F, false>(obj);
+              }
+          },
+    !Copyable || (Inline && is_trivially_copyable_v<F>)
+        ? nullptr
+        : +[](const void* from, void* to) {
+              if constexpr (Copyable) {
+                  const F& src = *function_target<F, Inline>(const_cast<void*>(from));
+                  if constexpr (Inline) {
+                      ::new (to) F(src);
+                  } else {
+                      ::new (to) F*(new F(src));
+                  }
+              }
+          },
+};
+
+template <bool Noexcept, typename R, typename... Args>
+inline constexpr function_vtable<Noexcept, R, Args...> function_empty_vtable = {
+    &function_call_empty<Noexcept, R, Args...>, nullptr, nullptr, nullptr};
+
+template <typename F, bool Noexcept, typename R, typename... Args>
+concept function_callable =
+    requires(F f, Args&&... args) {
+        mystl::invoke(static_cast<F>(f), mystl::forward<Args>(args)...);
+    } &&
+    (is_void_v<R> ||
+     is_convertible_v<decltype(mystl::invoke(mystl::declval<F>(), mystl::declval<Args>()...)), R>) &&
+    (!Noexcept || noexcept(mystl::invoke(mystl::declval<F>(), mystl::declval<Args>()...)));
+
+template <bool Copyable, bool Const, bool Noexcept, size_t N, typename R, typename... Args>
+class function_impl;
+
+template <typename T>
+inline constexpr bool is_function_impl_v = false;
+
+template <bool Copyable, bool Const, bool Noexcept, size_t N, typename R, typename... Args>
+inline constexpr bool is_function_impl_v<function_impl<Copyable, Const, Noexcept, N, R, Args...>> =
+    true;
+
+// The common implementation of function and move_only_function. The callable lives in the
+// inline buffer when function_stores_inline allows it and in one heap allocation otherwise;
+// either way the wrapper is a vtable pointer plus N bytes and moves without allocating.
+template <bool Copyable, bool Const, bool Noexcept, size_t N, typename R, typename... Args>
+class function_impl {
+    using vtable = function_vtable<Noexcept, R, Args...>;
+
+    // function's operator() is const and calls the target as an lvalue, like std::function.
+    static constexpr bool const_call = Const || Copyable;
+
+    template <typename F>
+    using target_ref = conditional_t<Const, const decay_t<F>&, decay_t<F>&>;
+
+public:
+    using result_type = R;
+
+    function_impl() noexcept : vt_(&function_empty_vtable<Noexcept, R, Args...>) {}
+
+    function_impl(nullptr_t) noexcept : function_impl() {}
+
+    template <typename F>
+        requires(!is_same_v<remove_cvref_t<F>, function_impl> &&
+                 function_callable<target_ref<F>, Noexcept, R, Args...> &&
+                 is_constructible_v<decay_t<F>, F> &&
+                 (!Copyable || is_copy_constructible_v<decay_t<F>>))
+    function_impl(F&& f) : function_impl() {
+        using D = decay_t<F>;
+        if constexpr (is_same_v<remove_cvref_t<F>, D> &&
+                      (is_pointer_v<D> || is_member_pointer_v<D> || is_function_impl_v<D>)) {
+            if (!f) {
+                return;
+            }
+        }
+        if constexpr (function_stores_inline<D, N>) {
+            ::new (static_cast<void*>(storage_.buf)) D(mystl::forward<F>(f));
+        } else {
+            ::new (static_cast<void*>(storage_.buf)) D*(new D(mystl::forward<F>(f)));
+        }
+        vt_ = &function_vtable_for<D, function_stores_inline<D, N>, Copyable, Const, Noexcept, R,
+                                   Args...>;
+    }
+
+    function_impl(const function_impl& other)
+        requires Copyable
+        : vt_(other.vt_) {
+        if (vt_->copy) {
+            vt_->copy(other.storage_.buf, storage_.buf);
+        } else {
+            storage_ = other.storage_;
+        }
+    }
+
+    function_impl(function_impl&& other) noexcept : vt_(other.vt_) { take_(other); }
+
+    ~function_impl() { reset_(); }
+
+    function_impl& operator=(const function_impl& other)
+        requires Copyable
+    {
+        if (this != &other) {
+            function_impl(other).swap(*this);
+        }
+        return *this;
+    }
+
+    function_impl& operator=(function_impl&& other) noexcept {
+        if (this != &other) {
+            reset_();
+            vt_ = other.vt_;
+            take_(other);
+        }
+        return *this;
+    }
+
+    function_impl& operator=(nullptr_t) noexcept {
+        reset_();
+        vt_ = &function_empty_vtable<Noexcept, R, Args...>;
+        return *this;
+    }
+
+    template <typename F>
+        requires(!is_same_v<remove_cvref_t<F>, function_impl> && is_constructible_v<function_impl, F>)
+    function_impl& operator=(F&& f) {
+        function_impl(mystl::forward<F>(f)).swap(*this);
+        return *this;
+    }
+
+    void swap(function_impl& other) noexcept {
+        function_impl tmp(mystl::move(other));
+        other.vt_ = vt_;
+        other.take_(*this);
+        vt_ = tmp.vt_;
+        take_(tmp);
+    }
+
+    friend void swap(function_impl& a, function_impl& b) noexcept { a.swap(b); }
+
+    explicit operator bool() const noexcept {
+        return vt_ != &function_empty_vtable<Noexcept, R, Args...>;
+    }
+
+    friend bool operator==(const function_impl& f, nullptr_t) noexcept { return !f; }
+
+    // Calling an empty wrapper throws std::bad_function_call, or terminates if Sig is noexcept.
+    R operator()(Args... args) const noexcept(Noexcept)
+        requires const_call
+    {
+        return vt_->call(const_cast<unsigned char*>(storage_.buf), mystl::forward<Args>(args)...);
+    }
+
+    R operator()(Args... args) noexcept(Noexcept)
+        requires(!const_call)
+    {
+        return vt_->call(storage_.buf, mystl::forward<Args>(args)...);
+    }
+
+private:
+    // Moves other's callable, described by vt_, into this and leaves other empty.
+    void take_(function_impl& other) noexcept {
+        if (vt_->relocate) {
+            vt_->relocate(other.storage_.buf, storage_.buf);
+        } else {
+            storage_ = other.storage_;
+        }
+        other.vt_ = &function_empty_vtable<Noexcept, R, Args...>;
+    }
+
+    void reset_() noexcept {
+        if (vt_->destroy) {
+            vt_->destroy(storage_.buf);
+        }
+    }
+
+    const vtable* vt_;
+    function_storage<N> storage_;
+};
+
+template <typename Sig, size_t N>
+struct function_select;
+
+template <typename R, typename... Args, bool Noexcept, size_t N>
+struct function_select<R(Args...) noexcept(Noexcept), N> {
+    template <bool Copyable>
+    using type = function_impl<Copyable, false, Noexcept, N, R, Args...>;
+};
+
+template <typename R, typename... Args, bool Noexcept, size_t N>
+struct function_select<R(Args...) const noexcept(Noexcept), N> {
+    template <bool Copyable>
+    using type = function_impl<Copyable, true, Noexcept, N, R, Args...>;
+};
+
+}  // namespace detail
+
+// Copyable type-erased callable, like std::function, with Sig one of R(Args...),
+// R(Args...) const, and their noexcept forms. Callables up to BufferSize bytes that can be moved
+// without throwing, or that are trivially relocatable, are stored inline.
+template <typename Sig, size_t BufferSize = detail::function_default_buffer>
+using function = typename detail::function_select<Sig, BufferSize>::template type<true>;
+
+// Move-only counterpart of function, which also accepts move-only callables.
+template <typename Sig, size_t BufferSize = detail::function_default_buffer>
+using move_only_function = typename detail::function_select<Sig, BufferSize>::template type<false>;
+
+// Tag carrying a callable known at compile time, such as &S::f, so that function_ref can call it
+// without storing it.
+template <auto V>
+struct nontype_t {
+    explicit nontype_t() = default;
+};
+
+template <auto V>
+inline constexpr nontype_t<V> nontype{};
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool is_nontype_v = false;
+
+template <auto V>
+inline constexpr bool is_nontype_v<nontype_t<V>> = true;
+
+union function_ref_target {
+    void* obj;
+    const void* cobj;
+    void (*fn)();
+};
+
+template <typename R, typename F, typename... Args>
+R function_ref_invoke(F&& f, Args&&... args) {
+    if constexpr (is_void_v<R>) {
+        mystl::invoke(mystl::forward<F>(f), mystl::forward<Args>(args)...);
+    } else {
+        return mystl::invoke(mystl::forward<F>(f), mystl::forward<Args>(args)...);
+    }
+}
+
+// A target address plus a thunk that knows its type: two words, trivially copyable, and
+// a call is one indirect call. Binding never allocates and never copies the callable.
+template <bool Const, bool Noexcept, typename R, typename... Args>
+class function_ref_impl {
+    template <typename T>
+    using cv = conditional_t<Const, const T, T>;
+
+    template <typename F>
+    static constexpr bool is_function_pointer_ =
+        is_pointer_v<remove_cvref_t<F>> && is_function_v<remove_pointer_t<remove_cvref_t<F>>>;
+
+public:
+    template <typename F>
+        requires(is_function_v<F> && function_callable<F*, Noexcept, R, Args...>)
+    function_ref_impl(F* f) noexcept {
+        target_.fn = reinterpret_cast<void (*)()>(f);
+        thunk_ = [](function_ref_target t, Args&&... args) noexcept(Noexcept) -> R {
+            return function_ref_invoke<R>(reinterpret_cast<F*>(t.fn), mystl::forward<Args>(args)...);
+        };
+    }
+
+    // Calls V, typically a member pointer: nontype<&S::f> binds nothing, so nothing can dangle.
+    template <auto V>
+        requires function_callable<const decltype(V)&, Noexcept, R, Args...>
+    function_ref_impl(nontype_t<V>) noexcept {
+        target_.obj = nullptr;
+        thunk_ = [](function_ref_target, Args&&... args) noexcept(Noexcept) -> R {
+            return function_ref_invoke<R>(V, mystl::forward<Args>(args)...);
+        };
+    }
+
+    // Calls V with obj as its first argument, as in function_ref(nontype<&S::f>, s). obj must
+    // outlive every call.
+    template <auto V, typename U, typename T = remove_reference_t<U>>
+        requires(!is_rvalue_reference_v<U&&> &&
+                 function_callable<const decltype(V)&, Noexcept, R, cv<T>&, Args...>)
+    function_ref_impl(nontype_t<V>, U&& obj) noexcept {
+        if constexpr (Const || is_const_v<T>) {
+            target_.cobj = static_cast<const void*>(&obj);
+        } else {
+            target_.obj = static_cast<void*>(&obj);
+        }
+        thunk_ = [](function_ref_target t, Args&&... args) noexcept(Noexcept) -> R {
+            cv<T>* target;
+            if constexpr (Const || is_const_v<T>) {
+                target = static_cast<cv<T>*>(t.cobj);
+            } else {
+                target = static_cast<T*>(t.obj);
+            }
+            return function_ref_invoke<R>(V, *target, mystl::forward<Args>(args)...);
+        };
+    }
+
+    // Binds to f, which must outlive every call. Member pointers go through nontype instead: they
+    // are almost always prvalues such as &S::f, and a reference to one dangles as soon as the
+    // full-expression ends.
+    template <typename F, typename T = remove_reference_t<F>>
+        requires(!is_same_v<remove_cv_t<T>, function_ref_impl> && !is_function_v<T> &&
+                 !is_function_pointer_<F> && !is_member_pointer_v<T> &&
+                 !is_nontype_v<remove_cv_t<T>> && function_callable<cv<T>&, Noexcept, R, Args...>)
+    function_ref_impl(F&& f) noexcept {
+        if constexpr (Const || is_const_v<T>) {
+            target_.cobj = static_cast<const void*>(&f);
+        } else {
+            target_.obj = static_cast<void*>(&f);
+        }
+        thunk_ = [](function_ref_target t, Args&&... args) noexcept(Noexcept) -> R {
+            cv<T>* target;
+            if constexpr (Const || is_const_v<T>) {
+                target = static_cast<cv<T>*>(t.cobj);
+            } else {
+                target = static_cast<T*>(t.obj);
+            }
+            return function_ref_invoke<R>(static_cast<cv<T>&>(*target),
+                                          mystl::forward<Args>(args)...);
+        };
+    }
+
+    function_ref_impl(const function_ref_impl&) noexcept = default;
+    function_ref_impl& operator=(const function_ref_impl&) noexcept = default;
+
+    // Assigning a callable would bind to a temporary that dies at the end of the statement.
+    // nontype binds nothing, so it converts and copy-assigns.
+    template <typename F>
+        requires(!is_same_v<remove_cvref_t<F>, function_ref_impl> &&
+                 !is_function_v<remove_reference_t<F>> && !is_function_pointer_<F> &&
+                 !is_nontype_v<remove_cvref_t<F>>)
+    function_ref_impl& operator=(F&&) = delete;
+
+    R operator()(Args... args) const noexcept(Noexcept) {
+        return thunk_(target_, mystl::forward<Args>(args)...);
+    }
+
+private:
+    function_ref_target target_;
+    R (*thunk_)(function_ref_target, Args&&...) noexcept(Noexcept);
+};
+
+template <typename Sig>
+struct function_ref_select;
+
+template <typename R, typename... Args, bool Noexcept>
+struct function_ref_select<R(Args...) noexcept(Noexcept)> {
+    using type = function_ref_impl<false, Noexcept, R, Args...>;
+};
+
+template <typename R, typename... Args, bool Noexcept>
+struct function_ref_select<R(Args...) const noexcept(Noexcept)> {
+    using type = function_ref_impl<true, Noexcept, R, Args...>;
+};
+
+}  // namespace detail
+
+// Non-owning reference to a callable, for parameters that are only called before the function
+// returns. Sig is R(Args...), optionally const and/or noexcept; with const the target is called
+// as a const object. Member pointers are bound as nontype<&S::f>, optionally with an object.
+template <typename Sig>
+using function_ref = typename detail::function_ref_select<Sig>::type;
+
 }  // namespace mystl
 
 #endif
\ No newline at end of file
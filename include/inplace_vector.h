@@ -0,0 +1,471 @@
+#ifndef MYSTL_HANDMADE_INPLACE_VECTOR_H_
+#define MYSTL_HANDMADE_INPLACE_VECTOR_H_
+
+#include <climits>
+#include <compare>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+
+#include "algorithm.h"
+#include "construct.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace detail {
+    // Smallest unsigned type that can count up to N, so that inplace_vector<char, 15> is 16 bytes.
+    template <size_t N>
+    using inplace_size_t =
+        conditional_t<(N <= UCHAR_MAX), unsigned char,
+                      conditional_t<(N <= USHRT_MAX), unsigned short,
+                                    conditional_t<(N <= UINT_MAX), unsigned int, size_t>>>;
+}  // namespace detail
+
+// A vector with a fixed capacity of N elements stored inside the object. It never allocates:
+// push_back and friends throw std::bad_alloc when full, try_push_back returns nullptr, and
+// unchecked_push_back has a precondition instead. inplace_vector is trivially copyable and
+// trivially destructible whenever T is.
+template <typename T, size_t N>
+class inplace_vector {
+    using size_storage = detail::inplace_size_t<N>;
+
+public:
+    using value_type             = T;
+    using size_type              = size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+
+    inplace_vector() noexcept = default;
+
+    explicit inplace_vector(size_type n) {
+        check_capacity_(n);
+        mystl::uninitialized_value_construct_n(data(), n);
+        size_ = static_cast<size_storage>(n);
+    }
+
+    inplace_vector(size_type n, const T& value) {
+        check_capacity_(n);
+        mystl::uninitialized_fill_n(data(), n, value);
+        size_ = static_cast<size_storage>(n);
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    inplace_vector(InputIt first, InputIt last) {
+        try {
+            append_range_(first, last);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    inplace_vector(std::initializer_list<T> ilist) : inplace_vector(ilist.begin(), ilist.end()) {}
+
+    inplace_vector(const inplace_vector&) requires is_trivially_copyable_v<T> = default;
+
+    inplace_vector(const inplace_vector& other) noexcept(is_nothrow_constructible_v<T, const T&>) {
+        mystl::uninitialized_copy(other.begin(), other.end(), data());
+        size_ = other.size_;
+    }
+
+    inplace_vector(inplace_vector&&) requires is_trivially_copyable_v<T> = default;
+
+    inplace_vector(inplace_vector&& other) noexcept(is_nothrow_move_constructible_v<T>) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // The source is left empty, which is a valid moved-from state.
+            mystl::uninitialized_relocate_n(other.data(), other.size(), data());
+            size_ = mystl::exchange(other.size_, size_storage(0));
+        } else {
+            mystl::uninitialized_move(other.begin(), other.end(), data());
+            size_ = other.size_;
+        }
+    }
+
+    ~inplace_vector() requires is_trivially_destructible_v<T> = default;
+
+    ~inplace_vector() { clear(); }
+
+    inplace_vector& operator=(const inplace_vector&) requires is_trivially_copyable_v<T> = default;
+
+    inplace_vector& operator=(const inplace_vector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    inplace_vector& operator=(inplace_vector&&) requires is_trivially_copyable_v<T> = default;
+
+    inplace_vector& operator=(inplace_vector&& other) noexcept(
+        is_nothrow_move_constructible_v<T> && is_nothrow_move_assignable_v<T>) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (is_trivially_relocatable_v<T>) {
+            clear();
+            mystl::uninitialized_relocate_n(other.data(), other.size(), data());
+            size_ = mystl::exchange(other.size_, size_storage(0));
+        } else {
+            const size_type common = size() < other.size() ? size() : other.size();
+            mystl::move(other.data(), other.data() + common, data());
+            if (other.size() > size()) {
+                mystl::uninitialized_move(other.data() + common, other.end(), end());
+            } else {
+                mystl::destroy(data() + other.size(), end());
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    inplace_vector& operator=(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    void assign(size_type n, const T& value) {
+        check_capacity_(n);
+        const size_type common = n < size() ? n : size();
+        mystl::fill_n(data(), common, value);
+        if (n > size()) {
+            mystl::uninitialized_fill_n(end(), n - size(), value);
+        } else {
+            mystl::destroy(data() + n, end());
+        }
+        size_ = static_cast<size_storage>(n);
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    void assign(InputIt first, InputIt last) {
+        if constexpr (requires { static_cast<size_type>(last - first); }) {
+            const size_type n = static_cast<size_type>(last - first);
+            check_capacity_(n);
+            if (n > size()) {
+                InputIt mid = first + static_cast<difference_type>(size());
+                mystl::copy(first, mid, data());
+                mystl::uninitialized_copy(mid, last, end());
+            } else {
+                mystl::destroy(mystl::copy(first, last, data()), end());
+            }
+            size_ = static_cast<size_storage>(n);
+        } else {
+            T* cur = data();
+            for (; first != last && cur != end(); ++first, (void)++cur) {
+                *cur = *first;
+            }
+            if (first == last) {
+                mystl::destroy(cur, end());
+                size_ = static_cast<size_storage>(cur - data());
+            } else {
+                append_range_(first, last);
+            }
+        }
+    }
+
+    void assign(std::initializer_list<T> ilist) { assign(ilist.begin(), ilist.end()); }
+
+    reference at(size_type pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("mystl::inplace_vector::at");
+        }
+        return data()[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("mystl::inplace_vector::at");
+        }
+        return data()[pos];
+    }
+
+    reference operator[](size_type pos) noexcept { return data()[pos]; }
+    const_reference operator[](size_type pos) const noexcept { return data()[pos]; }
+
+    reference front() noexcept { return data()[0]; }
+    const_reference front() const noexcept { return data()[0]; }
+
+    reference back() noexcept { return data()[size_ - 1]; }
+    const_reference back() const noexcept { return data()[size_ - 1]; }
+
+    T* data() noexcept { return reinterpret_cast<T*>(storage_); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>(storage_); }
+
+    iterator begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator cbegin() const noexcept { return data(); }
+
+    iterator end() noexcept { return data() + size_; }
+    const_iterator end() const noexcept { return data() + size_; }
+    const_iterator cend() const noexcept { return data() + size_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    size_type size() const noexcept { return size_; }
+
+    static constexpr size_type max_size() noexcept { return N; }
+
+    static constexpr size_type capacity() noexcept { return N; }
+
+    void reserve(size_type n) { check_capacity_(n); }
+
+    void shrink_to_fit() noexcept {}
+
+    void resize(size_type n) {
+        if (n > size()) {
+            check_capacity_(n);
+            mystl::uninitialized_value_construct(end(), data() + n);
+        } else {
+            mystl::destroy(data() + n, end());
+        }
+        size_ = static_cast<size_storage>(n);
+    }
+
+    void resize(size_type n, const T& value) {
+        if (n > size()) {
+            check_capacity_(n);
+            mystl::uninitialized_fill(end(), data() + n, value);
+        } else {
+            mystl::destroy(data() + n, end());
+        }
+        size_ = static_cast<size_storage>(n);
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == N) {
+            throw std::bad_alloc();
+        }
+        return unchecked_emplace_back(mystl::forward<Args>(args)...);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+
+    void push_back(T&& value) { emplace_back(mystl::move(value)); }
+
+    // Returns nullptr instead of throwing when the vector is full.
+    template <typename... Args>
+    T* try_emplace_back(Args&&... args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        return mystl::addressof(unchecked_emplace_back(mystl::forward<Args>(args)...));
+    }
+
+    T* try_push_back(const T& value) { return try_emplace_back(value); }
+
+    T* try_push_back(T&& value) { return try_emplace_back(mystl::move(value)); }
+
+    // Precondition: size() < capacity().
+    template <typename... Args>
+    reference unchecked_emplace_back(Args&&... args) {
+        T* p = mystl::construct_at(end(), mystl::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    reference unchecked_push_back(const T& value) { return unchecked_emplace_back(value); }
+
+    reference unchecked_push_back(T&& value) { return unchecked_emplace_back(mystl::move(value)); }
+
+    void pop_back() noexcept {
+        --size_;
+        mystl::destroy_at(end());
+    }
+
+    void clear() noexcept {
+        mystl::destroy(data(), end());
+        size_ = 0;
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        T* p = const_cast<T*>(pos);
+        if (size_ == N) {
+            throw std::bad_alloc();
+        }
+        if (p == end()) {
+            return mystl::addressof(unchecked_emplace_back(mystl::forward<Args>(args)...));
+        }
+        // Construct first: args may refer to an element that is about to shift.
+        if constexpr (is_trivially_relocatable_v<T>) {
+            alignas(T) unsigned char buffer[sizeof(T)];
+            T* tmp = mystl::construct_at(reinterpret_cast<T*>(buffer), mystl::forward<Args>(args)...);
+            mystl::uninitialized_relocate(p, end(), p + 1);
+            mystl::relocate_at(tmp, p);
+            ++size_;
+        } else {
+            T tmp(mystl::forward<Args>(args)...);
+            mystl::construct_at(end(), mystl::move(back()));
+            ++size_;
+            mystl::move_backward(p, end() - 2, end() - 1);
+            *p = mystl::move(tmp);
+        }
+        return p;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, mystl::move(value)); }
+
+    iterator insert(const_iterator pos, size_type n, const T& value) {
+        check_capacity_(size() + n);
+        if (begin() <= &value && &value < end()) {
+            T copy(value);
+            return insert_gap_(pos, n, [&copy](T* dst, size_type count) {
+                return mystl::uninitialized_fill_n(dst, count, copy);
+            });
+        }
+        return insert_gap_(pos, n, [&value](T* dst, size_type count) {
+            return mystl::uninitialized_fill_n(dst, count, value);
+        });
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        if constexpr (requires { static_cast<size_type>(last - first); }) {
+            const size_type n = static_cast<size_type>(last - first);
+            check_capacity_(size() + n);
+            return insert_gap_(pos, n, [first, last](T* dst, size_type) {
+                return mystl::uninitialized_copy(first, last, dst);
+            });
+        } else {
+            const size_type index = static_cast<size_type>(pos - begin());
+            const size_type old_size = size();
+            append_range_(first, last);
+            mystl::rotate(data() + index, data() + old_size, end());
+            return data() + index;
+        }
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        T* f = const_cast<T*>(first);
+        T* l = const_cast<T*>(last);
+        if (f == l) {
+            return f;
+        }
+        if constexpr (is_trivially_relocatable_v<T>) {
+            mystl::destroy(f, l);
+            mystl::uninitialized_relocate(l, end(), f);
+        } else {
+            mystl::destroy(mystl::move(l, end(), f), end());
+        }
+        size_ -= static_cast<size_storage>(l - f);
+        return f;
+    }
+
+    void swap(inplace_vector& other) noexcept(is_nothrow_swappable_v<T> &&
+                                              is_nothrow_move_constructible_v<T>) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            alignas(T) unsigned char tmp[sizeof(storage_)];
+            const size_t my_bytes = size() * sizeof(T);
+            const size_t other_bytes = other.size() * sizeof(T);
+            std::memcpy(tmp, storage_, my_bytes);
+            std::memcpy(storage_, other.storage_, other_bytes);
+            std::memcpy(other.storage_, tmp, my_bytes);
+            mystl::swap(size_, other.size_);
+        } else {
+            inplace_vector& shorter = size() < other.size() ? *this : other;
+            inplace_vector& longer = size() < other.size() ? other : *this;
+            T* s = shorter.data();
+            T* l = longer.data();
+            for (size_type i = 0; i < shorter.size(); ++i) {
+                using mystl::swap;
+                swap(s[i], l[i]);
+            }
+            mystl::uninitialized_move(l + shorter.size(), longer.end(), shorter.end());
+            mystl::destroy(l + shorter.size(), longer.end());
+            mystl::swap(size_, other.size_);
+        }
+    }
+
+private:
+    static void check_capacity_(size_type n) {
+        if (n > N) {
+            throw std::bad_alloc();
+        }
+    }
+
+    template <typename InputIt>
+    void append_range_(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    // Opens a gap of n elements at pos and fills it with fill(dst, n). Capacity has been checked.
+    template <typename Fill>
+    T* insert_gap_(const_iterator pos, size_type n, Fill fill) {
+        T* p = const_cast<T*>(pos);
+        if (n == 0) {
+            return p;
+        }
+        if constexpr (is_trivially_relocatable_v<T>) {
+            mystl::uninitialized_relocate(p, end(), p + n);
+            try {
+                fill(p, n);
+            } catch (...) {
+                mystl::uninitialized_relocate(p + n, end() + n, p);
+                throw;
+            }
+            size_ += static_cast<size_storage>(n);
+        } else {
+            T* old_end = end();
+            fill(old_end, n);
+            size_ += static_cast<size_storage>(n);
+            mystl::rotate(p, old_end, end());
+        }
+        return p;
+    }
+
+    size_storage size_ = 0;
+    alignas(T) unsigned char storage_[N == 0 ? 1 : N * sizeof(T)];
+};
+
+template <typename T, size_t N>
+bool operator==(const inplace_vector<T, N>& lhs, const inplace_vector<T, N>& rhs) {
+    return detail::sequence_equal(lhs, rhs);
+}
+
+template <typename T, size_t N>
+auto operator<=>(const inplace_vector<T, N>& lhs, const inplace_vector<T, N>& rhs)
+    -> decltype(detail::sequence_three_way(lhs, rhs)) {
+    return detail::sequence_three_way(lhs, rhs);
+}
+
+template <typename T, size_t N>
+void swap(inplace_vector<T, N>& lhs, inplace_vector<T, N>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <typename T, size_t N, typename Pred>
+size_t erase_if(inplace_vector<T, N>& v, Pred pred) {
+    return detail::sequence_erase_if(v, pred);
+}
+
+template <typename T, size_t N, typename U>
+size_t erase(inplace_vector<T, N>& v, const U& value) {
+    return mystl::erase_if(v, [&value](const T& elem) { return elem == value; });
+}
+
+}  // namespace mystl
+
+#endif
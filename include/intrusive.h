@@ -0,0 +1,775 @@
+#ifndef MYSTL_HANDMADE_INTRUSIVE_H_
+#define MYSTL_HANDMADE_INTRUSIVE_H_
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+// Shared ownership of an object that carries its own reference count. The count is reached
+// through two functions found by argument-dependent lookup:
+//
+//     void intrusive_ptr_add_ref(T* p);
+//     void intrusive_ptr_release(T* p);  // frees *p when the count drops to zero
+//
+// so an intrusive_ptr is a single pointer, needs no control block, and can be rebuilt from a
+// raw pointer at any time. intrusive_ref_counter provides both functions for classes that
+// derive from it.
+template <typename T>
+class intrusive_ptr {
+public:
+    using element_type = T;
+    using trivially_relocatable = true_type;
+
+    constexpr intrusive_ptr() noexcept = default;
+
+    constexpr intrusive_ptr(nullptr_t) noexcept {}
+
+    // With add_ref == false, adopts a reference the caller already holds (see detach()).
+    intrusive_ptr(T* p, bool add_ref = true) : p_(p) {
+        if (p_ && add_ref) {
+            intrusive_ptr_add_ref(p_);
+        }
+    }
+
+    intrusive_ptr(const intrusive_ptr& other) : intrusive_ptr(other.p_) {}
+
+    intrusive_ptr(intrusive_ptr&& other) noexcept : p_(mystl::exchange(other.p_, nullptr)) {}
+
+    template <typename U>
+        requires is_convertible_v<U*, T*>
+    intrusive_ptr(const intrusive_ptr<U>& other) : intrusive_ptr(other.get()) {}
+
+    template <typename U>
+        requires is_convertible_v<U*, T*>
+    intrusive_ptr(intrusive_ptr<U>&& other) noexcept : p_(other.detach()) {}
+
+    ~intrusive_ptr() {
+        if (p_) {
+            intrusive_ptr_release(p_);
+        }
+    }
+
+    intrusive_ptr& operator=(const intrusive_ptr& other) {
+        intrusive_ptr(other).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& other) noexcept {
+        intrusive_ptr(mystl::move(other)).swap(*this);
+        return *this;
+    }
+
+    template <typename U>
+        requires is_convertible_v<U*, T*>
+    intrusive_ptr& operator=(const intrusive_ptr<U>& other) {
+        intrusive_ptr(other).swap(*this);
+        return *this;
+    }
+
+    template <typename U>
+        requires is_convertible_v<U*, T*>
+    intrusive_ptr& operator=(intrusive_ptr<U>&& other) noexcept {
+        intrusive_ptr(mystl::move(other)).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(T* p) {
+        intrusive_ptr(p).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { intrusive_ptr().swap(*this); }
+
+    void reset(T* p, bool add_ref = true) { intrusive_ptr(p, add_ref).swap(*this); }
+
+    // Gives up the reference without releasing it.
+    T* detach() noexcept { return mystl::exchange(p_, nullptr); }
+
+    T* get() const noexcept { return p_; }
+    T& operator*() const noexcept { return *p_; }
+    T* operator->() const noexcept { return p_; }
+
+    explicit operator bool() const noexcept { return p_ != nullptr; }
+
+    void swap(intrusive_ptr& other) noexcept { mystl::swap(p_, other.p_); }
+
+    friend void swap(intrusive_ptr& a, intrusive_ptr& b) noexcept { a.swap(b); }
+
+private:
+    T* p_ = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const intrusive_ptr<T>& a, const intrusive_ptr<U>& b) noexcept {
+    return a.get() == b.get();
+}
+
+template <typename T, typename U>
+auto operator<=>(const intrusive_ptr<T>& a, const intrusive_ptr<U>& b) noexcept {
+    return std::compare_three_way()(a.get(), b.get());
+}
+
+template <typename T>
+bool operator==(const intrusive_ptr<T>& p, nullptr_t) noexcept {
+    return !p;
+}
+
+template <typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args) {
+    return intrusive_ptr<T>(new T(mystl::forward<Args>(args)...));
+}
+
+template <typename T, typename U>
+intrusive_ptr<T> static_pointer_cast(const intrusive_ptr<U>& p) {
+    return intrusive_ptr<T>(static_cast<T*>(p.get()));
+}
+
+template <typename T, typename U>
+intrusive_ptr<T> dynamic_pointer_cast(const intrusive_ptr<U>& p) {
+    return intrusive_ptr<T>(dynamic_cast<T*>(p.get()));
+}
+
+// Base that gives Derived a reference count for intrusive_ptr and deletes it through
+// `delete static_cast<Derived*>` at zero. Atomic = false counts with plain integers, for
+// objects that never leave one thread. Copies start with a count of their own.
+template <typename Derived, bool Atomic = true>
+class intrusive_ref_counter {
+public:
+    long use_count() const noexcept { return count_.get(); }
+
+protected:
+    intrusive_ref_counter() noexcept : count_(0) {}
+    intrusive_ref_counter(const intrusive_ref_counter&) noexcept : count_(0) {}
+    intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept { return *this; }
+    ~intrusive_ref_counter() = default;
+
+private:
+    friend void intrusive_ptr_add_ref(const intrusive_ref_counter* p) noexcept {
+        p->count_.increment();
+    }
+
+    friend void intrusive_ptr_release(const intrusive_ref_counter* p) noexcept {
+        if (p->count_.decrement()) {
+            delete static_cast<const Derived*>(p);
+        }
+    }
+
+    mutable detail::ref_count<Atomic> count_;
+};
+
+// Intrusive containers. An element joins a container through a hook it inherits from, so
+// inserting allocates nothing and an element can sit in as many containers at once as it has
+// hooks; the Tag parameter tells apart several hooks of the same kind in one class:
+//
+//     struct by_lru {};
+//     struct Session : mystl::list_hook<by_lru>, mystl::hash_hook<> { ... };
+//     mystl::intrusive_list<Session, by_lru> lru;
+//
+// The containers do not own their elements. An element must be erased from every container
+// before it is destroyed, and must outlive its membership. Copying an element copies no links.
+
+template <typename Tag = void>
+class list_hook {
+public:
+    list_hook() noexcept = default;
+    list_hook(const list_hook&) noexcept {}
+    list_hook& operator=(const list_hook&) noexcept { return *this; }
+
+    bool is_linked() const noexcept { return next_ != nullptr; }
+
+private:
+    template <typename, typename>
+    friend class intrusive_list;
+
+    list_hook* prev_ = nullptr;
+    list_hook* next_ = nullptr;
+};
+
+// Circular doubly-linked list through list_hook<Tag>, with a sentinel hook inside the list
+// object. Insertion and erasure are O(1) given the element, and so is size().
+template <typename T, typename Tag = void>
+class intrusive_list {
+    using hook = list_hook<Tag>;
+
+    static_assert(is_base_of_v<hook, T>, "T must derive from list_hook<Tag>");
+
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+
+    class const_iterator;
+
+    class iterator {
+        friend class intrusive_list;
+        friend class const_iterator;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = T&;
+        using pointer           = T*;
+
+        iterator() noexcept = default;
+
+        reference operator*() const noexcept { return *static_cast<T*>(node_); }
+        pointer operator->() const noexcept { return static_cast<T*>(node_); }
+
+        iterator& operator++() noexcept {
+            node_ = node_->next_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp = *this;
+            node_ = node_->next_;
+            return tmp;
+        }
+
+        iterator& operator--() noexcept {
+            node_ = node_->prev_;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept {
+            iterator tmp = *this;
+            node_ = node_->prev_;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.node_ == b.node_;
+        }
+
+    private:
+        explicit iterator(hook* node) noexcept : node_(node) {}
+
+        hook* node_ = nullptr;
+    };
+
+    class const_iterator {
+        friend class intrusive_list;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = const T&;
+        using pointer           = const T*;
+
+        const_iterator() noexcept = default;
+        const_iterator(iterator it) noexcept : it_(it) {}
+
+        reference operator*() const noexcept { return *it_; }
+        pointer operator->() const noexcept { return it_.operator->(); }
+
+        const_iterator& operator++() noexcept {
+            ++it_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++it_;
+            return tmp;
+        }
+
+        const_iterator& operator--() noexcept {
+            --it_;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept {
+            const_iterator tmp = *this;
+            --it_;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+            return a.it_ == b.it_;
+        }
+
+    private:
+        iterator it_;
+    };
+
+    intrusive_list() noexcept { head_.prev_ = head_.next_ = &head_; }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    intrusive_list(intrusive_list&& other) noexcept : intrusive_list() { splice(end(), other); }
+
+    intrusive_list& operator=(intrusive_list&& other) noexcept {
+        if (this != &other) {
+            clear();
+            splice(end(), other);
+        }
+        return *this;
+    }
+
+    // Unlinks the remaining elements.
+    ~intrusive_list() { clear(); }
+
+    iterator begin() noexcept { return iterator(head_.next_); }
+    iterator end() noexcept { return iterator(&head_); }
+    const_iterator begin() const noexcept { return iterator(head_.next_); }
+    const_iterator end() const noexcept { return iterator(const_cast<hook*>(&head_)); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    T& front() noexcept { return *begin(); }
+    const T& front() const noexcept { return *begin(); }
+    T& back() noexcept { return *--end(); }
+    const T& back() const noexcept { return *--end(); }
+
+    // The position of an element known to be in this list.
+    iterator iterator_to(T& value) noexcept { return iterator(static_cast<hook*>(&value)); }
+
+    const_iterator iterator_to(const T& value) const noexcept {
+        return iterator(const_cast<hook*>(static_cast<const hook*>(&value)));
+    }
+
+    // Links value, which must not be in a list through this hook, before pos.
+    iterator insert(const_iterator pos, T& value) noexcept {
+        hook* node = static_cast<hook*>(&value);
+        hook* next = pos.it_.node_;
+        node->prev_ = next->prev_;
+        node->next_ = next;
+        next->prev_->next_ = node;
+        next->prev_ = node;
+        ++size_;
+        return iterator(node);
+    }
+
+    void push_front(T& value) noexcept { insert(begin(), value); }
+    void push_back(T& value) noexcept { insert(end(), value); }
+
+    iterator erase(const_iterator pos) noexcept {
+        hook* node = pos.it_.node_;
+        hook* next = node->next_;
+        node->prev_->next_ = next;
+        next->prev_ = node->prev_;
+        node->prev_ = node->next_ = nullptr;
+        --size_;
+        return iterator(next);
+    }
+
+    iterator erase(T& value) noexcept { return erase(iterator_to(value)); }
+
+    void pop_front() noexcept { erase(begin()); }
+    void pop_back() noexcept { erase(--end()); }
+
+    void clear() noexcept {
+        hook* node = head_.next_;
+        while (node != &head_) {
+            hook* next = node->next_;
+            node->prev_ = node->next_ = nullptr;
+            node = next;
+        }
+        head_.prev_ = head_.next_ = &head_;
+        size_ = 0;
+    }
+
+    // Moves every element of other before pos.
+    void splice(const_iterator pos, intrusive_list& other) noexcept {
+        if (other.empty()) {
+            return;
+        }
+        hook* next = pos.it_.node_;
+        hook* first = other.head_.next_;
+        hook* last = other.head_.prev_;
+        first->prev_ = next->prev_;
+        last->next_ = next;
+        next->prev_->next_ = first;
+        next->prev_ = last;
+        size_ += other.size_;
+        other.head_.prev_ = other.head_.next_ = &other.head_;
+        other.size_ = 0;
+    }
+
+    // Moves value, which is in this list, before pos.
+    void move_before(const_iterator pos, T& value) noexcept {
+        if (pos.it_.node_ != static_cast<hook*>(&value)) {
+            erase(value);
+            insert(pos, value);
+        }
+    }
+
+    void swap(intrusive_list& other) noexcept {
+        intrusive_list tmp(mystl::move(other));
+        other.splice(other.end(), *this);
+        splice(end(), tmp);
+    }
+
+    friend void swap(intrusive_list& a, intrusive_list& b) noexcept { a.swap(b); }
+
+private:
+    hook head_;
+    size_type size_ = 0;
+};
+
+template <typename Tag = void>
+class hash_hook {
+public:
+    hash_hook() noexcept = default;
+    hash_hook(const hash_hook&) noexcept {}
+    hash_hook& operator=(const hash_hook&) noexcept { return *this; }
+
+    bool is_linked() const noexcept { return pprev_ != nullptr; }
+
+private:
+    template <typename, typename, typename, typename, typename>
+    friend class intrusive_hash_set;
+
+    hash_hook* next_ = nullptr;
+    // The pointer that points at this hook: a bucket or the previous hook's next_, so erasing
+    // needs no walk along the chain.
+    hash_hook** pprev_ = nullptr;
+    size_t hash_ = 0;
+};
+
+// Hash set with unique keys, chained through hash_hook<Tag>. KeyOf maps an element to its key
+// (`key_type operator()(const T&) const`); each hook caches its element's hash, so rehashing
+// and mismatched chain entries never call Hash or Eq. Inserting allocates only when it grows
+// the bucket array, which happens when the size would exceed the bucket count; reserve() up
+// front and insertion never allocates. Erasing given the element is O(1).
+namespace detail {
+    template <typename T, typename KeyOf>
+    using intrusive_key_t =
+        remove_cvref_t<decltype(mystl::declval<const KeyOf&>()(mystl::declval<const T&>()))>;
+}  // namespace detail
+
+template <typename T, typename KeyOf, typename Hash = hash<detail::intrusive_key_t<T, KeyOf>>,
+          typename Eq = std::equal_to<detail::intrusive_key_t<T, KeyOf>>, typename Tag = void>
+class intrusive_hash_set {
+    using hook = hash_hook<Tag>;
+
+    static_assert(is_base_of_v<hook, T>, "T must derive from hash_hook<Tag>");
+
+public:
+    using key_type        = detail::intrusive_key_t<T, KeyOf>;
+    using value_type      = T;
+    using hasher          = Hash;
+    using key_equal       = Eq;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+
+    class const_iterator;
+
+    class iterator {
+        friend class intrusive_hash_set;
+        friend class const_iterator;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = T&;
+        using pointer           = T*;
+
+        iterator() noexcept = default;
+
+        reference operator*() const noexcept { return *static_cast<T*>(node_); }
+        pointer operator->() const noexcept { return static_cast<T*>(node_); }
+
+        iterator& operator++() noexcept {
+            node_ = node_->next_;
+            if (node_ == nullptr) {
+                while (++bucket_ < set_->bucket_count_ && set_->buckets_[bucket_] == nullptr) {
+                }
+                if (bucket_ < set_->bucket_count_) {
+                    node_ = set_->buckets_[bucket_];
+                }
+            }
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.node_ == b.node_;
+        }
+
+    private:
+        iterator(const intrusive_hash_set* set, size_type bucket, hook* node) noexcept
+            : set_(set), bucket_(bucket), node_(node) {}
+
+        const intrusive_hash_set* set_ = nullptr;
+        size_type bucket_ = 0;
+        hook* node_ = nullptr;
+    };
+
+    class const_iterator {
+        friend class intrusive_hash_set;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = const T&;
+        using pointer           = const T*;
+
+        const_iterator() noexcept = default;
+        const_iterator(iterator it) noexcept : it_(it) {}
+
+        reference operator*() const noexcept { return *it_; }
+        pointer operator->() const noexcept { return it_.operator->(); }
+
+        const_iterator& operator++() noexcept {
+            ++it_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++it_;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+            return a.it_ == b.it_;
+        }
+
+    private:
+        iterator it_;
+    };
+
+    intrusive_hash_set() = default;
+
+    explicit intrusive_hash_set(size_type bucket_count, const hasher& hash = hasher(),
+                                const key_equal& eq = key_equal())
+        : hash_(hash), eq_(eq) {
+        rehash(bucket_count);
+    }
+
+    intrusive_hash_set(const intrusive_hash_set&) = delete;
+    intrusive_hash_set& operator=(const intrusive_hash_set&) = delete;
+
+    // The chain heads point back into the bucket array, which moves along with it.
+    intrusive_hash_set(intrusive_hash_set&& other) noexcept
+        : buckets_(mystl::exchange(other.buckets_, nullptr)),
+          bucket_count_(mystl::exchange(other.bucket_count_, 0)),
+          size_(mystl::exchange(other.size_, 0)),
+          hash_(other.hash_),
+          eq_(other.eq_) {}
+
+    intrusive_hash_set& operator=(intrusive_hash_set&& other) noexcept {
+        intrusive_hash_set(mystl::move(other)).swap(*this);
+        return *this;
+    }
+
+    // Unlinks the remaining elements.
+    ~intrusive_hash_set() {
+        clear();
+        delete[] buckets_;
+    }
+
+    iterator begin() noexcept { return iterator(first_()); }
+    iterator end() noexcept { return iterator(this, bucket_count_, nullptr); }
+    const_iterator begin() const noexcept { return iterator(first_()); }
+    const_iterator end() const noexcept { return iterator(this, bucket_count_, nullptr); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type bucket_count() const noexcept { return bucket_count_; }
+
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return eq_; }
+
+    // The position of an element known to be in this set.
+    iterator iterator_to(T& value) noexcept {
+        hook* node = static_cast<hook*>(&value);
+        return iterator(this, bucket_of_(node->hash_), node);
+    }
+
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_cast<intrusive_hash_set*>(this)->iterator_to(const_cast<T&>(value));
+    }
+
+    // Links value, which must not be in a set through this hook, unless an element with an
+    // equal key is present; returns that element and false in the latter case.
+    pair<iterator, bool> insert(T& value) {
+        const size_t h = hash_of_(KeyOf()(value));
+        if (iterator it = find_(KeyOf()(value), h); it.node_ != nullptr) {
+            return {it, false};
+        }
+        if (size_ >= bucket_count_) {
+            rehash(bucket_count_ == 0 ? min_buckets : bucket_count_ * 2);
+        }
+        hook* node = static_cast<hook*>(&value);
+        node->hash_ = h;
+        const size_type b = bucket_of_(h);
+        link_(node, buckets_[b]);
+        ++size_;
+        return {iterator(this, b, node), true};
+    }
+
+    iterator find(const key_type& key) noexcept { return find_(key, hash_of_(key)); }
+
+    const_iterator find(const key_type& key) const noexcept {
+        return const_cast<intrusive_hash_set*>(this)->find(key);
+    }
+
+    bool contains(const key_type& key) const noexcept { return find(key) != end(); }
+
+    iterator erase(const_iterator pos) noexcept {
+        iterator next = pos.it_;
+        ++next;
+        unlink_(pos.it_.node_);
+        --size_;
+        return next;
+    }
+
+    void erase(T& value) noexcept {
+        unlink_(static_cast<hook*>(&value));
+        --size_;
+    }
+
+    size_type erase(const key_type& key) noexcept {
+        iterator it = find(key);
+        if (it.node_ == nullptr) {
+            return 0;
+        }
+        erase(*it);
+        return 1;
+    }
+
+    void clear() noexcept {
+        for (size_type b = 0; b < bucket_count_; ++b) {
+            hook* node = buckets_[b];
+            while (node != nullptr) {
+                hook* next = node->next_;
+                node->next_ = nullptr;
+                node->pprev_ = nullptr;
+                node = next;
+            }
+            buckets_[b] = nullptr;
+        }
+        size_ = 0;
+    }
+
+    // Makes room for n elements without further allocation.
+    void reserve(size_type n) { rehash(n); }
+
+    // Resizes the bucket array to the power of two at or above max(n, size()).
+    void rehash(size_type n) {
+        size_type count = min_buckets;
+        while (count < n || count < size_) {
+            count <<= 1;
+        }
+        if (count == bucket_count_) {
+            return;
+        }
+        hook** buckets = new hook*[count]();
+        const size_type mask = count - 1;
+        for (size_type b = 0; b < bucket_count_; ++b) {
+            hook* node = buckets_[b];
+            while (node != nullptr) {
+                hook* next = node->next_;
+                link_(node, buckets[node->hash_ & mask]);
+                node = next;
+            }
+        }
+        delete[] buckets_;
+        buckets_ = buckets;
+        bucket_count_ = count;
+    }
+
+    void swap(intrusive_hash_set& other) noexcept {
+        mystl::swap(buckets_, other.buckets_);
+        mystl::swap(bucket_count_, other.bucket_count_);
+        mystl::swap(size_, other.size_);
+        mystl::swap(hash_, other.hash_);
+        mystl::swap(eq_, other.eq_);
+    }
+
+    friend void swap(intrusive_hash_set& a, intrusive_hash_set& b) noexcept { a.swap(b); }
+
+private:
+    static constexpr size_type min_buckets = 8;
+
+    // Hashers that do not declare is_avalanching get their result mixed: the bucket is chosen
+    // from the low bits alone.
+    size_t hash_of_(const key_type& key) const {
+        if constexpr (requires { requires bool(hasher::is_avalanching::value); }) {
+            return static_cast<size_t>(hash_(key));
+        } else {
+            return static_cast<size_t>(detail::hash_mix(static_cast<uint64_t>(hash_(key))));
+        }
+    }
+
+    size_type bucket_of_(size_t h) const noexcept { return h & (bucket_count_ - 1); }
+
+    iterator find_(const key_type& key, size_t h) {
+        if (bucket_count_ == 0) {
+            return end();
+        }
+        const size_type b = bucket_of_(h);
+        for (hook* node = buckets_[b]; node != nullptr; node = node->next_) {
+            if (node->hash_ == h && eq_(KeyOf()(*static_cast<T*>(node)), key)) {
+                return iterator(this, b, node);
+            }
+        }
+        return end();
+    }
+
+    // Pushes node at the front of the chain whose head is `head`.
+    static void link_(hook* node, hook*& head) noexcept {
+        node->next_ = head;
+        node->pprev_ = &head;
+        if (head != nullptr) {
+            head->pprev_ = &node->next_;
+        }
+        head = node;
+    }
+
+    static void unlink_(hook* node) noexcept {
+        *node->pprev_ = node->next_;
+        if (node->next_ != nullptr) {
+            node->next_->pprev_ = node->pprev_;
+        }
+        node->next_ = nullptr;
+        node->pprev_ = nullptr;
+    }
+
+    iterator first_() const noexcept {
+        for (size_type b = 0; b < bucket_count_; ++b) {
+            if (buckets_[b] != nullptr) {
+                return iterator(this, b, buckets_[b]);
+            }
+        }
+        return iterator(this, bucket_count_, nullptr);
+    }
+
+    hook** buckets_ = nullptr;
+    size_type bucket_count_ = 0;
+    size_type size_ = 0;
+    [[no_unique_address]] hasher hash_;
+    [[no_unique_address]] key_equal eq_;
+};
+
+}  // namespace mystl
+
+#endif
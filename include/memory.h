@@ -1,25 +1,21 @@
 #ifndef MYSTL_HANDMADE_MEMORY_H_
 #define MYSTL_HANDMADE_MEMORY_H_
 
+#include <atomic>
+#include <compare>
 #include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <new>
+
+#include "construct.h"
 #include "type_traits.h"
 #include "utility.h"
 
 namespace mystl {
 
-template <typename T>
-constexpr T* addressof(T& arg) noexcept {
-#if defined(__GNUEC__) || defined(__clang__) 
-    return __builtin_addressof(arg);
-#else
-    return reinterpret_cast<T*>(
-        &const_cast<char&>(reinterpret_cast<const volatile char&>(arg)));
-#endif
-}
-
-template <typename T>
-const T* addressof(const T&&) = delete;
-
 namespace detail {
     template <typename Ptr, bool = requires { typename Ptr::element_type; }>
     struct get_elem_type {};
@@ -34,7 +30,7 @@ namespace detail {
         using type = T;
     };
 
-    template <typename Ptr, bool = requires { typename Ptr::element_type; }>
+    template <typename Ptr, bool = requires { typename Ptr::difference_type; }>
     struct get_diff_type {
         using type = std::ptrdiff_t;
     };
@@ -62,7 +58,7 @@ template <typename Ptr>
 struct pointer_traits {
     using pointer           = Ptr;
     using element_type      = typename detail::get_elem_type<Ptr>::type;
-    using different_type    = typename detail::get_diff_type<Ptr>::type;
+    using difference_type   = typename detail::get_diff_type<Ptr>::type;
 
     template <typename U>
     using rebind = typename detail::get_rebind<Ptr, U>::type;
@@ -86,6 +82,1223 @@ struct pointer_traits<T*> {
     }
 };
 
+// The raw address held by a pointer or fancy pointer, without dereferencing it.
+template <typename T>
+constexpr T* to_address(T* p) noexcept {
+    static_assert(!is_function_v<T>, "to_address of a function pointer");
+    return p;
+}
+
+template <typename Ptr>
+constexpr auto to_address(const Ptr& p) noexcept {
+    if constexpr (requires { pointer_traits<Ptr>::to_address(p); }) {
+        return pointer_traits<Ptr>::to_address(p);
+    } else {
+        return mystl::to_address(p.operator->());
+    }
+}
+
+template <typename Pointer, typename SizeType = size_t>
+struct allocation_result {
+    Pointer ptr;
+    SizeType count;
+};
+
+namespace detail {
+    template <typename Alloc, typename T, typename = void>
+    struct alloc_pointer {
+        using type = T*;
+    };
+
+    template <typename Alloc, typename T>
+    struct alloc_pointer<Alloc, T, void_t<typename Alloc::pointer>> {
+        using type = typename Alloc::pointer;
+    };
+
+    template <typename Alloc, typename Ptr>
+    struct alloc_const_pointer {
+        using type = typename pointer_traits<Ptr>::template rebind<const typename Alloc::value_type>;
+    };
+
+    template <typename Alloc, typename Ptr>
+        requires requires { typename Alloc::const_pointer; }
+    struct alloc_const_pointer<Alloc, Ptr> {
+        using type = typename Alloc::const_pointer;
+    };
+
+    template <typename Alloc, typename Ptr>
+    struct alloc_void_pointer {
+        using type = typename pointer_traits<Ptr>::template rebind<void>;
+    };
+
+    template <typename Alloc, typename Ptr>
+        requires requires { typename Alloc::void_pointer; }
+    struct alloc_void_pointer<Alloc, Ptr> {
+        using type = typename Alloc::void_pointer;
+    };
+
+    template <typename Alloc, typename Ptr>
+    struct alloc_const_void_pointer {
+        using type = typename pointer_traits<Ptr>::template rebind<const void>;
+    };
+
+    template <typename Alloc, typename Ptr>
+        requires requires { typename Alloc::const_void_pointer; }
+    struct alloc_const_void_pointer<Alloc, Ptr> {
+        using type = typename Alloc::const_void_pointer;
+    };
+
+    template <typename Alloc, typename Ptr, typename = void>
+    struct alloc_diff_type {
+        using type = typename pointer_traits<Ptr>::difference_type;
+    };
+
+    template <typename Alloc, typename Ptr>
+    struct alloc_diff_type<Alloc, Ptr, void_t<typename Alloc::difference_type>> {
+        using type = typename Alloc::difference_type;
+    };
+
+    template <typename Alloc, typename Diff, typename = void>
+    struct alloc_size_type {
+        using type = make_unsigned_t<Diff>;
+    };
+
+    template <typename Alloc, typename Diff>
+    struct alloc_size_type<Alloc, Diff, void_t<typename Alloc::size_type>> {
+        using type = typename Alloc::size_type;
+    };
+
+#define MYSTL_ALLOC_TRAIT_MEMBER(trait, member, fallback)          \
+    template <typename Alloc, typename = void>                      \
+    struct trait {                                                  \
+        using type = fallback;                                      \
+    };                                                              \
+    template <typename Alloc>                                       \
+    struct trait<Alloc, void_t<typename Alloc::member>> {           \
+        using type = typename Alloc::member;                        \
+    };
+
+    MYSTL_ALLOC_TRAIT_MEMBER(alloc_pocca, propagate_on_container_copy_assignment, false_type)
+    MYSTL_ALLOC_TRAIT_MEMBER(alloc_pocma, propagate_on_container_move_assignment, false_type)
+    MYSTL_ALLOC_TRAIT_MEMBER(alloc_pocs, propagate_on_container_swap, false_type)
+    MYSTL_ALLOC_TRAIT_MEMBER(alloc_always_equal, is_always_equal, bool_constant<is_empty_v<Alloc>>)
+
+#undef MYSTL_ALLOC_TRAIT_MEMBER
+
+    template <typename Alloc, typename U>
+    concept has_rebind_other = requires { typename Alloc::template rebind<U>::other; };
+
+    template <typename Alloc, typename U, bool = has_rebind_other<Alloc, U>>
+    struct alloc_rebind {};
+
+    template <typename Alloc, typename U>
+    struct alloc_rebind<Alloc, U, true> {
+        using type = typename Alloc::template rebind<U>::other;
+    };
+
+    template <template <typename, typename...> class Template, typename T, typename... Args, typename U>
+    struct alloc_rebind<Template<T, Args...>, U, false> {
+        using type = Template<U, Args...>;
+    };
+}
+
+template <typename Alloc>
+struct allocator_traits {
+    using allocator_type     = Alloc;
+    using value_type         = typename Alloc::value_type;
+    using pointer            = typename detail::alloc_pointer<Alloc, value_type>::type;
+    using const_pointer      = typename detail::alloc_const_pointer<Alloc, pointer>::type;
+    using void_pointer       = typename detail::alloc_void_pointer<Alloc, pointer>::type;
+    using const_void_pointer = typename detail::alloc_const_void_pointer<Alloc, pointer>::type;
+    using difference_type    = typename detail::alloc_diff_type<Alloc, pointer>::type;
+    using size_type          = typename detail::alloc_size_type<Alloc, difference_type>::type;
+
+    using propagate_on_container_copy_assignment = typename detail::alloc_pocca<Alloc>::type;
+    using propagate_on_container_move_assignment = typename detail::alloc_pocma<Alloc>::type;
+    using propagate_on_container_swap            = typename detail::alloc_pocs<Alloc>::type;
+    using is_always_equal                        = typename detail::alloc_always_equal<Alloc>::type;
+
+    template <typename U>
+    using rebind_alloc = typename detail::alloc_rebind<Alloc, U>::type;
+
+    template <typename U>
+    using rebind_traits = allocator_traits<rebind_alloc<U>>;
+
+    [[nodiscard]] static constexpr pointer allocate(Alloc& a, size_type n) {
+        return a.allocate(n);
+    }
+
+    [[nodiscard]] static constexpr pointer allocate(Alloc& a, size_type n, const_void_pointer hint) {
+        if constexpr (requires { a.allocate(n, hint); }) {
+            return a.allocate(n, hint);
+        } else {
+            return a.allocate(n);
+        }
+    }
+
+    // Returns storage for at least n objects together with the capacity actually obtained, so
+    // containers can use the slack the allocator would otherwise waste.
+    [[nodiscard]] static constexpr allocation_result<pointer, size_type> allocate_at_least(
+        Alloc& a, size_type n) {
+        if constexpr (requires { a.allocate_at_least(n); }) {
+            return a.allocate_at_least(n);
+        } else {
+            return {a.allocate(n), n};
+        }
+    }
+
+    // Tries to grow the block at p, currently holding n objects, to at least new_n objects without
+    // moving it. Returns the new capacity on success and 0 if the allocator cannot (or does not
+    // know how to) expand in place.
+    static constexpr size_type try_expand(Alloc& a, pointer p, size_type n, size_type new_n) noexcept {
+        if constexpr (requires { a.try_expand(p, n, new_n); }) {
+            return a.try_expand(p, n, new_n);
+        } else {
+            return 0;
+        }
+    }
+
+    static constexpr void deallocate(Alloc& a, pointer p, size_type n) noexcept {
+        a.deallocate(p, n);
+    }
+
+    template <typename T, typename... Args>
+    static constexpr void construct(Alloc& a, T* p, Args&&... args) {
+        if constexpr (requires { a.construct(p, mystl::forward<Args>(args)...); }) {
+            a.construct(p, mystl::forward<Args>(args)...);
+        } else {
+            mystl::construct_at(p, mystl::forward<Args>(args)...);
+        }
+    }
+
+    template <typename T>
+    static constexpr void destroy(Alloc& a, T* p) noexcept {
+        if constexpr (requires { a.destroy(p); }) {
+            a.destroy(p);
+        } else {
+            mystl::destroy_at(p);
+        }
+    }
+
+    static constexpr size_type max_size(const Alloc& a) noexcept {
+        if constexpr (requires { a.max_size(); }) {
+            return a.max_size();
+        } else {
+            return std::numeric_limits<size_type>::max() / sizeof(value_type);
+        }
+    }
+
+    static constexpr Alloc select_on_container_copy_construction(const Alloc& a) {
+        if constexpr (requires { a.select_on_container_copy_construction(); }) {
+            return a.select_on_container_copy_construction();
+        } else {
+            return a;
+        }
+    }
+};
+
+namespace detail {
+    template <typename T>
+    inline constexpr bool is_over_aligned_v = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    // operator new hands out blocks in multiples of the default new alignment, so rounding the
+    // request up to that granule gives the caller capacity it would otherwise lose to padding.
+    template <typename T>
+    constexpr size_t round_up_to_new_granule(size_t n) noexcept {
+        constexpr size_t granule = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        if constexpr (sizeof(T) >= granule) {
+            return n;
+        } else {
+            const size_t bytes = (n * sizeof(T) + granule - 1) & ~(granule - 1);
+            return bytes / sizeof(T);
+        }
+    }
+}
+
+template <typename T>
+class allocator {
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = true_type;
+    using is_always_equal                        = true_type;
+
+    constexpr allocator() noexcept = default;
+    constexpr allocator(const allocator&) noexcept = default;
+
+    template <typename U>
+    constexpr allocator(const allocator<U>&) noexcept {}
+
+    constexpr ~allocator() = default;
+
+    constexpr allocator& operator=(const allocator&) = default;
+
+    [[nodiscard]] T* allocate(size_t n) {
+        static_assert(sizeof(T) != 0, "cannot allocate incomplete types");
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        if constexpr (detail::is_over_aligned_v<T>) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        } else {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+    }
+
+    [[nodiscard]] allocation_result<T*> allocate_at_least(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        const size_t count = detail::round_up_to_new_granule<T>(n);
+        return {allocate(count), count};
+    }
+
+    // n must be the count passed to allocate or returned by allocate_at_least; it is forwarded to
+    // sized operator delete so the underlying allocator can skip its size lookup.
+    void deallocate(T* p, size_t n) noexcept {
+        if constexpr (detail::is_over_aligned_v<T>) {
+            ::operator delete(p, n * sizeof(T), std::align_val_t{alignof(T)});
+        } else {
+            ::operator delete(p, n * sizeof(T));
+        }
+    }
+
+    static constexpr size_t max_size() noexcept {
+        return static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+    }
+};
+
+template <typename T, typename U>
+constexpr bool operator==(const allocator<T>&, const allocator<U>&) noexcept {
+    return true;
+}
+
+// Moves *source into the uninitialized storage at dest and ends the lifetime of *source.
+// Trivially relocatable types are transferred with a single memmove.
+template <typename T>
+    requires(is_trivially_relocatable_v<T> ||
+             (is_move_constructible_v<T> && is_destructible<T>::value))
+constexpr T* relocate_at(T* source, T* dest) noexcept(is_trivially_relocatable_v<T> ||
+                                                      is_nothrow_move_constructible_v<T>) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!mystl::is_constant_evaluated()) {
+            std::memmove(static_cast<void*>(dest), static_cast<const void*>(source), sizeof(T));
+            return std::launder(dest);
+        }
+    }
+    T* result = mystl::construct_at(dest, mystl::move(*source));
+    mystl::destroy_at(source);
+    return result;
+}
+
+// Relocates [first, last) into the uninitialized storage starting at d_first. Afterwards the
+// source range holds no live objects. If a move constructor throws, every object in both the
+// source and the destination range is destroyed before the exception propagates.
+template <typename T>
+constexpr T* uninitialized_relocate(T* first, T* last, T* d_first) noexcept(
+    is_trivially_relocatable_v<T> || is_nothrow_move_constructible_v<T>) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!mystl::is_constant_evaluated()) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n != 0) {
+                std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first),
+                             n * sizeof(T));
+            }
+            return d_first + n;
+        }
+    }
+    if constexpr (is_nothrow_move_constructible_v<T> || is_trivially_relocatable_v<T>) {
+        for (; first != last; ++first, (void)++d_first) {
+            mystl::construct_at(d_first, mystl::move(*first));
+            mystl::destroy_at(first);
+        }
+        return d_first;
+    } else {
+        T* current = d_first;
+        try {
+            for (; first != last; ++first, (void)++current) {
+                mystl::construct_at(current, mystl::move(*first));
+                mystl::destroy_at(first);
+            }
+            return current;
+        } catch (...) {
+            mystl::destroy(first, last);
+            mystl::destroy(d_first, current);
+            throw;
+        }
+    }
+}
+
+template <typename T, typename Size>
+constexpr T* uninitialized_relocate_n(T* first, Size n, T* d_first) noexcept(
+    is_trivially_relocatable_v<T> || is_nothrow_move_constructible_v<T>) {
+    return mystl::uninitialized_relocate(first, first + n, d_first);
+}
+
+
+template <typename T>
+struct default_delete {
+    constexpr default_delete() noexcept = default;
+
+    template <typename U>
+        requires is_convertible_v<U*, T*>
+    constexpr default_delete(const default_delete<U>&) noexcept {}
+
+    constexpr void operator()(T* p) const noexcept {
+        static_assert(sizeof(T) > 0, "cannot delete an incomplete type");
+        delete p;
+    }
+};
+
+template <typename T>
+struct default_delete<T[]> {
+    constexpr default_delete() noexcept = default;
+
+    template <typename U>
+        requires is_convertible_v<U (*)[], T (*)[]>
+    constexpr default_delete(const default_delete<U[]>&) noexcept {}
+
+    template <typename U>
+        requires is_convertible_v<U (*)[], T (*)[]>
+    constexpr void operator()(U* p) const noexcept {
+        static_assert(sizeof(U) > 0, "cannot delete an incomplete type");
+        delete[] p;
+    }
+};
+
+namespace detail {
+    template <typename T, typename D>
+    struct unique_ptr_pointer {
+        using type = remove_extent_t<T>*;
+    };
+
+    template <typename T, typename D>
+        requires requires { typename remove_reference_t<D>::pointer; }
+    struct unique_ptr_pointer<T, D> {
+        using type = typename remove_reference_t<D>::pointer;
+    };
+}  // namespace detail
+
+// Sole owner of an object (or, for T[], an array) released through D. The pointer and the
+// deleter share a compressed_pair, so with a stateless deleter a unique_ptr is exactly one
+// pointer, and it is trivially relocatable whenever the pointer and deleter are.
+template <typename T, typename D = default_delete<T>>
+class unique_ptr {
+public:
+    using pointer = typename detail::unique_ptr_pointer<T, D>::type;
+    using element_type = remove_extent_t<T>;
+    using deleter_type = D;
+    using trivially_relocatable =
+        bool_constant<is_trivially_relocatable_v<pointer> && is_trivially_relocatable_v<D>>;
+
+    constexpr unique_ptr() noexcept
+        requires(is_default_constructible_v<D> && !is_pointer_v<D>)
+        : p_(pointer(), D()) {}
+
+    constexpr unique_ptr(nullptr_t) noexcept
+        requires(is_default_constructible_v<D> && !is_pointer_v<D>)
+        : unique_ptr() {}
+
+    constexpr explicit unique_ptr(pointer p) noexcept
+        requires(is_default_constructible_v<D> && !is_pointer_v<D>)
+        : p_(p, D()) {}
+
+    template <typename E>
+        requires(is_constructible_v<D, E>)
+    constexpr unique_ptr(pointer p, E&& d) noexcept : p_(p, mystl::forward<E>(d)) {}
+
+    constexpr unique_ptr(unique_ptr&& other) noexcept
+        : p_(other.release(), mystl::forward<D>(other.get_deleter())) {}
+
+    template <typename U, typename E>
+        requires(is_array_v<U> == is_array_v<T> &&
+                 is_convertible_v<typename unique_ptr<U, E>::pointer, pointer> &&
+                 (!is_array_v<T> || is_same_v<remove_cv_t<remove_extent_t<U>>,
+                                              remove_cv_t<element_type>>) &&
+                 (is_reference_v<D> ? is_same_v<E, D> : is_convertible_v<E, D>))
+    constexpr unique_ptr(unique_ptr<U, E>&& other) noexcept
+        : p_(other.release(), mystl::forward<E>(other.get_deleter())) {}
+
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+
+    constexpr ~unique_ptr() { reset(); }
+
+    constexpr unique_ptr& operator=(unique_ptr&& other) noexcept {
+        reset(other.release());
+        get_deleter() = mystl::forward<D>(other.get_deleter());
+        return *this;
+    }
+
+    template <typename U, typename E>
+        requires(is_constructible_v<unique_ptr, unique_ptr<U, E>&&> && is_assignable_v<D&, E &&>)
+    constexpr unique_ptr& operator=(unique_ptr<U, E>&& other) noexcept {
+        reset(other.release());
+        get_deleter() = mystl::forward<E>(other.get_deleter());
+        return *this;
+    }
+
+    constexpr unique_ptr& operator=(nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    constexpr pointer release() noexcept { return mystl::exchange(p_.first, pointer()); }
+
+    constexpr void reset(pointer p = pointer()) noexcept {
+        pointer old = mystl::exchange(p_.first, p);
+        if (old) {
+            p_.second(old);
+        }
+    }
+
+    constexpr void swap(unique_ptr& other) noexcept { mystl::swap(p_, other.p_); }
+
+    friend constexpr void swap(unique_ptr& a, unique_ptr& b) noexcept { a.swap(b); }
+
+    constexpr pointer get() const noexcept { return p_.first; }
+    constexpr D& get_deleter() noexcept { return p_.second; }
+    constexpr const D& get_deleter() const noexcept { return p_.second; }
+
+    constexpr explicit operator bool() const noexcept { return static_cast<bool>(p_.first); }
+
+    constexpr add_lvalue_reference_t<T> operator*() const
+        noexcept(noexcept(*mystl::declval<pointer>()))
+        requires(!is_array_v<T>)
+    {
+        return *p_.first;
+    }
+
+    constexpr pointer operator->() const noexcept
+        requires(!is_array_v<T>)
+    {
+        return p_.first;
+    }
+
+    constexpr element_type& operator[](size_t i) const
+        requires is_array_v<T>
+    {
+        return p_.first[i];
+    }
+
+private:
+    compressed_pair<pointer, D> p_;
+};
+
+template <typename T1, typename D1, typename T2, typename D2>
+constexpr bool operator==(const unique_ptr<T1, D1>& a, const unique_ptr<T2, D2>& b) {
+    return a.get() == b.get();
+}
+
+template <typename T1, typename D1, typename T2, typename D2>
+constexpr auto operator<=>(const unique_ptr<T1, D1>& a, const unique_ptr<T2, D2>& b) {
+    return std::compare_three_way()(a.get(), b.get());
+}
+
+template <typename T, typename D>
+constexpr bool operator==(const unique_ptr<T, D>& p, nullptr_t) noexcept {
+    return !p;
+}
+
+template <typename T, typename D>
+constexpr auto operator<=>(const unique_ptr<T, D>& p, nullptr_t) {
+    using pointer = typename unique_ptr<T, D>::pointer;
+    return std::compare_three_way()(p.get(), static_cast<pointer>(nullptr));
+}
+
+template <typename T, typename... Args>
+    requires(!is_array_v<T>)
+constexpr unique_ptr<T> make_unique(Args&&... args) {
+    return unique_ptr<T>(new T(mystl::forward<Args>(args)...));
+}
+
+template <typename T>
+    requires is_unbounded_array_v<T>
+constexpr unique_ptr<T> make_unique(size_t n) {
+    return unique_ptr<T>(new remove_extent_t<T>[n]());
+}
+
+// Default-initializes instead of value-initializing: trivial types are left uninitialized.
+template <typename T>
+    requires(!is_array_v<T>)
+constexpr unique_ptr<T> make_unique_for_overwrite() {
+    return unique_ptr<T>(new T);
+}
+
+template <typename T>
+    requires is_unbounded_array_v<T>
+constexpr unique_ptr<T> make_unique_for_overwrite(size_t n) {
+    return unique_ptr<T>(new remove_extent_t<T>[n]);
+}
+
+class bad_weak_ptr : public std::exception {
+public:
+    const char* what() const noexcept override { return "mystl::bad_weak_ptr"; }
+};
+
+namespace detail {
+    // Reference counts. The atomic flavour increments with relaxed ordering and decrements with
+    // acq_rel, so the thread that drops the last reference sees every other owner's writes; the
+    // local flavour is a plain integer for objects that never leave one thread.
+    template <bool Atomic>
+    class ref_count {
+    public:
+        explicit ref_count(long n) noexcept : n_(n) {}
+
+        long get() const noexcept { return n_.load(std::memory_order_relaxed); }
+
+        void increment() noexcept { n_.fetch_add(1, std::memory_order_relaxed); }
+
+        // True when this dropped the count to zero.
+        bool decrement() noexcept { return n_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+        bool increment_if_nonzero() noexcept {
+            long n = n_.load(std::memory_order_relaxed);
+            while (n != 0) {
+                if (n_.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::atomic<long> n_;
+    };
+
+    template <>
+    class ref_count<false> {
+    public:
+        explicit ref_count(long n) noexcept : n_(n) {}
+
+        long get() const noexcept { return n_; }
+        void increment() noexcept { ++n_; }
+        bool decrement() noexcept { return --n_ == 0; }
+
+        bool increment_if_nonzero() noexcept {
+            if (n_ == 0) {
+                return false;
+            }
+            ++n_;
+            return true;
+        }
+
+    private:
+        long n_;
+    };
+
+    // Shared state of a group of shared_ptrs and weak_ptrs. The owners together hold one weak
+    // reference, so the block is freed when the last weak_ptr goes or, with none, right after
+    // the object is destroyed.
+    template <bool Atomic>
+    class shared_control {
+    public:
+        shared_control() noexcept : uses_(1), weaks_(1) {}
+
+        shared_control(const shared_control&) = delete;
+        shared_control& operator=(const shared_control&) = delete;
+
+        void add_ref() noexcept { uses_.increment(); }
+        bool try_add_ref() noexcept { return uses_.increment_if_nonzero(); }
+        void add_weak() noexcept { weaks_.increment(); }
+        long use_count() const noexcept { return uses_.get(); }
+
+        void release() noexcept {
+            if (uses_.decrement()) {
+                dispose_();
+                release_weak();
+            }
+        }
+
+        void release_weak() noexcept {
+            if (weaks_.decrement()) {
+                destroy_();
+            }
+        }
+
+    protected:
+        ~shared_control() = default;
+
+        // Destroys the managed object.
+        virtual void dispose_() noexcept = 0;
+        // Destroys and frees the control block itself.
+        virtual void destroy_() noexcept = 0;
+
+    private:
+        ref_count<Atomic> uses_;
+        ref_count<Atomic> weaks_;
+    };
+
+    // Frees a control block of type Block with (a rebound copy of) alloc.
+    template <typename Block, typename Alloc>
+    void shared_control_free(Block* block, const Alloc& alloc) noexcept {
+        using block_alloc = typename allocator_traits<Alloc>::template rebind_alloc<Block>;
+        using traits = allocator_traits<block_alloc>;
+        block_alloc a(alloc);
+        auto p = pointer_traits<typename traits::pointer>::pointer_to(*block);
+        block->~Block();
+        traits::deallocate(a, p, 1);
+    }
+
+    // Block for an object allocated separately, released through a deleter.
+    template <bool Atomic, typename P, typename D, typename Alloc>
+    class shared_control_ptr final : public shared_control<Atomic> {
+    public:
+        shared_control_ptr(P p, D d, const Alloc& a) noexcept
+            : p_(p), d_(mystl::move(d)), alloc_(a) {}
+
+    private:
+        void dispose_() noexcept override { d_(p_); }
+        void destroy_() noexcept override { shared_control_free(this, Alloc(alloc_)); }
+
+        P p_;
+        [[no_unique_address]] D d_;
+        [[no_unique_address]] Alloc alloc_;
+    };
+
+    // Block with the object inside it: make_shared and allocate_shared allocate once.
+    template <bool Atomic, typename T, typename Alloc>
+    class shared_control_inplace final : public shared_control<Atomic> {
+        using value_alloc = typename allocator_traits<Alloc>::template rebind_alloc<remove_cv_t<T>>;
+
+    public:
+        template <typename... Args>
+        explicit shared_control_inplace(const Alloc& a, Args&&... args) : alloc_(a) {
+            value_alloc va(alloc_);
+            allocator_traits<value_alloc>::construct(va, get(), mystl::forward<Args>(args)...);
+        }
+
+        remove_cv_t<T>* get() noexcept {
+            return std::launder(reinterpret_cast<remove_cv_t<T>*>(storage_));
+        }
+
+    private:
+        void dispose_() noexcept override {
+            value_alloc va(alloc_);
+            allocator_traits<value_alloc>::destroy(va, get());
+        }
+
+        void destroy_() noexcept override { shared_control_free(this, Alloc(alloc_)); }
+
+        [[no_unique_address]] Alloc alloc_;
+        alignas(T) unsigned char storage_[sizeof(T)];
+    };
+
+    // A Y* can be owned by a shared_ptr<T> (T may be U[]).
+    template <typename Y, typename T>
+    concept shared_ptr_owns =
+        (is_array_v<T> ? is_convertible_v<Y (*)[], T*> : is_convertible_v<Y*, T*>);
+
+    template <typename D, typename P>
+    concept shared_ptr_deleter = is_move_constructible_v<D> && requires(D& d, P p) { d(p); };
+
+    struct shared_ptr_access;
+}  // namespace detail
+
+template <typename T, bool Atomic>
+class basic_weak_ptr;
+
+template <typename T, bool Atomic>
+class basic_enable_shared_from_this;
+
+// Reference-counted shared ownership. shared_ptr (Atomic = true) may be copied and released
+// from any thread; local_shared_ptr (Atomic = false) counts with plain increments and must stay
+// on one thread. The object pointer and the control block pointer are separate, so aliasing and
+// pointer casts are free, and moving one is a copy of two words with no count traffic.
+template <typename T, bool Atomic>
+class basic_shared_ptr {
+    using control = detail::shared_control<Atomic>;
+
+public:
+    using element_type = remove_extent_t<T>;
+    using weak_type = basic_weak_ptr<T, Atomic>;
+    using trivially_relocatable = true_type;
+
+    constexpr basic_shared_ptr() noexcept = default;
+
+    constexpr basic_shared_ptr(nullptr_t) noexcept {}
+
+    template <typename Y>
+        requires detail::shared_ptr_owns<Y, T>
+    explicit basic_shared_ptr(Y* p)
+        : basic_shared_ptr(p, default_delete<conditional_t<is_array_v<T>, Y[], Y>>()) {}
+
+    template <typename Y, typename D>
+        requires(detail::shared_ptr_owns<Y, T> && detail::shared_ptr_deleter<D, Y*>)
+    basic_shared_ptr(Y* p, D d) : basic_shared_ptr(p, mystl::move(d), allocator<char>()) {}
+
+    // If allocating the control block throws, d(p) is called.
+    template <typename Y, typename D, typename Alloc>
+        requires(detail::shared_ptr_owns<Y, T> && detail::shared_ptr_deleter<D, Y*>)
+    basic_shared_ptr(Y* p, D d, Alloc a) : ptr_(p) {
+        ctrl_ = make_control_(p, d, a);
+        enable_weak_this_(p);
+    }
+
+    template <typename D>
+        requires detail::shared_ptr_deleter<D, nullptr_t>
+    basic_shared_ptr(nullptr_t, D d)
+        : basic_shared_ptr(nullptr, mystl::move(d), allocator<char>()) {}
+
+    template <typename D, typename Alloc>
+        requires detail::shared_ptr_deleter<D, nullptr_t>
+    basic_shared_ptr(nullptr_t, D d, Alloc a) {
+        ctrl_ = make_control_(nullptr, d, a);
+    }
+
+    // Aliasing: shares r's ownership but points at p, typically a member of *r.
+    template <typename Y>
+    basic_shared_ptr(const basic_shared_ptr<Y, Atomic>& r, element_type* p) noexcept
+        : ptr_(p), ctrl_(r.ctrl_) {
+        if (ctrl_) {
+            ctrl_->add_ref();
+        }
+    }
+
+    template <typename Y>
+    basic_shared_ptr(basic_shared_ptr<Y, Atomic>&& r, element_type* p) noexcept
+        : ptr_(p), ctrl_(mystl::exchange(r.ctrl_, nullptr)) {
+        r.ptr_ = nullptr;
+    }
+
+    basic_shared_ptr(const basic_shared_ptr& r) noexcept : ptr_(r.ptr_), ctrl_(r.ctrl_) {
+        if (ctrl_) {
+            ctrl_->add_ref();
+        }
+    }
+
+    basic_shared_ptr(basic_shared_ptr&& r) noexcept
+        : ptr_(mystl::exchange(r.ptr_, nullptr)), ctrl_(mystl::exchange(r.ctrl_, nullptr)) {}
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_shared_ptr(const basic_shared_ptr<Y, Atomic>& r) noexcept
+        : basic_shared_ptr(r, r.get()) {}
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_shared_ptr(basic_shared_ptr<Y, Atomic>&& r) noexcept
+        : ptr_(mystl::exchange(r.ptr_, nullptr)), ctrl_(mystl::exchange(r.ctrl_, nullptr)) {}
+
+    // Throws bad_weak_ptr if r has expired.
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    explicit basic_shared_ptr(const basic_weak_ptr<Y, Atomic>& r) : ptr_(r.ptr_), ctrl_(r.ctrl_) {
+        if (!ctrl_ || !ctrl_->try_add_ref()) {
+            throw bad_weak_ptr();
+        }
+    }
+
+    template <typename Y, typename D>
+        requires(is_convertible_v<typename unique_ptr<Y, D>::pointer, element_type*> &&
+                 !is_reference_v<D>)
+    basic_shared_ptr(unique_ptr<Y, D>&& r) {
+        if (r) {
+            // r keeps ownership until the control block exists, so a failed allocation leaves
+            // it untouched.
+            typename unique_ptr<Y, D>::pointer p = r.get();
+            ctrl_ = new_control_(p, r.get_deleter(), allocator<char>());
+            ptr_ = r.release();
+            enable_weak_this_(mystl::to_address(p));
+        }
+    }
+
+    ~basic_shared_ptr() {
+        if (ctrl_) {
+            ctrl_->release();
+        }
+    }
+
+    basic_shared_ptr& operator=(const basic_shared_ptr& r) noexcept {
+        basic_shared_ptr(r).swap(*this);
+        return *this;
+    }
+
+    basic_shared_ptr& operator=(basic_shared_ptr&& r) noexcept {
+        basic_shared_ptr(mystl::move(r)).swap(*this);
+        return *this;
+    }
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_shared_ptr& operator=(const basic_shared_ptr<Y, Atomic>& r) noexcept {
+        basic_shared_ptr(r).swap(*this);
+        return *this;
+    }
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_shared_ptr& operator=(basic_shared_ptr<Y, Atomic>&& r) noexcept {
+        basic_shared_ptr(mystl::move(r)).swap(*this);
+        return *this;
+    }
+
+    template <typename Y, typename D>
+        requires is_constructible_v<basic_shared_ptr, unique_ptr<Y, D>&&>
+    basic_shared_ptr& operator=(unique_ptr<Y, D>&& r) {
+        basic_shared_ptr(mystl::move(r)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { basic_shared_ptr().swap(*this); }
+
+    template <typename Y, typename... Rest>
+        requires is_constructible_v<basic_shared_ptr, Y*, Rest...>
+    void reset(Y* p, Rest... rest) {
+        basic_shared_ptr(p, mystl::move(rest)...).swap(*this);
+    }
+
+    void swap(basic_shared_ptr& r) noexcept {
+        mystl::swap(ptr_, r.ptr_);
+        mystl::swap(ctrl_, r.ctrl_);
+    }
+
+    friend void swap(basic_shared_ptr& a, basic_shared_ptr& b) noexcept { a.swap(b); }
+
+    element_type* get() const noexcept { return ptr_; }
+
+    add_lvalue_reference_t<T> operator*() const noexcept
+        requires(!is_array_v<T>)
+    {
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept
+        requires(!is_array_v<T>)
+    {
+        return ptr_;
+    }
+
+    element_type& operator[](std::ptrdiff_t i) const
+        requires is_array_v<T>
+    {
+        return ptr_[i];
+    }
+
+    long use_count() const noexcept { return ctrl_ ? ctrl_->use_count() : 0; }
+
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    // Orders by control block, so aliases of one object compare equivalent.
+    template <typename Y>
+    bool owner_before(const basic_shared_ptr<Y, Atomic>& r) const noexcept {
+        return std::less<const void*>()(ctrl_, r.ctrl_);
+    }
+
+    template <typename Y>
+    bool owner_before(const basic_weak_ptr<Y, Atomic>& r) const noexcept {
+        return std::less<const void*>()(ctrl_, r.ctrl_);
+    }
+
+private:
+    template <typename, bool>
+    friend class basic_shared_ptr;
+    template <typename, bool>
+    friend class basic_weak_ptr;
+    friend struct detail::shared_ptr_access;
+
+    // Takes over a control block whose use count already accounts for this pointer.
+    basic_shared_ptr(element_type* p, control* ctrl) noexcept : ptr_(p), ctrl_(ctrl) {}
+
+    // Moves d into a new control block for p. Neither p nor d is touched if the allocation
+    // throws.
+    template <typename P, typename D, typename Alloc>
+    static control* new_control_(P p, D& d, const Alloc& a) {
+        using block = detail::shared_control_ptr<Atomic, P, D, Alloc>;
+        using block_alloc = typename allocator_traits<Alloc>::template rebind_alloc<block>;
+        using traits = allocator_traits<block_alloc>;
+        block_alloc ba(a);
+        block* b = mystl::to_address(traits::allocate(ba, 1));
+        return ::new (static_cast<void*>(b)) block(p, mystl::move(d), a);
+    }
+
+    // As new_control_, but calls d(p) before rethrowing if the allocation fails.
+    template <typename P, typename D, typename Alloc>
+    static control* make_control_(P p, D& d, const Alloc& a) {
+        try {
+            return new_control_(p, d, a);
+        } catch (...) {
+            d(p);
+            throw;
+        }
+    }
+
+    // Points the weak_this of an enable_shared_from_this base of *p, if there is an unambiguous
+    // one and it is not owned yet, at this group.
+    template <typename Y>
+    void enable_weak_this_(Y* p) noexcept {
+        if constexpr (requires { enable_shared_from_this_base_(p); }) {
+            auto* base = enable_shared_from_this_base_(p);
+            if (base && base->weak_this_.expired()) {
+                // An expired link still holds a weak reference to its old group.
+                base->weak_this_.ptr_ = const_cast<remove_cv_t<Y>*>(p);
+                ctrl_->add_weak();
+                if (control* old = mystl::exchange(base->weak_this_.ctrl_, ctrl_)) {
+                    old->release_weak();
+                }
+            }
+        }
+    }
+
+    template <typename U>
+    static const basic_enable_shared_from_this<U, Atomic>* enable_shared_from_this_base_(
+        const basic_enable_shared_from_this<U, Atomic>* p) noexcept {
+        return p;
+    }
+
+    element_type* ptr_ = nullptr;
+    control* ctrl_ = nullptr;
+};
+
+// Non-owning observer of a basic_shared_ptr group; lock() gives temporary ownership if the
+// object is still alive. Keeps the control block, not the object, alive.
+template <typename T, bool Atomic>
+class basic_weak_ptr {
+    using control = detail::shared_control<Atomic>;
+
+public:
+    using element_type = remove_extent_t<T>;
+    using trivially_relocatable = true_type;
+
+    constexpr basic_weak_ptr() noexcept = default;
+
+    basic_weak_ptr(const basic_weak_ptr& r) noexcept : ptr_(r.ptr_), ctrl_(r.ctrl_) {
+        if (ctrl_) {
+            ctrl_->add_weak();
+        }
+    }
+
+    basic_weak_ptr(basic_weak_ptr&& r) noexcept
+        : ptr_(mystl::exchange(r.ptr_, nullptr)), ctrl_(mystl::exchange(r.ctrl_, nullptr)) {}
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_weak_ptr(const basic_shared_ptr<Y, Atomic>& r) noexcept : ptr_(r.ptr_), ctrl_(r.ctrl_) {
+        if (ctrl_) {
+            ctrl_->add_weak();
+        }
+    }
+
+    // Converting from a weak_ptr<Y> goes through lock(): Y* to T* may need the object (a virtual
+    // base), which may already be gone.
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_weak_ptr(const basic_weak_ptr<Y, Atomic>& r) noexcept : ctrl_(r.ctrl_) {
+        if (ctrl_) {
+            ptr_ = r.lock().get();
+            ctrl_->add_weak();
+        }
+    }
+
+    ~basic_weak_ptr() {
+        if (ctrl_) {
+            ctrl_->release_weak();
+        }
+    }
+
+    basic_weak_ptr& operator=(const basic_weak_ptr& r) noexcept {
+        basic_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    basic_weak_ptr& operator=(basic_weak_ptr&& r) noexcept {
+        basic_weak_ptr(mystl::move(r)).swap(*this);
+        return *this;
+    }
+
+    template <typename Y>
+        requires is_convertible_v<Y*, T*>
+    basic_weak_ptr& operator=(const basic_shared_ptr<Y, Atomic>& r) noexcept {
+        basic_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { basic_weak_ptr().swap(*this); }
+
+    void swap(basic_weak_ptr& r) noexcept {
+        mystl::swap(ptr_, r.ptr_);
+        mystl::swap(ctrl_, r.ctrl_);
+    }
+
+    friend void swap(basic_weak_ptr& a, basic_weak_ptr& b) noexcept { a.swap(b); }
+
+    long use_count() const noexcept { return ctrl_ ? ctrl_->use_count() : 0; }
+
+    bool expired() const noexcept { return use_count() == 0; }
+
+    basic_shared_ptr<T, Atomic> lock() const noexcept {
+        if (ctrl_ && ctrl_->try_add_ref()) {
+            return basic_shared_ptr<T, Atomic>(ptr_, ctrl_);
+        }
+        return basic_shared_ptr<T, Atomic>();
+    }
+
+    template <typename Y>
+    bool owner_before(const basic_shared_ptr<Y, Atomic>& r) const noexcept {
+        return std::less<const void*>()(ctrl_, r.ctrl_);
+    }
+
+    template <typename Y>
+    bool owner_before(const basic_weak_ptr<Y, Atomic>& r) const noexcept {
+        return std::less<const void*>()(ctrl_, r.ctrl_);
+    }
+
+private:
+    template <typename, bool>
+    friend class basic_shared_ptr;
+    template <typename, bool>
+    friend class basic_weak_ptr;
+
+    element_type* ptr_ = nullptr;
+    control* ctrl_ = nullptr;
+};
+
+// Base for classes that need a shared_ptr to themselves from inside a member function. The
+// link is set when the object is first owned by a basic_shared_ptr of the same flavour.
+template <typename T, bool Atomic>
+class basic_enable_shared_from_this {
+public:
+    basic_shared_ptr<T, Atomic> shared_from_this() {
+        return basic_shared_ptr<T, Atomic>(weak_this_);
+    }
+
+    basic_shared_ptr<const T, Atomic> shared_from_this() const {
+        return basic_shared_ptr<const T, Atomic>(weak_this_);
+    }
+
+    basic_weak_ptr<T, Atomic> weak_from_this() noexcept { return weak_this_; }
+
+    basic_weak_ptr<const T, Atomic> weak_from_this() const noexcept { return weak_this_; }
+
+protected:
+    constexpr basic_enable_shared_from_this() noexcept = default;
+
+    // Copies get their own link, set when they are owned.
+    basic_enable_shared_from_this(const basic_enable_shared_from_this&) noexcept {}
+
+    basic_enable_shared_from_this& operator=(const basic_enable_shared_from_this&) noexcept {
+        return *this;
+    }
+
+    ~basic_enable_shared_from_this() = default;
+
+private:
+    template <typename, bool>
+    friend class basic_shared_ptr;
+
+    mutable basic_weak_ptr<T, Atomic> weak_this_;
+};
+
+template <typename T>
+using shared_ptr = basic_shared_ptr<T, true>;
+
+template <typename T>
+using weak_ptr = basic_weak_ptr<T, true>;
+
+template <typename T>
+using enable_shared_from_this = basic_enable_shared_from_this<T, true>;
+
+template <typename T>
+using local_shared_ptr = basic_shared_ptr<T, false>;
+
+template <typename T>
+using local_weak_ptr = basic_weak_ptr<T, false>;
+
+template <typename T>
+using enable_local_shared_from_this = basic_enable_shared_from_this<T, false>;
+
+namespace detail {
+    struct shared_ptr_access {
+        template <typename T, bool Atomic, typename Alloc, typename... Args>
+        static basic_shared_ptr<T, Atomic> allocate(const Alloc& a, Args&&... args) {
+            using block = shared_control_inplace<Atomic, T, Alloc>;
+            using block_alloc = typename allocator_traits<Alloc>::template rebind_alloc<block>;
+            using traits = allocator_traits<block_alloc>;
+            block_alloc ba(a);
+            auto mem = traits::allocate(ba, 1);
+            block* b = mystl::to_address(mem);
+            try {
+                ::new (static_cast<void*>(b)) block(a, mystl::forward<Args>(args)...);
+            } catch (...) {
+                traits::deallocate(ba, mem, 1);
+                throw;
+            }
+            basic_shared_ptr<T, Atomic> result(b->get(), static_cast<shared_control<Atomic>*>(b));
+            result.enable_weak_this_(b->get());
+            return result;
+        }
+    };
+}  // namespace detail
+
+// One allocation holds both the control block and the object.
+template <typename T, typename... Args>
+    requires(!is_array_v<T>)
+shared_ptr<T> make_shared(Args&&... args) {
+    return detail::shared_ptr_access::allocate<T, true>(allocator<char>(),
+                                                        mystl::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+    requires(!is_array_v<T>)
+shared_ptr<T> allocate_shared(const Alloc& a, Args&&... args) {
+    return detail::shared_ptr_access::allocate<T, true>(a, mystl::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+    requires(!is_array_v<T>)
+local_shared_ptr<T> make_local_shared(Args&&... args) {
+    return detail::shared_ptr_access::allocate<T, false>(allocator<char>(),
+                                                         mystl::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+    requires(!is_array_v<T>)
+local_shared_ptr<T> allocate_local_shared(const Alloc& a, Args&&... args) {
+    return detail::shared_ptr_access::allocate<T, false>(a, mystl::forward<Args>(args)...);
+}
+
+template <typename T, typename U, bool Atomic>
+bool operator==(const basic_shared_ptr<T, Atomic>& a,
+                const basic_shared_ptr<U, Atomic>& b) noexcept {
+    return a.get() == b.get();
+}
+
+template <typename T, typename U, bool Atomic>
+auto operator<=>(const basic_shared_ptr<T, Atomic>& a,
+                 const basic_shared_ptr<U, Atomic>& b) noexcept {
+    return std::compare_three_way()(a.get(), b.get());
+}
+
+template <typename T, bool Atomic>
+bool operator==(const basic_shared_ptr<T, Atomic>& p, nullptr_t) noexcept {
+    return !p;
+}
+
+template <typename T, bool Atomic>
+auto operator<=>(const basic_shared_ptr<T, Atomic>& p, nullptr_t) noexcept {
+    return std::compare_three_way()(p.get(), static_cast<decltype(p.get())>(nullptr));
+}
+
+template <typename T, typename U, bool Atomic>
+basic_shared_ptr<T, Atomic> static_pointer_cast(const basic_shared_ptr<U, Atomic>& r) noexcept {
+    return basic_shared_ptr<T, Atomic>(r, static_cast<remove_extent_t<T>*>(r.get()));
+}
+
+template <typename T, typename U, bool Atomic>
+basic_shared_ptr<T, Atomic> const_pointer_cast(const basic_shared_ptr<U, Atomic>& r) noexcept {
+    return basic_shared_ptr<T, Atomic>(r, const_cast<remove_extent_t<T>*>(r.get()));
+}
+
+template <typename T, typename U, bool Atomic>
+basic_shared_ptr<T, Atomic> dynamic_pointer_cast(const basic_shared_ptr<U, Atomic>& r) noexcept {
+    if (auto* p = dynamic_cast<remove_extent_t<T>*>(r.get())) {
+        return basic_shared_ptr<T, Atomic>(r, p);
+    }
+    return basic_shared_ptr<T, Atomic>();
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,620 @@
+#ifndef MYSTL_HANDMADE_MEMORY_RESOURCE_H_
+#define MYSTL_HANDMADE_MEMORY_RESOURCE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "construct.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+namespace pmr {
+
+class memory_resource {
+public:
+    static constexpr size_t max_align = alignof(std::max_align_t);
+
+    memory_resource() = default;
+    memory_resource(const memory_resource&) = default;
+    virtual ~memory_resource() = default;
+
+    memory_resource& operator=(const memory_resource&) = default;
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment = max_align) {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, size_t bytes, size_t alignment = max_align) {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(const memory_resource& other) const noexcept { return do_is_equal(other); }
+
+private:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+    return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+namespace detail {
+
+constexpr size_t align_up(size_t n, size_t alignment) noexcept {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr size_t ceil_log2(size_t n) noexcept {
+    size_t shift = 0;
+    while ((size_t{1} << shift) < n) {
+        ++shift;
+    }
+    return shift;
+}
+
+class new_delete_resource_impl final : public memory_resource {
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, bytes, std::align_val_t{alignment});
+        } else {
+            ::operator delete(p, bytes);
+        }
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+class null_resource_impl final : public memory_resource {
+    void* do_allocate(size_t, size_t) override { throw std::bad_alloc(); }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace detail
+
+inline memory_resource* new_delete_resource() noexcept {
+    static detail::new_delete_resource_impl resource;
+    return &resource;
+}
+
+inline memory_resource* null_memory_resource() noexcept {
+    static detail::null_resource_impl resource;
+    return &resource;
+}
+
+namespace detail {
+inline std::atomic<memory_resource*>& default_resource_slot() noexcept {
+    static std::atomic<memory_resource*> slot{new_delete_resource()};
+    return slot;
+}
+}  // namespace detail
+
+inline memory_resource* get_default_resource() noexcept {
+    return detail::default_resource_slot().load(std::memory_order_acquire);
+}
+
+inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+    return detail::default_resource_slot().exchange(r ? r : new_delete_resource(),
+                                                     std::memory_order_acq_rel);
+}
+
+// Bump-pointer arena. Allocation advances a pointer inside the current chunk; deallocation is a
+// no-op and all memory is returned at once by release() or the destructor. When a chunk runs
+// out, the next one requested from upstream is twice as large as the previous one.
+class monotonic_buffer_resource : public memory_resource {
+public:
+    static constexpr size_t default_initial_size = 1024;
+    static constexpr double growth_factor = 2.0;
+
+    monotonic_buffer_resource() : monotonic_buffer_resource(get_default_resource()) {}
+
+    explicit monotonic_buffer_resource(memory_resource* upstream)
+        : upstream_(upstream), first_chunk_size_(default_initial_size),
+          next_size_(default_initial_size) {}
+
+    explicit monotonic_buffer_resource(size_t initial_size)
+        : monotonic_buffer_resource(initial_size, get_default_resource()) {}
+
+    monotonic_buffer_resource(size_t initial_size, memory_resource* upstream)
+        : upstream_(upstream), first_chunk_size_(initial_size > 0 ? initial_size : 1),
+          next_size_(first_chunk_size_) {}
+
+    monotonic_buffer_resource(void* buffer, size_t buffer_size)
+        : monotonic_buffer_resource(buffer, buffer_size, get_default_resource()) {}
+
+    // Serves allocations from `buffer` first; the caller keeps ownership of it.
+    monotonic_buffer_resource(void* buffer, size_t buffer_size, memory_resource* upstream)
+        : upstream_(upstream),
+          initial_buffer_(static_cast<char*>(buffer)),
+          initial_size_(buffer_size),
+          current_(static_cast<char*>(buffer)),
+          end_(static_cast<char*>(buffer) + buffer_size),
+          first_chunk_size_(next_after(buffer_size)),
+          next_size_(first_chunk_size_) {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+    ~monotonic_buffer_resource() override { release(); }
+
+    // Returns every chunk to upstream and rewinds to the initial buffer, if any.
+    void release() noexcept {
+        while (chunks_ != nullptr) {
+            chunk_header* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->bytes, chunks_->alignment);
+            chunks_ = next;
+        }
+        current_ = initial_buffer_;
+        end_ = initial_buffer_ + initial_size_;
+        next_size_ = first_chunk_size_;
+    }
+
+    memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (void* p = try_bump(bytes, alignment)) {
+            return p;
+        }
+        grow(bytes, alignment);
+        return try_bump(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct chunk_header {
+        chunk_header* next;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    static size_t next_after(size_t size) noexcept {
+        const size_t grown = static_cast<size_t>(static_cast<double>(size) * growth_factor);
+        return grown > default_initial_size ? grown : default_initial_size;
+    }
+
+    void* try_bump(size_t bytes, size_t alignment) noexcept {
+        const uintptr_t cur = reinterpret_cast<uintptr_t>(current_);
+        const uintptr_t aligned = (cur + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+        if (current_ == nullptr || aligned > end || end - aligned < bytes) {
+            return nullptr;
+        }
+        current_ = reinterpret_cast<char*>(aligned + bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void grow(size_t bytes, size_t alignment) {
+        const size_t chunk_align = alignment > max_align ? alignment : max_align;
+        const size_t header = detail::align_up(sizeof(chunk_header), chunk_align);
+        if (bytes > SIZE_MAX - header - max_align) {
+            throw std::bad_alloc();
+        }
+        size_t chunk_bytes = header + bytes;
+        if (chunk_bytes < next_size_) {
+            chunk_bytes = next_size_;
+        }
+        chunk_bytes = detail::align_up(chunk_bytes, max_align);
+
+        void* raw = upstream_->allocate(chunk_bytes, chunk_align);
+        chunks_ = ::new (raw) chunk_header{chunks_, chunk_bytes, chunk_align};
+        current_ = static_cast<char*>(raw) + header;
+        end_ = static_cast<char*>(raw) + chunk_bytes;
+        next_size_ = next_after(chunk_bytes);
+    }
+
+    memory_resource* upstream_;
+    char* initial_buffer_ = nullptr;
+    size_t initial_size_ = 0;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    size_t first_chunk_size_;
+    size_t next_size_;
+    chunk_header* chunks_ = nullptr;
+};
+
+struct pool_options {
+    size_t max_blocks_per_chunk = 0;
+    size_t largest_required_pool_block = 0;
+};
+
+// Segregated free lists, one per power-of-two block size. Requests larger than the largest pool
+// block, or aligned beyond max_align, go straight to upstream. Not thread-safe.
+class unsynchronized_pool_resource : public memory_resource {
+public:
+    static constexpr size_t min_block_size = memory_resource::max_align;
+    static constexpr size_t max_pool_block_size = size_t{1} << 20;
+    static constexpr size_t default_largest_block = 4096;
+    static constexpr size_t default_max_blocks_per_chunk = 1024;
+    static constexpr size_t initial_blocks_per_chunk = 16;
+
+    unsynchronized_pool_resource() : unsynchronized_pool_resource(pool_options{}) {}
+
+    explicit unsynchronized_pool_resource(memory_resource* upstream)
+        : unsynchronized_pool_resource(pool_options{}, upstream) {}
+
+    explicit unsynchronized_pool_resource(const pool_options& opts)
+        : unsynchronized_pool_resource(opts, get_default_resource()) {}
+
+    unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+        : upstream_(upstream), options_(normalize(opts)) {}
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+    unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+    ~unsynchronized_pool_resource() override { release(); }
+
+    void release() noexcept {
+        while (chunks_ != nullptr) {
+            chunk_header* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->bytes, max_align);
+            chunks_ = next;
+        }
+        while (oversized_ != nullptr) {
+            oversized_header* next = oversized_->next;
+            release_oversized(oversized_);
+            oversized_ = next;
+        }
+        for (pool& p : pools_) {
+            p = pool{};
+        }
+    }
+
+    memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    pool_options options() const noexcept { return options_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > options_.largest_required_pool_block || alignment > max_align) {
+            return allocate_oversized(bytes, alignment);
+        }
+        const size_t index = pool_index(bytes);
+        pool& p = pools_[index];
+        if (p.free_list != nullptr) {
+            free_block* block = p.free_list;
+            p.free_list = block->next;
+            return block;
+        }
+        if (p.bump == p.bump_end) {
+            refill(p, index);
+        }
+        void* block = p.bump;
+        p.bump += block_size(index);
+        return block;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        if (bytes > options_.largest_required_pool_block || alignment > max_align) {
+            deallocate_oversized(ptr);
+            return;
+        }
+        pool& p = pools_[pool_index(bytes)];
+        p.free_list = ::new (ptr) free_block{p.free_list};
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr size_t max_pools =
+        detail::ceil_log2(max_pool_block_size) - detail::ceil_log2(min_block_size) + 1;
+
+    struct free_block {
+        free_block* next;
+    };
+
+    struct pool {
+        free_block* free_list = nullptr;
+        char* bump = nullptr;
+        char* bump_end = nullptr;
+        size_t next_blocks = 0;
+    };
+
+    struct alignas(max_align) chunk_header {
+        chunk_header* next;
+        size_t bytes;
+    };
+
+    struct oversized_header {
+        oversized_header* prev;
+        oversized_header* next;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    static pool_options normalize(pool_options opts) noexcept {
+        if (opts.max_blocks_per_chunk == 0 || opts.max_blocks_per_chunk > (size_t{1} << 20)) {
+            opts.max_blocks_per_chunk = default_max_blocks_per_chunk;
+        }
+        if (opts.max_blocks_per_chunk < initial_blocks_per_chunk) {
+            opts.max_blocks_per_chunk = initial_blocks_per_chunk;
+        }
+        if (opts.largest_required_pool_block == 0) {
+            opts.largest_required_pool_block = default_largest_block;
+        }
+        if (opts.largest_required_pool_block < min_block_size) {
+            opts.largest_required_pool_block = min_block_size;
+        }
+        if (opts.largest_required_pool_block > max_pool_block_size) {
+            opts.largest_required_pool_block = max_pool_block_size;
+        }
+        opts.largest_required_pool_block = size_t{1}
+                                           << detail::ceil_log2(opts.largest_required_pool_block);
+        return opts;
+    }
+
+    static size_t pool_index(size_t bytes) noexcept {
+        return bytes <= min_block_size
+                   ? 0
+                   : detail::ceil_log2(bytes) - detail::ceil_log2(min_block_size);
+    }
+
+    static size_t block_size(size_t index) noexcept { return min_block_size << index; }
+
+    void refill(pool& p, size_t index) {
+        if (p.next_blocks == 0) {
+            p.next_blocks = initial_blocks_per_chunk;
+        }
+        const size_t bytes = sizeof(chunk_header) + p.next_blocks * block_size(index);
+        void* raw = upstream_->allocate(bytes, max_align);
+        chunks_ = ::new (raw) chunk_header{chunks_, bytes};
+        p.bump = static_cast<char*>(raw) + sizeof(chunk_header);
+        p.bump_end = static_cast<char*>(raw) + bytes;
+        if (p.next_blocks < options_.max_blocks_per_chunk) {
+            p.next_blocks *= 2;
+            if (p.next_blocks > options_.max_blocks_per_chunk) {
+                p.next_blocks = options_.max_blocks_per_chunk;
+            }
+        }
+    }
+
+    static size_t oversized_offset(size_t alignment) noexcept {
+        return detail::align_up(sizeof(oversized_header), alignment > max_align ? alignment
+                                                                                : max_align);
+    }
+
+    void* allocate_oversized(size_t bytes, size_t alignment) {
+        const size_t align = alignment > max_align ? alignment : max_align;
+        const size_t offset = oversized_offset(alignment);
+        if (bytes > SIZE_MAX - offset) {
+            throw std::bad_alloc();
+        }
+        char* raw = static_cast<char*>(upstream_->allocate(offset + bytes, align));
+        char* user = raw + offset;
+        auto* header = ::new (user - sizeof(oversized_header))
+            oversized_header{nullptr, oversized_, offset + bytes, align};
+        if (oversized_ != nullptr) {
+            oversized_->prev = header;
+        }
+        oversized_ = header;
+        return user;
+    }
+
+    void deallocate_oversized(void* ptr) noexcept {
+        auto* header = reinterpret_cast<oversized_header*>(static_cast<char*>(ptr) -
+                                                           sizeof(oversized_header));
+        if (header->prev != nullptr) {
+            header->prev->next = header->next;
+        } else {
+            oversized_ = header->next;
+        }
+        if (header->next != nullptr) {
+            header->next->prev = header->prev;
+        }
+        release_oversized(header);
+    }
+
+    void release_oversized(oversized_header* header) noexcept {
+        const size_t offset = oversized_offset(header->alignment);
+        char* raw = reinterpret_cast<char*>(header) + sizeof(oversized_header) - offset;
+        upstream_->deallocate(raw, header->bytes, header->alignment);
+    }
+
+    memory_resource* upstream_;
+    pool_options options_;
+    pool pools_[max_pools] = {};
+    chunk_header* chunks_ = nullptr;
+    oversized_header* oversized_ = nullptr;
+};
+
+// Pool resource shared between threads. It holds shard_count unsynchronized pools, each behind
+// its own mutex, and every thread sticks to one of them, so threads rarely wait for one another.
+// A pooled block freed by another thread joins that thread's pool, which is safe because every
+// pool has the same block sizes and chunks are only returned to upstream all at once. Oversized
+// blocks are tracked by the pool that allocated them, so they all go through the first shard.
+class synchronized_pool_resource : public memory_resource {
+public:
+    static constexpr size_t shard_count = 8;
+
+    synchronized_pool_resource() : synchronized_pool_resource(pool_options{}) {}
+
+    explicit synchronized_pool_resource(memory_resource* upstream)
+        : synchronized_pool_resource(pool_options{}, upstream) {}
+
+    explicit synchronized_pool_resource(const pool_options& opts)
+        : synchronized_pool_resource(opts, get_default_resource()) {}
+
+    synchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+        : synchronized_pool_resource(opts, upstream, make_index_sequence<shard_count>{}) {}
+
+    synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+    synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+    void release() {
+        for (shard& s : shards_) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.pool.release();
+        }
+    }
+
+    memory_resource* upstream_resource() const noexcept {
+        return shards_[0].pool.upstream_resource();
+    }
+
+    pool_options options() const noexcept { return shards_[0].pool.options(); }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        shard& s = shard_for(bytes, alignment);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.pool.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        shard& s = shard_for(bytes, alignment);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.pool.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct alignas(64) shard {
+        shard(const pool_options& opts, memory_resource* upstream) : pool(opts, upstream) {}
+
+        std::mutex mutex;
+        unsynchronized_pool_resource pool;
+    };
+
+    template <size_t... I>
+    synchronized_pool_resource(const pool_options& opts, memory_resource* upstream,
+                               index_sequence<I...>)
+        : shards_{make_shard<I>(opts, upstream)...} {}
+
+    // Returns a prvalue so that the non-movable shards are built in place.
+    template <size_t>
+    static shard make_shard(const pool_options& opts, memory_resource* upstream) {
+        return shard(opts, upstream);
+    }
+
+    // Threads are spread over the shards in the order they first allocate.
+    static size_t thread_shard() noexcept {
+        static std::atomic<size_t> next{0};
+        static thread_local const size_t index =
+            next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+        return index;
+    }
+
+    shard& shard_for(size_t bytes, size_t alignment) noexcept {
+        const bool pooled =
+            bytes <= shards_[0].pool.options().largest_required_pool_block && alignment <= max_align;
+        return shards_[pooled ? thread_shard() : 0];
+    }
+
+    shard shards_[shard_count];
+};
+
+template <typename T = std::byte>
+class polymorphic_allocator {
+public:
+    using value_type = T;
+
+    polymorphic_allocator() noexcept : resource_(get_default_resource()) {}
+
+    polymorphic_allocator(memory_resource* r) noexcept : resource_(r) {}
+
+    polymorphic_allocator(const polymorphic_allocator&) = default;
+
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+        : resource_(other.resource()) {}
+
+    polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    [[nodiscard]] void* allocate_bytes(size_t bytes,
+                                       size_t alignment = alignof(std::max_align_t)) {
+        return resource_->allocate(bytes, alignment);
+    }
+
+    void deallocate_bytes(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        resource_->deallocate(p, bytes, alignment);
+    }
+
+    template <typename U>
+    [[nodiscard]] U* allocate_object(size_t n = 1) {
+        if (n > static_cast<size_t>(-1) / sizeof(U)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<U*>(allocate_bytes(n * sizeof(U), alignof(U)));
+    }
+
+    template <typename U>
+    void deallocate_object(U* p, size_t n = 1) {
+        deallocate_bytes(p, n * sizeof(U), alignof(U));
+    }
+
+    template <typename U, typename... Args>
+    [[nodiscard]] U* new_object(Args&&... args) {
+        U* p = allocate_object<U>();
+        try {
+            mystl::construct_at(p, mystl::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_object(p);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename U>
+    void delete_object(U* p) {
+        mystl::destroy_at(p);
+        deallocate_object(p);
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const noexcept {
+        return polymorphic_allocator();
+    }
+
+    memory_resource* resource() const noexcept { return resource_; }
+
+private:
+    memory_resource* resource_;
+};
+
+template <typename T, typename U>
+bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+    return *lhs.resource() == *rhs.resource();
+}
+
+}  // namespace pmr
+}  // namespace mystl
+
+#endif
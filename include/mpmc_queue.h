@@ -0,0 +1,247 @@
+#ifndef MYSTL_HANDMADE_MPMC_QUEUE_H_
+#define MYSTL_HANDMADE_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "construct.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+// Bounded lock-free multi-producer multi-consumer queue (Vyukov). Every slot carries a sequence
+// number that says whose turn it is: a producer holding ticket t may fill slot t & mask once its
+// sequence equals t, and a consumer holding ticket t may empty it once it equals t + 1. Claiming a
+// ticket is one CAS on tail (producers) or head (consumers), which live on separate cache lines,
+// and the batch operations claim several consecutive tickets with that same single CAS.
+//
+// Capacity is rounded up to a power of two. T must be nothrow move constructible: a claimed slot
+// has to be published, so a throwing constructor runs before the ticket is taken.
+template <typename T>
+class mpmc_queue {
+    static_assert(is_nothrow_move_constructible_v<T>,
+                  "mpmc_queue requires a nothrow move constructible element type");
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    explicit mpmc_queue(size_type capacity) : mask_(round_up_(capacity) - 1) {
+        slots_ = new slot[mask_ + 1];
+        for (size_type i = 0; i <= mask_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        for (size_type pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            mystl::destroy_at(slots_[pos & mask_].value());
+        }
+        delete[] slots_;
+    }
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+    // A snapshot that may be stale by the time it is used.
+    size_type size_approx() const noexcept {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty_approx() const noexcept { return size_approx() == 0; }
+
+    // Constructs an element at the tail; returns false if the queue is full.
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (is_nothrow_constructible_v<T, Args...>) {
+            return emplace_(mystl::forward<Args>(args)...);
+        } else {
+            T tmp(mystl::forward<Args>(args)...);
+            return emplace_(mystl::move(tmp));
+        }
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+
+    bool try_push(T&& value) { return try_emplace(mystl::move(value)); }
+
+    // Moves the element at the head into `out`; returns false if the queue is empty.
+    bool try_pop(T& out) {
+        size_type pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            slot& s = slots_[pos & mask_];
+            const size_type seq = s.seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff =
+                static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    take_(s, pos, out);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Pushes up to n elements from first, claiming all the slots it can get with one CAS, and
+    // returns how many were pushed. Elements whose construction may throw are pushed one by
+    // one, each built before its slot is claimed.
+    template <typename InputIt>
+    size_type try_push_n(InputIt first, size_type n) {
+        if constexpr (is_nothrow_constructible_v<T, decltype(*first)>) {
+            if (n == 0) {
+                return 0;
+            }
+            size_type pos = tail_.load(std::memory_order_relaxed);
+            while (true) {
+                const size_type k = count_ready_(pos, n, 0);
+                if (k == 0) {
+                    if (is_full_at_(pos)) {
+                        return 0;
+                    }
+                    pos = tail_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (tail_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                    for (size_type i = 0; i < k; ++i, ++first) {
+                        slot& s = slots_[(pos + i) & mask_];
+                        mystl::construct_at(s.value(), *first);
+                        s.seq.store(pos + i + 1, std::memory_order_release);
+                    }
+                    return k;
+                }
+            }
+        } else {
+            size_type pushed = 0;
+            for (; pushed < n; ++pushed, ++first) {
+                if (!try_emplace(*first)) {
+                    break;
+                }
+            }
+            return pushed;
+        }
+    }
+
+    // Pops up to n elements into out, claiming all the filled slots it can get with one CAS,
+    // and returns how many were popped. Assignment through out must not throw.
+    template <typename OutputIt>
+    size_type try_pop_n(OutputIt out, size_type n) {
+        if (n == 0) {
+            return 0;
+        }
+        size_type pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            const size_type k = count_ready_(pos, n, 1);
+            if (k == 0) {
+                if (is_empty_at_(pos)) {
+                    return 0;
+                }
+                pos = head_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (head_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                for (size_type i = 0; i < k; ++i, ++out) {
+                    slot& s = slots_[(pos + i) & mask_];
+                    T* value = s.value();
+                    *out = mystl::move(*value);
+                    mystl::destroy_at(value);
+                    s.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+                }
+                return k;
+            }
+        }
+    }
+
+private:
+    struct slot {
+        std::atomic<size_type> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static size_type round_up_(size_type n) noexcept {
+        size_type cap = 2;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    template <typename... Args>
+    bool emplace_(Args&&... args) noexcept {
+        size_type pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            slot& s = slots_[pos & mask_];
+            const size_type seq = s.seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff =
+                static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    mystl::construct_at(s.value(), mystl::forward<Args>(args)...);
+                    s.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Releases the slot even if the assignment throws, so the queue stays consistent.
+    void take_(slot& s, size_type pos, T& out) {
+        T* value = s.value();
+        struct release {
+            slot& s;
+            T* value;
+            size_type next;
+            ~release() {
+                mystl::destroy_at(value);
+                s.seq.store(next, std::memory_order_release);
+            }
+        } guard{s, value, pos + mask_ + 1};
+        out = mystl::move(*value);
+    }
+
+    // How many of the slots for tickets pos, pos + 1, ... (at most n) are ready, i.e. have
+    // sequence ticket + offset: 0 for producers, 1 for consumers.
+    size_type count_ready_(size_type pos, size_type n, size_type offset) const noexcept {
+        size_type k = 0;
+        while (k < n && k <= mask_ &&
+               slots_[(pos + k) & mask_].seq.load(std::memory_order_acquire) == pos + k + offset) {
+            ++k;
+        }
+        return k;
+    }
+
+    bool is_full_at_(size_type pos) const noexcept {
+        const size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos) < 0;
+    }
+
+    bool is_empty_at_(size_type pos) const noexcept {
+        const size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1) < 0;
+    }
+
+    alignas(64) std::atomic<size_type> head_{0};
+    alignas(64) std::atomic<size_type> tail_{0};
+    alignas(64) slot* slots_ = nullptr;
+    const size_type mask_;
+};
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef MYSTL_HANDMADE_NUMERIC_H_
+#define MYSTL_HANDMADE_NUMERIC_H_
+
+#include <functional>
+
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+namespace detail {
+    template <typename It>
+    using numeric_value_t = remove_cvref_t<decltype(*mystl::declval<It&>())>;
+}  // namespace detail
+
+template <typename InputIt, typename T, typename BinaryOp>
+    requires invocable<BinaryOp&, T, decltype(*mystl::declval<InputIt&>())>
+constexpr T accumulate(InputIt first, InputIt last, T init, BinaryOp op) {
+    for (; first != last; ++first) {
+        init = mystl::invoke(op, mystl::move(init), *first);
+    }
+    return init;
+}
+
+template <typename InputIt, typename T>
+constexpr T accumulate(InputIt first, InputIt last, T init) {
+    return mystl::accumulate(first, last, mystl::move(init), std::plus<>());
+}
+
+// Like accumulate, but op must be associative and commutative, which lets the parallel
+// overloads in execution.h regroup the terms.
+template <typename InputIt, typename T, typename BinaryOp>
+    requires invocable<BinaryOp&, T, decltype(*mystl::declval<InputIt&>())>
+constexpr T reduce(InputIt first, InputIt last, T init, BinaryOp op) {
+    return mystl::accumulate(first, last, mystl::move(init), mystl::move(op));
+}
+
+template <typename InputIt, typename T>
+constexpr T reduce(InputIt first, InputIt last, T init) {
+    return mystl::reduce(first, last, mystl::move(init), std::plus<>());
+}
+
+template <typename InputIt>
+constexpr detail::numeric_value_t<InputIt> reduce(InputIt first, InputIt last) {
+    return mystl::reduce(first, last, detail::numeric_value_t<InputIt>(), std::plus<>());
+}
+
+template <typename InputIt, typename T, typename ReduceOp, typename TransformOp>
+    requires invocable<TransformOp&, decltype(*mystl::declval<InputIt&>())>
+constexpr T transform_reduce(InputIt first, InputIt last, T init, ReduceOp reduce,
+                             TransformOp transform) {
+    for (; first != last; ++first) {
+        init = mystl::invoke(reduce, mystl::move(init), mystl::invoke(transform, *first));
+    }
+    return init;
+}
+
+template <typename InputIt1, typename InputIt2, typename T, typename ReduceOp,
+          typename TransformOp>
+    requires invocable<TransformOp&, decltype(*mystl::declval<InputIt1&>()),
+                       decltype(*mystl::declval<InputIt2&>())>
+constexpr T transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init,
+                             ReduceOp reduce, TransformOp transform) {
+    for (; first1 != last1; ++first1, (void)++first2) {
+        init = mystl::invoke(reduce, mystl::move(init), mystl::invoke(transform, *first1, *first2));
+    }
+    return init;
+}
+
+template <typename InputIt1, typename InputIt2, typename T>
+constexpr T transform_reduce(InputIt1 first1, InputIt1 last1, InputIt2 first2, T init) {
+    return mystl::transform_reduce(first1, last1, first2, mystl::move(init), std::plus<>(),
+                                   std::multiplies<>());
+}
+
+template <typename InputIt, typename OutputIt, typename BinaryOp, typename T>
+    requires invocable<BinaryOp&, T, decltype(*mystl::declval<InputIt&>())>
+constexpr OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOp op,
+                                  T init) {
+    for (; first != last; ++first, (void)++d_first) {
+        init = mystl::invoke(op, mystl::move(init), *first);
+        *d_first = init;
+    }
+    return d_first;
+}
+
+template <typename InputIt, typename OutputIt, typename BinaryOp>
+constexpr OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first, BinaryOp op) {
+    if (first == last) {
+        return d_first;
+    }
+    detail::numeric_value_t<InputIt> acc = *first;
+    *d_first = acc;
+    return mystl::inclusive_scan(++first, last, ++d_first, op, mystl::move(acc));
+}
+
+template <typename InputIt, typename OutputIt>
+constexpr OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first) {
+    return mystl::inclusive_scan(first, last, d_first, std::plus<>());
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,570 @@
+#ifndef MYSTL_HANDMADE_OPTIONAL_H_
+#define MYSTL_HANDMADE_OPTIONAL_H_
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <new>
+
+#include "construct.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+struct nullopt_t {
+    struct tag_ {};
+    constexpr explicit nullopt_t(tag_) noexcept {}
+};
+
+inline constexpr nullopt_t nullopt{nullopt_t::tag_{}};
+
+class bad_optional_access : public std::exception {
+public:
+    const char* what() const noexcept override { return "mystl::bad_optional_access"; }
+};
+
+// Niche customization point. By default optional<T> stores T next to an engaged flag, which
+// padding usually rounds up to a whole alignment unit. A specialization of niche_traits<T>
+// names an object representation that no live T ever has, and optional<T> then keeps its empty
+// state in exactly sizeof(T) bytes:
+//
+//     static void set_empty(void* storage) noexcept;        // writes that representation
+//     static bool is_empty(const void* storage) noexcept;   // recognises it
+//
+// set_empty receives storage that holds no live T; is_empty receives storage that holds either
+// a live T or what set_empty wrote. T must be trivially copyable: an empty niche optional is
+// copied byte for byte and never destroyed. Niche optionals cannot be used in constant
+// expressions, since the empty state is written and read through raw bytes.
+template <typename T>
+struct niche_traits {};
+
+// A bool is one byte holding 0 or 1.
+template <>
+struct niche_traits<bool> {
+    static void set_empty(void* storage) noexcept { *static_cast<unsigned char*>(storage) = 2; }
+
+    static bool is_empty(const void* storage) noexcept {
+        return *static_cast<const unsigned char*>(storage) == 2;
+    }
+};
+
+// Address 1 is misaligned for every type with an alignment above one and lies in the page at
+// address zero, which is never mapped, for the rest. A null pointer remains an engaged value.
+template <typename T>
+struct niche_traits<T*> {
+    static_assert(sizeof(T*) == sizeof(uintptr_t));
+
+    static void set_empty(void* storage) noexcept {
+        const uintptr_t bits = 1;
+        std::memcpy(storage, &bits, sizeof(bits));
+    }
+
+    static bool is_empty(const void* storage) noexcept {
+        uintptr_t bits;
+        std::memcpy(&bits, storage, sizeof(bits));
+        return bits == 1;
+    }
+};
+
+// Niche for a type with a sentinel value, such as an enumerator past the last one or an id
+// that is never issued. The empty optional holds a live Sentinel, so an optional that is
+// assigned Sentinel reads as empty:
+//
+//     template <> struct mystl::niche_traits<color> : mystl::niche_value<color, color(255)> {};
+template <typename T, T Sentinel>
+struct niche_value {
+    static void set_empty(void* storage) noexcept { ::new (storage) T(Sentinel); }
+
+    static bool is_empty(const void* storage) noexcept {
+        return *std::launder(static_cast<const T*>(storage)) == Sentinel;
+    }
+};
+
+template <typename T>
+class optional;
+
+namespace detail {
+    template <typename T>
+    concept has_niche = requires(void* p, const void* cp) {
+        niche_traits<T>::set_empty(p);
+        { niche_traits<T>::is_empty(cp) } -> convertible_to<bool>;
+    };
+
+    template <typename T>
+    inline constexpr bool is_optional_v = false;
+
+    template <typename T>
+    inline constexpr bool is_optional_v<optional<T>> = true;
+
+    // Constructs the value from invoke(f, arg), which transform() relies on for types that
+    // cannot be moved.
+    struct optional_invoke_t {
+        explicit optional_invoke_t() = default;
+    };
+
+    // Engaged flag beside a union: trivially destructible, copyable and so on whenever T is.
+    template <typename T, bool = has_niche<T>>
+    struct optional_storage {
+        union {
+            char empty_;
+            remove_cv_t<T> value_;
+        };
+        bool engaged_;
+
+        constexpr optional_storage() noexcept : empty_(), engaged_(false) {}
+
+        template <typename... Args>
+        constexpr explicit optional_storage(in_place_t, Args&&... args)
+            : value_(mystl::forward<Args>(args)...), engaged_(true) {}
+
+        template <typename F, typename Arg>
+        constexpr optional_storage(optional_invoke_t, F&& f, Arg&& arg)
+            : value_(mystl::invoke(mystl::forward<F>(f), mystl::forward<Arg>(arg))),
+              engaged_(true) {}
+
+        constexpr ~optional_storage()
+            requires is_trivially_destructible_v<T>
+        = default;
+
+        constexpr ~optional_storage() {
+            if (engaged_) {
+                mystl::destroy_at(mystl::addressof(value_));
+            }
+        }
+
+        constexpr bool has_value_() const noexcept { return engaged_; }
+        constexpr T& get_() noexcept { return value_; }
+        constexpr const T& get_() const noexcept { return value_; }
+
+        template <typename... Args>
+        constexpr void construct_(Args&&... args) {
+            mystl::construct_at(mystl::addressof(value_), mystl::forward<Args>(args)...);
+            engaged_ = true;
+        }
+
+        constexpr void destroy_() noexcept {
+            mystl::destroy_at(mystl::addressof(value_));
+            engaged_ = false;
+        }
+    };
+
+    // Just the bytes of a T; the empty state is the niche representation.
+    template <typename T>
+    struct optional_storage<T, true> {
+        static_assert(is_trivially_copyable_v<T>, "a type with a niche must be trivially copyable");
+
+        using traits = niche_traits<T>;
+
+        alignas(T) unsigned char bytes_[sizeof(T)];
+
+        optional_storage() noexcept { traits::set_empty(bytes_); }
+
+        template <typename... Args>
+        explicit optional_storage(in_place_t, Args&&... args) {
+            ::new (static_cast<void*>(bytes_)) T(mystl::forward<Args>(args)...);
+        }
+
+        template <typename F, typename Arg>
+        optional_storage(optional_invoke_t, F&& f, Arg&& arg) {
+            ::new (static_cast<void*>(bytes_))
+                T(mystl::invoke(mystl::forward<F>(f), mystl::forward<Arg>(arg)));
+        }
+
+        bool has_value_() const noexcept { return !traits::is_empty(bytes_); }
+        T& get_() noexcept { return *std::launder(reinterpret_cast<T*>(bytes_)); }
+        const T& get_() const noexcept { return *std::launder(reinterpret_cast<const T*>(bytes_)); }
+
+        template <typename... Args>
+        void construct_(Args&&... args) {
+            ::new (static_cast<void*>(bytes_)) T(mystl::forward<Args>(args)...);
+        }
+
+        void destroy_() noexcept { traits::set_empty(bytes_); }
+    };
+
+    // T can be built from, or converted from, an optional<U> itself; such conversions bypass
+    // the converting constructors of optional.
+    template <typename T, typename U>
+    concept optional_converts_from =
+        is_constructible_v<T, optional<U>&> || is_constructible_v<T, const optional<U>&> ||
+        is_constructible_v<T, optional<U>&&> || is_constructible_v<T, const optional<U>&&> ||
+        is_convertible_v<optional<U>&, T> || is_convertible_v<const optional<U>&, T> ||
+        is_convertible_v<optional<U>&&, T> || is_convertible_v<const optional<U>&&, T>;
+
+    template <typename T, typename U>
+    concept optional_assigns_from =
+        optional_converts_from<T, U> || is_assignable_v<T&, optional<U>&> ||
+        is_assignable_v<T&, const optional<U>&> || is_assignable_v<T&, optional<U>&&> ||
+        is_assignable_v<T&, const optional<U>&&>;
+}  // namespace detail
+
+// A T or nothing. The value lives inside the optional; copying, moving and destroying an
+// optional are trivial whenever they are for T, so an optional of a trivially copyable type is
+// itself trivially copyable. Types with a niche (see niche_traits) keep the empty state inside
+// the bytes of T, so sizeof(optional<T>) == sizeof(T) for bool, pointers and opted-in types.
+template <typename T>
+class optional : private detail::optional_storage<T> {
+    using base = detail::optional_storage<T>;
+
+    static_assert(!is_reference_v<T> && !is_array_v<T> && !is_void_v<T>,
+                  "optional requires an object type");
+    static_assert(!is_same_v<remove_cv_t<T>, nullopt_t> && !is_same_v<remove_cv_t<T>, in_place_t>,
+                  "optional of nullopt_t or in_place_t");
+
+public:
+    using value_type = T;
+    using trivially_relocatable = bool_constant<is_trivially_relocatable_v<T>>;
+
+    constexpr optional() noexcept {}
+
+    constexpr optional(nullopt_t) noexcept {}
+
+    constexpr optional(const optional&)
+        requires is_trivially_copy_constructible_v<T>
+    = default;
+
+    constexpr optional(const optional& other)
+        requires(is_copy_constructible_v<T> && !is_trivially_copy_constructible_v<T>)
+        : base() {
+        if (other.has_value()) {
+            this->construct_(*other);
+        }
+    }
+
+    constexpr optional(optional&&)
+        requires is_trivially_move_constructible_v<T>
+    = default;
+
+    constexpr optional(optional&& other) noexcept(is_nothrow_move_constructible_v<T>)
+        requires(is_move_constructible_v<T> && !is_trivially_move_constructible_v<T>)
+        : base() {
+        if (other.has_value()) {
+            this->construct_(mystl::move(*other));
+        }
+    }
+
+    template <typename... Args>
+        requires is_constructible_v<T, Args...>
+    constexpr explicit optional(in_place_t, Args&&... args)
+        : base(in_place, mystl::forward<Args>(args)...) {}
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<T, std::initializer_list<U>&, Args...>
+    constexpr explicit optional(in_place_t, std::initializer_list<U> il, Args&&... args)
+        : base(in_place, il, mystl::forward<Args>(args)...) {}
+
+    template <typename U = remove_cv_t<T>>
+        requires(is_constructible_v<T, U> && !is_same_v<remove_cvref_t<U>, in_place_t> &&
+                 !is_same_v<remove_cvref_t<U>, optional> &&
+                 !(is_same_v<remove_cv_t<T>, bool> && detail::is_optional_v<remove_cvref_t<U>>))
+    constexpr explicit(!is_convertible_v<U, T>) optional(U&& value)
+        : base(in_place, mystl::forward<U>(value)) {}
+
+    template <typename U>
+        requires(!is_same_v<T, U> && is_constructible_v<T, const U&> &&
+                 (is_same_v<remove_cv_t<T>, bool> || !detail::optional_converts_from<T, U>))
+    constexpr explicit(!is_convertible_v<const U&, T>) optional(const optional<U>& other)
+        : base() {
+        if (other.has_value()) {
+            this->construct_(*other);
+        }
+    }
+
+    template <typename U>
+        requires(!is_same_v<T, U> && is_constructible_v<T, U> &&
+                 (is_same_v<remove_cv_t<T>, bool> || !detail::optional_converts_from<T, U>))
+    constexpr explicit(!is_convertible_v<U, T>) optional(optional<U>&& other)
+        : base() {
+        if (other.has_value()) {
+            this->construct_(mystl::move(*other));
+        }
+    }
+
+    constexpr optional& operator=(nullopt_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    constexpr optional& operator=(const optional&)
+        requires(is_trivially_copy_constructible_v<T> && is_trivially_copy_assignable_v<T> &&
+                 is_trivially_destructible_v<T>)
+    = default;
+
+    constexpr optional& operator=(const optional& other)
+        requires(is_copy_constructible_v<T> && is_copy_assignable_v<T> &&
+                 !(is_trivially_copy_constructible_v<T> && is_trivially_copy_assignable_v<T> &&
+                   is_trivially_destructible_v<T>))
+    {
+        assign_(other);
+        return *this;
+    }
+
+    constexpr optional& operator=(optional&&)
+        requires(is_trivially_move_constructible_v<T> && is_trivially_move_assignable_v<T> &&
+                 is_trivially_destructible_v<T>)
+    = default;
+
+    constexpr optional& operator=(optional&& other) noexcept(
+        is_nothrow_move_constructible_v<T> && is_nothrow_move_assignable_v<T>)
+        requires(is_move_constructible_v<T> && is_move_assignable_v<T> &&
+                 !(is_trivially_move_constructible_v<T> && is_trivially_move_assignable_v<T> &&
+                   is_trivially_destructible_v<T>))
+    {
+        assign_(mystl::move(other));
+        return *this;
+    }
+
+    template <typename U = remove_cv_t<T>>
+        requires(!is_same_v<remove_cvref_t<U>, optional> && is_constructible_v<T, U> &&
+                 is_assignable_v<T&, U> && !(is_scalar_v<T> && is_same_v<T, decay_t<U>>))
+    constexpr optional& operator=(U&& value) {
+        if (has_value()) {
+            this->get_() = mystl::forward<U>(value);
+        } else {
+            this->construct_(mystl::forward<U>(value));
+        }
+        return *this;
+    }
+
+    template <typename U>
+        requires(!is_same_v<T, U> && is_constructible_v<T, const U&> &&
+                 is_assignable_v<T&, const U&> && !detail::optional_assigns_from<T, U>)
+    constexpr optional& operator=(const optional<U>& other) {
+        assign_(other);
+        return *this;
+    }
+
+    template <typename U>
+        requires(!is_same_v<T, U> && is_constructible_v<T, U> && is_assignable_v<T&, U> &&
+                 !detail::optional_assigns_from<T, U>)
+    constexpr optional& operator=(optional<U>&& other) {
+        assign_(mystl::move(other));
+        return *this;
+    }
+
+    template <typename... Args>
+        requires is_constructible_v<T, Args...>
+    constexpr T& emplace(Args&&... args) {
+        reset();
+        this->construct_(mystl::forward<Args>(args)...);
+        return this->get_();
+    }
+
+    template <typename U, typename... Args>
+        requires is_constructible_v<T, std::initializer_list<U>&, Args...>
+    constexpr T& emplace(std::initializer_list<U> il, Args&&... args) {
+        reset();
+        this->construct_(il, mystl::forward<Args>(args)...);
+        return this->get_();
+    }
+
+    constexpr void reset() noexcept {
+        if (has_value()) {
+            this->destroy_();
+        }
+    }
+
+    constexpr void swap(optional& other) noexcept(is_nothrow_move_constructible_v<T> &&
+                                                  is_nothrow_swappable_v<T>) {
+        if (has_value() && other.has_value()) {
+            mystl::swap(this->get_(), other.get_());
+        } else if (has_value()) {
+            other.construct_(mystl::move(this->get_()));
+            this->destroy_();
+        } else if (other.has_value()) {
+            this->construct_(mystl::move(other.get_()));
+            other.destroy_();
+        }
+    }
+
+    friend constexpr void swap(optional& a, optional& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    constexpr bool has_value() const noexcept { return this->has_value_(); }
+    constexpr explicit operator bool() const noexcept { return this->has_value_(); }
+
+    constexpr T* operator->() noexcept { return mystl::addressof(this->get_()); }
+    constexpr const T* operator->() const noexcept { return mystl::addressof(this->get_()); }
+
+    constexpr T& operator*() & noexcept { return this->get_(); }
+    constexpr const T& operator*() const& noexcept { return this->get_(); }
+    constexpr T&& operator*() && noexcept { return mystl::move(this->get_()); }
+    constexpr const T&& operator*() const&& noexcept { return mystl::move(this->get_()); }
+
+    constexpr T& value() & { return checked_(*this); }
+    constexpr const T& value() const& { return checked_(*this); }
+    constexpr T&& value() && { return mystl::move(checked_(*this)); }
+    constexpr const T&& value() const&& { return mystl::move(checked_(*this)); }
+
+    template <typename U>
+    constexpr T value_or(U&& fallback) const& {
+        return has_value() ? this->get_() : static_cast<T>(mystl::forward<U>(fallback));
+    }
+
+    template <typename U>
+    constexpr T value_or(U&& fallback) && {
+        return has_value() ? mystl::move(this->get_())
+                           : static_cast<T>(mystl::forward<U>(fallback));
+    }
+
+    // f(value) for an engaged optional, an empty result otherwise. f returns an optional.
+    template <typename F>
+    constexpr auto and_then(F&& f) & { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) const& { return and_then_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto and_then(F&& f) && {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto and_then(F&& f) const&& {
+        return and_then_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // optional(f(value)) for an engaged optional, an empty optional otherwise. The result is
+    // constructed in place from the call, so it need not be movable.
+    template <typename F>
+    constexpr auto transform(F&& f) & { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) const& { return transform_(*this, mystl::forward<F>(f)); }
+    template <typename F>
+    constexpr auto transform(F&& f) && {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto transform(F&& f) const&& {
+        return transform_(mystl::move(*this), mystl::forward<F>(f));
+    }
+
+    // This optional if engaged, f() otherwise. f returns an optional<T>.
+    template <typename F>
+        requires is_copy_constructible_v<T>
+    constexpr optional or_else(F&& f) const& {
+        return has_value() ? *this : static_cast<optional>(mystl::forward<F>(f)());
+    }
+
+    template <typename F>
+        requires is_move_constructible_v<T>
+    constexpr optional or_else(F&& f) && {
+        return has_value() ? mystl::move(*this) : static_cast<optional>(mystl::forward<F>(f)());
+    }
+
+private:
+    template <typename>
+    friend class optional;
+
+    template <typename F, typename Arg>
+    constexpr optional(detail::optional_invoke_t tag, F&& f, Arg&& arg)
+        : base(tag, mystl::forward<F>(f), mystl::forward<Arg>(arg)) {}
+
+    template <typename Self>
+    static constexpr auto& checked_(Self& self) {
+        if (!self.has_value()) {
+            throw bad_optional_access();
+        }
+        return self.get_();
+    }
+
+    template <typename Other>
+    constexpr void assign_(Other&& other) {
+        if (has_value() && other.has_value()) {
+            this->get_() = *mystl::forward<Other>(other);
+        } else if (other.has_value()) {
+            this->construct_(*mystl::forward<Other>(other));
+        } else {
+            reset();
+        }
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto and_then_(Self&& self, F&& f) {
+        using R = remove_cvref_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                        *mystl::forward<Self>(self)))>;
+        static_assert(detail::is_optional_v<R>, "and_then requires a function returning optional");
+        if (self.has_value()) {
+            return mystl::invoke(mystl::forward<F>(f), *mystl::forward<Self>(self));
+        }
+        return R();
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_(Self&& self, F&& f) {
+        using U = remove_cv_t<decltype(mystl::invoke(mystl::forward<F>(f),
+                                                     *mystl::forward<Self>(self)))>;
+        if (self.has_value()) {
+            return optional<U>(detail::optional_invoke_t{}, mystl::forward<F>(f),
+                               *mystl::forward<Self>(self));
+        }
+        return optional<U>();
+    }
+};
+
+template <typename T>
+optional(T) -> optional<T>;
+
+template <typename T, typename U>
+    requires requires(const T& a, const U& b) {
+        { a == b } -> convertible_to<bool>;
+    }
+constexpr bool operator==(const optional<T>& a, const optional<U>& b) {
+    if (a.has_value() != b.has_value()) {
+        return false;
+    }
+    return !a.has_value() || *a == *b;
+}
+
+template <typename T, std::three_way_comparable_with<T> U>
+constexpr std::compare_three_way_result_t<T, U> operator<=>(const optional<T>& a,
+                                                            const optional<U>& b) {
+    if (a.has_value() && b.has_value()) {
+        return *a <=> *b;
+    }
+    return a.has_value() <=> b.has_value();
+}
+
+template <typename T>
+constexpr bool operator==(const optional<T>& a, nullopt_t) noexcept {
+    return !a.has_value();
+}
+
+template <typename T>
+constexpr std::strong_ordering operator<=>(const optional<T>& a, nullopt_t) noexcept {
+    return a.has_value() <=> false;
+}
+
+template <typename T, typename U>
+    requires(!detail::is_optional_v<U> && requires(const T& a, const U& b) {
+        { a == b } -> convertible_to<bool>;
+    })
+constexpr bool operator==(const optional<T>& a, const U& b) {
+    return a.has_value() && *a == b;
+}
+
+template <typename T, typename U>
+    requires(!detail::is_optional_v<U> && std::three_way_comparable_with<T, U>)
+constexpr std::compare_three_way_result_t<T, U> operator<=>(const optional<T>& a, const U& b) {
+    return a.has_value() ? *a <=> b : std::strong_ordering::less;
+}
+
+template <typename T>
+constexpr optional<decay_t<T>> make_optional(T&& value) {
+    return optional<decay_t<T>>(mystl::forward<T>(value));
+}
+
+template <typename T, typename... Args>
+constexpr optional<T> make_optional(Args&&... args) {
+    return optional<T>(in_place, mystl::forward<Args>(args)...);
+}
+
+template <typename T, typename U, typename... Args>
+constexpr optional<T> make_optional(std::initializer_list<U> il, Args&&... args) {
+    return optional<T>(in_place, il, mystl::forward<Args>(args)...);
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,518 @@
+#ifndef MYSTL_HANDMADE_SCHEDULER_H_
+#define MYSTL_HANDMADE_SCHEDULER_H_
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "thread_pool.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace detail {
+    struct sched_task {
+        void (*run)(sched_task*) noexcept = nullptr;
+        sched_task* next = nullptr;  // link in the injection queue
+    };
+
+    // Blocks while word == expected. Spurious returns are allowed; callers re-check.
+    inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) noexcept {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected,
+                nullptr, nullptr, 0);
+#else
+        word.wait(expected, std::memory_order_acquire);
+#endif
+    }
+
+    inline void futex_wake(std::atomic<uint32_t>& word, int count) noexcept {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr,
+                nullptr, 0);
+#else
+        if (count == 1) {
+            word.notify_one();
+        } else {
+            word.notify_all();
+        }
+#endif
+    }
+
+    inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    // Chase-Lev work-stealing deque, after Le, Pop, Cohen and Zappa Nardelli, "Correct and
+    // Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013), with the paper's seq_cst
+    // fences folded into seq_cst accesses of top and bottom (the same code on x86). The owning
+    // thread pushes and pops at the bottom without a read-modify-write except when taking the
+    // last element; thieves take from the top with one CAS. The ring doubles when full; old
+    // rings may still be read by a thief mid-steal, so they are kept until destruction.
+    class chase_lev_deque {
+    public:
+        explicit chase_lev_deque(int64_t capacity = 256) : ring_(new ring(capacity)) {}
+
+        chase_lev_deque(const chase_lev_deque&) = delete;
+        chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+        ~chase_lev_deque() {
+            delete ring_.load(std::memory_order_relaxed);
+            for (ring* r : retired_) {
+                delete r;
+            }
+        }
+
+        // Owner only.
+        void push(sched_task* task) {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_acquire);
+            ring* r = ring_.load(std::memory_order_relaxed);
+            if (b - t > r->mask) {
+                r = grow_(r, t, b);
+            }
+            r->put(b, task);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        // Owner only. Takes the most recently pushed task.
+        sched_task* pop() noexcept {
+            const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            ring* r = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_seq_cst);
+            if (t > b) {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            sched_task* task = r->get(b);
+            if (t == b) {
+                // Last element: race the thieves for it.
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed)) {
+                    task = nullptr;
+                }
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return task;
+        }
+
+        // Any thread. Takes the oldest task; returns nullptr when empty or when it loses a race.
+        sched_task* steal() noexcept {
+            int64_t t = top_.load(std::memory_order_seq_cst);
+            const int64_t b = bottom_.load(std::memory_order_seq_cst);
+            if (t >= b) {
+                return nullptr;
+            }
+            sched_task* task = ring_.load(std::memory_order_acquire)->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return task;
+        }
+
+        bool empty() const noexcept {
+            return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct ring {
+            explicit ring(int64_t capacity)
+                : mask(capacity - 1), slots(new std::atomic<sched_task*>[static_cast<size_t>(capacity)]) {}
+            ~ring() { delete[] slots; }
+
+            sched_task* get(int64_t i) const noexcept {
+                return slots[i & mask].load(std::memory_order_relaxed);
+            }
+            void put(int64_t i, sched_task* task) noexcept {
+                slots[i & mask].store(task, std::memory_order_relaxed);
+            }
+
+            int64_t mask;
+            std::atomic<sched_task*>* slots;
+        };
+
+        ring* grow_(ring* old, int64_t t, int64_t b) {
+            ring* bigger = new ring(2 * (old->mask + 1));
+            try {
+                retired_.push_back(old);
+            } catch (...) {
+                delete bigger;
+                throw;
+            }
+            for (int64_t i = t; i < b; ++i) {
+                bigger->put(i, old->get(i));
+            }
+            ring_.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+        alignas(64) std::atomic<int64_t> top_{0};
+        alignas(64) std::atomic<int64_t> bottom_{0};
+        std::atomic<ring*> ring_;
+        vector<ring*> retired_;
+    };
+}  // namespace detail
+
+// Counts the tasks spawned into it that have not finished; scheduler::wait_for blocks on it.
+class task_group {
+public:
+    task_group() = default;
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    bool done() const noexcept { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class scheduler;
+
+    std::atomic<uint32_t> pending_{0};
+};
+
+// Work-stealing task scheduler. Each worker owns a Chase-Lev deque: tasks spawned by a worker
+// go to the bottom of its own deque and it runs them newest first, while idle workers steal the
+// oldest tasks of a randomly chosen victim. Tasks from threads outside the scheduler enter
+// through a global injection queue. An idle worker spins briefly, then parks on a futex until
+// new work is published. Threads blocked in wait_for run tasks while they wait, so fork-join
+// nesting cannot exhaust the workers. Tasks must not throw; an escaping exception terminates.
+class scheduler {
+public:
+    // A worker count of zero is raised to one.
+    explicit scheduler(size_t workers = default_worker_count())
+        : workers_(new worker[workers > 0 ? workers : 1]), size_(workers > 0 ? workers : 1) {
+        for (size_t i = 0; i < size_; ++i) {
+            workers_[i].rng = 0x9e3779b97f4a7c15ull * (i + 1);
+            workers_[i].owner = this;
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            workers_[i].thread = std::thread([this, i] { worker_loop_(workers_[i]); });
+        }
+    }
+
+    scheduler(const scheduler&) = delete;
+    scheduler& operator=(const scheduler&) = delete;
+
+    // Runs everything already scheduled, then joins the workers.
+    ~scheduler() {
+        stop_.store(true, std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_release);
+        detail::futex_wake(epoch_, INT_MAX);
+        for (size_t i = 0; i < size_; ++i) {
+            workers_[i].thread.join();
+        }
+        delete[] workers_;
+    }
+
+    size_t size() const noexcept { return size_; }
+
+    // Runs f() at some point; nothing waits for it.
+    template <typename F>
+        requires invocable<decay_t<F>&>
+    void submit(F&& f) {
+        enqueue_(mystl::forward<F>(f), nullptr);
+    }
+
+    // Runs f() as part of `group`; wait_for(group) returns after it has finished.
+    template <typename F>
+        requires invocable<decay_t<F>&>
+    void spawn(task_group& group, F&& f) {
+        enqueue_(mystl::forward<F>(f), &group);
+    }
+
+    // Returns once every task spawned into `group` has finished, running other tasks meanwhile.
+    // A thread outside the scheduler that finds nothing to run parks until the group is done.
+    void wait_for(task_group& group) noexcept {
+        worker* self = current_worker_();
+        int idle = 0;
+        while (true) {
+            const uint32_t pending = group.pending_.load(std::memory_order_acquire);
+            if (pending == 0) {
+                return;
+            }
+            if (detail::sched_task* task = find_work_(self)) {
+                task->run(task);
+                idle = 0;
+            } else if (self != nullptr || ++idle < spin_limit) {
+                relax_(idle);
+            } else {
+                detail::futex_wait(group.pending_, pending);
+            }
+        }
+    }
+
+    // Runs every callable, possibly in parallel, and returns when all have finished. The first
+    // runs on the calling thread; the others are spawned without copying the callables. If the
+    // first throws, the exception propagates once the spawned ones have finished.
+    template <typename F, typename... Fs>
+        requires(invocable<F&> && (invocable<Fs&> && ...))
+    void parallel_invoke(F&& f, Fs&&... fs) {
+        task_group group;
+        // The spawned tasks refer to group and fs, so every exit waits for them.
+        struct join {
+            scheduler& sched;
+            task_group& group;
+            ~join() { sched.wait_for(group); }
+        } guard{*this, group};
+        (spawn(group, [&fs]() noexcept { mystl::invoke(fs); }), ...);
+        mystl::invoke(f);
+    }
+
+    // Calls f(i) for every i in [0, n) and returns once all calls have finished. The caller and
+    // up to size() spawned helpers claim indices with an atomic counter, so a loop costs one
+    // task per helper rather than one per index. The caller runs other tasks while it waits for
+    // the helpers, so nested loops cannot deadlock. f must not throw.
+    template <typename F>
+        requires invocable<F&, size_t>
+    void parallel_for(size_t n, F&& f) {
+        if (n == 0) {
+            return;
+        }
+        struct bulk {
+            F& fn;
+            size_t count;
+            std::atomic<size_t> next{0};
+
+            void work() noexcept {
+                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                    mystl::invoke(fn, i);
+                }
+            }
+        };
+        bulk job{f, n};
+        const size_t helpers = n - 1 < size_ ? n - 1 : size_;
+        task_group group;
+        // The helpers refer to job, so every exit waits for them.
+        struct join {
+            scheduler& sched;
+            task_group& group;
+            ~join() { sched.wait_for(group); }
+        } guard{*this, group};
+        for (size_t h = 0; h < helpers; ++h) {
+            spawn(group, [&job]() noexcept { job.work(); });
+        }
+        job.work();
+    }
+
+    // MYSTL_NUM_THREADS or hardware_concurrency(), less one for the thread that waits, and at
+    // least one.
+    static size_t default_worker_count() noexcept {
+        const size_t n = thread_pool::default_thread_count();
+        return n > 0 ? n : 1;
+    }
+
+    // The one set of workers behind parallel_invoke and the parallel execution policies,
+    // started on first use.
+    static scheduler& default_scheduler() {
+        static scheduler sched;
+        return sched;
+    }
+
+private:
+    static constexpr int spin_limit = 64;
+
+    struct worker {
+        detail::chase_lev_deque deque;
+        uint64_t rng = 0;
+        std::thread thread;
+        scheduler* owner = nullptr;
+    };
+
+    static worker*& current_slot_() noexcept {
+        static thread_local worker* current = nullptr;
+        return current;
+    }
+
+    worker* current_worker_() const noexcept {
+        worker* w = current_slot_();
+        return w != nullptr && w->owner == this ? w : nullptr;
+    }
+
+    // Counts the task in its group only once it exists, and takes it back out if it cannot be
+    // queued, so a failed spawn never leaves the group pending.
+    template <typename F>
+    void enqueue_(F&& f, task_group* group) {
+        struct task : detail::sched_task {
+            task(F&& fn, task_group* g) : fn(mystl::forward<F>(fn)), group(g) {}
+            decay_t<F> fn;
+            task_group* group;
+        };
+        task* t = new task(mystl::forward<F>(f), group);
+        t->run = [](detail::sched_task* self) noexcept {
+            task* me = static_cast<task*>(self);
+            mystl::invoke(me->fn);
+            task_group* g = me->group;
+            delete me;
+            // The waiter may destroy the group as soon as it sees zero; waking a futex at a
+            // dead address is harmless, at worst a spurious wake-up for its next user.
+            if (g != nullptr && g->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                detail::futex_wake(g->pending_, INT_MAX);
+            }
+        };
+        if (group != nullptr) {
+            group->pending_.fetch_add(1, std::memory_order_relaxed);
+        }
+        try {
+            schedule_(t);
+        } catch (...) {
+            delete t;
+            if (group != nullptr && group->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                detail::futex_wake(group->pending_, INT_MAX);
+            }
+            throw;
+        }
+    }
+
+    void schedule_(detail::sched_task* task) {
+        if (worker* self = current_worker_()) {
+            self->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            task->next = nullptr;
+            if (inject_tail_ != nullptr) {
+                inject_tail_->next = task;
+            } else {
+                inject_head_ = task;
+            }
+            inject_tail_ = task;
+            injected_.fetch_add(1, std::memory_order_release);
+        }
+        // An RMW rather than a load: it is ordered against a parking worker's increment, so
+        // either the worker sees the task when it re-checks or this sees the worker and wakes it.
+        if (sleepers_.fetch_add(0, std::memory_order_seq_cst) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            detail::futex_wake(epoch_, 1);
+        }
+    }
+
+    detail::sched_task* pop_injected_() {
+        if (injected_.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        detail::sched_task* task = inject_head_;
+        if (task != nullptr) {
+            inject_head_ = task->next;
+            if (inject_head_ == nullptr) {
+                inject_tail_ = nullptr;
+            }
+            injected_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    static uint64_t next_random_(uint64_t& state) noexcept {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    detail::sched_task* find_work_(worker* self) {
+        if (self != nullptr) {
+            if (detail::sched_task* task = self->deque.pop()) {
+                return task;
+            }
+        }
+        if (detail::sched_task* task = pop_injected_()) {
+            return task;
+        }
+        static thread_local uint64_t outside_rng = 0x2545f4914f6cdd1dull;
+        uint64_t& rng = self != nullptr ? self->rng : outside_rng;
+        const size_t start = static_cast<size_t>(next_random_(rng) % size_);
+        for (size_t i = 0; i < size_; ++i) {
+            worker& victim = workers_[(start + i) % size_];
+            if (&victim == self) {
+                continue;
+            }
+            if (detail::sched_task* task = victim.deque.steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    bool has_work_() const noexcept {
+        if (injected_.load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            if (!workers_[i].deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void relax_(int idle) noexcept {
+        if (idle < spin_limit / 2) {
+            detail::cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void worker_loop_(worker& self) noexcept {
+        current_slot_() = &self;
+        int idle = 0;
+        while (true) {
+            if (detail::sched_task* task = find_work_(&self)) {
+                task->run(task);
+                idle = 0;
+                continue;
+            }
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (++idle < spin_limit) {
+                relax_(idle);
+                continue;
+            }
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            if (!has_work_() && !stop_.load(std::memory_order_acquire)) {
+                detail::futex_wait(epoch_, epoch);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    worker* workers_;
+    size_t size_;
+
+    std::mutex inject_mutex_;
+    detail::sched_task* inject_head_ = nullptr;
+    detail::sched_task* inject_tail_ = nullptr;
+    std::atomic<size_t> injected_{0};
+
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+// Fork-join on the default scheduler.
+template <typename F, typename... Fs>
+    requires(invocable<F&> && (invocable<Fs&> && ...))
+void parallel_invoke(F&& f, Fs&&... fs) {
+    scheduler::default_scheduler().parallel_invoke(mystl::forward<F>(f), mystl::forward<Fs>(fs)...);
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,333 @@
+#ifndef MYSTL_HANDMADE_SMALL_VECTOR_H_
+#define MYSTL_HANDMADE_SMALL_VECTOR_H_
+
+#include <compare>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "algorithm.h"
+#include "construct.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace detail {
+    // Default inline capacity: as many elements as fit in a 64-byte small_vector<T>, at least one.
+    template <typename T>
+    inline constexpr size_t small_vector_default_inline =
+        sizeof(T) + 3 * sizeof(void*) > 64 ? 1 : (64 - 3 * sizeof(void*)) / sizeof(T);
+}  // namespace detail
+
+// A vector that keeps up to N elements in storage inside the object and moves to the heap only
+// when it grows beyond that. Once on the heap it behaves like mystl::vector (doubling growth,
+// in-place expansion through allocator_traits::try_expand); clear() keeps the heap buffer and
+// shrink_to_fit() moves back inline when the elements fit.
+template <typename T, size_t N = detail::small_vector_default_inline<T>,
+          typename Alloc = allocator<T>>
+class small_vector : private detail::vector_base<T, Alloc, small_vector<T, N, Alloc>> {
+    using base = detail::vector_base<T, Alloc, small_vector>;
+    using typename base::alloc_traits;
+    friend base;
+
+    static_assert(is_same_v<typename alloc_traits::pointer, T*>,
+                  "mystl::small_vector requires an allocator with raw pointers");
+
+public:
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::size_type;
+    using typename base::difference_type;
+    using typename base::reference;
+    using typename base::const_reference;
+    using typename base::pointer;
+    using typename base::const_pointer;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+    small_vector() noexcept(noexcept(Alloc())) : small_vector(Alloc()) {}
+
+    explicit small_vector(const Alloc& alloc) noexcept : base(alloc) { reset_inline_(); }
+
+    explicit small_vector(size_type n, const Alloc& alloc = Alloc()) : small_vector(alloc) {
+        init_guarded_([&] {
+            reserve(n);
+            construct_at_end_value_(n);
+        });
+    }
+
+    small_vector(size_type n, const T& value, const Alloc& alloc = Alloc()) : small_vector(alloc) {
+        init_guarded_([&] {
+            reserve(n);
+            construct_at_end_fill_(n, value);
+        });
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    small_vector(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : small_vector(alloc) {
+        init_guarded_([&] { assign(first, last); });
+    }
+
+    small_vector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc())
+        : small_vector(ilist.begin(), ilist.end(), alloc) {}
+
+    small_vector(const small_vector& other)
+        : small_vector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+        init_guarded_([&] {
+            reserve(other.size());
+            construct_at_end_copy_(other.begin_, other.end_);
+        });
+    }
+
+    small_vector(small_vector&& other) noexcept(is_nothrow_move_constructible_v<T>)
+        : small_vector(other.alloc_) {
+        take_(other);
+    }
+
+    ~small_vector() {
+        destroy_range_(begin_, end_);
+        release_heap_();
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (alloc_ != other.alloc_) {
+                clear();
+                release_heap_();
+                reset_inline_();
+            }
+            alloc_ = other.alloc_;
+        }
+        assign(other.begin_, other.end_);
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(is_nothrow_move_constructible_v<T> &&
+                                                           is_nothrow_move_assignable_v<T>) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            // Our heap block came from the old allocator; free it before taking other's.
+            if (alloc_ != other.alloc_) {
+                clear();
+                release_heap_();
+            }
+            alloc_ = mystl::move(other.alloc_);
+        }
+        if (!other.is_inline_() && alloc_ == other.alloc_) {
+            clear();
+            release_heap_();
+            steal_heap_(other);
+            return *this;
+        }
+        if constexpr (relocate_bitwise) {
+            if (other.size() <= capacity()) {
+                clear();
+                end_ = mystl::uninitialized_relocate(other.begin_, other.end_, begin_);
+                other.end_ = other.begin_;
+                return *this;
+            }
+        }
+        move_assign_range_(other.begin_, other.end_);
+        other.clear();
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    using base::assign;
+    using base::get_allocator;
+    using base::at;
+    using base::operator[];
+    using base::front;
+    using base::back;
+    using base::data;
+    using base::begin;
+    using base::cbegin;
+    using base::end;
+    using base::cend;
+    using base::empty;
+    using base::size;
+    using base::capacity;
+    using base::max_size;
+
+    // True while the elements live in the inline buffer.
+    bool is_small() const noexcept { return is_inline_(); }
+
+    using base::reserve;
+
+    void shrink_to_fit() {
+        if (is_inline_() || cap_ == end_) {
+            return;
+        }
+        if (size() <= N) {
+            T* old_begin = begin_;
+            const size_type old_cap = capacity();
+            T* dst = inline_data_();
+            T* new_end = transfer_(begin_, end_, dst);
+            release_transferred_(begin_, end_);
+            begin_ = dst;
+            end_ = new_end;
+            cap_ = dst + N;
+            alloc_traits::deallocate(alloc_, old_begin, old_cap);
+            return;
+        }
+        shrink_heap_();
+    }
+
+    using base::clear;
+    using base::insert;
+    using base::emplace;
+    using base::emplace_back;
+    using base::push_back;
+    using base::pop_back;
+    using base::erase;
+    using base::resize;
+
+    void swap(small_vector& other) noexcept(is_nothrow_move_constructible_v<T> &&
+                                            is_nothrow_move_assignable_v<T>) {
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            using mystl::swap;
+            swap(alloc_, other.alloc_);
+        }
+        if (!is_inline_() && !other.is_inline_()) {
+            using mystl::swap;
+            swap(begin_, other.begin_);
+            swap(end_, other.end_);
+            swap(cap_, other.cap_);
+            return;
+        }
+        small_vector tmp(mystl::move(other));
+        other.take_(*this);
+        take_(tmp);
+    }
+
+private:
+    using base::begin_;
+    using base::end_;
+    using base::cap_;
+    using base::alloc_;
+    using base::relocate_bitwise;
+    using base::destroy_range_;
+    using base::construct_at_end_value_;
+    using base::construct_at_end_fill_;
+    using base::construct_at_end_copy_;
+    using base::move_assign_range_;
+    using base::transfer_;
+    using base::release_transferred_;
+    using base::shrink_heap_;
+
+    static constexpr const char* name_ = "mystl::small_vector";
+
+    T* inline_data_() noexcept { return reinterpret_cast<T*>(inline_); }
+
+    bool is_inline_() const noexcept {
+        return begin_ == reinterpret_cast<const T*>(inline_);
+    }
+
+    void reset_inline_() noexcept {
+        begin_ = end_ = inline_data_();
+        cap_ = begin_ + N;
+    }
+
+    // Constructors call this so that a throwing element constructor does not leak the buffer.
+    template <typename F>
+    void init_guarded_(F f) {
+        try {
+            f();
+        } catch (...) {
+            destroy_range_(begin_, end_);
+            release_heap_();
+            throw;
+        }
+    }
+
+    // Moves other's contents into this vector, which must be empty and inline. Leaves other empty.
+    void take_(small_vector& other) {
+        if (!other.is_inline_()) {
+            steal_heap_(other);
+            return;
+        }
+        T* dst = inline_data_();
+        if constexpr (relocate_bitwise) {
+            end_ = mystl::uninitialized_relocate(other.begin_, other.end_, dst);
+        } else {
+            for (T* src = other.begin_; src != other.end_; ++src, (void)++end_) {
+                alloc_traits::construct(alloc_, end_, mystl::move(*src));
+            }
+            other.destroy_range_(other.begin_, other.end_);
+        }
+        other.end_ = other.begin_;
+    }
+
+    void steal_heap_(small_vector& other) noexcept {
+        begin_ = other.begin_;
+        end_ = other.end_;
+        cap_ = other.cap_;
+        other.reset_inline_();
+    }
+
+    size_type next_capacity_(size_type required) const {
+        const size_type max = max_size();
+        if (required > max) {
+            throw std::length_error(name_);
+        }
+        const size_type cap = capacity();
+        size_type grown = cap > max / 2 ? max : cap * 2;
+        return grown < required ? required : grown;
+    }
+
+    bool owns_heap_() const noexcept { return !is_inline_(); }
+
+    void release_heap_() noexcept {
+        if (!is_inline_()) {
+            alloc_traits::deallocate(alloc_, begin_, capacity());
+            reset_inline_();
+        }
+    }
+
+    alignas(T) unsigned char inline_[N == 0 ? 1 : N * sizeof(T)];
+};
+
+template <typename T, size_t N, typename Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs) {
+    return detail::sequence_equal(lhs, rhs);
+}
+
+template <typename T, size_t N, typename Alloc>
+auto operator<=>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+    -> decltype(detail::sequence_three_way(lhs, rhs)) {
+    return detail::sequence_three_way(lhs, rhs);
+}
+
+template <typename T, size_t N, typename Alloc>
+void swap(small_vector<T, N, Alloc>& lhs,
+          small_vector<T, N, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <typename T, size_t N, typename Alloc, typename Pred>
+size_t erase_if(small_vector<T, N, Alloc>& v, Pred pred) {
+    return detail::sequence_erase_if(v, pred);
+}
+
+template <typename T, size_t N, typename Alloc, typename U>
+size_t erase(small_vector<T, N, Alloc>& v, const U& value) {
+    return mystl::erase_if(v, [&value](const T& elem) { return elem == value; });
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef MYSTL_HANDMADE_SPSC_RING_H_
+#define MYSTL_HANDMADE_SPSC_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+#include "utility.h"
+
+namespace mystl {
+
+// Wait-free ring buffer for exactly one producer thread and one consumer thread. head and tail
+// are free-running counters, each written by one side only; every side also keeps a private copy
+// of the other side's counter on its own cache line and reloads it only when that copy says the
+// ring is full (producer) or empty (consumer), so the steady state touches no shared line beyond
+// the slots themselves.
+//
+// The slots hold live, default-constructed T objects. Besides the copying try_push/try_pop,
+// acquire_write/commit and peek/release hand out spans over the slots, so the producer can fill
+// them in place and the consumer can read them where they are. Capacity is rounded up to a
+// power of two.
+template <typename T>
+class spsc_ring {
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    explicit spsc_ring(size_type capacity)
+        : buf_(new T[round_up_(capacity)]()), mask_(round_up_(capacity) - 1) {}
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    ~spsc_ring() { delete[] buf_; }
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+    // A snapshot that may be stale by the time it is used. head is read before tail so the
+    // difference cannot wrap below zero; it can overshoot while both sides run, hence the clamp.
+    size_type size_approx() const noexcept {
+        const size_type head = head_.load(std::memory_order_acquire);
+        const size_type size = tail_.load(std::memory_order_acquire) - head;
+        return size < capacity() ? size : capacity();
+    }
+
+    bool empty_approx() const noexcept { return size_approx() == 0; }
+
+    // Producer side.
+
+    bool try_push(const T& value) { return push_(value); }
+
+    bool try_push(T&& value) { return push_(mystl::move(value)); }
+
+    // Up to n free slots starting at the tail, as one contiguous span: it is shorter than n when
+    // the ring is nearly full or the free region wraps around the end of the buffer. The slots
+    // hold valid but unspecified values; the producer overwrites them and then calls commit().
+    std::span<T> acquire_write(size_type n) noexcept {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (capacity() - (tail - cached_head_) < n) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        return {buf_ + (tail & mask_), clamp_(n, capacity() - (tail - cached_head_), tail)};
+    }
+
+    // Publishes the first n slots of the last acquire_write() span to the consumer.
+    void commit(size_type n) noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Consumer side.
+
+    bool try_pop(T& out) {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = mystl::move(buf_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Up to n filled slots starting at the head, as one contiguous span, shortened the same way
+    // as acquire_write(). The consumer may read or move from them, then calls release().
+    std::span<T> peek(size_type n) noexcept {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ - head < n) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        return {buf_ + (head & mask_), clamp_(n, cached_tail_ - head, head)};
+    }
+
+    // Hands the first n slots of the last peek() span back to the producer.
+    void release(size_type n) noexcept {
+        head_.store(head_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+private:
+    static size_type round_up_(size_type n) noexcept {
+        size_type cap = 1;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    // min(n, available, slots left before the buffer wraps at index pos).
+    size_type clamp_(size_type n, size_type available, size_type pos) const noexcept {
+        const size_type to_end = capacity() - (pos & mask_);
+        n = n < available ? n : available;
+        return n < to_end ? n : to_end;
+    }
+
+    template <typename U>
+    bool push_(U&& value) {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == capacity()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == capacity()) {
+                return false;
+            }
+        }
+        buf_[tail & mask_] = mystl::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer's line.
+    alignas(64) std::atomic<size_type> head_{0};
+    size_type cached_tail_ = 0;
+    // Producer's line.
+    alignas(64) std::atomic<size_type> tail_{0};
+    size_type cached_head_ = 0;
+    // Read-only after construction.
+    alignas(64) T* const buf_;
+    const size_type mask_;
+};
+
+}  // namespace mystl
+
+#endif
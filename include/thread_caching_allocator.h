@@ -0,0 +1,535 @@
+#ifndef MYSTL_HANDMADE_THREAD_CACHING_ALLOCATOR_H_
+#define MYSTL_HANDMADE_THREAD_CACHING_ALLOCATOR_H_
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "memory.h"
+#include "type_traits.h"
+
+// Size-class allocator with per-thread caches, in the spirit of tcmalloc:
+//
+//   * Requests up to max_small_size, aligned to at most max_small_alignment, are rounded to one
+//     of num_classes size classes. Each thread
+//     keeps a free list per class and only touches the shared central list to refill or flush a
+//     whole batch, so the common path takes no lock.
+//   * Central lists carve objects out of spans: span_size-aligned mappings whose header records
+//     the size class, so a pointer's class can be recovered without being told its size.
+//   * Larger or more strictly aligned requests get their own span_size-aligned mapping, rounded
+//     up to whole pages, and are unmapped on release. Sizes that cannot be mapped, and alignments
+//     of span_size or more, throw std::bad_alloc.
+//   * trim() flushes the calling thread's cache and unmaps every span whose objects are all free.
+//
+// mystl::thread_caching_allocator<T> plugs this into allocator_traits. Defining
+// MYSTL_DEFINE_GLOBAL_OPERATOR_NEW() in exactly one translation unit replaces the global
+// (non-aligned) operator new/delete as well.
+
+// Granularity of large mappings; must be a multiple of the system page size.
+#ifndef MYSTL_TC_PAGE_SIZE
+#define MYSTL_TC_PAGE_SIZE 4096
+#endif
+
+namespace mystl {
+namespace tc {
+
+inline constexpr size_t span_size = size_t{256} << 10;
+inline constexpr size_t span_header_size = 64;
+inline constexpr size_t min_alignment = 16;
+inline constexpr size_t max_small_size = size_t{32} << 10;
+inline constexpr size_t max_small_alignment = 128;
+inline constexpr size_t num_classes = 16 + 7 * 4;
+inline constexpr size_t page_size = MYSTL_TC_PAGE_SIZE;
+
+namespace detail {
+
+// Sizes up to 256 bytes use 16-byte steps; above that every power-of-two range is split into
+// four classes, which bounds internal fragmentation at 25%.
+constexpr size_t size_to_class(size_t bytes) noexcept {
+    if (bytes <= 256) {
+        return bytes == 0 ? 0 : (bytes + 15) / 16 - 1;
+    }
+    const size_t n = bytes - 1;
+    const size_t lg = static_cast<size_t>(63 - __builtin_clzll(n));
+    const size_t step = (size_t{1} << lg) / 4;
+    return 16 + (lg - 8) * 4 + (n - (size_t{1} << lg)) / step;
+}
+
+constexpr size_t class_to_size(size_t cls) noexcept {
+    if (cls < 16) {
+        return (cls + 1) * 16;
+    }
+    const size_t lg = 8 + (cls - 16) / 4;
+    const size_t step = (size_t{1} << lg) / 4;
+    return (size_t{1} << lg) + ((cls - 16) % 4 + 1) * step;
+}
+
+// Every object of a class is aligned to the largest power of two dividing its size, up to
+// max_small_alignment: objects start at class_offset(cls) in their span, a multiple of that too.
+constexpr size_t class_alignment(size_t cls) noexcept {
+    const size_t size = class_to_size(cls);
+    const size_t lowest_bit = size & (~size + 1);
+    return lowest_bit < max_small_alignment ? lowest_bit : max_small_alignment;
+}
+
+// Class for a request of `bytes` at `alignment` (a power of two up to max_small_alignment): the
+// smallest class that holds max(bytes, alignment) and whose objects are aligned enough. Sizes
+// above 256 are multiples of 64, and every power of two is a class, so this steps at most a few
+// classes past size_to_class.
+constexpr size_t size_to_class(size_t bytes, size_t alignment) noexcept {
+    if (alignment <= min_alignment) {
+        return size_to_class(bytes);
+    }
+    size_t cls = size_to_class(bytes > alignment ? bytes : alignment);
+    while (class_alignment(cls) < alignment) {
+        ++cls;
+    }
+    return cls;
+}
+
+// Number of objects moved between a thread cache and the central list at once.
+constexpr size_t batch_size(size_t cls) noexcept {
+    const size_t n = (size_t{64} << 10) / class_to_size(cls);
+    return n < 2 ? 2 : (n > 64 ? 64 : n);
+}
+
+static_assert(class_to_size(num_classes - 1) == max_small_size);
+static_assert(size_to_class(max_small_size) == num_classes - 1);
+static_assert(class_alignment(num_classes - 1) == max_small_alignment);
+static_assert(page_size % 4096 == 0 && span_size % page_size == 0);
+
+struct free_object {
+    free_object* next;
+};
+
+enum class span_kind : uint32_t { small = 0x5350414e, large = 0x4c415247 };
+
+struct alignas(span_header_size) span_header {
+    span_kind kind;
+    uint32_t size_class;
+    size_t mapping_bytes;
+    size_t capacity;
+    size_t free_count;
+    span_header* next;
+};
+
+static_assert(sizeof(span_header) == span_header_size);
+
+constexpr size_t class_offset(size_t cls) noexcept {
+    return class_alignment(cls) > span_header_size ? class_alignment(cls) : span_header_size;
+}
+
+inline span_header* span_of(void* p) noexcept {
+    return reinterpret_cast<span_header*>(reinterpret_cast<uintptr_t>(p) & ~(span_size - 1));
+}
+
+// Maps `bytes` (a multiple of page_size) at a span_size-aligned address.
+inline void* map_aligned(size_t bytes) {
+    const size_t padded = bytes + span_size;
+    void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (start + span_size - 1) & ~(span_size - 1);
+    if (aligned != start) {
+        ::munmap(raw, aligned - start);
+    }
+    const uintptr_t tail = aligned + bytes;
+    if (tail != start + padded) {
+        ::munmap(reinterpret_cast<void*>(tail), start + padded - tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+inline void unmap(void* p, size_t bytes) noexcept {
+    ::munmap(p, bytes);
+}
+
+struct alignas(64) central_list {
+    std::mutex mutex;
+    free_object* head = nullptr;
+    size_t count = 0;
+    span_header* spans = nullptr;
+};
+
+inline central_list* central_lists() noexcept {
+    static central_list lists[num_classes];
+    return lists;
+}
+
+// Carves a fresh span into objects of class `cls` and pushes them onto the central list.
+// Caller holds the list's mutex.
+inline void grow_central(central_list& list, size_t cls) {
+    const size_t size = class_to_size(cls);
+    void* base = map_aligned(span_size);
+    const size_t offset = class_offset(cls);
+    const size_t capacity = (span_size - offset) / size;
+    auto* span = ::new (base) span_header{span_kind::small, static_cast<uint32_t>(cls), span_size,
+                                          capacity, capacity, list.spans};
+    list.spans = span;
+
+    char* first = static_cast<char*>(base) + offset;
+    free_object* head = list.head;
+    for (size_t i = capacity; i > 0; --i) {
+        head = ::new (first + (i - 1) * size) free_object{head};
+    }
+    list.head = head;
+    list.count += capacity;
+}
+
+// Moves up to `want` objects from the central list into a chain; returns how many were moved.
+inline size_t fetch_from_central(size_t cls, size_t want, free_object*& out) {
+    central_list& list = central_lists()[cls];
+    std::lock_guard<std::mutex> lock(list.mutex);
+    if (list.count < want) {
+        grow_central(list, cls);
+    }
+    free_object* head = list.head;
+    free_object* last = head;
+    span_of(last)->free_count--;
+    for (size_t i = 1; i < want; ++i) {
+        last = last->next;
+        span_of(last)->free_count--;
+    }
+    list.head = last->next;
+    list.count -= want;
+    last->next = nullptr;
+    out = head;
+    return want;
+}
+
+inline void return_to_central(size_t cls, free_object* head, free_object* tail, size_t n) {
+    central_list& list = central_lists()[cls];
+    std::lock_guard<std::mutex> lock(list.mutex);
+    for (free_object* obj = head;; obj = obj->next) {
+        span_of(obj)->free_count++;
+        if (obj == tail) {
+            break;
+        }
+    }
+    tail->next = list.head;
+    list.head = head;
+    list.count += n;
+}
+
+struct thread_cache {
+    free_object* lists[num_classes] = {};
+    uint32_t counts[num_classes] = {};
+
+    void* allocate(size_t cls) {
+        free_object* obj = lists[cls];
+        if (obj == nullptr) [[unlikely]] {
+            counts[cls] = static_cast<uint32_t>(fetch_from_central(cls, batch_size(cls), obj));
+        }
+        lists[cls] = obj->next;
+        --counts[cls];
+        return obj;
+    }
+
+    void deallocate(void* p, size_t cls) {
+        lists[cls] = ::new (p) free_object{lists[cls]};
+        if (++counts[cls] > 2 * batch_size(cls)) [[unlikely]] {
+            flush(cls, batch_size(cls));
+        }
+    }
+
+    void flush(size_t cls, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        free_object* head = lists[cls];
+        free_object* tail = head;
+        for (size_t i = 1; i < n; ++i) {
+            tail = tail->next;
+        }
+        lists[cls] = tail->next;
+        counts[cls] -= static_cast<uint32_t>(n);
+        return_to_central(cls, head, tail, n);
+    }
+
+    void flush_all() {
+        for (size_t cls = 0; cls < num_classes; ++cls) {
+            flush(cls, counts[cls]);
+        }
+    }
+};
+
+enum class cache_state : unsigned char { uninitialized, live, destroyed };
+
+inline thread_local cache_state tls_state = cache_state::uninitialized;
+
+struct thread_cache_holder {
+    thread_cache cache;
+
+    thread_cache_holder() noexcept { tls_state = cache_state::live; }
+    ~thread_cache_holder() {
+        cache.flush_all();
+        tls_state = cache_state::destroyed;
+    }
+};
+
+// Returns nullptr once the calling thread's cache has been torn down, in which case callers go
+// straight to the central lists.
+inline thread_cache* current_cache() noexcept {
+    if (tls_state == cache_state::destroyed) [[unlikely]] {
+        return nullptr;
+    }
+    static thread_local thread_cache_holder holder;
+    return &holder.cache;
+}
+
+constexpr size_t large_offset(size_t alignment) noexcept {
+    return alignment > span_header_size ? alignment : span_header_size;
+}
+
+// Largest block a mapping with this header offset can hold: rounding offset + bytes up to a
+// whole page, plus the span map_aligned pads with, must not wrap around.
+constexpr size_t max_large_size(size_t offset) noexcept {
+    return SIZE_MAX - offset - 2 * span_size;
+}
+
+// Only valid for bytes <= max_large_size(offset).
+constexpr size_t large_mapping_size(size_t offset, size_t bytes) noexcept {
+    return (offset + bytes + page_size - 1) & ~(page_size - 1);
+}
+
+// The header of a block is found by rounding its address down to a span boundary, so a block
+// may not itself be span-aligned: alignments of span_size and up are refused.
+constexpr bool large_fits(size_t bytes, size_t alignment) noexcept {
+    return alignment < span_size && bytes <= max_large_size(large_offset(alignment));
+}
+
+inline void* allocate_large(size_t bytes, size_t alignment) {
+    if (!large_fits(bytes, alignment)) {
+        throw std::bad_alloc();
+    }
+    const size_t offset = large_offset(alignment);
+    const size_t mapping = large_mapping_size(offset, bytes);
+    void* base = map_aligned(mapping);
+    ::new (base) span_header{span_kind::large, 0, mapping, 1, 0, nullptr};
+    return static_cast<char*>(base) + offset;
+}
+
+constexpr bool is_small(size_t bytes, size_t alignment) noexcept {
+    return bytes <= max_small_size && alignment <= max_small_alignment;
+}
+
+inline void deallocate_small(void* p, size_t cls) {
+    if (thread_cache* cache = current_cache()) [[likely]] {
+        cache->deallocate(p, cls);
+    } else {
+        auto* obj = ::new (p) free_object{nullptr};
+        return_to_central(cls, obj, obj, 1);
+    }
+}
+
+}  // namespace detail
+
+[[nodiscard]] inline void* allocate(size_t bytes, size_t alignment = min_alignment) {
+    if (detail::is_small(bytes, alignment)) [[likely]] {
+        const size_t cls = detail::size_to_class(bytes, alignment);
+        if (detail::thread_cache* cache = detail::current_cache()) [[likely]] {
+            return cache->allocate(cls);
+        }
+        detail::free_object* obj = nullptr;
+        detail::fetch_from_central(cls, 1, obj);
+        return obj;
+    }
+    return detail::allocate_large(bytes, alignment);
+}
+
+// Sized release: small blocks find their class from `bytes` without touching the span header.
+inline void deallocate(void* p, size_t bytes, size_t alignment = min_alignment) {
+    if (p == nullptr) {
+        return;
+    }
+    if (detail::is_small(bytes, alignment)) [[likely]] {
+        detail::deallocate_small(p, detail::size_to_class(bytes, alignment));
+        return;
+    }
+    detail::span_header* span = detail::span_of(p);
+    detail::unmap(span, span->mapping_bytes);
+}
+
+// Unsized release, used by the global operator delete replacement.
+inline void deallocate(void* p) {
+    if (p == nullptr) {
+        return;
+    }
+    detail::span_header* span = detail::span_of(p);
+    if (span->kind == detail::span_kind::small) {
+        detail::deallocate_small(p, span->size_class);
+    } else {
+        detail::unmap(span, span->mapping_bytes);
+    }
+}
+
+// Usable size of a block returned by allocate(bytes, alignment). Requesting exactly this many
+// bytes maps to the same size class or mapping, so callers may allocate and free with it.
+// Requests that allocate() refuses are returned unchanged.
+constexpr size_t good_size(size_t bytes, size_t alignment = min_alignment) noexcept {
+    if (detail::is_small(bytes, alignment)) {
+        return detail::class_to_size(detail::size_to_class(bytes, alignment));
+    }
+    if (!detail::large_fits(bytes, alignment)) {
+        return bytes;
+    }
+    const size_t offset = detail::large_offset(alignment);
+    return detail::large_mapping_size(offset, bytes) - offset;
+}
+
+// Grows the block at p from old_bytes to at least new_bytes without moving it. Small blocks can
+// only grow within their size class; large blocks are extended with mremap when the address
+// range after the mapping is free. Returns the new usable size, or 0 on failure.
+inline size_t try_expand(void* p, size_t old_bytes, size_t new_bytes,
+                         size_t alignment = min_alignment) noexcept {
+    if (detail::is_small(old_bytes, alignment)) {
+        const size_t usable = good_size(old_bytes, alignment);
+        return new_bytes <= usable ? usable : 0;
+    }
+    detail::span_header* span = detail::span_of(p);
+    const size_t offset = static_cast<size_t>(static_cast<char*>(p) - reinterpret_cast<char*>(span));
+    if (new_bytes > detail::max_large_size(offset)) {
+        return 0;
+    }
+    const size_t mapping = detail::large_mapping_size(offset, new_bytes);
+    if (mapping <= span->mapping_bytes) {
+        return span->mapping_bytes - offset;
+    }
+#if defined(__linux__)
+    void* grown = ::mremap(span, span->mapping_bytes, mapping, 0);
+    if (grown == span) {
+        span->mapping_bytes = mapping;
+        return mapping - offset;
+    }
+#endif
+    return 0;
+}
+
+// Flushes the calling thread's cache and returns every completely free span to the OS.
+inline void trim() {
+    if (detail::thread_cache* cache = detail::current_cache()) {
+        cache->flush_all();
+    }
+    for (size_t cls = 0; cls < num_classes; ++cls) {
+        detail::central_list& list = detail::central_lists()[cls];
+        std::lock_guard<std::mutex> lock(list.mutex);
+
+        bool any_idle = false;
+        for (detail::span_header* span = list.spans; span != nullptr; span = span->next) {
+            any_idle |= span->free_count == span->capacity;
+        }
+        if (!any_idle) {
+            continue;
+        }
+
+        detail::free_object** link = &list.head;
+        while (*link != nullptr) {
+            detail::span_header* span = detail::span_of(*link);
+            if (span->free_count == span->capacity) {
+                *link = (*link)->next;
+                --list.count;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+
+        detail::span_header** span_link = &list.spans;
+        while (*span_link != nullptr) {
+            detail::span_header* span = *span_link;
+            if (span->free_count == span->capacity) {
+                *span_link = span->next;
+                detail::unmap(span, span->mapping_bytes);
+            } else {
+                span_link = &span->next;
+            }
+        }
+    }
+}
+
+}  // namespace tc
+
+template <typename T>
+class thread_caching_allocator {
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = true_type;
+    using is_always_equal                        = true_type;
+
+    constexpr thread_caching_allocator() noexcept = default;
+
+    template <typename U>
+    constexpr thread_caching_allocator(const thread_caching_allocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(tc::allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // Reports the full size-class capacity so containers grow into the slack for free.
+    [[nodiscard]] allocation_result<T*> allocate_at_least(size_t n) {
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        const size_t count = tc::good_size(n * sizeof(T), alignof(T)) / sizeof(T);
+        return {static_cast<T*>(tc::allocate(count * sizeof(T), alignof(T))), count};
+    }
+
+    void deallocate(T* p, size_t n) noexcept { tc::deallocate(p, n * sizeof(T), alignof(T)); }
+
+    size_t try_expand(T* p, size_t n, size_t new_n) noexcept {
+        if (new_n > max_size()) {
+            return 0;
+        }
+        return tc::try_expand(p, n * sizeof(T), new_n * sizeof(T), alignof(T)) / sizeof(T);
+    }
+
+    static constexpr size_t max_size() noexcept {
+        return static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+    }
+};
+
+template <typename T, typename U>
+constexpr bool operator==(const thread_caching_allocator<T>&,
+                          const thread_caching_allocator<U>&) noexcept {
+    return true;
+}
+
+}  // namespace mystl
+
+// Replacement functions may not be inline, so this expands to out-of-line definitions and must
+// be used in exactly one translation unit. Aligned forms are left to the C++ runtime.
+#define MYSTL_DEFINE_GLOBAL_OPERATOR_NEW()                                                  \
+    void* operator new(std::size_t n) { return mystl::tc::allocate(n); }                    \
+    void* operator new[](std::size_t n) { return mystl::tc::allocate(n); }                  \
+    void* operator new(std::size_t n, const std::nothrow_t&) noexcept {                     \
+        try {                                                                               \
+            return mystl::tc::allocate(n);                                                  \
+        } catch (...) {                                                                     \
+            return nullptr;                                                                 \
+        }                                                                                   \
+    }                                                                                       \
+    void* operator new[](std::size_t n, const std::nothrow_t& tag) noexcept {               \
+        return ::operator new(n, tag);                                                      \
+    }                                                                                       \
+    void operator delete(void* p) noexcept { mystl::tc::deallocate(p); }                    \
+    void operator delete[](void* p) noexcept { mystl::tc::deallocate(p); }                  \
+    void operator delete(void* p, std::size_t n) noexcept { mystl::tc::deallocate(p, n); }  \
+    void operator delete[](void* p, std::size_t) noexcept { mystl::tc::deallocate(p); }     \
+    void operator delete(void* p, const std::nothrow_t&) noexcept {                         \
+        mystl::tc::deallocate(p);                                                           \
+    }                                                                                       \
+    void operator delete[](void* p, const std::nothrow_t&) noexcept {                       \
+        mystl::tc::deallocate(p);                                                           \
+    }
+
+#endif
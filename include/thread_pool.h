@@ -0,0 +1,201 @@
+#ifndef MYSTL_HANDMADE_THREAD_POOL_H_
+#define MYSTL_HANDMADE_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include "type_traits.h"
+#include "utility.h"
+#include "vector.h"
+
+namespace mystl {
+
+namespace detail {
+    // Queue node. Tasks link themselves into the pool's queue, so queueing never allocates;
+    // `next == nullptr` marks a task that a worker has already dequeued.
+    struct pool_task {
+        void (*run)(pool_task*) noexcept = nullptr;
+        pool_task* prev = nullptr;
+        pool_task* next = nullptr;
+    };
+}  // namespace detail
+
+// A fixed set of worker threads fed from one FIFO queue, for programs that want a pool of their
+// own. The library itself runs everything on scheduler::default_scheduler() (scheduler.h), so
+// that it never starts a second set of workers. parallel_for splits a loop into chunks that the
+// caller and any idle workers claim with an atomic counter, so a loop costs one queue operation
+// per helping worker rather than one per chunk. Tasks must not throw; an escaping exception
+// terminates.
+class thread_pool {
+public:
+    explicit thread_pool(size_t threads = default_thread_count()) {
+        head_.prev = &head_;
+        head_.next = &head_;
+        workers_.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { worker_loop_(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Runs the tasks still queued, then joins the workers.
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (std::thread& t : workers_) {
+            t.join();
+        }
+    }
+
+    size_t size() const noexcept { return workers_.size(); }
+
+    // Runs f() on a worker. The callable is moved into a single heap allocation.
+    template <typename F>
+        requires invocable<decay_t<F>&>
+    void submit(F&& f) {
+        struct task : detail::pool_task {
+            explicit task(F&& fn) : fn(mystl::forward<F>(fn)) {}
+            decay_t<F> fn;
+        };
+        task* t = new task(mystl::forward<F>(f));
+        t->run = [](detail::pool_task* self) noexcept {
+            task* me = static_cast<task*>(self);
+            mystl::invoke(me->fn);
+            delete me;
+        };
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            push_(t);
+        }
+        work_cv_.notify_one();
+    }
+
+    // Calls f(i) for every i in [0, n) and returns once all calls have finished. The caller
+    // runs chunks itself and, when it runs out, withdraws helpers that no worker has picked up
+    // yet, so nested calls from inside a worker cannot deadlock.
+    template <typename F>
+        requires invocable<F&, size_t>
+    void parallel_for(size_t n, F&& f) {
+        if (n == 0) {
+            return;
+        }
+        const size_t helpers = n - 1 < size() ? n - 1 : size();
+        if (helpers == 0) {
+            for (size_t i = 0; i < n; ++i) {
+                mystl::invoke(f, i);
+            }
+            return;
+        }
+
+        struct bulk {
+            F& fn;
+            size_t count;
+            std::atomic<size_t> next{0};
+
+            void work() noexcept {
+                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                    mystl::invoke(fn, i);
+                }
+            }
+        };
+        struct helper : detail::pool_task {
+            bulk* job;
+            thread_pool* pool;
+            size_t* running;
+        };
+
+        bulk job{f, n};
+        size_t running = helpers;
+        vector<helper> nodes(helpers);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (helper& h : nodes) {
+                h.job = &job;
+                h.pool = this;
+                h.running = &running;
+                h.run = [](detail::pool_task* self) noexcept {
+                    helper* me = static_cast<helper*>(self);
+                    me->job->work();
+                    thread_pool* pool = me->pool;
+                    // `me` lives on the caller's stack; it is gone once the count drops.
+                    {
+                        std::lock_guard<std::mutex> lock(pool->mutex_);
+                        --*me->running;
+                    }
+                    pool->done_cv_.notify_all();
+                };
+                push_(&h);
+            }
+        }
+        work_cv_.notify_all();
+        job.work();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (helper& h : nodes) {
+            if (h.next != nullptr) {
+                unlink_(&h);
+                --running;
+            }
+        }
+        done_cv_.wait(lock, [&running] { return running == 0; });
+    }
+
+    // MYSTL_NUM_THREADS - 1 workers if that is set, else hardware_concurrency() - 1: the
+    // thread that calls parallel_for is the last one.
+    static size_t default_thread_count() noexcept {
+        size_t threads = std::thread::hardware_concurrency();
+        if (const char* env = std::getenv("MYSTL_NUM_THREADS")) {
+            threads = std::strtoul(env, nullptr, 10);
+        }
+        return threads > 1 ? threads - 1 : 0;
+    }
+
+private:
+    void push_(detail::pool_task* t) noexcept {
+        t->prev = head_.prev;
+        t->next = &head_;
+        head_.prev->next = t;
+        head_.prev = t;
+    }
+
+    static void unlink_(detail::pool_task* t) noexcept {
+        t->prev->next = t->next;
+        t->next->prev = t->prev;
+        t->next = nullptr;
+    }
+
+    void worker_loop_() noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return stop_ || head_.next != &head_; });
+            if (head_.next == &head_) {
+                return;
+            }
+            detail::pool_task* t = head_.next;
+            unlink_(t);
+            lock.unlock();
+            t->run(t);
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    detail::pool_task head_;
+    bool stop_ = false;
+    vector<std::thread> workers_;
+};
+
+}  // namespace mystl
+
+#endif
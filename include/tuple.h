@@ -0,0 +1,428 @@
+#ifndef MYSTL_HANDMADE_TUPLE_H_
+#define MYSTL_HANDMADE_TUPLE_H_
+
+#include <compare>
+#include <cstddef>
+#include <utility>
+
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+template <typename... Ts>
+class tuple;
+
+namespace detail {
+    // Element I of a tuple. Empty element types take no space: the leaves are distinct bases of
+    // the tuple, and the member itself is [[no_unique_address]], which also covers final types.
+    template <size_t I, typename T>
+    struct tuple_leaf {
+        using type = T;
+
+        constexpr tuple_leaf() : value() {}
+
+        template <typename... Args>
+        constexpr explicit tuple_leaf(in_place_t, Args&&... args)
+            : value(mystl::forward<Args>(args)...) {}
+
+        [[no_unique_address]] T value;
+    };
+
+    // Overload resolution against the leaf bases finds element I (or the element of type T) in
+    // one step, with no recursive instantiation; a type that occurs twice is ambiguous.
+    template <size_t I, typename T>
+    constexpr tuple_leaf<I, T>& tuple_leaf_at(tuple_leaf<I, T>& leaf) noexcept {
+        return leaf;
+    }
+
+    template <size_t I, typename T>
+    constexpr const tuple_leaf<I, T>& tuple_leaf_at(const tuple_leaf<I, T>& leaf) noexcept {
+        return leaf;
+    }
+
+    template <typename T, size_t I>
+    constexpr tuple_leaf<I, T>& tuple_leaf_of(tuple_leaf<I, T>& leaf) noexcept {
+        return leaf;
+    }
+
+    template <typename T, size_t I>
+    constexpr const tuple_leaf<I, T>& tuple_leaf_of(const tuple_leaf<I, T>& leaf) noexcept {
+        return leaf;
+    }
+
+    struct tuple_from_tuple_t {};
+
+    template <typename Seq, typename... Ts>
+    struct tuple_storage;
+
+    template <size_t... Is, typename... Ts>
+    struct tuple_storage<index_sequence<Is...>, Ts...> : tuple_leaf<Is, Ts>... {
+        constexpr tuple_storage() = default;
+
+        template <typename... Args>
+        constexpr explicit tuple_storage(in_place_t, Args&&... args)
+            : tuple_leaf<Is, Ts>(in_place, mystl::forward<Args>(args))... {}
+
+        // Element-wise from any tuple-like with a matching mystl::get.
+        template <typename Tuple>
+        constexpr tuple_storage(tuple_from_tuple_t, Tuple&& t)
+            : tuple_leaf<Is, Ts>(in_place, get<Is>(mystl::forward<Tuple>(t)))... {}
+    };
+
+    template <typename T>
+    concept tuple_like = requires { tuple_size<remove_cvref_t<T>>::value; };
+}  // namespace detail
+
+template <typename... Ts>
+struct tuple_size<tuple<Ts...>> : integral_constant<size_t, sizeof...(Ts)> {};
+
+template <typename... Ts>
+struct tuple_size<const tuple<Ts...>> : integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t I, typename... Ts>
+struct tuple_element<I, tuple<Ts...>> {
+    static_assert(I < sizeof...(Ts), "Index out of bounds in tuple_element");
+    using type = typename remove_cvref_t<decltype(detail::tuple_leaf_at<I>(
+        mystl::declval<tuple<Ts...>&>()))>::type;
+};
+
+template <size_t I, typename... Ts>
+struct tuple_element<I, const tuple<Ts...>> {
+    using type = add_const_t<tuple_element_t<I, tuple<Ts...>>>;
+};
+
+template <size_t I, typename... Ts>
+constexpr tuple_element_t<I, tuple<Ts...>>& get(tuple<Ts...>& t) noexcept {
+    return detail::tuple_leaf_at<I>(t).value;
+}
+
+template <size_t I, typename... Ts>
+constexpr const tuple_element_t<I, tuple<Ts...>>& get(const tuple<Ts...>& t) noexcept {
+    return detail::tuple_leaf_at<I>(t).value;
+}
+
+template <size_t I, typename... Ts>
+constexpr tuple_element_t<I, tuple<Ts...>>&& get(tuple<Ts...>&& t) noexcept {
+    return static_cast<tuple_element_t<I, tuple<Ts...>>&&>(detail::tuple_leaf_at<I>(t).value);
+}
+
+template <size_t I, typename... Ts>
+constexpr const tuple_element_t<I, tuple<Ts...>>&& get(const tuple<Ts...>&& t) noexcept {
+    return static_cast<const tuple_element_t<I, tuple<Ts...>>&&>(
+        detail::tuple_leaf_at<I>(t).value);
+}
+
+template <typename T, typename... Ts>
+constexpr T& get(tuple<Ts...>& t) noexcept {
+    return detail::tuple_leaf_of<T>(t).value;
+}
+
+template <typename T, typename... Ts>
+constexpr const T& get(const tuple<Ts...>& t) noexcept {
+    return detail::tuple_leaf_of<T>(t).value;
+}
+
+template <typename T, typename... Ts>
+constexpr T&& get(tuple<Ts...>&& t) noexcept {
+    return static_cast<T&&>(detail::tuple_leaf_of<T>(t).value);
+}
+
+template <typename T, typename... Ts>
+constexpr const T&& get(const tuple<Ts...>&& t) noexcept {
+    return static_cast<const T&&>(detail::tuple_leaf_of<T>(t).value);
+}
+
+// Heterogeneous fixed-size collection. It is flat: one base per element over an index_sequence,
+// so instantiating or indexing a tuple of N elements costs O(1) template depth instead of the N
+// levels of a recursive head/tail layout. Empty elements occupy no storage, and a tuple of
+// trivially copyable or relocatable elements is itself trivially copyable or relocatable.
+template <typename... Ts>
+class tuple : public detail::tuple_storage<index_sequence_for<Ts...>, Ts...> {
+    using base = detail::tuple_storage<index_sequence_for<Ts...>, Ts...>;
+
+    static constexpr bool has_references_ = (is_reference_v<Ts> || ...);
+
+    template <typename... Us>
+    static constexpr bool is_self_ =
+        sizeof...(Us) == 1 && (is_same_v<remove_cvref_t<Us>, tuple> && ...);
+
+    // A one-element tuple built from another tuple treats it as its element, not element-wise,
+    // when the element can be constructed from it directly.
+    template <typename Tuple>
+    static constexpr bool converts_from_ =
+        !is_same_v<remove_cvref_t<Tuple>, tuple> &&
+        (sizeof...(Ts) != 1 || (!is_constructible_v<Ts, Tuple> && ...));
+
+public:
+    using trivially_relocatable = bool_constant<(is_trivially_relocatable_v<Ts> && ...)>;
+
+    constexpr tuple()
+        requires(is_default_constructible_v<Ts> && ...)
+    = default;
+
+    constexpr explicit(!(is_convertible_v<const Ts&, Ts> && ...)) tuple(const Ts&... args)
+        requires(sizeof...(Ts) >= 1 && (is_copy_constructible_v<Ts> && ...))
+        : base(in_place, args...) {}
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && sizeof...(Ts) >= 1 && !is_self_<Us...> &&
+                 (is_constructible_v<Ts, Us> && ...))
+    constexpr explicit(!(is_convertible_v<Us, Ts> && ...)) tuple(Us&&... args)
+        : base(in_place, mystl::forward<Us>(args)...) {}
+
+    constexpr tuple(const tuple&) = default;
+    constexpr tuple(tuple&&) = default;
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && converts_from_<const tuple<Us...>&> &&
+                 (is_constructible_v<Ts, const Us&> && ...))
+    constexpr explicit(!(is_convertible_v<const Us&, Ts> && ...)) tuple(const tuple<Us...>& t)
+        : base(detail::tuple_from_tuple_t{}, t) {}
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && converts_from_<tuple<Us...>&&> &&
+                 (is_constructible_v<Ts, Us> && ...))
+    constexpr explicit(!(is_convertible_v<Us, Ts> && ...)) tuple(tuple<Us...>&& t)
+        : base(detail::tuple_from_tuple_t{}, mystl::move(t)) {}
+
+    template <typename U1, typename U2>
+        requires(sizeof...(Ts) == 2 && is_constructible_v<tuple, const U1&, const U2&>)
+    constexpr tuple(const pair<U1, U2>& p) : base(detail::tuple_from_tuple_t{}, p) {}
+
+    template <typename U1, typename U2>
+        requires(sizeof...(Ts) == 2 && is_constructible_v<tuple, U1, U2>)
+    constexpr tuple(pair<U1, U2>&& p) : base(detail::tuple_from_tuple_t{}, mystl::move(p)) {}
+
+    // Tuples of references assign through them, so they cannot use the defaulted operators.
+    constexpr tuple& operator=(const tuple&)
+        requires(!has_references_)
+    = default;
+
+    constexpr tuple& operator=(tuple&&)
+        requires(!has_references_)
+    = default;
+
+    constexpr tuple& operator=(const tuple& other)
+        requires(has_references_ && (is_copy_assignable_v<Ts> && ...))
+    {
+        assign_(other, index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    constexpr tuple& operator=(tuple&& other) noexcept((is_nothrow_assignable_v<Ts&, Ts> && ...))
+        requires(has_references_ && (is_assignable_v<Ts&, Ts> && ...))
+    {
+        assign_(mystl::move(other), index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && !is_same_v<tuple<Us...>, tuple> &&
+                 (is_assignable_v<Ts&, const Us&> && ...))
+    constexpr tuple& operator=(const tuple<Us...>& other) {
+        assign_(other, index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts) && !is_same_v<tuple<Us...>, tuple> &&
+                 (is_assignable_v<Ts&, Us> && ...))
+    constexpr tuple& operator=(tuple<Us...>&& other) {
+        assign_(mystl::move(other), index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    template <typename U1, typename U2>
+        requires(sizeof...(Ts) == 2 && is_assignable_v<tuple&, tuple<const U1&, const U2&>>)
+    constexpr tuple& operator=(const pair<U1, U2>& p) {
+        assign_(p, index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    template <typename U1, typename U2>
+        requires(sizeof...(Ts) == 2 && is_assignable_v<tuple&, tuple<U1&&, U2&&>>)
+    constexpr tuple& operator=(pair<U1, U2>&& p) {
+        assign_(mystl::move(p), index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    constexpr void swap(tuple& other) noexcept((is_nothrow_swappable_v<Ts> && ...)) {
+        swap_(other, index_sequence_for<Ts...>{});
+    }
+
+    friend constexpr void swap(tuple& a, tuple& b) noexcept(noexcept(a.swap(b)))
+        requires(is_swappable_v<Ts> && ...)
+    {
+        a.swap(b);
+    }
+
+private:
+    template <typename Tuple, size_t... Is>
+    constexpr void assign_(Tuple&& other, index_sequence<Is...>) {
+        ((get<Is>(*this) = get<Is>(mystl::forward<Tuple>(other))), ...);
+    }
+
+    template <size_t... Is>
+    constexpr void swap_(tuple& other, index_sequence<Is...>) {
+        using mystl::swap;
+        (swap(get<Is>(*this), get<Is>(other)), ...);
+    }
+};
+
+template <typename... Ts>
+tuple(Ts...) -> tuple<Ts...>;
+
+template <typename T1, typename T2>
+tuple(pair<T1, T2>) -> tuple<T1, T2>;
+
+namespace detail {
+    template <typename... Ts, typename... Us, size_t... Is>
+    constexpr bool tuple_equal(const tuple<Ts...>& a, const tuple<Us...>& b, index_sequence<Is...>) {
+        return ((get<Is>(a) == get<Is>(b)) && ...);
+    }
+
+    template <typename R, typename... Ts, typename... Us, size_t... Is>
+    constexpr R tuple_compare(const tuple<Ts...>& a, const tuple<Us...>& b, index_sequence<Is...>) {
+        R result = std::strong_ordering::equal;
+        static_cast<void>(((result = get<Is>(a) <=> get<Is>(b), result == 0) && ...));
+        return result;
+    }
+}  // namespace detail
+
+template <typename... Ts, typename... Us>
+    requires(sizeof...(Ts) == sizeof...(Us))
+constexpr bool operator==(const tuple<Ts...>& a, const tuple<Us...>& b) {
+    return detail::tuple_equal(a, b, index_sequence_for<Ts...>{});
+}
+
+template <typename... Ts, typename... Us>
+    requires(sizeof...(Ts) == sizeof...(Us))
+constexpr auto operator<=>(const tuple<Ts...>& a, const tuple<Us...>& b)
+    -> std::common_comparison_category_t<
+        decltype(mystl::declval<const Ts&>() <=> mystl::declval<const Us&>())...> {
+    using R = std::common_comparison_category_t<
+        decltype(mystl::declval<const Ts&>() <=> mystl::declval<const Us&>())...>;
+    return detail::tuple_compare<R>(a, b, index_sequence_for<Ts...>{});
+}
+
+template <typename... Args>
+constexpr tuple<unwrap_ref_decay_t<Args>...> make_tuple(Args&&... args) {
+    return tuple<unwrap_ref_decay_t<Args>...>(mystl::forward<Args>(args)...);
+}
+
+template <typename... Args>
+constexpr tuple<Args&...> tie(Args&... args) noexcept {
+    return tuple<Args&...>(args...);
+}
+
+template <typename... Args>
+constexpr tuple<Args&&...> forward_as_tuple(Args&&... args) noexcept {
+    return tuple<Args&&...>(mystl::forward<Args>(args)...);
+}
+
+namespace detail {
+    struct ignore_t {
+        template <typename T>
+        constexpr const ignore_t& operator=(const T&) const noexcept {
+            return *this;
+        }
+    };
+}  // namespace detail
+
+// Placeholder for tie() positions whose values are not wanted.
+inline constexpr detail::ignore_t ignore{};
+
+namespace detail {
+    template <typename F, typename Tuple, size_t... Is>
+    constexpr decltype(auto) apply_impl(F&& f, Tuple&& t, index_sequence<Is...>) noexcept(
+        noexcept(mystl::invoke(mystl::forward<F>(f), get<Is>(mystl::forward<Tuple>(t))...))) {
+        return mystl::invoke(mystl::forward<F>(f), get<Is>(mystl::forward<Tuple>(t))...);
+    }
+
+    template <typename T, typename Tuple, size_t... Is>
+    constexpr T make_from_tuple_impl(Tuple&& t, index_sequence<Is...>) {
+        return T(get<Is>(mystl::forward<Tuple>(t))...);
+    }
+
+    template <typename Tuple>
+    using tuple_indices_for = make_index_sequence<tuple_size<remove_cvref_t<Tuple>>::value>;
+}  // namespace detail
+
+// Calls f with the elements of t (a tuple or pair) as arguments, forwarded with t's value
+// category, so an rvalue tuple's elements are moved straight into the parameters.
+template <typename F, detail::tuple_like Tuple>
+constexpr decltype(auto) apply(F&& f, Tuple&& t) noexcept(noexcept(detail::apply_impl(
+    mystl::forward<F>(f), mystl::forward<Tuple>(t), detail::tuple_indices_for<Tuple>{}))) {
+    return detail::apply_impl(mystl::forward<F>(f), mystl::forward<Tuple>(t),
+                              detail::tuple_indices_for<Tuple>{});
+}
+
+// Constructs a T in place (guaranteed elision) from the elements of t.
+template <typename T, detail::tuple_like Tuple>
+constexpr T make_from_tuple(Tuple&& t) {
+    return detail::make_from_tuple_impl<T>(mystl::forward<Tuple>(t),
+                                           detail::tuple_indices_for<Tuple>{});
+}
+
+namespace detail {
+    // For element K of the concatenation: which argument it comes from and its index there.
+    template <size_t... Sizes>
+    struct tuple_cat_table {
+        static constexpr size_t size = (Sizes + ... + 0);
+
+        struct entry {
+            size_t outer;
+            size_t inner;
+        };
+
+        struct entries {
+            entry at[size + 1];
+        };
+
+        static constexpr entries value = [] {
+            constexpr size_t sizes[] = {Sizes..., 0};
+            entries e{};
+            size_t k = 0;
+            for (size_t outer = 0; outer < sizeof...(Sizes); ++outer) {
+                for (size_t inner = 0; inner < sizes[outer]; ++inner, ++k) {
+                    e.at[k] = {outer, inner};
+                }
+            }
+            return e;
+        }();
+    };
+
+    template <typename Table, typename Refs, size_t... Ks>
+    constexpr auto tuple_cat_impl(Refs&& refs, index_sequence<Ks...>) {
+        using result = tuple<tuple_element_t<
+            Table::value.at[Ks].inner,
+            remove_cvref_t<tuple_element_t<Table::value.at[Ks].outer, remove_cvref_t<Refs>>>>...>;
+        return result(get<Table::value.at[Ks].inner>(
+            get<Table::value.at[Ks].outer>(mystl::forward<Refs>(refs)))...);
+    }
+}  // namespace detail
+
+// Concatenates tuples (and pairs). Each element is copied or moved once, directly from its source
+// into the result, with no intermediate tuples.
+template <detail::tuple_like... Tuples>
+constexpr auto tuple_cat(Tuples&&... tuples) {
+    using table = detail::tuple_cat_table<tuple_size<remove_cvref_t<Tuples>>::value...>;
+    return detail::tuple_cat_impl<table>(mystl::forward_as_tuple(mystl::forward<Tuples>(tuples)...),
+                                         make_index_sequence<table::size>{});
+}
+
+}  // namespace mystl
+
+// Structured bindings look up std::tuple_size / std::tuple_element and then find get by ADL.
+namespace std {
+template <typename... Ts>
+struct tuple_size<mystl::tuple<Ts...>> : mystl::integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t I, typename... Ts>
+struct tuple_element<I, mystl::tuple<Ts...>> {
+    using type = mystl::tuple_element_t<I, mystl::tuple<Ts...>>;
+};
+}  // namespace std
+
+#endif
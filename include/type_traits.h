@@ -173,6 +173,30 @@ struct add_pointer {
 template <typename T>
 using add_pointer_t = typename add_pointer<T>::type;
 
+template <typename T>
+struct remove_pointer {
+    using type = T;
+};
+template <typename T>
+struct remove_pointer<T*> {
+    using type = T;
+};
+template <typename T>
+struct remove_pointer<T* const> {
+    using type = T;
+};
+template <typename T>
+struct remove_pointer<T* volatile> {
+    using type = T;
+};
+template <typename T>
+struct remove_pointer<T* const volatile> {
+    using type = T;
+};
+
+template <typename T>
+using remove_pointer_t = typename remove_pointer<T>::type;
+
 template <typename T, typename = void>
 struct add_lvalue_reference {
     using type = T;
@@ -283,6 +307,14 @@ struct is_array<T[]> : true_type {};
 template <typename T, size_t N>
 struct is_array<T[N]> : true_type {};
 
+template <typename T>
+struct is_unbounded_array : false_type {};
+template <typename T>
+struct is_unbounded_array<T[]> : true_type {};
+
+template <typename T>
+inline constexpr bool is_unbounded_array_v = is_unbounded_array<T>::value;
+
 template <typename T, typename... Args>
 struct is_nothrow_constructible : bool_constant<__is_nothrow_constructible(T, Args...)> {};
 
@@ -295,6 +327,19 @@ struct is_nothrow_move_constructible : bool_constant<__is_nothrow_constructible(
 template <typename T>
 inline constexpr bool is_nothrow_move_constructible_v = is_nothrow_move_constructible<T>::value;
 
+template <typename T>
+struct is_nothrow_copy_constructible : bool_constant<__is_nothrow_constructible(T, const T&)> {};
+
+template <typename T>
+inline constexpr bool is_nothrow_copy_constructible_v = is_nothrow_copy_constructible<T>::value;
+
+template <typename T>
+struct is_nothrow_default_constructible : bool_constant<__is_nothrow_constructible(T)> {};
+
+template <typename T>
+inline constexpr bool is_nothrow_default_constructible_v =
+    is_nothrow_default_constructible<T>::value;
+
 template <typename T, typename... Args>
 struct is_trivially_constructible : bool_constant<__is_trivially_constructible(T, Args...)> {};
 
@@ -313,6 +358,73 @@ struct is_trivially_move_constructible : is_trivially_constructible<T, T&&> {};
 template <typename T>
 inline constexpr bool is_trivially_move_constructible_v = is_trivially_move_constructible<T>::value;
 
+template <typename T>
+struct is_trivially_default_constructible : is_trivially_constructible<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_default_constructible_v =
+    is_trivially_default_constructible<T>::value;
+
+template <typename T, typename U>
+struct is_trivially_assignable : bool_constant<__is_trivially_assignable(T, U)> {};
+
+template <typename T, typename U>
+inline constexpr bool is_trivially_assignable_v = is_trivially_assignable<T, U>::value;
+
+template <typename T>
+struct is_trivially_copy_assignable : is_trivially_assignable<T&, const T&> {};
+
+template <typename T>
+inline constexpr bool is_trivially_copy_assignable_v = is_trivially_copy_assignable<T>::value;
+
+template <typename T>
+struct is_trivially_move_assignable : is_trivially_assignable<T&, T&&> {};
+
+template <typename T>
+inline constexpr bool is_trivially_move_assignable_v = is_trivially_move_assignable<T>::value;
+
+template <typename T>
+struct is_empty : bool_constant<__is_empty(T)> {};
+
+template <typename T>
+inline constexpr bool is_empty_v = is_empty<T>::value;
+
+template <typename T>
+struct is_final : bool_constant<__is_final(T)> {};
+
+template <typename T>
+inline constexpr bool is_final_v = is_final<T>::value;
+
+template <typename T>
+struct is_trivially_copyable : bool_constant<__is_trivially_copyable(T)> {};
+
+template <typename T>
+inline constexpr bool is_trivially_copyable_v = is_trivially_copyable<T>::value;
+
+namespace detail {
+template <typename T>
+concept declares_trivially_relocatable = requires {
+    typename T::trivially_relocatable;
+    requires bool(T::trivially_relocatable::value);
+};
+}  // namespace detail
+
+// A type is trivially relocatable when moving an object to new storage and destroying the
+// original is equivalent to copying its bytes. Class types opt in either by specializing this
+// trait or by declaring `using trivially_relocatable = mystl::true_type;`.
+template <typename T>
+struct is_trivially_relocatable
+    : bool_constant<(is_trivially_move_constructible_v<remove_all_extents_t<T>> &&
+                     is_trivially_destructible_v<remove_all_extents_t<T>>) ||
+                    detail::declares_trivially_relocatable<remove_all_extents_t<T>>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+constexpr bool is_constant_evaluated() noexcept {
+    return __builtin_is_constant_evaluated();
+}
+
 template <typename T>
 inline constexpr bool is_array_v = is_array<T>::value;
 
@@ -438,18 +550,12 @@ namespace detail {
 template <typename T, bool = is_arithmetic_v<T>>
 struct is_signed_helper : false_type {};
 template <typename T>
-struct is_signed_helper<T, true> {
-    static constexpr bool _v = (T(-1) < T(0));
-    using type = bool_constant<_v>;
-};
+struct is_signed_helper<T, true> : bool_constant<(T(-1) < T(0))> {};
 
 template <typename T, bool = is_arithmetic_v<T>>
 struct is_unsigned_helper : false_type {};
 template <typename T>
-struct is_unsigned_helper<T, true> {
-    static constexpr bool _v = (T(0) < T(-1));
-    using type = bool_constant<_v>;
-};
+struct is_unsigned_helper<T, true> : bool_constant<(T(0) < T(-1))> {};
 }  // namespace detail
 
 template <typename T>
@@ -488,7 +594,7 @@ template <typename T>
 struct is_member_object_pointer_helper : false_type {};
 
 template <typename T, typename U>
-struct is_member_object_pointer_helper<T U::*> : bool_constant<!is_function<T>> {};
+struct is_member_object_pointer_helper<T U::*> : bool_constant<!is_function_v<T>> {};
 
 }  // namespace detail
 
@@ -505,7 +611,7 @@ template <typename T>
 inline constexpr bool is_member_function_pointer_v = is_member_function_pointer<T>::value;
 
 template <typename T>
-struct is_member_object_pointer : detail:is_member_object_pointer_helper<remove_cv_t<T>> {};
+struct is_member_object_pointer : detail::is_member_object_pointer_helper<remove_cv_t<T>> {};
 
 template <typename T>
 inline constexpr bool is_member_object_pointer_v = is_member_object_pointer<T>::value;
@@ -523,6 +629,29 @@ struct is_scalar : disjunction<is_arithmetic<T>, is_pointer<T>, is_member_pointe
 template <typename T>
 inline constexpr bool is_scalar_v = is_scalar<T>::value;
 
+namespace detail {
+template <typename T>
+concept declares_uniquely_represented = requires {
+    typename T::uniquely_represented;
+    requires bool(T::uniquely_represented::value);
+};
+}  // namespace detail
+
+// A type is uniquely represented when two objects compare equal exactly when their object
+// representations are the same bytes, so hashing can consume the bytes in one pass. This holds
+// for integers, enums and pointers but not for floating-point types (0.0 == -0.0) or types with
+// padding. Class types opt in either by specializing this trait or by declaring
+// `using uniquely_represented = mystl::true_type;`.
+template <typename T>
+struct is_uniquely_represented
+    : bool_constant<is_integral_v<remove_cv_t<remove_all_extents_t<T>>> ||
+                    is_enum_v<remove_all_extents_t<T>> ||
+                    is_pointer_v<remove_all_extents_t<T>> ||
+                    detail::declares_uniquely_represented<remove_cv_t<remove_all_extents_t<T>>>> {};
+
+template <typename T>
+inline constexpr bool is_uniquely_represented_v = is_uniquely_represented<T>::value;
+
 template <typename T, typename... Args>
 struct is_constructible : bool_constant<__is_constructible(T, Args...)> {};
 
@@ -583,8 +712,30 @@ struct is_nothrow_move_assignable : is_nothrow_assignable<T&, T&&> {};
 template <typename T>
 inline constexpr bool is_nothrow_move_assignable_v = is_nothrow_move_assignable<T>::value;
 
+#if defined(__has_builtin)
+#if __has_builtin(__is_convertible)
+#define MYSTL_HAS_BUILTIN_IS_CONVERTIBLE 1
+#endif
+#endif
+
+#if defined(MYSTL_HAS_BUILTIN_IS_CONVERTIBLE)
 template <typename From, typename To>
 struct is_convertible : bool_constant<__is_convertible(From, To)> {};
+#else
+namespace detail {
+template <typename To>
+void convert_to(To) noexcept;
+
+template <typename From, typename To>
+concept implicitly_convertible = requires { detail::convert_to<To>(mystl::declval<From>()); };
+}  // namespace detail
+
+template <typename From, typename To>
+struct is_convertible
+    : bool_constant<(is_void_v<From> && is_void_v<To>) ||
+                    (!is_void_v<To> && !is_function_v<To> && !is_array_v<To> &&
+                     detail::implicitly_convertible<From, To>)> {};
+#endif
 
 template <typename From, typename To>
 inline constexpr bool is_convertible_v = is_convertible<From, To>::value;
@@ -716,6 +867,42 @@ struct make_unsigned_helper<long long> {
     using type = unsigned long long;
 };
 template <>
+struct make_unsigned_helper<unsigned char> {
+    using type = unsigned char;
+};
+template <>
+struct make_unsigned_helper<unsigned short> {
+    using type = unsigned short;
+};
+template <>
+struct make_unsigned_helper<unsigned int> {
+    using type = unsigned int;
+};
+template <>
+struct make_unsigned_helper<unsigned long> {
+    using type = unsigned long;
+};
+template <>
+struct make_unsigned_helper<unsigned long long> {
+    using type = unsigned long long;
+};
+#if defined(__cpp_char8_t)
+template <>
+struct make_unsigned_helper<char8_t> {
+    using type = unsigned char;
+};
+#endif
+template <>
+struct make_unsigned_helper<char16_t> {
+    using type = conditional_t<sizeof(char16_t) == sizeof(unsigned short), unsigned short,
+                               unsigned int>;
+};
+template <>
+struct make_unsigned_helper<char32_t> {
+    using type = conditional_t<sizeof(char32_t) == sizeof(unsigned int), unsigned int,
+                               unsigned long>;
+};
+template <>
 struct make_unsigned_helper<wchar_t> {
     using type = conditional_t<
         sizeof(wchar_t) == sizeof(unsigned short), unsigned short,
@@ -725,6 +912,30 @@ struct make_unsigned_helper<wchar_t> {
 template <typename T>
 struct make_signed_helper {};
 
+template <>
+struct make_signed_helper<char> {
+    using type = signed char;
+};
+template <>
+struct make_signed_helper<signed char> {
+    using type = signed char;
+};
+template <>
+struct make_signed_helper<short> {
+    using type = short;
+};
+template <>
+struct make_signed_helper<int> {
+    using type = int;
+};
+template <>
+struct make_signed_helper<long> {
+    using type = long;
+};
+template <>
+struct make_signed_helper<long long> {
+    using type = long long;
+};
 template <>
 struct make_signed_helper<unsigned char> {
     using type = signed char;
@@ -765,13 +976,22 @@ struct make_signed_helper<wchar_t> {
                                conditional_t<sizeof(wchar_t) == sizeof(int), int, long long>>;
 };
 
+template <typename T, bool = is_enum_v<T>>
+struct enum_base {
+    using type = T;
+};
+template <typename T>
+struct enum_base<T, true> {
+    using type = apply_cv_t<T, __underlying_type(T)>;
+};
+
 }  // namespace detail
 
 template <typename T>
 struct make_unsigned {
 private:
-    using base_t = conditional_t<is_enum_v<T>, __underlying_type(T), T>;
-    using raw_t = typename detail::make_signed_helper<remove_cv_t<base_t>>::type;
+    using base_t = typename detail::enum_base<T>::type;
+    using raw_t = typename detail::make_unsigned_helper<remove_cv_t<base_t>>::type;
 
 public:
     using type = apply_cv_t<base_t, raw_t>;
@@ -783,7 +1003,7 @@ using make_unsigned_t = typename make_unsigned<T>::type;
 template <typename T>
 struct make_signed {
 private:
-    using base_t = conditional_t<is_enum_v<T>, __underlying_type(T), T>;
+    using base_t = typename detail::enum_base<T>::type;
     using raw_t = typename detail::make_signed_helper<remove_cv_t<base_t>>::type;
 
 public:
@@ -805,6 +1025,15 @@ struct is_pair<pair<T1, T2>> : true_type {};
 template <typename T>
 inline constexpr bool is_pair_v = is_pair<remove_cv_t<T>>::value;
 
+template <typename T1, typename T2>
+struct is_trivially_relocatable<pair<T1, T2>>
+    : bool_constant<is_trivially_relocatable_v<T1> && is_trivially_relocatable_v<T2>> {};
+
+template <typename T1, typename T2>
+struct is_uniquely_represented<pair<T1, T2>>
+    : bool_constant<is_uniquely_represented_v<T1> && is_uniquely_represented_v<T2> &&
+                    sizeof(pair<T1, T2>) == sizeof(T1) + sizeof(T2)> {};
+
 }  // namespace mystl
 
 #endif
\ No newline at end of file
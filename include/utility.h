@@ -28,6 +28,19 @@ constexpr T&& forward(remove_reference_t<T>&& arg) noexcept {
     return static_cast<T&&>(arg);
 }
 
+template <typename T>
+constexpr T* addressof(T& arg) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_addressof(arg);
+#else
+    return reinterpret_cast<T*>(
+        &const_cast<char&>(reinterpret_cast<const volatile char&>(arg)));
+#endif
+}
+
+template <typename T>
+const T* addressof(const T&&) = delete;
+
 template <typename T, typename U = T>
 constexpr T exchange(T& obj, U&& new_value) noexcept(is_nothrow_move_constructible_v<T> &&
                                                      is_nothrow_assignable_v<T&, U>) {
@@ -236,6 +249,13 @@ struct in_place_index_t {
 template <size_t I>
 inline constexpr in_place_index_t<I> in_place_index{};
 
+// Tags a range or container pair passed to flat_map/flat_set as already sorted and free of
+// duplicate keys, which skips the sort.
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
 template <typename T1, typename T2>
 struct pair {
     using first_type = T1;
@@ -425,6 +445,183 @@ constexpr auto make_pair(T1&& x, T2&& y) {
     return R(mystl::forward<T1>(x), mystl::forward<T2>(y));
 }
 
+// A pair whose members are [[no_unique_address]]: an empty member (a stateless comparator,
+// hasher, allocator or deleter) takes no space, so compressed_pair<std::less<int>, int*> is the
+// size of a pointer. Otherwise it behaves like pair: public first and second, get<I> and get<T>,
+// structured bindings. Copy, move and assignment are defaulted, so it is trivially copyable
+// exactly when both members are, and trivially relocatable likewise.
+template <typename T1, typename T2>
+struct compressed_pair {
+    using first_type = T1;
+    using second_type = T2;
+    using trivially_relocatable =
+        bool_constant<is_trivially_relocatable_v<T1> && is_trivially_relocatable_v<T2>>;
+
+    [[no_unique_address]] T1 first;
+    [[no_unique_address]] T2 second;
+
+    constexpr compressed_pair()
+        requires(is_default_constructible_v<T1> && is_default_constructible_v<T2>)
+        : first(), second() {}
+
+    constexpr explicit(!is_convertible_v<const T1&, T1> || !is_convertible_v<const T2&, T2>)
+        compressed_pair(const T1& x, const T2& y)
+        requires(is_copy_constructible_v<T1> && is_copy_constructible_v<T2>)
+        : first(x), second(y) {}
+
+    template <typename U1, typename U2>
+        requires(is_constructible_v<T1, U1> && is_constructible_v<T2, U2>)
+    constexpr explicit(!is_convertible_v<U1, T1> || !is_convertible_v<U2, T2>)  //
+        compressed_pair(U1&& x, U2&& y)
+        : first(mystl::forward<U1>(x)), second(mystl::forward<U2>(y)) {}
+
+    constexpr compressed_pair(const compressed_pair&) = default;
+    constexpr compressed_pair(compressed_pair&&) = default;
+
+    constexpr compressed_pair& operator=(const compressed_pair&) = default;
+    constexpr compressed_pair& operator=(compressed_pair&&) = default;
+
+    template <typename U1, typename U2>
+        requires(is_constructible_v<T1, const U1&> && is_constructible_v<T2, const U2&>)
+    constexpr explicit(!is_convertible_v<const U1&, T1> || !is_convertible_v<const U2&, T2>)
+        compressed_pair(const pair<U1, U2>& p)
+        : first(p.first), second(p.second) {}
+
+    template <typename U1, typename U2>
+        requires(is_constructible_v<T1, U1 &&> && is_constructible_v<T2, U2 &&>)
+    constexpr explicit(!is_convertible_v<U1&&, T1> || !is_convertible_v<U2&&, T2>)
+        compressed_pair(pair<U1, U2>&& p)
+        : first(mystl::forward<U1>(p.first)), second(mystl::forward<U2>(p.second)) {}
+
+    template <typename U1, typename U2>
+        requires(is_assignable_v<T1&, const U1&> && is_assignable_v<T2&, const U2&>)
+    constexpr compressed_pair& operator=(const compressed_pair<U1, U2>& p) {
+        first = p.first;
+        second = p.second;
+        return *this;
+    }
+
+    template <typename U1, typename U2>
+        requires(is_assignable_v<T1&, U1 &&> && is_assignable_v<T2&, U2 &&>)
+    constexpr compressed_pair& operator=(compressed_pair<U1, U2>&& p) {
+        first = mystl::forward<U1>(p.first);
+        second = mystl::forward<U2>(p.second);
+        return *this;
+    }
+};
+
+template <typename T1, typename T2>
+compressed_pair(T1, T2) -> compressed_pair<T1, T2>;
+
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr bool operator==(const compressed_pair<T1, T2>& lhs, const compressed_pair<U1, U2>& rhs) {
+    return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator<=>(const compressed_pair<T1, T2>& lhs, const compressed_pair<U1, U2>& rhs)
+    -> std::common_comparison_category_t<decltype(lhs.first <=> rhs.first),
+                                         decltype(lhs.second <=> rhs.second)> {
+    if (auto cmp = lhs.first <=> rhs.first; cmp != 0) {
+        return cmp;
+    }
+    return lhs.second <=> rhs.second;
+}
+
+template <swappable T1, swappable T2>
+constexpr void swap(compressed_pair<T1, T2>& x,
+                    compressed_pair<T1, T2>& y) noexcept(is_nothrow_swappable_v<T1> &&
+                                                         is_nothrow_swappable_v<T2>) {
+    using mystl::swap;
+    swap(x.first, y.first);
+    swap(x.second, y.second);
+}
+
+template <typename T1, typename T2>
+struct tuple_size<compressed_pair<T1, T2>> : integral_constant<size_t, 2> {};
+
+template <typename T1, typename T2>
+struct tuple_size<const compressed_pair<T1, T2>> : integral_constant<size_t, 2> {};
+
+template <size_t I, typename T1, typename T2>
+struct tuple_element<I, compressed_pair<T1, T2>> : tuple_element<I, pair<T1, T2>> {};
+
+template <size_t I, typename T1, typename T2>
+struct tuple_element<I, const compressed_pair<T1, T2>> : tuple_element<I, const pair<T1, T2>> {};
+
+template <size_t I, typename T1, typename T2>
+constexpr auto& get(compressed_pair<T1, T2>& p) noexcept {
+    static_assert(I < 2, "Index out of bounds in compressed_pair::get");
+    if constexpr (I == 0) {
+        return p.first;
+    } else {
+        return p.second;
+    }
+}
+
+template <size_t I, typename T1, typename T2>
+constexpr const auto& get(const compressed_pair<T1, T2>& p) noexcept {
+    static_assert(I < 2, "Index out of bounds in compressed_pair::get");
+    if constexpr (I == 0) {
+        return p.first;
+    } else {
+        return p.second;
+    }
+}
+
+template <size_t I, typename T1, typename T2>
+constexpr auto&& get(compressed_pair<T1, T2>&& p) noexcept {
+    static_assert(I < 2, "Index out of bounds in compressed_pair::get");
+    if constexpr (I == 0) {
+        return mystl::move(p.first);
+    } else {
+        return mystl::move(p.second);
+    }
+}
+
+template <size_t I, typename T1, typename T2>
+constexpr const auto&& get(const compressed_pair<T1, T2>&& p) noexcept {
+    static_assert(I < 2, "Index out of bounds in compressed_pair::get");
+    if constexpr (I == 0) {
+        return mystl::move(p.first);
+    } else {
+        return mystl::move(p.second);
+    }
+}
+
+template <typename T, typename T1, typename T2>
+constexpr T& get(compressed_pair<T1, T2>& p) noexcept {
+    static_assert(is_same_v<T, T1> ^ is_same_v<T, T2>,
+                  "Type T must occur exactly once in compressed_pair");
+    if constexpr (is_same_v<T, T1>) {
+        return p.first;
+    } else {
+        return p.second;
+    }
+}
+
+template <typename T, typename T1, typename T2>
+constexpr const T& get(const compressed_pair<T1, T2>& p) noexcept {
+    static_assert(is_same_v<T, T1> ^ is_same_v<T, T2>,
+                  "Type T must occur exactly once in compressed_pair");
+    if constexpr (is_same_v<T, T1>) {
+        return p.first;
+    } else {
+        return p.second;
+    }
+}
+
+template <typename T, typename T1, typename T2>
+constexpr T&& get(compressed_pair<T1, T2>&& p) noexcept {
+    static_assert(is_same_v<T, T1> ^ is_same_v<T, T2>,
+                  "Type T must occur exactly once in compressed_pair");
+    if constexpr (is_same_v<T, T1>) {
+        return mystl::move(p.first);
+    } else {
+        return mystl::move(p.second);
+    }
+}
+
 }  // namespace mystl
 
 #endif
\ No newline at end of file
@@ -0,0 +1,685 @@
+#ifndef MYSTL_HANDMADE_VARIANT_H_
+#define MYSTL_HANDMADE_VARIANT_H_
+
+#include <compare>
+#include <cstddef>
+#include <exception>
+#include <initializer_list>
+
+#include "construct.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+template <typename... Ts>
+class variant;
+
+inline constexpr size_t variant_npos = static_cast<size_t>(-1);
+
+class bad_variant_access : public std::exception {
+public:
+    const char* what() const noexcept override { return "mystl::bad_variant_access"; }
+};
+
+// An alternative for variants that should be default constructible without a first
+// alternative that is.
+struct monostate {};
+
+constexpr bool operator==(monostate, monostate) noexcept {
+    return true;
+}
+
+constexpr std::strong_ordering operator<=>(monostate, monostate) noexcept {
+    return std::strong_ordering::equal;
+}
+
+template <typename V>
+struct variant_size;
+
+template <typename... Ts>
+struct variant_size<variant<Ts...>> : integral_constant<size_t, sizeof...(Ts)> {};
+
+template <typename V>
+struct variant_size<const V> : variant_size<V> {};
+
+template <typename V>
+inline constexpr size_t variant_size_v = variant_size<V>::value;
+
+template <size_t I, typename V>
+struct variant_alternative;
+
+template <size_t I, typename T, typename... Ts>
+struct variant_alternative<I, variant<T, Ts...>> : variant_alternative<I - 1, variant<Ts...>> {};
+
+template <typename T, typename... Ts>
+struct variant_alternative<0, variant<T, Ts...>> {
+    using type = T;
+};
+
+template <size_t I, typename V>
+struct variant_alternative<I, const V> {
+    using type = const typename variant_alternative<I, V>::type;
+};
+
+template <size_t I, typename V>
+using variant_alternative_t = typename variant_alternative<I, V>::type;
+
+namespace detail {
+    // The smallest unsigned type that holds every index and, as its maximum, the valueless one.
+    template <size_t N>
+    using variant_index_t = conditional_t<(N < 255), unsigned char,
+                                          conditional_t<(N < 65535), unsigned short, unsigned>>;
+
+    // Recursive union of the alternatives, so every member is a real union member and
+    // switching alternatives stays valid in constant expressions. Its destructor is trivial when
+    // every alternative's is; variant destroys the active member itself otherwise.
+    template <bool TrivialDtor, typename... Ts>
+    union variant_union {};
+
+    template <bool TrivialDtor, typename T, typename... Ts>
+    union variant_union<TrivialDtor, T, Ts...> {
+        char empty_;
+        T head_;
+        variant_union<TrivialDtor, Ts...> tail_;
+
+        constexpr variant_union() noexcept : empty_() {}
+
+        template <typename... Args>
+        constexpr explicit variant_union(in_place_index_t<0>, Args&&... args)
+            : head_(mystl::forward<Args>(args)...) {}
+
+        template <size_t I, typename... Args>
+        constexpr explicit variant_union(in_place_index_t<I>, Args&&... args)
+            : tail_(in_place_index<I - 1>, mystl::forward<Args>(args)...) {}
+
+        constexpr ~variant_union()
+            requires TrivialDtor
+        = default;
+
+        constexpr ~variant_union() {}
+    };
+
+    template <size_t I, typename U>
+    constexpr auto&& variant_get_alt(U&& u) noexcept {
+        if constexpr (I == 0) {
+            return mystl::forward<U>(u).head_;
+        } else {
+            return variant_get_alt<I - 1>(mystl::forward<U>(u).tail_);
+        }
+    }
+
+    // Digit k of a flattened index over variants with Sizes alternatives each, the first variant's
+    // being the most significant.
+    template <size_t... Sizes>
+    constexpr size_t variant_flat_digit(size_t flat, size_t k) noexcept {
+        constexpr size_t sizes[] = {Sizes..., 0};
+        size_t stride = 1;
+        for (size_t j = k + 1; j < sizeof...(Sizes); ++j) {
+            stride *= sizes[j];
+        }
+        return flat / stride % sizes[k];
+    }
+
+    // One table of function pointers over the flattened index space of several variants:
+    // entry k calls f(integral_constant<size_t, i>...) with the per-variant indices i that k
+    // encodes, the first variant's being the most significant digit. Every dispatch, visit over
+    // any number of variants included, is one load and one indirect call.
+    template <typename R, typename F, size_t... Sizes>
+    struct variant_jump_table {
+        using entry_type = R (*)(F&&);
+
+        static constexpr size_t size = (Sizes * ... * 1);
+        static constexpr size_t sizes[] = {Sizes..., 0};
+
+        template <size_t Flat, size_t... Ks>
+        static constexpr R call(F&& f, index_sequence<Ks...>) {
+            return static_cast<F&&>(f)(
+                integral_constant<size_t, variant_flat_digit<Sizes...>(Flat, Ks)>{}...);
+        }
+
+        template <size_t Flat>
+        static constexpr R entry(F&& f) {
+            return call<Flat>(static_cast<F&&>(f), make_index_sequence<sizeof...(Sizes)>{});
+        }
+
+        struct table_type {
+            entry_type entries[size];
+        };
+
+        template <size_t... Flats>
+        static constexpr table_type make(index_sequence<Flats...>) noexcept {
+            return {{&entry<Flats>...}};
+        }
+
+        static constexpr table_type table = make(make_index_sequence<size>{});
+    };
+
+    template <typename R, size_t... Sizes, typename F>
+    constexpr R variant_dispatch(size_t flat, F&& f) {
+        return variant_jump_table<R, F&&, Sizes...>::table.entries[flat](mystl::forward<F>(f));
+    }
+
+    struct variant_access {
+        template <size_t I, typename V>
+        static constexpr auto&& get(V&& v) noexcept {
+            return variant_get_alt<I>(mystl::forward<V>(v).u_);
+        }
+    };
+
+    // How many of Ts are T, and the index of the first.
+    template <typename T, typename... Ts>
+    inline constexpr size_t variant_type_count = (size_t{is_same_v<T, Ts>} + ... + 0);
+
+    template <typename T, typename... Ts>
+    constexpr size_t variant_type_index() noexcept {
+        constexpr bool matches[] = {is_same_v<T, Ts>..., false};
+        size_t i = 0;
+        while (i < sizeof...(Ts) && !matches[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    // The alternative the converting constructor picks for a U: overload resolution over
+    // F(T_i) for every T_i that U converts to without narrowing.
+    template <typename T>
+    struct variant_array {
+        T x[1];
+    };
+
+    template <size_t I, typename T>
+    struct variant_overload {
+        template <typename U>
+            requires requires { variant_array<T>{{mystl::declval<U>()}}; }
+        integral_constant<size_t, I> operator()(T, U&&) const;
+    };
+
+    template <typename Is, typename... Ts>
+    struct variant_overload_set;
+
+    template <size_t... Is, typename... Ts>
+    struct variant_overload_set<index_sequence<Is...>, Ts...> : variant_overload<Is, Ts>... {
+        using variant_overload<Is, Ts>::operator()...;
+    };
+
+    template <typename U, typename... Ts>
+    using variant_selected =
+        decltype(variant_overload_set<index_sequence_for<Ts...>, Ts...>{}(mystl::declval<U>(),
+                                                                          mystl::declval<U>()));
+
+    template <typename T>
+    inline constexpr bool is_in_place_tag_v = false;
+
+    template <typename T>
+    inline constexpr bool is_in_place_tag_v<in_place_type_t<T>> = true;
+
+    template <size_t I>
+    inline constexpr bool is_in_place_tag_v<in_place_index_t<I>> = true;
+
+    template <typename T>
+    concept variant_equality_comparable = requires(const T& a) {
+        { a == a } -> convertible_to<bool>;
+    };
+
+    template <typename V>
+    inline constexpr bool is_variant_v = false;
+
+    template <typename... Ts>
+    inline constexpr bool is_variant_v<variant<Ts...>> = true;
+}  // namespace detail
+
+// Type-safe union of Ts..., stored inline. The index is the smallest unsigned integer that
+// fits, so with small alternatives a variant is rarely larger than the largest of them plus one
+// byte. Copy, move and destruction are trivial whenever they are for every alternative, so a
+// variant of trivially copyable types may be copied with memcpy. If constructing the new
+// alternative throws during an assignment or emplace whose type has a throwing move
+// constructor, the variant is left valueless_by_exception().
+template <typename... Ts>
+class variant {
+    static_assert(sizeof...(Ts) > 0, "variant must have at least one alternative");
+    static_assert(((!is_reference_v<Ts> && !is_array_v<Ts> && !is_void_v<Ts>) && ...),
+                  "variant alternatives must be object types");
+
+    using index_type = detail::variant_index_t<sizeof...(Ts)>;
+
+    static constexpr index_type npos_ = static_cast<index_type>(-1);
+    static constexpr bool trivial_dtor_ = (is_trivially_destructible_v<Ts> && ...);
+
+    template <size_t I>
+    using alt_ = variant_alternative_t<I, variant>;
+
+public:
+    using trivially_relocatable = bool_constant<(is_trivially_relocatable_v<Ts> && ...)>;
+
+    constexpr variant() noexcept(is_nothrow_default_constructible_v<alt_<0>>)
+        requires is_default_constructible_v<alt_<0>>
+        : u_(in_place_index<0>), index_(0) {}
+
+    constexpr variant(const variant&)
+        requires(is_trivially_copy_constructible_v<Ts> && ...)
+    = default;
+
+    constexpr variant(const variant& other)
+        requires((is_copy_constructible_v<Ts> && ...) &&
+                 !(is_trivially_copy_constructible_v<Ts> && ...))
+        : u_(), index_(npos_) {
+        if (!other.valueless_by_exception()) {
+            dispatch_<void>(other.index_, [&](auto i) {
+                construct_<i.value>(detail::variant_get_alt<i.value>(other.u_));
+            });
+        }
+    }
+
+    constexpr variant(variant&&)
+        requires(is_trivially_move_constructible_v<Ts> && ...)
+    = default;
+
+    constexpr variant(variant&& other) noexcept((is_nothrow_move_constructible_v<Ts> && ...))
+        requires((is_move_constructible_v<Ts> && ...) &&
+                 !(is_trivially_move_constructible_v<Ts> && ...))
+        : u_(), index_(npos_) {
+        if (!other.valueless_by_exception()) {
+            dispatch_<void>(other.index_, [&](auto i) {
+                construct_<i.value>(mystl::move(detail::variant_get_alt<i.value>(other.u_)));
+            });
+        }
+    }
+
+    template <typename U, size_t J = detail::variant_selected<U, Ts...>::value>
+        requires(!is_same_v<remove_cvref_t<U>, variant> &&
+                 !detail::is_in_place_tag_v<remove_cvref_t<U>> && is_constructible_v<alt_<J>, U>)
+    constexpr variant(U&& value) noexcept(is_nothrow_constructible_v<alt_<J>, U>)
+        : u_(in_place_index<J>, mystl::forward<U>(value)), index_(J) {}
+
+    template <typename T, typename... Args>
+        requires(detail::variant_type_count<T, Ts...> == 1 && is_constructible_v<T, Args...>)
+    constexpr explicit variant(in_place_type_t<T>, Args&&... args)
+        : variant(in_place_index<detail::variant_type_index<T, Ts...>()>,
+                  mystl::forward<Args>(args)...) {}
+
+    template <typename T, typename U, typename... Args>
+        requires(detail::variant_type_count<T, Ts...> == 1 &&
+                 is_constructible_v<T, std::initializer_list<U>&, Args...>)
+    constexpr explicit variant(in_place_type_t<T>, std::initializer_list<U> il, Args&&... args)
+        : variant(in_place_index<detail::variant_type_index<T, Ts...>()>, il,
+                  mystl::forward<Args>(args)...) {}
+
+    template <size_t I, typename... Args>
+        requires(I < sizeof...(Ts) && is_constructible_v<alt_<I>, Args...>)
+    constexpr explicit variant(in_place_index_t<I>, Args&&... args)
+        : u_(in_place_index<I>, mystl::forward<Args>(args)...), index_(I) {}
+
+    template <size_t I, typename U, typename... Args>
+        requires(I < sizeof...(Ts) &&
+                 is_constructible_v<alt_<I>, std::initializer_list<U>&, Args...>)
+    constexpr explicit variant(in_place_index_t<I>, std::initializer_list<U> il, Args&&... args)
+        : u_(in_place_index<I>, il, mystl::forward<Args>(args)...), index_(I) {}
+
+    constexpr ~variant()
+        requires trivial_dtor_
+    = default;
+
+    constexpr ~variant() { reset_(); }
+
+    constexpr variant& operator=(const variant&)
+        requires((is_trivially_copy_constructible_v<Ts> && is_trivially_copy_assignable_v<Ts> &&
+                  is_trivially_destructible_v<Ts>) &&
+                 ...)
+    = default;
+
+    constexpr variant& operator=(const variant& other)
+        requires((is_copy_constructible_v<Ts> && is_copy_assignable_v<Ts>) && ... &&
+                 !((is_trivially_copy_constructible_v<Ts> && is_trivially_copy_assignable_v<Ts> &&
+                    is_trivially_destructible_v<Ts>) &&
+                   ...))
+    {
+        if (other.valueless_by_exception()) {
+            reset_();
+            return *this;
+        }
+        dispatch_<void>(other.index_, [&](auto j) {
+            using T = alt_<j.value>;
+            const T& value = detail::variant_get_alt<j.value>(other.u_);
+            if (index_ == j.value) {
+                detail::variant_get_alt<j.value>(u_) = value;
+            } else if constexpr (is_nothrow_copy_constructible_v<T> ||
+                                 !is_nothrow_move_constructible_v<T>) {
+                emplace<j.value>(value);
+            } else {
+                emplace<j.value>(T(value));
+            }
+        });
+        return *this;
+    }
+
+    constexpr variant& operator=(variant&&)
+        requires((is_trivially_move_constructible_v<Ts> && is_trivially_move_assignable_v<Ts> &&
+                  is_trivially_destructible_v<Ts>) &&
+                 ...)
+    = default;
+
+    constexpr variant& operator=(variant&& other) noexcept(
+        ((is_nothrow_move_constructible_v<Ts> && is_nothrow_move_assignable_v<Ts>) && ...))
+        requires((is_move_constructible_v<Ts> && is_move_assignable_v<Ts>) && ... &&
+                 !((is_trivially_move_constructible_v<Ts> && is_trivially_move_assignable_v<Ts> &&
+                    is_trivially_destructible_v<Ts>) &&
+                   ...))
+    {
+        if (other.valueless_by_exception()) {
+            reset_();
+            return *this;
+        }
+        dispatch_<void>(other.index_, [&](auto j) {
+            auto&& value = detail::variant_get_alt<j.value>(mystl::move(other.u_));
+            if (index_ == j.value) {
+                detail::variant_get_alt<j.value>(u_) = mystl::move(value);
+            } else {
+                emplace<j.value>(mystl::move(value));
+            }
+        });
+        return *this;
+    }
+
+    template <typename U, size_t J = detail::variant_selected<U, Ts...>::value>
+        requires(!is_same_v<remove_cvref_t<U>, variant> && is_constructible_v<alt_<J>, U> &&
+                 is_assignable_v<alt_<J>&, U>)
+    constexpr variant& operator=(U&& value) noexcept(is_nothrow_assignable_v<alt_<J>&, U> &&
+                                                    is_nothrow_constructible_v<alt_<J>, U>) {
+        using T = alt_<J>;
+        if (index_ == J) {
+            detail::variant_get_alt<J>(u_) = mystl::forward<U>(value);
+        } else if constexpr (is_nothrow_constructible_v<T, U> ||
+                             !is_nothrow_move_constructible_v<T>) {
+            emplace<J>(mystl::forward<U>(value));
+        } else {
+            emplace<J>(T(mystl::forward<U>(value)));
+        }
+        return *this;
+    }
+
+    template <typename T, typename... Args>
+        requires(detail::variant_type_count<T, Ts...> == 1 && is_constructible_v<T, Args...>)
+    constexpr T& emplace(Args&&... args) {
+        return emplace<detail::variant_type_index<T, Ts...>()>(mystl::forward<Args>(args)...);
+    }
+
+    template <typename T, typename U, typename... Args>
+        requires(detail::variant_type_count<T, Ts...> == 1 &&
+                 is_constructible_v<T, std::initializer_list<U>&, Args...>)
+    constexpr T& emplace(std::initializer_list<U> il, Args&&... args) {
+        return emplace<detail::variant_type_index<T, Ts...>()>(il, mystl::forward<Args>(args)...);
+    }
+
+    template <size_t I, typename... Args>
+        requires(I < sizeof...(Ts) && is_constructible_v<alt_<I>, Args...>)
+    constexpr alt_<I>& emplace(Args&&... args) {
+        return emplace_<I>(mystl::forward<Args>(args)...);
+    }
+
+    template <size_t I, typename U, typename... Args>
+        requires(I < sizeof...(Ts) &&
+                 is_constructible_v<alt_<I>, std::initializer_list<U>&, Args...>)
+    constexpr alt_<I>& emplace(std::initializer_list<U> il, Args&&... args) {
+        return emplace_<I>(il, mystl::forward<Args>(args)...);
+    }
+
+
+    constexpr size_t index() const noexcept {
+        return index_ == npos_ ? variant_npos : static_cast<size_t>(index_);
+    }
+
+    constexpr bool valueless_by_exception() const noexcept { return index_ == npos_; }
+
+    constexpr void swap(variant& other) noexcept(
+        ((is_nothrow_move_constructible_v<Ts> && is_nothrow_swappable_v<Ts>) && ...)) {
+        if (index_ == other.index_) {
+            if (!valueless_by_exception()) {
+                dispatch_<void>(index_, [&](auto i) {
+                    mystl::swap(detail::variant_get_alt<i.value>(u_),
+                                detail::variant_get_alt<i.value>(other.u_));
+                });
+            }
+        } else {
+            variant tmp(mystl::move(other));
+            other = mystl::move(*this);
+            *this = mystl::move(tmp);
+        }
+    }
+
+    friend constexpr void swap(variant& a, variant& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+private:
+    friend struct detail::variant_access;
+
+    template <typename R, typename F>
+    static constexpr R dispatch_(index_type index, F&& f) {
+        return detail::variant_dispatch<R, sizeof...(Ts)>(index, mystl::forward<F>(f));
+    }
+
+    template <size_t I, typename... Args>
+    constexpr void construct_(Args&&... args) {
+        mystl::construct_at(mystl::addressof(u_), in_place_index<I>, mystl::forward<Args>(args)...);
+        index_ = static_cast<index_type>(I);
+    }
+
+    // Builds the new alternative in a temporary first when that cannot throw on the move into
+    // place, so a throwing constructor leaves the old value untouched.
+    template <size_t I, typename... Args>
+    constexpr alt_<I>& emplace_(Args&&... args) {
+        using T = alt_<I>;
+        if constexpr (is_nothrow_constructible_v<T, Args...> ||
+                      !is_nothrow_move_constructible_v<T>) {
+            reset_();
+            construct_<I>(mystl::forward<Args>(args)...);
+        } else {
+            T tmp(mystl::forward<Args>(args)...);
+            reset_();
+            construct_<I>(mystl::move(tmp));
+        }
+        return detail::variant_get_alt<I>(u_);
+    }
+
+    constexpr void reset_() noexcept {
+        if constexpr (!trivial_dtor_) {
+            if (!valueless_by_exception()) {
+                dispatch_<void>(index_, [this](auto i) {
+                    mystl::destroy_at(mystl::addressof(detail::variant_get_alt<i.value>(u_)));
+                });
+            }
+        }
+        index_ = npos_;
+    }
+
+    detail::variant_union<trivial_dtor_, Ts...> u_;
+    index_type index_;
+};
+
+template <typename T, typename... Ts>
+constexpr bool holds_alternative(const variant<Ts...>& v) noexcept {
+    static_assert(detail::variant_type_count<T, Ts...> == 1,
+                  "T must occur exactly once in the alternatives");
+    return v.index() == detail::variant_type_index<T, Ts...>();
+}
+
+template <size_t I, typename... Ts>
+constexpr variant_alternative_t<I, variant<Ts...>>& get(variant<Ts...>& v) {
+    if (v.index() != I) {
+        throw bad_variant_access();
+    }
+    return detail::variant_access::get<I>(v);
+}
+
+template <size_t I, typename... Ts>
+constexpr variant_alternative_t<I, variant<Ts...>>&& get(variant<Ts...>&& v) {
+    if (v.index() != I) {
+        throw bad_variant_access();
+    }
+    return detail::variant_access::get<I>(mystl::move(v));
+}
+
+template <size_t I, typename... Ts>
+constexpr const variant_alternative_t<I, variant<Ts...>>& get(const variant<Ts...>& v) {
+    if (v.index() != I) {
+        throw bad_variant_access();
+    }
+    return detail::variant_access::get<I>(v);
+}
+
+template <size_t I, typename... Ts>
+constexpr const variant_alternative_t<I, variant<Ts...>>&& get(const variant<Ts...>&& v) {
+    if (v.index() != I) {
+        throw bad_variant_access();
+    }
+    return detail::variant_access::get<I>(mystl::move(v));
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr T& get(variant<Ts...>& v) {
+    return mystl::get<detail::variant_type_index<T, Ts...>()>(v);
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr T&& get(variant<Ts...>&& v) {
+    return mystl::get<detail::variant_type_index<T, Ts...>()>(mystl::move(v));
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr const T& get(const variant<Ts...>& v) {
+    return mystl::get<detail::variant_type_index<T, Ts...>()>(v);
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr const T&& get(const variant<Ts...>&& v) {
+    return mystl::get<detail::variant_type_index<T, Ts...>()>(mystl::move(v));
+}
+
+template <size_t I, typename... Ts>
+constexpr add_pointer_t<variant_alternative_t<I, variant<Ts...>>> get_if(
+    variant<Ts...>* v) noexcept {
+    if (v == nullptr || v->index() != I) {
+        return nullptr;
+    }
+    return mystl::addressof(detail::variant_access::get<I>(*v));
+}
+
+template <size_t I, typename... Ts>
+constexpr add_pointer_t<const variant_alternative_t<I, variant<Ts...>>> get_if(
+    const variant<Ts...>* v) noexcept {
+    if (v == nullptr || v->index() != I) {
+        return nullptr;
+    }
+    return mystl::addressof(detail::variant_access::get<I>(*v));
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr add_pointer_t<T> get_if(variant<Ts...>* v) noexcept {
+    return mystl::get_if<detail::variant_type_index<T, Ts...>()>(v);
+}
+
+template <typename T, typename... Ts>
+    requires(detail::variant_type_count<T, Ts...> == 1)
+constexpr add_pointer_t<const T> get_if(const variant<Ts...>* v) noexcept {
+    return mystl::get_if<detail::variant_type_index<T, Ts...>()>(v);
+}
+
+namespace detail {
+    template <typename R, typename Visitor, typename... Vs>
+    constexpr R variant_visit(Visitor&& vis, Vs&&... vs) {
+        if ((vs.valueless_by_exception() || ...)) {
+            throw bad_variant_access();
+        }
+        size_t flat = 0;
+        static_cast<void>(((flat = flat * variant_size_v<remove_cvref_t<Vs>> + vs.index()), ...));
+        return variant_dispatch<R, variant_size_v<remove_cvref_t<Vs>>...>(
+            flat, [&](auto... is) -> R {
+                if constexpr (is_void_v<R>) {
+                    mystl::invoke(mystl::forward<Visitor>(vis),
+                                  variant_access::get<is.value>(mystl::forward<Vs>(vs))...);
+                } else {
+                    return mystl::invoke(mystl::forward<Visitor>(vis),
+                                         variant_access::get<is.value>(mystl::forward<Vs>(vs))...);
+                }
+            });
+    }
+
+    // The type vis returns for the alternatives that flattened index Flat encodes.
+    template <size_t Flat, typename Visitor, typename... Vs, size_t... Ks>
+    auto variant_visit_result_at(index_sequence<Ks...>) -> decltype(mystl::invoke(
+        mystl::declval<Visitor>(),
+        variant_access::get<variant_flat_digit<variant_size_v<remove_cvref_t<Vs>>...>(Flat, Ks)>(
+            mystl::declval<Vs>())...));
+
+    template <typename Visitor, typename... Vs, size_t... Flats>
+    constexpr bool variant_visit_same_result(index_sequence<Flats...>) noexcept {
+        using first = decltype(variant_visit_result_at<0, Visitor, Vs...>(
+            make_index_sequence<sizeof...(Vs)>{}));
+        return (is_same_v<first, decltype(variant_visit_result_at<Flats, Visitor, Vs...>(
+                                     make_index_sequence<sizeof...(Vs)>{}))> &&
+                ...);
+    }
+}  // namespace detail
+
+// Calls vis with the active alternative of every variant. The alternatives' indices are folded
+// into one index into a table built at compile time, so visiting any number of variants costs
+// a single indexed call. Throws bad_variant_access if a variant is valueless.
+template <typename Visitor, typename... Vs>
+    requires(detail::is_variant_v<remove_cvref_t<Vs>> && ...)
+constexpr decltype(auto) visit(Visitor&& vis, Vs&&... vs) {
+    using R = decltype(mystl::invoke(mystl::forward<Visitor>(vis),
+                                     detail::variant_access::get<0>(mystl::forward<Vs>(vs))...));
+    static_assert(detail::variant_visit_same_result<Visitor, Vs...>(
+                      make_index_sequence<(variant_size_v<remove_cvref_t<Vs>> * ... * 1)>{}),
+                  "mystl::visit requires the same return type for every alternative; "
+                  "use visit<R> to convert the results");
+    return detail::variant_visit<R>(mystl::forward<Visitor>(vis), mystl::forward<Vs>(vs)...);
+}
+
+// As above, with every result converted to R.
+template <typename R, typename Visitor, typename... Vs>
+    requires(detail::is_variant_v<remove_cvref_t<Vs>> && ...)
+constexpr R visit(Visitor&& vis, Vs&&... vs) {
+    return detail::variant_visit<R>(mystl::forward<Visitor>(vis), mystl::forward<Vs>(vs)...);
+}
+
+template <typename... Ts>
+    requires(detail::variant_equality_comparable<Ts> && ...)
+constexpr bool operator==(const variant<Ts...>& a, const variant<Ts...>& b) {
+    if (a.index() != b.index()) {
+        return false;
+    }
+    if (a.valueless_by_exception()) {
+        return true;
+    }
+    return detail::variant_dispatch<bool, sizeof...(Ts)>(a.index(), [&](auto i) {
+        return detail::variant_access::get<i.value>(a) == detail::variant_access::get<i.value>(b);
+    });
+}
+
+// Valueless variants order first, then by index, then by value.
+template <typename... Ts>
+    requires(std::three_way_comparable<Ts> && ...)
+constexpr std::common_comparison_category_t<std::compare_three_way_result_t<Ts>...> operator<=>(
+    const variant<Ts...>& a, const variant<Ts...>& b) {
+    using R = std::common_comparison_category_t<std::compare_three_way_result_t<Ts>...>;
+    if (a.valueless_by_exception() || b.valueless_by_exception()) {
+        return b.valueless_by_exception() <=> a.valueless_by_exception();
+    }
+    if (a.index() != b.index()) {
+        return a.index() <=> b.index();
+    }
+    return detail::variant_dispatch<R, sizeof...(Ts)>(a.index(), [&](auto i) -> R {
+        return detail::variant_access::get<i.value>(a) <=> detail::variant_access::get<i.value>(b);
+    });
+}
+
+}  // namespace mystl
+
+#endif
@@ -0,0 +1,963 @@
+#ifndef MYSTL_HANDMADE_VECTOR_H_
+#define MYSTL_HANDMADE_VECTOR_H_
+
+#include <compare>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "algorithm.h"
+#include "construct.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+namespace mystl {
+
+// Growth policy for vector. The first allocation holds at least max(1, initial_bytes /
+// sizeof(T)) elements; each reallocation multiplies the capacity by
+// growth_numerator / growth_denominator. Pass a struct with the same members as the third
+// template argument of vector to change either.
+struct vector_growth_policy {
+    static constexpr size_t initial_bytes = 64;
+    static constexpr size_t growth_numerator = 2;
+    static constexpr size_t growth_denominator = 1;
+};
+
+namespace detail {
+    // Storage and public interface shared by vector and small_vector: live elements in
+    // [begin_, end_) of a block that ends at cap_, plus the element construction, relocation and
+    // growth paths. Derived provides
+    //   next_capacity_(required)  the capacity to grow to,
+    //   owns_heap_()              whether begin_ points at a block obtained from alloc_,
+    //   release_heap_()           frees that block, once empty, and falls back to its own storage,
+    //   name_                     the prefix of its exception messages.
+    template <typename T, typename Alloc, typename Derived>
+    class vector_base {
+    public:
+        using value_type      = T;
+        using allocator_type  = Alloc;
+        using size_type       = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = T&;
+        using const_reference = const T&;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using iterator        = T*;
+        using const_iterator  = const T*;
+
+        void assign(size_type n, const T& value) {
+            if (n > capacity()) {
+                // Fill a new block before releasing the old one: value may be an element.
+                auto [new_begin, new_cap] = allocate_checked_(n);
+                try {
+                    construct_fill_(new_begin, n, value);
+                } catch (...) {
+                    alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                    throw;
+                }
+                destroy_range_(begin_, end_);
+                adopt_(new_begin, new_cap, new_begin + n);
+                return;
+            }
+            const size_type common = n < size() ? n : size();
+            mystl::fill_n(begin_, common, value);
+            if (n > size()) {
+                construct_at_end_fill_(n - size(), value);
+            } else {
+                erase_at_end_(begin_ + n);
+            }
+        }
+
+        template <typename InputIt>
+            requires requires(InputIt it) { *it; ++it; }
+        void assign(InputIt first, InputIt last) {
+            assign_range_(first, last);
+        }
+
+        void assign(std::initializer_list<T> ilist) { assign_range_(ilist.begin(), ilist.end()); }
+
+        allocator_type get_allocator() const noexcept { return alloc_; }
+
+        reference at(size_type pos) {
+            if (pos >= size()) {
+                throw_out_of_range_();
+            }
+            return begin_[pos];
+        }
+
+        const_reference at(size_type pos) const {
+            if (pos >= size()) {
+                throw_out_of_range_();
+            }
+            return begin_[pos];
+        }
+
+        reference operator[](size_type pos) noexcept { return begin_[pos]; }
+        const_reference operator[](size_type pos) const noexcept { return begin_[pos]; }
+
+        reference front() noexcept { return *begin_; }
+        const_reference front() const noexcept { return *begin_; }
+
+        reference back() noexcept { return end_[-1]; }
+        const_reference back() const noexcept { return end_[-1]; }
+
+        T* data() noexcept { return begin_; }
+        const T* data() const noexcept { return begin_; }
+
+        iterator begin() noexcept { return begin_; }
+        const_iterator begin() const noexcept { return begin_; }
+        const_iterator cbegin() const noexcept { return begin_; }
+
+        iterator end() noexcept { return end_; }
+        const_iterator end() const noexcept { return end_; }
+        const_iterator cend() const noexcept { return end_; }
+
+        [[nodiscard]] bool empty() const noexcept { return begin_ == end_; }
+
+        size_type size() const noexcept { return static_cast<size_type>(end_ - begin_); }
+
+        size_type capacity() const noexcept { return static_cast<size_type>(cap_ - begin_); }
+
+        size_type max_size() const noexcept {
+            const size_type by_alloc = alloc_traits::max_size(alloc_);
+            const size_type by_diff =
+                static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(T);
+            return by_alloc < by_diff ? by_alloc : by_diff;
+        }
+
+        void reserve(size_type n) {
+            if (n > capacity()) {
+                if (n > max_size()) {
+                    throw_length_error_();
+                }
+                reallocate_(n);
+            }
+        }
+
+        void clear() noexcept { erase_at_end_(begin_); }
+
+        iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+
+        iterator insert(const_iterator pos, T&& value) { return emplace(pos, mystl::move(value)); }
+
+        iterator insert(const_iterator pos, size_type n, const T& value) {
+            if (n == 0) {
+                return const_cast<T*>(pos);
+            }
+            if (end_ + n <= cap_ && !(begin_ <= &value && &value < end_)) {
+                return insert_n_in_place_(pos, n, [this, &value](T* dst, size_type count) {
+                    return construct_fill_(dst, count, value);
+                });
+            }
+            T copy(value);
+            return insert_n_(pos, n, [this, &copy](T* dst, size_type count) {
+                return construct_fill_(dst, count, copy);
+            });
+        }
+
+        template <typename InputIt>
+            requires requires(InputIt it) { *it; ++it; }
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            if constexpr (requires { static_cast<size_type>(last - first); }) {
+                const size_type n = static_cast<size_type>(last - first);
+                if (n == 0) {
+                    return const_cast<T*>(pos);
+                }
+                return insert_n_(pos, n, [this, first, last](T* dst, size_type) {
+                    return construct_copy_(dst, first, last);
+                });
+            } else {
+                const size_type index = static_cast<size_type>(pos - begin_);
+                const size_type old_size = size();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+                mystl::rotate(begin_ + index, begin_ + old_size, end_);
+                return begin_ + index;
+            }
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        }
+
+        template <typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            T* p = const_cast<T*>(pos);
+            if (p == end_) {
+                emplace_back(mystl::forward<Args>(args)...);
+                return end_ - 1;
+            }
+            if (end_ == cap_) {
+                return insert_n_(pos, 1, [this, &args...](T* dst, size_type) {
+                    alloc_traits::construct(alloc_, dst, mystl::forward<Args>(args)...);
+                    return dst + 1;
+                });
+            }
+            // Construct first: args may refer to an element that is about to shift.
+            if constexpr (relocate_bitwise) {
+                alignas(T) unsigned char buffer[sizeof(T)];
+                T* tmp =
+                    mystl::construct_at(reinterpret_cast<T*>(buffer), mystl::forward<Args>(args)...);
+                mystl::uninitialized_relocate(p, end_, p + 1);
+                mystl::relocate_at(tmp, p);
+                ++end_;
+            } else {
+                T tmp(mystl::forward<Args>(args)...);
+                alloc_traits::construct(alloc_, end_, mystl::move(end_[-1]));
+                ++end_;
+                mystl::move_backward(p, end_ - 2, end_ - 1);
+                *p = mystl::move(tmp);
+            }
+            return p;
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (end_ != cap_) [[likely]] {
+                alloc_traits::construct(alloc_, end_, mystl::forward<Args>(args)...);
+                return *end_++;
+            }
+            return realloc_emplace_back_(mystl::forward<Args>(args)...);
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+
+        void push_back(T&& value) { emplace_back(mystl::move(value)); }
+
+        void pop_back() noexcept {
+            --end_;
+            destroy_one_(end_);
+        }
+
+        iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            T* f = const_cast<T*>(first);
+            T* l = const_cast<T*>(last);
+            if (f == l) {
+                return f;
+            }
+            if constexpr (relocate_bitwise) {
+                destroy_range_(f, l);
+                mystl::uninitialized_relocate(l, end_, f);
+                end_ -= (l - f);
+            } else {
+                erase_at_end_(mystl::move(l, end_, f));
+            }
+            return f;
+        }
+
+        void resize(size_type n) {
+            if (n > size()) {
+                reserve_for_append_(n - size());
+                construct_at_end_value_(n - size());
+            } else {
+                erase_at_end_(begin_ + n);
+            }
+        }
+
+        void resize(size_type n, const T& value) {
+            if (n > size()) {
+                if (n > capacity() && begin_ <= &value && &value < end_) {
+                    T copy(value);
+                    reserve_for_append_(n - size());
+                    construct_at_end_fill_(n - size(), copy);
+                } else {
+                    reserve_for_append_(n - size());
+                    construct_at_end_fill_(n - size(), value);
+                }
+            } else {
+                erase_at_end_(begin_ + n);
+            }
+        }
+
+    protected:
+        using alloc_traits = allocator_traits<Alloc>;
+
+        static constexpr bool default_construct =
+            !requires(Alloc& a, T* p) { a.construct(p, mystl::declval<T&&>()); };
+        static constexpr bool default_destroy = !requires(Alloc& a, T* p) { a.destroy(p); };
+
+        // Elements can be moved between buffers with memcpy and no per-element hooks.
+        static constexpr bool relocate_bitwise =
+            is_trivially_relocatable_v<T> && default_construct && default_destroy;
+
+        // Reallocation moves elements when that cannot throw (or copying is impossible) and
+        // copies them otherwise, which keeps push_back strongly exception-safe.
+        static constexpr bool move_on_realloc =
+            is_nothrow_move_constructible_v<T> || !is_copy_constructible_v<T>;
+
+        explicit vector_base(const Alloc& alloc) noexcept : alloc_(alloc) {}
+
+        explicit vector_base(Alloc&& alloc) noexcept : alloc_(mystl::move(alloc)) {}
+
+        Derived& derived_() noexcept { return static_cast<Derived&>(*this); }
+
+        [[noreturn]] static void throw_out_of_range_() {
+            throw std::out_of_range(std::string(Derived::name_) + "::at");
+        }
+
+        [[noreturn]] static void throw_length_error_() { throw std::length_error(Derived::name_); }
+
+        // A block of at least n elements, or length_error if n exceeds max_size().
+        auto allocate_checked_(size_type n) {
+            if (n > max_size()) {
+                throw_length_error_();
+            }
+            return alloc_traits::allocate_at_least(alloc_, n);
+        }
+
+        // Gives an empty vector whose heap block, if any, has been released a new block.
+        void allocate_exactly_(size_type n) {
+            auto [p, cap] = allocate_checked_(n);
+            begin_ = end_ = p;
+            cap_ = p + cap;
+        }
+
+        template <typename InputIt>
+        void assign_range_(InputIt first, InputIt last) {
+            if constexpr (requires { static_cast<size_type>(last - first); }) {
+                const size_type n = static_cast<size_type>(last - first);
+                if (n > capacity()) {
+                    clear();
+                    derived_().release_heap_();
+                    allocate_exactly_(n);
+                    construct_at_end_copy_(first, last);
+                } else if (n > size()) {
+                    InputIt mid = first + static_cast<difference_type>(size());
+                    mystl::copy(first, mid, begin_);
+                    construct_at_end_copy_(mid, last);
+                } else {
+                    erase_at_end_(mystl::copy(first, last, begin_));
+                }
+            } else {
+                T* cur = begin_;
+                for (; first != last && cur != end_; ++first, (void)++cur) {
+                    *cur = *first;
+                }
+                if (first == last) {
+                    erase_at_end_(cur);
+                } else {
+                    for (; first != last; ++first) {
+                        emplace_back(*first);
+                    }
+                }
+            }
+        }
+
+        // Like assign_range_, but moves from [first, last), which lies outside this vector.
+        void move_assign_range_(T* first, T* last) {
+            const size_type n = static_cast<size_type>(last - first);
+            if (n > capacity()) {
+                clear();
+                derived_().release_heap_();
+                allocate_exactly_(n);
+                construct_at_end_move_(first, last);
+            } else if (n > size()) {
+                T* mid = first + size();
+                mystl::move(first, mid, begin_);
+                construct_at_end_move_(mid, last);
+            } else {
+                erase_at_end_(mystl::move(first, last, begin_));
+            }
+        }
+
+        // Tries to extend the current block to hold `n` elements without moving it.
+        bool try_expand_(size_type n) noexcept {
+            if (!derived_().owns_heap_()) {
+                return false;
+            }
+            const size_type got = alloc_traits::try_expand(alloc_, begin_, capacity(), n);
+            if (got >= n) {
+                cap_ = begin_ + got;
+                return true;
+            }
+            return false;
+        }
+
+        void reallocate_(size_type n) {
+            if (try_expand_(n)) {
+                return;
+            }
+            auto [new_begin, new_cap] = alloc_traits::allocate_at_least(alloc_, n);
+            move_to_(new_begin, new_cap);
+        }
+
+        // Moves the elements into a block of about size() elements if that is smaller than the
+        // current one.
+        void shrink_heap_() {
+            auto [new_begin, new_cap] = alloc_traits::allocate_at_least(alloc_, size());
+            if (new_cap >= capacity()) {
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                return;
+            }
+            move_to_(new_begin, new_cap);
+        }
+
+        // Transfers the elements into a freshly allocated block and adopts it. The block is
+        // freed if a copy throws.
+        void move_to_(T* new_begin, size_type new_cap) {
+            T* new_end;
+            try {
+                new_end = transfer_all_(new_begin);
+            } catch (...) {
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                throw;
+            }
+            adopt_(new_begin, new_cap, new_end);
+        }
+
+        void reserve_for_append_(size_type extra) {
+            if (extra > static_cast<size_type>(cap_ - end_)) {
+                reallocate_(derived_().next_capacity_(size() + extra));
+            }
+        }
+
+        // Moves or copies [begin_, end_) into dst, then ends the lifetime of the originals. If a
+        // copy throws, the originals are untouched.
+        T* transfer_all_(T* dst) {
+            T* dst_end = transfer_(begin_, end_, dst);
+            release_transferred_(begin_, end_);
+            return dst_end;
+        }
+
+        T* transfer_(T* first, T* last, T* dst) {
+            if constexpr (relocate_bitwise) {
+                if (first != last) {
+                    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(first),
+                                static_cast<size_t>(last - first) * sizeof(T));
+                }
+                return dst + (last - first);
+            } else if constexpr (move_on_realloc) {
+                if constexpr (default_construct) {
+                    return mystl::uninitialized_move(first, last, dst);
+                } else {
+                    T* cur = dst;
+                    try {
+                        for (; first != last; ++first, (void)++cur) {
+                            alloc_traits::construct(alloc_, cur, mystl::move(*first));
+                        }
+                    } catch (...) {
+                        destroy_range_(dst, cur);
+                        throw;
+                    }
+                    return cur;
+                }
+            } else {
+                return construct_copy_(dst, first, last);
+            }
+        }
+
+        void release_transferred_(T* first, T* last) noexcept {
+            if constexpr (!relocate_bitwise) {
+                destroy_range_(first, last);
+            }
+        }
+
+        // Releases the current block, if it came from alloc_, and takes over the new one.
+        void adopt_(T* new_begin, size_type new_cap, T* new_end) noexcept {
+            if (derived_().owns_heap_()) {
+                alloc_traits::deallocate(alloc_, begin_, capacity());
+            }
+            begin_ = new_begin;
+            end_ = new_end;
+            cap_ = new_begin + new_cap;
+        }
+
+        template <typename... Args>
+        T& realloc_emplace_back_(Args&&... args) {
+            const size_type n = derived_().next_capacity_(size() + 1);
+            if (try_expand_(n)) {
+                alloc_traits::construct(alloc_, end_, mystl::forward<Args>(args)...);
+                return *end_++;
+            }
+            auto [new_begin, new_cap] = alloc_traits::allocate_at_least(alloc_, n);
+            T* slot = new_begin + size();
+            try {
+                alloc_traits::construct(alloc_, slot, mystl::forward<Args>(args)...);
+            } catch (...) {
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                throw;
+            }
+            try {
+                transfer_all_(new_begin);
+            } catch (...) {
+                destroy_one_(slot);
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                throw;
+            }
+            adopt_(new_begin, new_cap, slot + 1);
+            return *slot;
+        }
+
+        // Opens a gap of n elements at pos and fills it with fill(dst, n). Reallocates when
+        // needed.
+        template <typename Fill>
+        T* insert_n_(const T* pos, size_type n, Fill fill) {
+            T* p = const_cast<T*>(pos);
+            if (n <= static_cast<size_type>(cap_ - end_)) {
+                return insert_n_in_place_(pos, n, fill);
+            }
+            const size_type index = static_cast<size_type>(p - begin_);
+            const size_type new_size = size() + n;
+            auto [new_begin, new_cap] =
+                alloc_traits::allocate_at_least(alloc_, derived_().next_capacity_(new_size));
+            T* gap = new_begin + index;
+            try {
+                fill(gap, n);
+            } catch (...) {
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                throw;
+            }
+            bool prefix_done = false;
+            try {
+                transfer_(begin_, p, new_begin);
+                prefix_done = true;
+                transfer_(p, end_, gap + n);
+            } catch (...) {
+                if (prefix_done) {
+                    destroy_range_(new_begin, gap);
+                }
+                destroy_range_(gap, gap + n);
+                alloc_traits::deallocate(alloc_, new_begin, new_cap);
+                throw;
+            }
+            release_transferred_(begin_, end_);
+            adopt_(new_begin, new_cap, new_begin + new_size);
+            return gap;
+        }
+
+        template <typename Fill>
+        T* insert_n_in_place_(const T* pos, size_type n, Fill fill) {
+            T* p = const_cast<T*>(pos);
+            if constexpr (relocate_bitwise) {
+                mystl::uninitialized_relocate(p, end_, p + n);
+                try {
+                    fill(p, n);
+                } catch (...) {
+                    mystl::uninitialized_relocate(p + n, end_ + n, p);
+                    throw;
+                }
+                end_ += n;
+            } else {
+                const size_type index = static_cast<size_type>(p - begin_);
+                T* old_end = end_;
+                end_ = fill(end_, n);
+                mystl::rotate(begin_ + index, old_end, end_);
+                p = begin_ + index;
+            }
+            return p;
+        }
+
+        T* construct_fill_(T* dst, size_type n, const T& value) {
+            if constexpr (default_construct) {
+                return mystl::uninitialized_fill_n(dst, n, value);
+            } else {
+                T* cur = dst;
+                try {
+                    for (; n > 0; --n, ++cur) {
+                        alloc_traits::construct(alloc_, cur, value);
+                    }
+                } catch (...) {
+                    destroy_range_(dst, cur);
+                    throw;
+                }
+                return cur;
+            }
+        }
+
+        template <typename InputIt>
+        T* construct_copy_(T* dst, InputIt first, InputIt last) {
+            if constexpr (default_construct) {
+                return mystl::uninitialized_copy(first, last, dst);
+            } else {
+                T* cur = dst;
+                try {
+                    for (; first != last; ++first, (void)++cur) {
+                        alloc_traits::construct(alloc_, cur, *first);
+                    }
+                } catch (...) {
+                    destroy_range_(dst, cur);
+                    throw;
+                }
+                return cur;
+            }
+        }
+
+        void construct_at_end_value_(size_type n) {
+            if constexpr (default_construct) {
+                end_ = mystl::uninitialized_value_construct_n(end_, n);
+            } else {
+                for (; n > 0; --n) {
+                    alloc_traits::construct(alloc_, end_);
+                    ++end_;
+                }
+            }
+        }
+
+        void construct_at_end_fill_(size_type n, const T& value) {
+            end_ = construct_fill_(end_, n, value);
+        }
+
+        template <typename InputIt>
+        void construct_at_end_copy_(InputIt first, InputIt last) {
+            end_ = construct_copy_(end_, first, last);
+        }
+
+        void construct_at_end_move_(T* first, T* last) {
+            for (; first != last; ++first) {
+                alloc_traits::construct(alloc_, end_, mystl::move(*first));
+                ++end_;
+            }
+        }
+
+        void destroy_one_(T* p) noexcept {
+            if constexpr (default_destroy) {
+                mystl::destroy_at(p);
+            } else {
+                alloc_traits::destroy(alloc_, p);
+            }
+        }
+
+        void destroy_range_(T* first, T* last) noexcept {
+            if constexpr (default_destroy) {
+                mystl::destroy(first, last);
+            } else {
+                for (; first != last; ++first) {
+                    alloc_traits::destroy(alloc_, first);
+                }
+            }
+        }
+
+        void erase_at_end_(T* new_end) noexcept {
+            destroy_range_(new_end, end_);
+            end_ = new_end;
+        }
+
+        T* begin_ = nullptr;
+        T* end_ = nullptr;
+        T* cap_ = nullptr;
+        [[no_unique_address]] Alloc alloc_;
+    };
+
+    // Shared definitions of the free functions each vector-like container declares.
+    template <typename V>
+    bool sequence_equal(const V& lhs, const V& rhs) {
+        return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <typename V, typename T = typename V::value_type>
+    auto sequence_three_way(const V& lhs, const V& rhs)
+        -> decltype(mystl::declval<const T&>() <=> mystl::declval<const T&>()) {
+        const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (auto cmp = lhs[i] <=> rhs[i]; cmp != 0) {
+                return cmp;
+            }
+        }
+        return lhs.size() <=> rhs.size();
+    }
+
+    template <typename V, typename Pred>
+    size_t sequence_erase_if(V& v, Pred& pred) {
+        auto write = v.begin();
+        for (auto read = v.begin(); read != v.end(); ++read) {
+            if (!pred(*read)) {
+                if (write != read) {
+                    *write = mystl::move(*read);
+                }
+                ++write;
+            }
+        }
+        const size_t removed = static_cast<size_t>(v.end() - write);
+        v.erase(write, v.end());
+        return removed;
+    }
+}  // namespace detail
+
+template <typename T, typename Alloc = allocator<T>, typename Growth = vector_growth_policy>
+class vector : private detail::vector_base<T, Alloc, vector<T, Alloc, Growth>> {
+    using base = detail::vector_base<T, Alloc, vector>;
+    using typename base::alloc_traits;
+    friend base;
+
+    static_assert(is_same_v<typename alloc_traits::pointer, T*>,
+                  "mystl::vector requires an allocator with raw pointers");
+    static_assert(Growth::growth_numerator > Growth::growth_denominator,
+                  "vector growth factor must be greater than 1");
+
+public:
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::size_type;
+    using typename base::difference_type;
+    using typename base::reference;
+    using typename base::const_reference;
+    using typename base::pointer;
+    using typename base::const_pointer;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    vector() noexcept(noexcept(Alloc())) : vector(Alloc()) {}
+
+    explicit vector(const Alloc& alloc) noexcept : base(alloc) {}
+
+    explicit vector(size_type n, const Alloc& alloc = Alloc()) : base(alloc) {
+        if (n != 0) {
+            init_guarded_([&] {
+                allocate_exactly_(n);
+                construct_at_end_value_(n);
+            });
+        }
+    }
+
+    vector(size_type n, const T& value, const Alloc& alloc = Alloc()) : base(alloc) {
+        if (n != 0) {
+            init_guarded_([&] {
+                allocate_exactly_(n);
+                construct_at_end_fill_(n, value);
+            });
+        }
+    }
+
+    template <typename InputIt>
+        requires requires(InputIt it) { *it; ++it; }
+    vector(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : base(alloc) {
+        init_guarded_([&] { assign_range_(first, last); });
+    }
+
+    vector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc())
+        : vector(ilist.begin(), ilist.end(), alloc) {}
+
+    vector(const vector& other)
+        : base(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+        if (!other.empty()) {
+            init_guarded_([&] {
+                allocate_exactly_(other.size());
+                construct_at_end_copy_(other.begin_, other.end_);
+            });
+        }
+    }
+
+    vector(const vector& other, const Alloc& alloc) : base(alloc) {
+        if (!other.empty()) {
+            init_guarded_([&] {
+                allocate_exactly_(other.size());
+                construct_at_end_copy_(other.begin_, other.end_);
+            });
+        }
+    }
+
+    vector(vector&& other) noexcept : base(mystl::move(other.alloc_)) { steal_(other); }
+
+    vector(vector&& other, const Alloc& alloc) : base(alloc) {
+        if (alloc_ == other.alloc_) {
+            steal_(other);
+        } else if (!other.empty()) {
+            init_guarded_([&] {
+                allocate_exactly_(other.size());
+                construct_at_end_move_(other.begin_, other.end_);
+            });
+        }
+    }
+
+    ~vector() { release_storage_(); }
+
+    vector& operator=(const vector& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (alloc_ != other.alloc_) {
+                release_storage_();
+            }
+            alloc_ = other.alloc_;
+        }
+        assign_range_(other.begin_, other.end_);
+        return *this;
+    }
+
+    vector& operator=(vector&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            release_storage_();
+            alloc_ = mystl::move(other.alloc_);
+            steal_(other);
+        } else {
+            if (alloc_ == other.alloc_) {
+                release_storage_();
+                steal_(other);
+            } else {
+                move_assign_range_(other.begin_, other.end_);
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    vector& operator=(std::initializer_list<T> ilist) {
+        assign_range_(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    using base::assign;
+    using base::get_allocator;
+    using base::at;
+    using base::operator[];
+    using base::front;
+    using base::back;
+    using base::data;
+    using base::begin;
+    using base::cbegin;
+    using base::end;
+    using base::cend;
+    using base::empty;
+    using base::size;
+    using base::capacity;
+    using base::max_size;
+    using base::reserve;
+
+    void shrink_to_fit() {
+        if (cap_ == end_) {
+            return;
+        }
+        if (empty()) {
+            release_storage_();
+            return;
+        }
+        shrink_heap_();
+    }
+
+    using base::clear;
+    using base::insert;
+    using base::emplace;
+    using base::emplace_back;
+    using base::push_back;
+    using base::pop_back;
+    using base::erase;
+    using base::resize;
+
+    void swap(vector& other) noexcept {
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            using mystl::swap;
+            swap(alloc_, other.alloc_);
+        }
+        swap_storage_(other);
+    }
+
+private:
+    using base::begin_;
+    using base::end_;
+    using base::cap_;
+    using base::alloc_;
+    using base::destroy_range_;
+    using base::construct_at_end_value_;
+    using base::construct_at_end_fill_;
+    using base::construct_at_end_copy_;
+    using base::construct_at_end_move_;
+    using base::allocate_exactly_;
+    using base::assign_range_;
+    using base::move_assign_range_;
+    using base::shrink_heap_;
+
+    static constexpr const char* name_ = "mystl::vector";
+
+    // Constructors call this so that a throwing element constructor does not leak the buffer.
+    template <typename F>
+    void init_guarded_(F f) {
+        try {
+            f();
+        } catch (...) {
+            release_storage_();
+            throw;
+        }
+    }
+
+    size_type min_capacity_() const noexcept {
+        constexpr size_type n = Growth::initial_bytes / sizeof(T);
+        return n > 0 ? n : 1;
+    }
+
+    size_type next_capacity_(size_type required) const {
+        const size_type max = max_size();
+        if (required > max) {
+            throw std::length_error(name_);
+        }
+        const size_type cap = capacity();
+        size_type grown = cap > max / Growth::growth_numerator
+                              ? max
+                              : cap * Growth::growth_numerator / Growth::growth_denominator;
+        if (grown < required) {
+            grown = required;
+        }
+        if (grown < min_capacity_()) {
+            grown = min_capacity_() < max ? min_capacity_() : max;
+        }
+        return grown;
+    }
+
+    bool owns_heap_() const noexcept { return begin_ != nullptr; }
+
+    void release_heap_() noexcept {
+        if (begin_ != nullptr) {
+            alloc_traits::deallocate(alloc_, begin_, capacity());
+            begin_ = end_ = cap_ = nullptr;
+        }
+    }
+
+    void release_storage_() noexcept {
+        destroy_range_(begin_, end_);
+        release_heap_();
+    }
+
+    void steal_(vector& other) noexcept {
+        begin_ = mystl::exchange(other.begin_, nullptr);
+        end_ = mystl::exchange(other.end_, nullptr);
+        cap_ = mystl::exchange(other.cap_, nullptr);
+    }
+
+    void swap_storage_(vector& other) noexcept {
+        using mystl::swap;
+        swap(begin_, other.begin_);
+        swap(end_, other.end_);
+        swap(cap_, other.cap_);
+    }
+};
+
+template <typename T, typename Alloc, typename Growth>
+bool operator==(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs) {
+    return detail::sequence_equal(lhs, rhs);
+}
+
+template <typename T, typename Alloc, typename Growth>
+auto operator<=>(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
+    -> decltype(detail::sequence_three_way(lhs, rhs)) {
+    return detail::sequence_three_way(lhs, rhs);
+}
+
+template <typename T, typename Alloc, typename Growth>
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename T, typename Alloc, typename Growth, typename Pred>
+size_t erase_if(vector<T, Alloc, Growth>& v, Pred pred) {
+    return detail::sequence_erase_if(v, pred);
+}
+
+template <typename T, typename Alloc, typename Growth, typename U>
+size_t erase(vector<T, Alloc, Growth>& v, const U& value) {
+    return mystl::erase_if(v, [&value](const T& elem) { return elem == value; });
+}
+
+}  // namespace mystl
+
+#endif
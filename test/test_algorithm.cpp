@@ -0,0 +1,284 @@
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "algorithm.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+static const int sizes[] = {0, 1, 2, 7, 16, 17, 24, 25, 129, 1000, 20000};
+
+template <typename T, typename Gen, typename Compare = std::less<T>>
+void check_sort(Gen gen, int n, Compare comp = Compare()) {
+    mystl::vector<T> v;
+    for (int i = 0; i < n; ++i) {
+        v.push_back(gen(i));
+    }
+    mystl::sort(v.begin(), v.end(), comp);
+    assert(mystl::is_sorted(v.begin(), v.end(), comp));
+}
+
+void test_sort() {
+    TEST_CASE("sort");
+
+    std::mt19937 rng(7);
+    for (int n : sizes) {
+        check_sort<int>([&](int) { return static_cast<int>(rng()); }, n);
+        check_sort<int>([&](int) { return static_cast<int>(rng() % 3); }, n);
+        check_sort<int>([](int i) { return i; }, n);
+        check_sort<int>([n](int i) { return n - i; }, n);
+        check_sort<int>([](int i) { return i % 2 ? i : -i; }, n);
+        check_sort<unsigned>([&](int) { return static_cast<unsigned>(rng()); }, n);
+        check_sort<float>([&](int) { return static_cast<float>(rng() % 200) - 100.0f; }, n);
+        check_sort<double>([&](int) { return static_cast<double>(rng()); }, n, std::greater<double>());
+        check_sort<std::string>([&](int) { return std::to_string(rng() % 500); }, n);
+    }
+
+    // The float kernels must not merge -0.0 and +0.0, which compare equal.
+    mystl::vector<float> zeros = {0.0f, -0.0f, 1.0f, -0.0f, 0.0f, -1.0f};
+    mystl::sort(zeros.begin(), zeros.end());
+    int negative = 0;
+    for (float f : zeros) {
+        negative += std::signbit(f) ? 1 : 0;
+    }
+    assert(negative == 3 && zeros.front() == -1.0f && zeros.back() == 1.0f);
+
+    // Sixteen keys fill both network registers; the final merge ties every -0.0 with a +0.0.
+    mystl::vector<float> halves(16, -0.0f);
+    mystl::fill(halves.begin() + 8, halves.end(), 0.0f);
+    mystl::sort(halves.begin(), halves.end());
+    negative = 0;
+    for (float f : halves) {
+        negative += std::signbit(f) ? 1 : 0;
+    }
+    assert(negative == 8);
+
+    // Small inputs with many duplicates come out as a permutation of the input, bit for bit.
+    const float pool[] = {-0.0f, 0.0f, 1.0f, -1.0f};
+    for (int n = 1; n <= 16; ++n) {
+        mystl::vector<float> keys;
+        for (int i = 0; i < n; ++i) {
+            keys.push_back(pool[rng() % 4]);
+        }
+        mystl::vector<float> sorted = keys;
+        mystl::sort(sorted.begin(), sorted.end());
+        assert(mystl::is_sorted(sorted.begin(), sorted.end()));
+        mystl::vector<uint32_t> before, after;
+        for (int i = 0; i < n; ++i) {
+            before.push_back(std::bit_cast<uint32_t>(keys[i]));
+            after.push_back(std::bit_cast<uint32_t>(sorted[i]));
+        }
+        mystl::sort(before.begin(), before.end());
+        mystl::sort(after.begin(), after.end());
+        assert(before == after);
+    }
+
+    TEST_CASE_PASS("sort");
+}
+
+void test_stable_sort() {
+    TEST_CASE("stable_sort");
+
+    std::mt19937 rng(11);
+    for (int n : sizes) {
+        mystl::vector<mystl::pair<int, int>> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back({static_cast<int>(rng() % 10), i});
+        }
+        mystl::stable_sort(v.begin(), v.end(),
+                           [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (int i = 1; i < n; ++i) {
+            assert(v[i - 1].first < v[i].first ||
+                   (v[i - 1].first == v[i].first && v[i - 1].second < v[i].second));
+        }
+    }
+
+    mystl::vector<int> ints = {5, 3, 9, 1, 3};
+    mystl::stable_sort(ints.begin(), ints.end());
+    assert((ints == mystl::vector<int>{1, 3, 3, 5, 9}));
+
+    TEST_CASE_PASS("stable_sort");
+}
+
+void test_partial_sort() {
+    TEST_CASE("partial_sort");
+
+    std::mt19937 rng(3);
+    mystl::vector<int> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(static_cast<int>(rng() % 100000));
+    }
+    mystl::vector<int> sorted = v;
+    mystl::sort(sorted.begin(), sorted.end());
+    mystl::partial_sort(v.begin(), v.begin() + 50, v.end());
+    assert(mystl::equal(v.begin(), v.begin() + 50, sorted.begin()));
+
+    mystl::partial_sort(v.begin(), v.begin(), v.end());
+    mystl::partial_sort(v.begin(), v.end(), v.end(), std::greater<int>());
+    assert(v.front() == sorted.back() && v.back() == sorted.front());
+
+    TEST_CASE_PASS("partial_sort");
+}
+
+void test_binary_search() {
+    TEST_CASE("lower_bound / upper_bound");
+
+    mystl::vector<int> v = {1, 2, 2, 2, 5, 8};
+    assert(mystl::lower_bound(v.begin(), v.end(), 2) - v.begin() == 1);
+    assert(mystl::upper_bound(v.begin(), v.end(), 2) - v.begin() == 4);
+    assert(mystl::lower_bound(v.begin(), v.end(), 0) == v.begin());
+    assert(mystl::lower_bound(v.begin(), v.end(), 9) == v.end());
+    assert(mystl::upper_bound(v.begin(), v.begin(), 9) == v.begin());
+
+    TEST_CASE_PASS("lower_bound / upper_bound");
+}
+
+// Trivially copyable, but only move assignment is available.
+struct MoveAssignOnly {
+    int val;
+
+    MoveAssignOnly(int v) : val(v) {}
+    MoveAssignOnly(const MoveAssignOnly&) = default;
+    MoveAssignOnly(MoveAssignOnly&&) = default;
+    MoveAssignOnly& operator=(const MoveAssignOnly&) = delete;
+    MoveAssignOnly& operator=(MoveAssignOnly&&) = default;
+};
+
+void test_copy_move() {
+    TEST_CASE("copy / move");
+
+    static_assert(mystl::detail::is_memmove_assignable_v<int*, int*>);
+    static_assert(mystl::detail::is_memmove_assignable_v<const int*, int*, true>);
+    static_assert(!mystl::detail::is_memmove_assignable_v<MoveAssignOnly*, MoveAssignOnly*>);
+    static_assert(mystl::detail::is_memmove_assignable_v<MoveAssignOnly*, MoveAssignOnly*, true>);
+
+    int src[] = {1, 2, 3, 4, 5};
+    int dst[5] = {};
+    [[maybe_unused]] int* copied_end = mystl::copy(src, src + 5, dst);
+    assert(copied_end == dst + 5 && dst[4] == 5);
+
+    // {1, 2, 3, 4, 5} -> {2, 3, 4, 5, 5} -> {2, 3, 2, 3, 4}
+    MoveAssignOnly items[] = {1, 2, 3, 4, 5};
+    [[maybe_unused]] MoveAssignOnly* moved_end = mystl::move(items + 1, items + 5, items);
+    assert(moved_end == items + 4 && items[3].val == 5);
+    [[maybe_unused]] MoveAssignOnly* moved_begin =
+        mystl::move_backward(items, items + 3, items + 5);
+    assert(moved_begin == items + 2 && items[2].val == 2 && items[4].val == 4);
+
+    TEST_CASE_PASS("copy / move");
+}
+
+void test_rotate() {
+    TEST_CASE("rotate");
+
+    for (int n = 0; n <= 12; ++n) {
+        for (int k = 0; k <= n; ++k) {
+            mystl::vector<int> v;
+            std::forward_list<int> fl;
+            for (int i = n - 1; i >= 0; --i) {
+                fl.push_front(i);
+            }
+            for (int i = 0; i < n; ++i) {
+                v.push_back(i);
+            }
+
+            [[maybe_unused]] auto pos = mystl::rotate(v.begin(), v.begin() + k, v.end());
+            [[maybe_unused]] auto fl_pos =
+                mystl::rotate(fl.begin(), std::next(fl.begin(), k), fl.end());
+            assert(pos - v.begin() == n - k && std::distance(fl.begin(), fl_pos) == n - k);
+            int i = 0;
+            for ([[maybe_unused]] int x : fl) {
+                assert(x == (i + k) % n && v[i] == x);
+                ++i;
+            }
+        }
+    }
+
+    // A long range with a one-element tail must not recurse once per element.
+    mystl::vector<std::string> big(2000000, "x");
+    big.back() = "tail";
+    [[maybe_unused]] auto pos = mystl::rotate(big.begin(), big.end() - 1, big.end());
+    assert(pos == big.begin() + 1 && big.front() == "tail" && big.back() == "x");
+
+    TEST_CASE_PASS("rotate");
+}
+
+void test_radix_sort() {
+    TEST_CASE("radix_sort");
+
+    std::mt19937_64 rng(5);
+    for (int n : sizes) {
+        mystl::vector<long long> i64;
+        mystl::vector<unsigned short> u16;
+        mystl::vector<double> f64;
+        for (int i = 0; i < n; ++i) {
+            i64.push_back(static_cast<long long>(rng()) >> (i % 40));
+            u16.push_back(static_cast<unsigned short>(rng()));
+            f64.push_back(static_cast<double>(static_cast<long long>(rng() % 2001) - 1000) / 8.0);
+        }
+        mystl::radix_sort(i64.begin(), i64.end());
+        mystl::radix_sort(u16.begin(), u16.end());
+        mystl::radix_sort(f64.begin(), f64.end());
+        assert(mystl::is_sorted(i64.begin(), i64.end()));
+        assert(mystl::is_sorted(u16.begin(), u16.end()));
+        assert(mystl::is_sorted(f64.begin(), f64.end()));
+    }
+
+    mystl::vector<float> floats = {3.5f, -0.0f, -2.0f, 0.0f, -1e30f, 1e30f};
+    for (int i = 0; i < 100; ++i) {
+        floats.push_back(static_cast<float>(i % 7) - 3.0f);
+    }
+    mystl::radix_sort(floats.begin(), floats.end());
+    assert(floats.front() == -1e30f && floats.back() == 1e30f);
+    assert(mystl::is_sorted(floats.begin(), floats.end()));
+
+    // Keys with only the low byte varying, stable with respect to the payload.
+    mystl::vector<mystl::pair<unsigned, std::string>> pairs;
+    for (int i = 0; i < 500; ++i) {
+        pairs.push_back({0x12345600u + static_cast<unsigned>(rng() % 4), std::to_string(i)});
+    }
+    mystl::radix_sort(pairs.begin(), pairs.end());
+    for (size_t i = 1; i < pairs.size(); ++i) {
+        assert(pairs[i - 1].first <= pairs[i].first);
+        if (pairs[i - 1].first == pairs[i].first) {
+            assert(std::stoi(pairs[i - 1].second) < std::stoi(pairs[i].second));
+        }
+    }
+
+    struct record {
+        int id;
+        short key;
+    };
+    mystl::vector<record> records;
+    for (int i = 0; i < 300; ++i) {
+        records.push_back({i, static_cast<short>(static_cast<int>(rng() % 200) - 100)});
+    }
+    mystl::radix_sort(records.begin(), records.end(), &record::key);
+    for (size_t i = 1; i < records.size(); ++i) {
+        assert(records[i - 1].key < records[i].key ||
+               (records[i - 1].key == records[i].key && records[i - 1].id < records[i].id));
+    }
+
+    TEST_CASE_PASS("radix_sort");
+}
+
+int main() {
+    test_sort();
+    test_stable_sort();
+    test_partial_sort();
+    test_binary_search();
+    test_copy_move();
+    test_rotate();
+    test_radix_sort();
+
+    std::cout << "All algorithm tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "construct.h"
+#include "type_traits.h"
+#include "utility.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct Counted {
+    static int alive;
+    int val;
+
+    Counted() : val(-1) { ++alive; }
+    Counted(int v) : val(v) { ++alive; }
+    Counted(const Counted& other) : val(other.val) { ++alive; }
+    Counted(Counted&& other) noexcept : val(other.val) {
+        other.val = 0;
+        ++alive;
+    }
+    ~Counted() { --alive; }
+};
+
+int Counted::alive = 0;
+
+struct ThrowOnThird {
+    static int constructed;
+    int val;
+
+    ThrowOnThird(int v) : val(v) {}
+    ThrowOnThird(const ThrowOnThird& other) : val(other.val) {
+        if (constructed == 2) {
+            throw 42;
+        }
+        ++constructed;
+    }
+    ~ThrowOnThird() { --constructed; }
+};
+
+int ThrowOnThird::constructed = 0;
+
+template <typename T>
+struct RawBuffer {
+    alignas(T) unsigned char bytes[sizeof(T) * 8];
+    T* data() { return reinterpret_cast<T*>(bytes); }
+};
+
+void test_construct_destroy_at() {
+    TEST_CASE("construct_at / destroy_at");
+
+    RawBuffer<std::string> buf;
+    std::string* s = mystl::construct_at(buf.data(), 5, 'x');
+    assert(*s == "xxxxx");
+    mystl::destroy_at(s);
+
+    RawBuffer<Counted> cbuf;
+    Counted* c = mystl::construct_at(cbuf.data(), 7);
+    assert(Counted::alive == 1 && c->val == 7);
+    mystl::destroy_at(c);
+    assert(Counted::alive == 0);
+
+    TEST_CASE_PASS("construct_at / destroy_at");
+}
+
+void test_uninitialized_copy_trivial() {
+    TEST_CASE("uninitialized_copy trivial");
+
+    static_assert(mystl::detail::is_bitwise_constructible_v<const int*, int*, const int&>);
+    static_assert(!mystl::detail::is_bitwise_constructible_v<const Counted*, Counted*,
+                                                             const Counted&>);
+
+    int src[5] = {1, 2, 3, 4, 5};
+    RawBuffer<int> buf;
+    [[maybe_unused]] int* end = mystl::uninitialized_copy(src, src + 5, buf.data());
+    assert(end == buf.data() + 5);
+    for (int i = 0; i < 5; ++i) {
+        assert(buf.data()[i] == src[i]);
+    }
+
+    end = mystl::uninitialized_copy_n(src, 3, buf.data() + 5);
+    assert(end == buf.data() + 8);
+    assert(buf.data()[7] == 3);
+
+    TEST_CASE_PASS("uninitialized_copy trivial");
+}
+
+void test_uninitialized_copy_move_nontrivial() {
+    TEST_CASE("uninitialized_copy / move non-trivial");
+
+    std::string src[3] = {"alpha", "beta", "gamma"};
+    RawBuffer<std::string> buf;
+    std::string* end = mystl::uninitialized_copy(src, src + 3, buf.data());
+    assert(end == buf.data() + 3);
+    assert(buf.data()[1] == "beta" && src[1] == "beta");
+    mystl::destroy(buf.data(), end);
+
+    [[maybe_unused]] auto [in, out] = mystl::uninitialized_move_n(src, 3, buf.data());
+    assert(in == src + 3 && out == buf.data() + 3);
+    assert(buf.data()[2] == "gamma");
+    mystl::destroy_n(buf.data(), 3);
+
+    TEST_CASE_PASS("uninitialized_copy / move non-trivial");
+}
+
+void test_uninitialized_fill() {
+    TEST_CASE("uninitialized_fill");
+
+    RawBuffer<char> cbuf;
+    mystl::uninitialized_fill(cbuf.data(), cbuf.data() + 8, 'z');
+    for (int i = 0; i < 8; ++i) {
+        assert(cbuf.data()[i] == 'z');
+    }
+
+    RawBuffer<double> dbuf;
+    mystl::uninitialized_fill_n(dbuf.data(), 8, 0.0);
+    assert(dbuf.data()[7] == 0.0);
+    mystl::uninitialized_fill_n(dbuf.data(), 8, -0.0);
+    assert(dbuf.data()[3] == 0.0);
+    mystl::uninitialized_fill_n(dbuf.data(), 8, 2.5);
+    assert(dbuf.data()[5] == 2.5);
+
+    RawBuffer<Counted> buf;
+    Counted* end = mystl::uninitialized_fill_n(buf.data(), 4, Counted(9));
+    assert(Counted::alive == 4 && buf.data()[3].val == 9);
+    mystl::destroy(buf.data(), end);
+    assert(Counted::alive == 0);
+
+    TEST_CASE_PASS("uninitialized_fill");
+}
+
+void test_uninitialized_value_construct() {
+    TEST_CASE("uninitialized_value_construct");
+
+    RawBuffer<int*> pbuf;
+    mystl::uninitialized_value_construct(pbuf.data(), pbuf.data() + 8);
+    for (int i = 0; i < 8; ++i) {
+        assert(pbuf.data()[i] == nullptr);
+    }
+
+    RawBuffer<Counted> buf;
+    Counted* end = mystl::uninitialized_value_construct_n(buf.data(), 3);
+    assert(Counted::alive == 3 && buf.data()[2].val == -1);
+    mystl::destroy_n(buf.data(), end - buf.data());
+    assert(Counted::alive == 0);
+
+    TEST_CASE_PASS("uninitialized_value_construct");
+}
+
+void test_rollback_on_exception() {
+    TEST_CASE("rollback on exception");
+
+    ThrowOnThird src[4] = {1, 2, 3, 4};
+    RawBuffer<ThrowOnThird> buf;
+    [[maybe_unused]] bool thrown = false;
+    try {
+        mystl::uninitialized_copy(src, src + 4, buf.data());
+    } catch (int) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(ThrowOnThird::constructed == 0);
+
+    TEST_CASE_PASS("rollback on exception");
+}
+
+int main() {
+    test_construct_destroy_at();
+    test_uninitialized_copy_trivial();
+    test_uninitialized_copy_move_nontrivial();
+    test_uninitialized_fill();
+    test_uninitialized_value_construct();
+    test_rollback_on_exception();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "execution.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+namespace ex = mystl::execution;
+
+static_assert(mystl::is_execution_policy_v<mystl::execution::parallel_policy>);
+static_assert(!mystl::is_execution_policy_v<int>);
+
+static const size_t sizes[] = {0, 1, 1000, 50000, 200003};
+
+void test_numeric() {
+    TEST_CASE("reduce / transform_reduce / inclusive_scan");
+
+    std::mt19937 rng(1);
+    for (size_t n : sizes) {
+        mystl::vector<long> v(n);
+        for (long& x : v) {
+            x = static_cast<long>(rng() % 1000);
+        }
+        [[maybe_unused]] const long sum = mystl::accumulate(v.begin(), v.end(), 0L);
+        assert(mystl::reduce(ex::par, v.begin(), v.end()) == sum);
+        assert(mystl::reduce(ex::seq, v.begin(), v.end(), 5L) == sum + 5);
+        assert(mystl::transform_reduce(ex::par_unseq, v.begin(), v.end(), v.begin(), 0L) ==
+               mystl::transform_reduce(v.begin(), v.end(), v.begin(), 0L));
+        assert(mystl::transform_reduce(ex::par, v.begin(), v.end(), 0L, std::plus<>(),
+                                       [](long x) { return x % 7; }) ==
+               mystl::transform_reduce(v.begin(), v.end(), 0L, std::plus<>(),
+                                       [](long x) { return x % 7; }));
+
+        mystl::vector<long> expected(n);
+        mystl::vector<long> out(n);
+        mystl::inclusive_scan(v.begin(), v.end(), expected.begin());
+        mystl::inclusive_scan(ex::par, v.begin(), v.end(), out.begin());
+        assert(out == expected);
+        mystl::inclusive_scan(v.begin(), v.end(), expected.begin(), std::plus<>(), 3L);
+        mystl::inclusive_scan(ex::par, v.begin(), v.end(), out.begin(), std::plus<>(), 3L);
+        assert(out == expected);
+        // In place.
+        mystl::inclusive_scan(ex::par, v.begin(), v.end(), v.begin());
+        assert(n == 0 || v.back() == sum);
+    }
+
+    TEST_CASE_PASS("reduce / transform_reduce / inclusive_scan");
+}
+
+void test_elementwise() {
+    TEST_CASE("for_each / transform / copy / fill");
+
+    for (size_t n : sizes) {
+        mystl::vector<int> v(n);
+        mystl::fill(ex::par, v.begin(), v.end(), 2);
+        mystl::for_each(ex::par_unseq, v.begin(), v.end(), [](int& x) { x *= 3; });
+        mystl::vector<int> w(n);
+        mystl::transform(ex::par, v.begin(), v.end(), w.begin(), [](int x) { return x + 1; });
+        mystl::transform(ex::unseq, v.begin(), v.end(), w.begin(), w.begin(), std::plus<>());
+        mystl::vector<int> c(n);
+        mystl::copy(ex::par, w.begin(), w.end(), c.begin());
+        for ([[maybe_unused]] int x : c) {
+            assert(x == 13);
+        }
+    }
+
+    TEST_CASE_PASS("for_each / transform / copy / fill");
+}
+
+void test_sort() {
+    TEST_CASE("sort");
+
+    std::mt19937 rng(2);
+    for (size_t n : sizes) {
+        mystl::vector<unsigned> v(n);
+        for (unsigned& x : v) {
+            x = static_cast<unsigned>(rng() % 5000);
+        }
+        mystl::sort(ex::par, v.begin(), v.end());
+        assert(mystl::is_sorted(v.begin(), v.end()));
+
+        mystl::vector<std::string> s(n / 4);
+        for (std::string& x : s) {
+            x = std::to_string(rng());
+        }
+        mystl::sort(ex::par_unseq, s.begin(), s.end(), std::greater<>());
+        assert(mystl::is_sorted(s.begin(), s.end(), std::greater<>()));
+    }
+
+    TEST_CASE_PASS("sort");
+}
+
+void test_nested() {
+    TEST_CASE("nested in parallel_invoke");
+
+    // The policies run on the default scheduler, so loops started from its tasks share the
+    // same workers and help each other finish.
+    mystl::vector<long> a(100000, 1);
+    mystl::vector<long> b(100000, 2);
+    long sum_a = 0;
+    long sum_b = 0;
+    mystl::parallel_invoke([&] { sum_a = mystl::reduce(ex::par, a.begin(), a.end()); },
+                           [&] { sum_b = mystl::reduce(ex::par, b.begin(), b.end()); });
+    assert(sum_a == 100000 && sum_b == 200000);
+
+    TEST_CASE_PASS("nested in parallel_invoke");
+}
+
+int main() {
+    // Force real workers even on single-core machines; read when the default scheduler starts.
+    setenv("MYSTL_NUM_THREADS", "4", 1);
+
+    test_numeric();
+    test_elementwise();
+    test_sort();
+    test_nested();
+
+    std::cout << "All execution tests passed!" << std::endl;
+    return 0;
+}
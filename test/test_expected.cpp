@@ -0,0 +1,301 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expected.h"
+#include "type_traits.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+enum class errc : unsigned char { ok, timeout, refused };
+
+template <>
+struct mystl::niche_traits<errc> : mystl::niche_value<errc, errc::ok> {};
+
+struct Counter {
+    static inline int live = 0;
+
+    int value;
+
+    explicit Counter(int v) : value(v) { ++live; }
+    Counter(const Counter& other) : value(other.value) { ++live; }
+    Counter(Counter&& other) noexcept : value(other.value) { ++live; }
+    Counter& operator=(const Counter&) = default;
+    Counter& operator=(Counter&&) = default;
+    ~Counter() { --live; }
+};
+
+// Copying throws on demand and moving may throw, so replacing an error by one of these has to
+// set the error aside and put it back on failure.
+struct Fragile {
+    static inline bool fail = false;
+
+    int value;
+
+    explicit Fragile(int v) : value(v) {}
+    Fragile(const Fragile& other) : value(other.value) {
+        if (fail) {
+            throw std::runtime_error("copy");
+        }
+    }
+    Fragile(Fragile&& other) noexcept(false) : value(other.value) {}
+    Fragile& operator=(const Fragile&) = default;
+};
+
+// Neither copyable nor movable: transform() must construct it in place.
+struct Pinned {
+    explicit Pinned(int v) : value(v) {}
+    Pinned(const Pinned&) = delete;
+
+    int value;
+};
+
+using result = mystl::expected<int, std::string>;
+
+// Copying is not trivial, so expected's copies, reassignments, emplace and swap all go through
+// construct_at.
+struct Literal {
+    int v;
+    constexpr Literal(int x) noexcept : v(x) {}
+    constexpr Literal(const Literal& other) noexcept : v(other.v) {}
+    constexpr Literal& operator=(const Literal& other) noexcept {
+        v = other.v;
+        return *this;
+    }
+};
+
+constexpr bool constexpr_copy_and_assign() {
+    mystl::expected<Literal, int> a(Literal(1));
+    mystl::expected<Literal, int> copy = a;
+    mystl::expected<long, int> widened = mystl::expected<int, int>(2);
+    mystl::expected<Literal, int> b(mystl::unexpect, 3);
+    b = a;           // error -> value
+    b = Literal(7);  // value assignment
+    a = mystl::unexpected<int>(2);
+    a.emplace(3);    // error -> value
+    mystl::expected<Literal, int> c(mystl::unexpect, 1);
+    swap(copy, c);   // value <-> error
+    return b->v == 7 && *widened == 2 && a->v == 3 && c->v == 1 && copy.error() == 1;
+}
+
+void test_basics() {
+    TEST_CASE("construction and access");
+
+    result ok = 3;
+    assert(ok && ok.has_value() && *ok == 3 && ok.value() == 3 && ok == 3);
+    result bad = mystl::unexpected(std::string("boom"));
+    assert(!bad && bad.error() == "boom" && bad == mystl::unexpected<std::string>("boom"));
+    assert(bad.value_or(7) == 7 && ok.error_or("none") == "none" && bad.error_or("") == "boom");
+
+    result def;
+    assert(def && *def == 0);
+
+    mystl::expected<std::vector<int>, int> v(mystl::in_place, {1, 2, 3});
+    assert(v->size() == 3);
+    mystl::expected<std::vector<int>, std::string> e(mystl::unexpect, 2, 'x');
+    assert(e.error() == "xx");
+
+    mystl::expected<long, std::string> widened = ok;
+    assert(widened == 3L);
+    mystl::expected<long, std::string> widened_error = bad;
+    assert(widened_error.error() == "boom");
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        static_cast<void>(bad.value());
+    } catch (const mystl::bad_expected_access<std::string>& ex) {
+        threw = ex.error() == "boom";
+    }
+    assert(threw);
+
+    constexpr mystl::expected<int, int> ce(4);
+    static_assert(*ce == 4 && ce.value_or(0) == 4);
+    constexpr mystl::expected<int, int> ce_error(mystl::unexpect, 9);
+    static_assert(ce_error.error() == 9 && ce_error.transform([](int x) { return x; }) != 9);
+    static_assert(constexpr_copy_and_assign());
+
+    TEST_CASE_PASS("construction and access");
+}
+
+void test_assignment() {
+    TEST_CASE("assignment, swap and lifetime");
+
+    Counter::live = 0;
+    {
+        using E = mystl::expected<Counter, std::string>;
+        E a(mystl::in_place, 1);
+        E b = a;
+        assert(Counter::live == 2);
+        b = mystl::unexpected(std::string("gone"));
+        assert(Counter::live == 1 && !b);
+        b = a;
+        assert(Counter::live == 2 && b->value == 1);
+        a = mystl::unexpected(std::string("a"));
+        swap(a, b);
+        assert(a->value == 1 && b.error() == "a" && Counter::live == 1);
+        b.swap(a);
+        assert(b->value == 1 && a.error() == "a" && Counter::live == 1);
+        a.emplace(Counter(5));
+        assert(a->value == 5 && Counter::live == 2);
+        a = Counter(6);
+        assert(a->value == 6 && Counter::live == 2);
+    }
+    assert(Counter::live == 0);
+
+    // A throwing copy leaves the old error in place.
+    using F = mystl::expected<Fragile, Counter>;
+    F f(mystl::unexpect, 8);
+    F source(mystl::in_place, 1);
+    Fragile::fail = true;
+    [[maybe_unused]] bool threw = false;
+    try {
+        f = source;
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    Fragile::fail = false;
+    assert(threw && !f && f.error().value == 8);
+    f = source;
+    assert(f && f->value == 1);
+
+    TEST_CASE_PASS("assignment, swap and lifetime");
+}
+
+void test_monadic() {
+    TEST_CASE("and_then / or_else / transform / transform_error");
+
+    auto parse = [](const std::string& text) -> result {
+        if (text.empty() || text[0] < '0' || text[0] > '9') {
+            return mystl::unexpected("not a number: " + text);
+        }
+        return std::stoi(text);
+    };
+    auto positive = [](int x) -> result {
+        return x > 0 ? result(x) : result(mystl::unexpect, "not positive");
+    };
+
+    mystl::expected<std::string, std::string> text("42");
+    assert(text.and_then(parse).and_then(positive) == 42);
+    assert(text.and_then(parse).transform([](int x) { return x * 2; }) == 84);
+
+    mystl::expected<std::string, std::string> word("x");
+    result failed = word.and_then(parse).and_then(positive);
+    assert(failed.error() == "not a number: x");
+
+    result recovered = failed.or_else([](const std::string&) { return result(0); });
+    assert(recovered == 0);
+    assert(result(5).or_else([](const std::string&) { return result(0); }) == 5);
+
+    [[maybe_unused]] mystl::expected<int, size_t> length =
+        failed.transform_error([](const std::string& s) { return s.size(); });
+    assert(length.error() == 15);
+
+    mystl::expected<Pinned, std::string> pinned = result(3).transform([](int x) {
+        return Pinned(x);
+    });
+    assert(pinned->value == 3);
+
+    mystl::expected<std::string, std::string> moved = mystl::move(text).transform(
+        [](std::string&& s) { return mystl::move(s) + "!"; });
+    assert(*moved == "42!");
+
+    int calls = 0;
+    mystl::expected<void, std::string> done = result(1).transform([&](int) { ++calls; });
+    assert(done && calls == 1);
+    mystl::expected<void, std::string> skipped = failed.transform([&](int) { ++calls; });
+    assert(!skipped && calls == 1);
+
+    TEST_CASE_PASS("and_then / or_else / transform / transform_error");
+}
+
+void test_void() {
+    TEST_CASE("expected<void, E>");
+
+    using status = mystl::expected<void, std::string>;
+    status ok;
+    assert(ok && ok.has_value());
+    ok.value();
+    status bad(mystl::unexpect, "disk full");
+    assert(!bad && bad.error() == "disk full" && bad != ok);
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        bad.value();
+    } catch (const mystl::bad_expected_access<void>&) {
+        threw = true;
+    }
+    assert(threw);
+
+    status copy = bad;
+    assert(copy == bad);
+    copy = ok;
+    assert(copy);
+    swap(copy, bad);
+    assert(!copy && bad && copy.error() == "disk full");
+    copy.emplace();
+    assert(copy);
+
+    int step = 0;
+    auto next = [&]() -> status {
+        ++step;
+        return step < 3 ? status() : status(mystl::unexpect, "step " + std::to_string(step));
+    };
+    status chained = ok.and_then(next).and_then(next).and_then(next).and_then(next);
+    assert(!chained && chained.error() == "step 3" && step == 3);
+    assert(chained.or_else([](const std::string&) { return status(); }));
+    assert(chained.transform_error([](const std::string& s) { return s.size(); }).error() == 6);
+    assert(ok.transform([] { return 1; }) == 1);
+
+    // An error code whose "ok" enumerator is its niche: success is stored in the error itself.
+    using code = mystl::expected<void, errc>;
+    code c;
+    assert(c);
+    c = mystl::unexpected(errc::timeout);
+    assert(!c && c.error() == errc::timeout);
+    code d = c;
+    c.emplace();
+    assert(c && d.error() == errc::timeout);
+    swap(c, d);
+    assert(!c && d && c.error_or(errc::ok) == errc::timeout);
+
+    TEST_CASE_PASS("expected<void, E>");
+}
+
+void test_layout() {
+    TEST_CASE("layout and triviality");
+
+    struct pod {
+        int a;
+        double b;
+    };
+    static_assert(mystl::is_trivially_copyable_v<mystl::expected<int, int>>);
+    static_assert(mystl::is_trivially_copyable_v<mystl::expected<pod, errc>>);
+    static_assert(mystl::is_trivially_destructible_v<mystl::expected<pod, int>>);
+    static_assert(mystl::is_trivially_copyable_v<mystl::expected<void, int>>);
+    static_assert(!mystl::is_trivially_copyable_v<result>);
+    static_assert(!mystl::is_trivially_destructible_v<mystl::expected<void, std::string>>);
+    static_assert(!mystl::is_copy_constructible_v<mystl::expected<Pinned, int>>);
+    static_assert(mystl::is_trivially_relocatable_v<mystl::expected<int, pod>>);
+
+    static_assert(sizeof(mystl::expected<int, int>) == 2 * sizeof(int));
+    static_assert(sizeof(mystl::expected<void, int>) == 2 * sizeof(int));
+    static_assert(sizeof(mystl::expected<void, errc>) == sizeof(errc));
+    static_assert(sizeof(mystl::expected<void, const char*>) == sizeof(const char*));
+    static_assert(sizeof(mystl::expected<void, char>) == 2);
+
+    TEST_CASE_PASS("layout and triviality");
+}
+
+int main() {
+    test_basics();
+    test_assignment();
+    test_monadic();
+    test_void();
+    test_layout();
+
+    std::cout << "All expected tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "flat_hash_map.h"
+#include "memory_resource.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct string_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+};
+
+struct string_eq {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// Every key collides on the hash, so probing crosses groups and relies on the key comparison.
+struct constant_hash {
+    size_t operator()(int) const { return 42; }
+};
+
+struct counted {
+    static int live;
+    static int built;
+    int value;
+
+    counted(int v) : value(v) {
+        ++live;
+        ++built;
+    }
+    counted(const counted& other) : value(other.value) { ++live; }
+    counted(counted&& other) noexcept : value(other.value) { ++live; }
+    ~counted() { --live; }
+    counted& operator=(const counted&) = default;
+    bool operator==(const counted&) const = default;
+};
+
+int counted::live = 0;
+int counted::built = 0;
+
+// Blocks outstanding per tagged_allocator id, shared by every rebound type.
+int tagged_live[2] = {0, 0};
+
+// Propagates on copy assignment and counts the blocks each id has outstanding, so freeing a block
+// with the wrong instance shows up as a mismatched count.
+template <typename T>
+struct tagged_allocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = mystl::true_type;
+
+    int id;
+
+    explicit tagged_allocator(int i) : id(i) {}
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t n) {
+        ++tagged_live[id];
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        --tagged_live[id];
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const tagged_allocator<U>& other) const {
+        return id == other.id;
+    }
+};
+
+void test_insert_find_erase() {
+    TEST_CASE("insert / find / erase");
+
+    mystl::flat_hash_map<int, int> m;
+    assert(m.empty() && m.begin() == m.end() && m.find(1) == m.end());
+    for (int i = 0; i < 10000; ++i) {
+        [[maybe_unused]] auto [it, inserted] = m.insert({i, i * 2});
+        assert(inserted && it->first == i && it->second == i * 2);
+    }
+    assert(m.size() == 10000);
+    [[maybe_unused]] const bool reinserted = m.insert({5, 0}).second;
+    assert(!reinserted && m.at(5) == 10);
+    for (int i = 0; i < 10000; ++i) {
+        assert(m.contains(i) && m.at(i) == i * 2);
+    }
+    assert(!m.contains(-1) && m.count(10000) == 0);
+
+    for (int i = 0; i < 10000; i += 2) {
+        [[maybe_unused]] const size_t erased = m.erase(i);
+        assert(erased == 1);
+    }
+    [[maybe_unused]] const size_t erased_again = m.erase(0);
+    assert(m.size() == 5000 && erased_again == 0);
+    for (int i = 0; i < 10000; ++i) {
+        assert(m.contains(i) == (i % 2 == 1));
+    }
+
+    size_t seen = 0;
+    long long sum = 0;
+    for (const auto& [k, v] : m) {
+        ++seen;
+        sum += v - 2 * k;
+    }
+    assert(seen == 5000 && sum == 0);
+
+    // Churn through erase and reinsert without growing: tombstones must be reclaimed.
+    [[maybe_unused]] const size_t cap = m.capacity();
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 10000; i += 2) {
+            m.emplace(i, round);
+        }
+        for (int i = 0; i < 10000; i += 2) {
+            m.erase(i);
+        }
+    }
+    assert(m.capacity() == cap && m.size() == 5000);
+
+    [[maybe_unused]] bool thrown = false;
+    try {
+        (void)m.at(0);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    TEST_CASE_PASS("insert / find / erase");
+}
+
+void test_map_api() {
+    TEST_CASE("map api");
+
+    mystl::flat_hash_map<std::string, std::string> m = {{"a", "1"}, {"b", "2"}};
+    assert(m.size() == 2 && m.at("a") == "1");
+
+    [[maybe_unused]] bool inserted = m.try_emplace("c", 3, 'x').second;
+    assert(inserted && m.at("c") == "xxx");
+    inserted = m.try_emplace("c", "no").second;
+    assert(!inserted && m.at("c") == "xxx");
+    inserted = m.insert_or_assign("a", "one").second;
+    assert(!inserted && m.at("a") == "one");
+    inserted = m.insert_or_assign("d", "4").second;
+    assert(inserted);
+    m["e"] += "five";
+    assert(m.at("e") == "five" && m.size() == 5);
+
+    auto it = m.find("b");
+    it = m.erase(it);
+    assert(!m.contains("b") && m.size() == 4);
+    [[maybe_unused]] const size_t removed =
+        mystl::erase_if(m, [](const auto& kv) { return kv.first < "d"; });
+    assert(removed == 2 && m.size() == 2);
+
+    mystl::flat_hash_map<std::string, std::string> copy = m;
+    assert(copy == m);
+    copy["z"] = "26";
+    assert(!(copy == m));
+    mystl::flat_hash_map<std::string, std::string> moved = mystl::move(copy);
+    assert(moved.size() == 3 && copy.empty());
+    moved.swap(m);
+    assert(m.size() == 3 && moved.size() == 2);
+    m = moved;
+    assert(m == moved);
+    m.clear();
+    assert(m.empty() && m.find("d") == m.end());
+
+    TEST_CASE_PASS("map api");
+}
+
+void test_heterogeneous_lookup() {
+    TEST_CASE("heterogeneous lookup");
+
+    mystl::flat_hash_map<std::string, int, string_hash, string_eq> m;
+    m["routing"] = 1;
+    m["table"] = 2;
+    [[maybe_unused]] std::string_view key = "routing";
+    assert(m.find(key) != m.end() && m.find(key)->second == 1);
+    assert(m.contains("table") && !m.contains(std::string_view("tab")));
+    [[maybe_unused]] const size_t erased = m.erase(std::string_view("table"));
+    assert(erased == 1 && m.size() == 1);
+
+    TEST_CASE_PASS("heterogeneous lookup");
+}
+
+void test_find_many() {
+    TEST_CASE("find_many");
+
+    mystl::flat_hash_map<uint64_t, uint64_t> m;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        m[i * 7] = i;
+    }
+    mystl::vector<uint64_t> keys;
+    for (uint64_t i = 0; i < 100; ++i) {
+        keys.push_back(i * 3);
+    }
+    mystl::vector<mystl::flat_hash_map<uint64_t, uint64_t>::iterator> found(keys.size());
+    [[maybe_unused]] auto out_end = m.find_many(keys.begin(), keys.end(), found.begin());
+    assert(out_end == found.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] % 7 == 0) {
+            assert(found[i] != m.end() && found[i]->second == keys[i] / 7);
+        } else {
+            assert(found[i] == m.end());
+        }
+    }
+
+    TEST_CASE_PASS("find_many");
+}
+
+void test_collisions_and_lifetimes() {
+    TEST_CASE("collisions / lifetimes");
+
+    mystl::flat_hash_set<int, constant_hash> s;
+    for (int i = 0; i < 100; ++i) {
+        [[maybe_unused]] const bool inserted = s.insert(i).second;
+        assert(inserted);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        s.erase(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        assert(s.contains(i) == (i % 3 != 0));
+    }
+
+    {
+        mystl::flat_hash_map<int, counted> m;
+        for (int i = 0; i < 1000; ++i) {
+            m.try_emplace(i, i);
+        }
+        assert(counted::live == 1000);
+        counted::built = 0;
+        m.emplace(5, 99);
+        assert(counted::live == 1000 && m.at(5).value == 5 && counted::built == 0);
+        m.emplace(mystl::pair<const int, counted>(6, 99));
+        assert(m.at(6).value == 6 && counted::built == 1);
+        m.erase(5);
+        assert(counted::live == 999);
+        m.rehash(0);
+        assert(counted::live == 999);
+    }
+    assert(counted::live == 0);
+
+    mystl::pmr::monotonic_buffer_resource arena;
+    using alloc_t = mystl::pmr::polymorphic_allocator<int>;
+    mystl::flat_hash_set<int, std::hash<int>, std::equal_to<int>, alloc_t> pmr_set{alloc_t(&arena)};
+    for (int i = 0; i < 500; ++i) {
+        pmr_set.insert(i);
+    }
+    assert(pmr_set.size() == 500 && pmr_set.get_allocator().resource() == &arena);
+
+    // Copy assignment that takes the other table's allocator frees the old slots with the old one.
+    {
+        using tagged_set = mystl::flat_hash_set<int, std::hash<int>, std::equal_to<int>,
+                                                tagged_allocator<int>>;
+        tagged_set a(tagged_allocator<int>(0));
+        tagged_set b(tagged_allocator<int>(1));
+        for (int i = 0; i < 20; ++i) {
+            a.insert(i);
+            b.insert(-i);
+        }
+        a = b;
+        assert(a.get_allocator().id == 1 && a.contains(-19) && !a.contains(19));
+        assert(tagged_live[0] == 0 && tagged_live[1] == 2);
+    }
+    assert(tagged_live[0] == 0 && tagged_live[1] == 0);
+
+    mystl::flat_hash_set<std::string> strings = {"x", "y", "x"};
+    assert(strings.size() == 2);
+    strings.reserve(1000);
+    assert(strings.capacity() >= 1000 && strings.contains("y"));
+
+    TEST_CASE_PASS("collisions / lifetimes");
+}
+
+// Arguments that refer into the map must survive the growth the insertion triggers.
+void test_aliasing() {
+    TEST_CASE("aliasing arguments");
+
+    const std::string payload(64, 'p');
+    mystl::flat_hash_map<int, std::string> m;
+    m.try_emplace(0, payload);
+    for (int i = 1; i < 200; ++i) {
+        m.try_emplace(i, m.at(0));
+        m.insert_or_assign(-i, m.at(i - 1));
+        m.emplace(1000 + i, m.at(0));
+    }
+    assert(m.size() == 3 * 199 + 1);
+    for ([[maybe_unused]] const auto& [key, value] : m) {
+        assert(value == payload);
+    }
+
+    // Each key is read from the mapped value of the previous entry.
+    auto name = [](int i) { return std::string(40, 'k') + std::to_string(i); };
+    mystl::flat_hash_map<std::string, std::string> links;
+    links[name(0)] = name(1);
+    for (int i = 1; i < 200; ++i) {
+        links[links.at(name(i - 1))] = name(i + 1);
+    }
+    assert(links.size() == 200 && links.at(name(199)) == name(200));
+
+    TEST_CASE_PASS("aliasing arguments");
+}
+
+int main() {
+    test_insert_find_erase();
+    test_map_api();
+    test_heterogeneous_lookup();
+    test_find_many();
+    test_collisions_and_lifetimes();
+    test_aliasing();
+
+    return 0;
+}
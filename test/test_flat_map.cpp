@@ -0,0 +1,181 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "flat_map.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_lookup() {
+    TEST_CASE("lookup");
+
+    mystl::flat_map<int, std::string> m = {{3, "c"}, {1, "a"}, {2, "b"}, {1, "dup"}};
+    assert(m.size() == 3);
+    assert(m.at(1) == "a" && m.at(2) == "b" && m.at(3) == "c");
+    assert(m.contains(2) && !m.contains(4) && m.count(3) == 1);
+    assert(m.find(4) == m.end());
+    assert(m.find(2)->second == "b");
+    assert(m.lower_bound(2) - m.begin() == 1);
+    assert(m.upper_bound(2) - m.begin() == 2);
+    assert(m.lower_bound(0) == m.begin() && m.upper_bound(9) == m.end());
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        (void)m.at(7);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    int expected = 1;
+    for (auto [k, v] : m) {
+        assert(k == expected);
+        ++expected;
+        v += "!";
+    }
+    assert(m.at(1) == "a!");
+
+    TEST_CASE_PASS("lookup");
+}
+
+void test_insert_erase() {
+    TEST_CASE("insert / erase");
+
+    mystl::flat_map<int, int> m;
+    for (int i = 9; i >= 0; --i) {
+        [[maybe_unused]] const bool inserted = m.try_emplace(i, i * 10).second;
+        assert(inserted);
+    }
+    [[maybe_unused]] bool inserted = m.try_emplace(5, -1).second;
+    assert(!inserted && m.at(5) == 50);
+    inserted = m.insert_or_assign(5, -1).second;
+    assert(!inserted && m.at(5) == -1);
+    m[42] = 7;
+    assert(m.size() == 11 && m.at(42) == 7);
+    assert(mystl::is_sorted(m.keys().begin(), m.keys().end()));
+
+    [[maybe_unused]] const size_t erased = m.erase(42);
+    [[maybe_unused]] const size_t erased_again = m.erase(42);
+    assert(erased == 1 && erased_again == 0);
+    [[maybe_unused]] auto it = m.erase(m.find(3));
+    assert(it->first == 4);
+    m.erase(m.begin(), m.begin() + 2);
+    assert(m.begin()->first == 2 && m.size() == 7);
+
+    [[maybe_unused]] const size_t removed =
+        mystl::erase_if(m, [](auto kv) { return kv.first % 2 == 0; });
+    assert(removed == 4);
+    assert(m.size() == 3 && m.at(5) == -1 && m.at(7) == 70 && m.at(9) == 90);
+
+    // A throwing predicate keeps what it has not removed yet instead of emptying the map.
+    mystl::flat_map<int, int> t = {{1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}};
+    [[maybe_unused]] bool threw = false;
+    try {
+        mystl::erase_if(t, [](auto kv) {
+            if (kv.first == 4) {
+                throw 4;
+            }
+            return kv.first == 2;
+        });
+    } catch (int) {
+        threw = true;
+    }
+    assert(threw && t.size() == 4 && t.keys().size() == t.values().size());
+    assert(t.at(1) == 1 && t.at(3) == 3 && t.at(4) == 4 && t.at(5) == 5 && !t.contains(2));
+
+    TEST_CASE_PASS("insert / erase");
+}
+
+void test_bulk_insert() {
+    TEST_CASE("bulk insert");
+
+    mystl::flat_map<int, int> m = {{10, 0}, {20, 0}, {30, 0}};
+    mystl::vector<mystl::pair<int, int>> batch;
+    for (int i = 40; i >= 0; --i) {
+        batch.push_back({i, 1});
+    }
+    batch.push_back({5, 2});
+    m.insert(batch.begin(), batch.end());
+    assert(m.size() == 41);
+    assert(mystl::is_sorted(m.keys().begin(), m.keys().end()));
+    // Existing entries win over the batch, and the first duplicate in the batch wins.
+    assert(m.at(10) == 0 && m.at(20) == 0 && m.at(30) == 0);
+    assert(m.at(5) == 1 && m.at(40) == 1);
+
+    mystl::flat_map<int, int> s;
+    s.insert(mystl::sorted_unique, {{1, 1}, {3, 3}});
+    s.insert(mystl::sorted_unique, {{0, 0}, {2, 2}, {3, 9}, {4, 4}});
+    assert(s.size() == 5 && s.at(3) == 3 && s.begin()->first == 0);
+
+    TEST_CASE_PASS("bulk insert");
+}
+
+void test_containers() {
+    TEST_CASE("extract / replace");
+
+    mystl::vector<int> keys = {3, 1, 2, 1};
+    mystl::vector<std::string> values = {"c", "a", "b", "x"};
+    mystl::flat_map<int, std::string> m(mystl::move(keys), mystl::move(values));
+    assert(m.size() == 3 && m.at(1) == "a");
+
+    [[maybe_unused]] const int* key_data = m.keys().data();
+    auto c = mystl::move(m).extract();
+    assert(m.empty() && c.keys.data() == key_data);
+    assert(c.keys.size() == 3 && c.values[2] == "c");
+
+    c.keys.push_back(4);
+    c.values.push_back("d");
+    m.replace(mystl::move(c.keys), mystl::move(c.values));
+    assert(m.size() == 4 && m.keys().data() == key_data && m.at(4) == "d");
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        mystl::flat_map<int, int> bad(mystl::vector<int>{1, 2}, mystl::vector<int>{1});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    mystl::flat_map<int, std::string> sorted(mystl::sorted_unique, {{1, "a"}, {2, "b"}});
+    assert(sorted.size() == 2);
+
+    TEST_CASE_PASS("extract / replace");
+}
+
+void test_transparent_and_compare() {
+    TEST_CASE("transparent lookup / comparison");
+
+    mystl::flat_map<std::string, int, std::less<>> m = {{"apple", 1}, {"pear", 2}};
+    std::string_view key = "pear";
+    assert(m.contains(key) && m.at(key) == 2 && m.find(std::string_view("fig")) == m.end());
+    [[maybe_unused]] const size_t erased = m.erase(key);
+    assert(erased == 1 && m.size() == 1);
+
+    mystl::flat_map<int, int> a = {{1, 1}, {2, 2}};
+    mystl::flat_map<int, int> b = {{1, 1}, {2, 3}};
+    assert(a != b && a < b);
+    b[2] = 2;
+    assert(a == b);
+    b[3] = 0;
+    assert(a < b);
+    swap(a, b);
+    assert(a.size() == 3 && b.size() == 2);
+
+    mystl::flat_map<int, int, std::greater<int>> desc = {{1, 1}, {3, 3}, {2, 2}};
+    assert(desc.begin()->first == 3 && desc.find(1) != desc.end());
+
+    TEST_CASE_PASS("transparent lookup / comparison");
+}
+
+int main() {
+    test_lookup();
+    test_insert_erase();
+    test_bulk_insert();
+    test_containers();
+    test_transparent_and_compare();
+
+    std::cout << "All flat_map tests passed!" << std::endl;
+    return 0;
+}
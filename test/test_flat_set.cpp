@@ -0,0 +1,79 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "flat_set.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_basic() {
+    TEST_CASE("basic");
+
+    mystl::flat_set<int> s = {5, 1, 4, 1, 3};
+    assert(s.size() == 4 && *s.begin() == 1 && *(s.end() - 1) == 5);
+    assert(s.contains(4) && !s.contains(2) && s.count(5) == 1);
+    [[maybe_unused]] const bool inserted = s.insert(2).second;
+    [[maybe_unused]] const bool inserted_again = s.insert(2).second;
+    assert(inserted && !inserted_again);
+    assert(s.size() == 5 && mystl::is_sorted(s.begin(), s.end()));
+    [[maybe_unused]] const size_t erased = s.erase(1);
+    [[maybe_unused]] const size_t erased_again = s.erase(1);
+    assert(erased == 1 && erased_again == 0);
+    assert(*s.lower_bound(3) == 3 && *s.upper_bound(3) == 4);
+    [[maybe_unused]] const size_t removed = mystl::erase_if(s, [](int x) { return x % 2 == 0; });
+    assert(removed == 2 && (s == mystl::flat_set<int>{3, 5}));
+
+    mystl::flat_set<int> t = {1, 2, 3, 4, 5};
+    [[maybe_unused]] bool threw = false;
+    try {
+        mystl::erase_if(t, [](int x) {
+            if (x == 4) {
+                throw x;
+            }
+            return x == 2;
+        });
+    } catch (int) {
+        threw = true;
+    }
+    assert(threw && (t == mystl::flat_set<int>{1, 3, 4, 5}));
+
+    TEST_CASE_PASS("basic");
+}
+
+void test_bulk_and_containers() {
+    TEST_CASE("bulk insert / extract");
+
+    mystl::flat_set<int> s = {100, 50};
+    mystl::vector<int> batch;
+    for (int i = 0; i < 200; ++i) {
+        batch.push_back((i * 37) % 101);
+    }
+    s.insert(batch.begin(), batch.end());
+    assert(s.size() == 101 && mystl::is_sorted(s.begin(), s.end()));
+
+    [[maybe_unused]] const int* data = s.begin();
+    mystl::vector<int> keys = mystl::move(s).extract();
+    assert(s.empty() && keys.data() == data && keys.size() == 101);
+    s.replace(mystl::move(keys));
+    assert(s.size() == 101 && s.begin() == data);
+
+    mystl::flat_set<int> sorted(mystl::sorted_unique, {1, 2, 3});
+    sorted.insert(mystl::sorted_unique, {0, 2, 4});
+    assert((sorted == mystl::flat_set<int>{0, 1, 2, 3, 4}));
+
+    mystl::flat_set<std::string, std::less<>> words(mystl::vector<std::string>{"b", "a", "b"});
+    assert(words.size() == 2 && words.contains(std::string_view("a")));
+    assert((words < mystl::flat_set<std::string, std::less<>>{"c"}));
+
+    TEST_CASE_PASS("bulk insert / extract");
+}
+
+int main() {
+    test_basic();
+    test_bulk_and_containers();
+
+    std::cout << "All flat_set tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,367 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "flat_hash_map.h"
+#include "functional.h"
+#include "utility.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct point {
+    int x;
+    int y;
+    std::string label;
+
+    bool operator==(const point&) const = default;
+
+    friend void hash_append(mystl::hash_state& h, const point& p) { hash_append(h, p.x, p.y, p.label); }
+};
+
+struct packed_id {
+    using uniquely_represented = mystl::true_type;
+
+    uint32_t shard;
+    uint32_t local;
+};
+
+static_assert(mystl::is_uniquely_represented_v<int>);
+static_assert(mystl::is_uniquely_represented_v<int*>);
+static_assert(mystl::is_uniquely_represented_v<packed_id>);
+static_assert(mystl::is_uniquely_represented_v<mystl::pair<int, int>>);
+static_assert(!mystl::is_uniquely_represented_v<mystl::pair<char, int>>);
+static_assert(!mystl::is_uniquely_represented_v<double>);
+static_assert(!mystl::is_uniquely_represented_v<point>);
+
+void test_invoke() {
+    TEST_CASE("invoke");
+
+    struct S {
+        int v;
+        int twice() const { return v * 2; }
+    };
+    [[maybe_unused]] S s{21};
+    assert(mystl::invoke(&S::twice, s) == 42);
+    assert(mystl::invoke(&S::v, &s) == 21);
+    assert(mystl::invoke([](int a, int b) { return a + b; }, 1, 2) == 3);
+
+    struct N {
+        int get() const noexcept { return 1; }
+        int may_throw() const { return 2; }
+    };
+    static_assert(noexcept(mystl::invoke(&N::get, N{})));
+    static_assert(!noexcept(mystl::invoke(&N::may_throw, N{})));
+    static_assert(noexcept(mystl::invoke([]() noexcept {})));
+
+    TEST_CASE_PASS("invoke");
+}
+
+void test_byte_hash() {
+    TEST_CASE("byte hash");
+
+    // Every length up to 128 bytes, covering the short, 16-byte and 48-byte paths; a change of
+    // one byte anywhere must change the hash.
+    unsigned char buf[128];
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+    for (size_t len = 1; len <= sizeof(buf); ++len) {
+        [[maybe_unused]] const uint64_t h = mystl::detail::hash_bytes(buf, len, 1);
+        assert(h == mystl::detail::hash_bytes(buf, len, 1));
+        assert(h != mystl::detail::hash_bytes(buf, len, 2));
+        assert(h != mystl::detail::hash_bytes(buf, len - 1, 1));
+        for (size_t pos = 0; pos < len; pos += 7) {
+            buf[pos] ^= 1;
+            assert(h != mystl::detail::hash_bytes(buf, len, 1));
+            buf[pos] ^= 1;
+        }
+    }
+
+    TEST_CASE_PASS("byte hash");
+}
+
+void test_hash_values() {
+    TEST_CASE("hash values");
+
+    mystl::hash<int> int_hash;
+    // Sequential integers must not map to sequential hashes.
+    assert(int_hash(1) != 1 && int_hash(1) != int_hash(2));
+    size_t low_bits_seen = 0;
+    for (int i = 0; i < 128; ++i) {
+        low_bits_seen |= size_t(1) << (int_hash(i) & 63);
+    }
+    assert(__builtin_popcountll(low_bits_seen) > 48);
+
+    [[maybe_unused]] mystl::hash<double> double_hash;
+    assert(double_hash(0.0) == double_hash(-0.0));
+    assert(double_hash(1.0) != double_hash(2.0));
+
+    [[maybe_unused]] mystl::hash<std::string> string_hash;
+    const std::string s = "routing table";
+    assert(string_hash(s) == string_hash(std::string_view("routing table")));
+    assert(string_hash(s) == string_hash("routing table"));
+    assert(string_hash(s) != string_hash("routing tablE"));
+
+    [[maybe_unused]] mystl::hash<point> point_hash;
+    assert(point_hash({1, 2, "a"}) == point_hash({1, 2, "a"}));
+    assert(point_hash({1, 2, "a"}) != point_hash({2, 1, "a"}));
+
+    [[maybe_unused]] mystl::hash<packed_id> id_hash;
+    assert(id_hash({1, 2}) != id_hash({2, 1}));
+
+    [[maybe_unused]] mystl::hash<mystl::pair<std::string, int>> pair_hash;
+    assert(pair_hash({"a", 1}) != pair_hash({"a", 2}));
+
+    [[maybe_unused]] mystl::hash<mystl::vector<int>> vector_hash;
+    assert(vector_hash({1, 2, 3}) == vector_hash({1, 2, 3}));
+    assert(vector_hash({1, 2, 3}) != vector_hash({1, 2}));
+
+    [[maybe_unused]] mystl::hash<mystl::vector<std::string>> nested_hash;
+    assert(nested_hash({"ab", "c"}) != nested_hash({"a", "bc"}));
+
+    size_t seed = 0;
+    mystl::hash_combine(seed, 1);
+    mystl::hash_combine(seed, std::string("x"));
+    size_t other = 0;
+    mystl::hash_combine(other, std::string("x"));
+    mystl::hash_combine(other, 1);
+    assert(seed != other && seed != 0);
+
+    TEST_CASE_PASS("hash values");
+}
+
+void test_hash_in_table() {
+    TEST_CASE("hash in table");
+
+    mystl::flat_hash_map<std::string, int, mystl::hash<std::string>, std::equal_to<>> m;
+    m["alpha"] = 1;
+    assert(m.find(std::string_view("alpha")) != m.end());
+    assert(m.contains("alpha"));
+
+    mystl::flat_hash_map<point, int> points;
+    points[{1, 2, "p"}] = 3;
+    assert(points.at({1, 2, "p"}) == 3);
+
+    TEST_CASE_PASS("hash in table");
+}
+
+int add_one(int x) { return x + 1; }
+
+// Counts live instances, and can make copies throw.
+struct tracked {
+    static inline int live = 0;
+    int value;
+    explicit tracked(int v) : value(v) { ++live; }
+    tracked(const tracked& o) : value(o.value) { ++live; }
+    tracked(tracked&& o) noexcept : value(o.value) { ++live; }
+    ~tracked() { --live; }
+    int operator()(int x) const { return value + x; }
+};
+
+// Its move may throw, but it opts in to being moved as bytes, so it still fits inline.
+struct relocatable_callable {
+    using trivially_relocatable = mystl::true_type;
+    void* p[2];
+    std::string* s;
+    relocatable_callable(const relocatable_callable&) = default;
+    relocatable_callable(relocatable_callable&& o) noexcept(false) : p{o.p[0], o.p[1]}, s(o.s) {}
+    explicit relocatable_callable(std::string* str) : p{}, s(str) {}
+    size_t operator()() const { return s->size(); }
+};
+
+static_assert(sizeof(mystl::function<void()>) == 4 * sizeof(void*));
+static_assert(sizeof(mystl::move_only_function<void(), 64>) == 64 + sizeof(void*));
+static_assert(mystl::detail::function_stores_inline<relocatable_callable, 24>);
+static_assert(!mystl::is_copy_constructible_v<mystl::move_only_function<void()>>);
+static_assert(mystl::is_copy_constructible_v<mystl::function<void()>>);
+static_assert(mystl::is_nothrow_move_constructible_v<mystl::function<void()>>);
+
+void test_function() {
+    TEST_CASE("function");
+
+    mystl::function<int(int)> f;
+    assert(!f && f == nullptr);
+    [[maybe_unused]] bool threw = false;
+    try {
+        f(1);
+    } catch (const std::bad_function_call&) {
+        threw = true;
+    }
+    assert(threw);
+
+    f = add_one;
+    assert(f && f(1) == 2);
+    int (*null_fn)(int) = nullptr;
+    f = null_fn;
+    assert(!f);
+
+    // Three captured pointers stay inline; std::function would allocate.
+    int a = 1, b = 2, c = 3;
+    f = [pa = &a, pb = &b, pc = &c](int x) { return *pa + *pb + *pc + x; };
+    assert(f(4) == 10);
+    const mystl::function<int(int)> copy = f;
+    c = 30;
+    assert(copy(4) == 37 && f(0) == 33);
+
+    struct S {
+        int v;
+        int get() const { return v; }
+    };
+    mystl::function<int(const S&)> member = &S::get;
+    assert(member(S{7}) == 7);
+    mystl::function<long(int)> converting = add_one;
+    assert(converting(41) == 42L);
+
+    {
+        mystl::function<int(int)> big = [t = tracked(10), pad = std::string(64, 'x')](int x) {
+            return t(x) + static_cast<int>(pad.size());
+        };
+        assert(tracked::live == 1 && big(1) == 75);
+        mystl::function<int(int)> big_copy = big;
+        assert(tracked::live == 2 && big_copy(0) == 74);
+        mystl::function<int(int)> moved = mystl::move(big);
+        assert(!big && tracked::live == 2 && moved(0) == 74);
+        swap(moved, f);
+        assert(moved(0) == 33 && f(0) == 74);
+        f = nullptr;
+        assert(tracked::live == 1);
+        mystl::function<int(int)> inline_tracked = tracked(5);
+        assert(tracked::live == 2 && inline_tracked(1) == 6);
+    }
+    assert(tracked::live == 0);
+
+    std::string s = "abc";
+    mystl::function<size_t()> rel = relocatable_callable(&s);
+    mystl::function<size_t()> rel2 = mystl::move(rel);
+    assert(rel2() == 3);
+
+    TEST_CASE_PASS("function");
+}
+
+void test_move_only_function() {
+    TEST_CASE("move_only_function");
+
+    struct move_only {
+        int v;
+        move_only(int x) : v(x) {}
+        move_only(move_only&&) noexcept = default;
+        move_only(const move_only&) = delete;
+        int operator()() { return ++v; }
+    };
+    mystl::move_only_function<int()> counter = move_only(0);
+    assert(counter() == 1 && counter() == 2);
+    mystl::move_only_function<int()> other = mystl::move(counter);
+    assert(!counter && other() == 3);
+
+    mystl::move_only_function<int(int) const noexcept> pure = [](int x) noexcept { return x * 2; };
+    static_assert(noexcept(pure(1)));
+    [[maybe_unused]] const auto& cref = pure;
+    assert(cref(21) == 42);
+
+    // A copyable function nests inside a move-only one.
+    mystl::function<int(int)> f = add_one;
+    mystl::move_only_function<int(int)> g = f;
+    assert(g(1) == 2);
+    mystl::move_only_function<int(int)> empty = mystl::function<int(int)>();
+    assert(!empty);
+
+    // The buffer size is a parameter: 64 bytes hold this inline, 8 bytes do not.
+    struct wide {
+        long v[8];
+        long operator()() const { return v[7]; }
+    };
+    mystl::move_only_function<long(), 64> wide_inline = wide{{0, 0, 0, 0, 0, 0, 0, 9}};
+    mystl::move_only_function<long(), 8> wide_heap = wide{{0, 0, 0, 0, 0, 0, 0, 8}};
+    assert(wide_inline() == 9 && wide_heap() == 8);
+
+    {
+        mystl::move_only_function<int(int)> t = tracked(1);
+        mystl::move_only_function<int(int)> u;
+        u = mystl::move(t);
+        assert(tracked::live == 1 && u(1) == 2);
+    }
+    assert(tracked::live == 0);
+
+    TEST_CASE_PASS("move_only_function");
+}
+
+int apply_ref(mystl::function_ref<int(int)> f, int x) { return f(x); }
+
+void test_function_ref() {
+    TEST_CASE("function_ref");
+
+    static_assert(sizeof(mystl::function_ref<int(int)>) == 2 * sizeof(void*));
+    static_assert(mystl::is_trivially_copyable_v<mystl::function_ref<int(int)>>);
+
+    assert(apply_ref(add_one, 1) == 2);
+    assert(apply_ref(&add_one, 2) == 3);
+    [[maybe_unused]] int base = 10;
+    assert(apply_ref([&base](int x) { return base + x; }, 5) == 15);
+
+    // The target is referenced, not copied.
+    int calls = 0;
+    auto counter = [&calls](int x) mutable { return ++calls + x; };
+    mystl::function_ref<int(int)> r = counter;
+    r(0);
+    r(0);
+    assert(calls == 2);
+    [[maybe_unused]] mystl::function_ref<int(int)> r2 = r;
+    r = add_one;
+    assert(r(1) == 2 && r2(0) == 3);
+
+    struct S {
+        int v;
+        int get() const noexcept { return v; }
+        int operator()() { return -1; }
+        int operator()() const { return 1; }
+    };
+    // A member pointer prvalue like &S::get would be referenced after it dies, so member pointers
+    // are bound through nontype instead.
+    static_assert(!mystl::is_constructible_v<mystl::function_ref<int(const S&)>, decltype(&S::get)>);
+    static_assert(!mystl::is_constructible_v<mystl::function_ref<int(S*)>, int S::*&>);
+    mystl::function_ref<int(const S&) noexcept> member_fn = mystl::nontype<&S::get>;
+    mystl::function_ref<int&(S*)> member_obj = mystl::nontype<&S::v>;
+    static_assert(sizeof(member_fn) == 2 * sizeof(void*));
+    S target{5};
+    member_obj(&target) = 6;
+    assert(member_fn(target) == 6 && member_obj(&target) == 6);
+    mystl::function_ref<int()> bound_fn(mystl::nontype<&S::get>, target);
+    mystl::function_ref<int() const> bound_obj(mystl::nontype<&S::v>, target);
+    target.v = 7;
+    assert(bound_fn() == 7 && bound_obj() == 7);
+    member_obj = mystl::nontype<&S::v>;
+    static_assert(!mystl::is_constructible_v<mystl::function_ref<int()>,
+                                             mystl::nontype_t<&S::get>, S&&>);
+    auto get = [](const S& x) noexcept { return x.get(); };
+    mystl::function_ref<int(const S&) noexcept> by_member = get;
+    static_assert(noexcept(by_member(S{})));
+    assert(by_member(S{4}) == 4);
+    S s{9};
+
+    // const signatures call the target as const.
+    [[maybe_unused]] mystl::function_ref<int() const> as_const = s;
+    [[maybe_unused]] mystl::function_ref<int()> as_mutable = s;
+    assert(as_const() == 1 && as_mutable() == -1);
+
+    mystl::function<int(int)> owning = add_one;
+    assert(apply_ref(owning, 0) == 1);
+    static_assert(!mystl::is_constructible_v<mystl::function_ref<int(int) noexcept>, int (*)(int)>);
+
+    TEST_CASE_PASS("function_ref");
+}
+
+int main() {
+    test_invoke();
+    test_byte_hash();
+    test_hash_values();
+    test_hash_in_table();
+    test_function();
+    test_move_only_function();
+    test_function_ref();
+
+    return 0;
+}
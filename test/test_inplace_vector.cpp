@@ -0,0 +1,130 @@
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <new>
+#include <string>
+
+#include "inplace_vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+static_assert(sizeof(mystl::inplace_vector<char, 15>) == 16);
+static_assert(mystl::is_trivially_copyable_v<mystl::inplace_vector<int, 4>>);
+static_assert(mystl::is_trivially_destructible_v<mystl::inplace_vector<int, 4>>);
+static_assert(!mystl::is_trivially_copyable_v<mystl::inplace_vector<std::string, 4>>);
+
+void test_basic() {
+    TEST_CASE("basic");
+
+    mystl::inplace_vector<int, 8> v;
+    assert(v.empty() && v.capacity() == 8);
+    for (int i = 0; i < 8; ++i) {
+        v.push_back(i);
+    }
+    assert(v.size() == 8 && v.back() == 7);
+
+    [[maybe_unused]] bool thrown = false;
+    try {
+        v.push_back(8);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown && v.size() == 8);
+    [[maybe_unused]] const int* pushed = v.try_push_back(8);
+    assert(pushed == nullptr);
+
+    v.pop_back();
+    [[maybe_unused]] int* p = v.try_emplace_back(70);
+    assert(p == &v.back() && *p == 70);
+
+    mystl::inplace_vector<int, 8> copy = v;
+    assert(copy == v);
+    copy[0] = -1;
+    assert(copy < v);
+
+    mystl::inplace_vector<int, 4> list = {1, 2, 3};
+    assert(list.size() == 3 && list.at(2) == 3);
+    list.resize(4);
+    assert(list[3] == 0);
+    list.resize(1);
+    assert(list.size() == 1);
+
+    thrown = false;
+    try {
+        mystl::inplace_vector<int, 2> too_big = {1, 2, 3};
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    TEST_CASE_PASS("basic");
+}
+
+void test_insert_erase() {
+    TEST_CASE("insert / erase");
+
+    mystl::inplace_vector<std::string, 16> v = {"a", "b", "c"};
+    v.insert(v.begin() + 1, "x");
+    assert((v == mystl::inplace_vector<std::string, 16>{"a", "x", "b", "c"}));
+    v.insert(v.begin(), 2, v[3]);
+    assert(v[0] == "c" && v[1] == "c" && v[2] == "a");
+    std::list<std::string> more = {"m", "n"};
+    v.insert(v.end(), more.begin(), more.end());
+    assert(v.back() == "n" && v.size() == 8);
+    v.emplace(v.begin(), v.back());
+    assert(v.front() == "n");
+    v.erase(v.begin(), v.begin() + 3);
+    assert(v.front() == "a" && v.size() == 6);
+    [[maybe_unused]] const size_t erased = mystl::erase(v, "m");
+    assert(erased == 1 && v.size() == 5);
+
+    mystl::inplace_vector<int, 16> ints = {1, 2, 3, 4};
+    ints.insert(ints.begin() + 2, {9, 9});
+    assert((ints == mystl::inplace_vector<int, 16>{1, 2, 9, 9, 3, 4}));
+    ints.erase(ints.begin());
+    assert(ints.front() == 2 && ints.size() == 5);
+
+    [[maybe_unused]] bool thrown = false;
+    try {
+        ints.insert(ints.begin(), 20, 0);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown && ints.size() == 5);
+
+    TEST_CASE_PASS("insert / erase");
+}
+
+void test_move_and_swap() {
+    TEST_CASE("move / swap");
+
+    mystl::inplace_vector<std::string, 4> a = {"one", "two"};
+    mystl::inplace_vector<std::string, 4> b = {"three"};
+    a.swap(b);
+    assert(a.size() == 1 && a[0] == "three" && b.size() == 2 && b[1] == "two");
+
+    mystl::inplace_vector<std::string, 4> c = mystl::move(b);
+    assert(c.size() == 2 && c[0] == "one");
+    a = c;
+    assert(a == c);
+    a = {"z"};
+    assert(a.size() == 1 && a[0] == "z");
+    c = mystl::move(a);
+    assert(c.size() == 1 && c[0] == "z");
+
+    mystl::inplace_vector<int, 4> x = {1, 2, 3};
+    mystl::inplace_vector<int, 4> y = {4};
+    mystl::swap(x, y);
+    assert(x.size() == 1 && y.size() == 3 && y[2] == 3);
+
+    TEST_CASE_PASS("move / swap");
+}
+
+int main() {
+    test_basic();
+    test_insert_erase();
+    test_move_and_swap();
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "intrusive.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct Counted : mystl::intrusive_ref_counter<Counted> {
+    static inline int destroyed = 0;
+
+    explicit Counted(int v) : value(v) {}
+    virtual ~Counted() { ++destroyed; }
+
+    int value;
+};
+
+struct MoreCounted : Counted {
+    MoreCounted() : Counted(2) {}
+};
+
+struct by_lru {};
+struct by_name {};
+
+// Lives in an LRU list, a by-id index and a by-name index at once.
+struct Session : mystl::list_hook<by_lru>, mystl::hash_hook<>, mystl::hash_hook<by_name> {
+    Session(int i, std::string n) : id(i), name(mystl::move(n)) {}
+
+    int id;
+    std::string name;
+};
+
+struct session_id {
+    int operator()(const Session& s) const { return s.id; }
+};
+
+struct session_name {
+    const std::string& operator()(const Session& s) const { return s.name; }
+};
+
+using lru_list = mystl::intrusive_list<Session, by_lru>;
+using id_index = mystl::intrusive_hash_set<Session, session_id>;
+using name_index = mystl::intrusive_hash_set<Session, session_name, mystl::hash<std::string>,
+                                             std::equal_to<std::string>, by_name>;
+
+void test_intrusive_ptr() {
+    TEST_CASE("intrusive_ptr");
+
+    static_assert(sizeof(mystl::intrusive_ptr<Counted>) == sizeof(Counted*));
+
+    Counted::destroyed = 0;
+    {
+        auto p = mystl::make_intrusive<Counted>(1);
+        assert(p->use_count() == 1 && (*p).value == 1);
+
+        mystl::intrusive_ptr<Counted> q = p;
+        assert(p->use_count() == 2 && q == p);
+
+        // A raw pointer can be turned back into an owner at any time.
+        mystl::intrusive_ptr<Counted> r(q.get());
+        assert(p->use_count() == 3);
+
+        Counted* raw = r.detach();
+        assert(!r && p->use_count() == 3);
+        r.reset(raw, false);
+        assert(p->use_count() == 3);
+
+        q.reset();
+        r = nullptr;
+        assert(p->use_count() == 1 && Counted::destroyed == 0);
+    }
+    assert(Counted::destroyed == 1);
+
+    mystl::intrusive_ptr<Counted> base = mystl::make_intrusive<MoreCounted>();
+    auto derived = mystl::dynamic_pointer_cast<MoreCounted>(base);
+    assert(derived && derived->value == 2 && base->use_count() == 2);
+    base.reset();
+    derived.reset();
+    assert(Counted::destroyed == 2);
+
+    TEST_CASE_PASS("intrusive_ptr");
+}
+
+void test_intrusive_list() {
+    TEST_CASE("intrusive_list");
+
+    Session a(1, "a"), b(2, "b"), c(3, "c");
+    lru_list lru;
+    assert(lru.empty() && !a.mystl::list_hook<by_lru>::is_linked());
+
+    lru.push_back(a);
+    lru.push_back(b);
+    lru.push_front(c);
+    assert(lru.size() == 3 && lru.front().id == 3 && lru.back().id == 2);
+
+    // Touching an element moves it to the front in O(1).
+    lru.move_before(lru.begin(), b);
+    [[maybe_unused]] int order[3];
+    int i = 0;
+    for (const Session& s : lru) {
+        order[i++] = s.id;
+    }
+    assert(order[0] == 2 && order[1] == 3 && order[2] == 1);
+
+    lru.erase(c);
+    assert(lru.size() == 2 && !c.mystl::list_hook<by_lru>::is_linked());
+    [[maybe_unused]] auto it = lru.erase(lru.iterator_to(b));
+    assert(&*it == &a && lru.size() == 1);
+
+    lru_list other;
+    other.push_back(b);
+    other.push_back(c);
+    lru.splice(lru.begin(), other);
+    assert(other.empty() && lru.size() == 3 && lru.front().id == 2 && lru.back().id == 1);
+
+    lru_list moved(mystl::move(lru));
+    assert(lru.empty() && moved.size() == 3 && (--moved.end())->id == 1);
+
+    moved.pop_front();
+    moved.pop_back();
+    assert(moved.size() == 1 && moved.front().id == 3);
+    moved.clear();
+    assert(moved.empty() && !c.mystl::list_hook<by_lru>::is_linked());
+
+    TEST_CASE_PASS("intrusive_list");
+}
+
+void test_intrusive_hash_set() {
+    TEST_CASE("intrusive_hash_set");
+
+    constexpr int count = 100;
+    Session* sessions[count];
+    for (int i = 0; i < count; ++i) {
+        sessions[i] = new Session(i, std::string("s").append(std::to_string(i)));
+    }
+
+    id_index ids;
+    name_index names(count);
+    [[maybe_unused]] const size_t name_buckets = names.bucket_count();
+    for (Session* s : sessions) {
+        [[maybe_unused]] const bool id_inserted = ids.insert(*s).second;
+        [[maybe_unused]] const bool name_inserted = names.insert(*s).second;
+        assert(id_inserted && name_inserted);
+    }
+    assert(ids.size() == count && names.size() == count);
+    assert(ids.bucket_count() >= count && names.bucket_count() == name_buckets);
+
+    Session dup(7, "s7");
+    [[maybe_unused]] auto [pos, inserted] = ids.insert(dup);
+    assert(!inserted && &*pos == sessions[7]);
+    assert(!dup.mystl::hash_hook<>::is_linked());
+
+    assert(ids.find(42)->name == "s42" && names.find("s42")->id == 42);
+    assert(!ids.contains(count) && !names.contains("x"));
+
+    int seen = 0;
+    for (const Session& s : ids) {
+        seen += s.id;
+    }
+    assert(seen == count * (count - 1) / 2);
+
+    // Erasing through the element unlinks it from one index without disturbing the other.
+    ids.erase(*sessions[5]);
+    assert(!ids.contains(5) && names.contains("s5") && ids.size() == count - 1);
+    [[maybe_unused]] const size_t erased = ids.erase(6);
+    [[maybe_unused]] const size_t erased_again = ids.erase(6);
+    assert(erased == 1 && erased_again == 0);
+    [[maybe_unused]] auto next = names.erase(names.iterator_to(*sessions[9]));
+    assert(names.size() == count - 1 && (next == names.end() || next->id != 9));
+
+    ids.rehash(512);
+    assert(ids.bucket_count() == 512 && ids.find(50)->id == 50 && ids.size() == count - 2);
+
+    id_index moved(mystl::move(ids));
+    assert(ids.empty() && moved.find(99)->id == 99);
+
+    moved.clear();
+    names.clear();
+    for (Session* s : sessions) {
+        assert(!s->mystl::hash_hook<>::is_linked() && !s->mystl::hash_hook<by_name>::is_linked());
+        delete s;
+    }
+
+    TEST_CASE_PASS("intrusive_hash_set");
+}
+
+int main() {
+    test_intrusive_ptr();
+    test_intrusive_list();
+    test_intrusive_hash_set();
+
+    std::cout << "All intrusive tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,530 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "memory.h"
+#include "type_traits.h"
+#include "utility.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+// Owns a heap int; moving it around is only safe through relocation or its move constructor.
+struct Handle {
+    using trivially_relocatable = mystl::true_type;
+
+    static int destroyed;
+    int* ptr;
+
+    explicit Handle(int v) : ptr(new int(v)) {}
+    Handle(Handle&& other) noexcept : ptr(mystl::exchange(other.ptr, nullptr)) {}
+    ~Handle() {
+        ++destroyed;
+        delete ptr;
+    }
+};
+
+int Handle::destroyed = 0;
+
+// Set to make the next ::operator new throw, for exercising allocation failure paths. Every
+// allocation and deallocation function is replaced, all out of line, so that each new pairs
+// with the matching delete and GCC does not see the malloc/free inside them.
+static bool fail_next_new = false;
+
+static void* test_allocate(size_t n, size_t align) {
+    if (fail_next_new) {
+        fail_next_new = false;
+        throw std::bad_alloc();
+    }
+    if (n == 0) {
+        n = 1;
+    }
+    void* p = align <= alignof(std::max_align_t)
+                  ? std::malloc(n)
+                  : std::aligned_alloc(align, (n + align - 1) / align * align);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+[[gnu::noinline]] void* operator new(size_t n) { return test_allocate(n, 0); }
+[[gnu::noinline]] void* operator new[](size_t n) { return test_allocate(n, 0); }
+[[gnu::noinline]] void* operator new(size_t n, std::align_val_t a) {
+    return test_allocate(n, static_cast<size_t>(a));
+}
+[[gnu::noinline]] void* operator new[](size_t n, std::align_val_t a) {
+    return test_allocate(n, static_cast<size_t>(a));
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+struct Tracked {
+    static int moves;
+    static int destroyed;
+    std::string val;
+
+    explicit Tracked(std::string v) : val(mystl::move(v)) {}
+    Tracked(Tracked&& other) noexcept : val(mystl::move(other.val)) { ++moves; }
+    ~Tracked() { ++destroyed; }
+};
+
+int Tracked::moves = 0;
+int Tracked::destroyed = 0;
+
+template <typename T>
+struct RawBuffer {
+    alignas(T) unsigned char bytes[sizeof(T) * 8];
+    T* data() { return reinterpret_cast<T*>(bytes); }
+};
+
+void test_trivially_relocatable_trait() {
+    TEST_CASE("is_trivially_relocatable");
+
+    static_assert(mystl::is_trivially_relocatable_v<int>);
+    static_assert(mystl::is_trivially_relocatable_v<int*>);
+    static_assert(mystl::is_trivially_relocatable_v<int[4]>);
+    static_assert(mystl::is_trivially_relocatable_v<Handle>);
+    static_assert(!mystl::is_trivially_relocatable_v<Tracked>);
+    static_assert(mystl::is_trivially_relocatable_v<mystl::pair<Handle, int>>);
+    static_assert(!mystl::is_trivially_relocatable_v<mystl::pair<Handle, Tracked>>);
+
+    TEST_CASE_PASS("is_trivially_relocatable");
+}
+
+void test_relocate_at() {
+    TEST_CASE("relocate_at");
+
+    RawBuffer<Handle> src;
+    RawBuffer<Handle> dst;
+    Handle* h = mystl::construct_at(src.data(), 17);
+    Handle::destroyed = 0;
+    Handle* moved = mystl::relocate_at(h, dst.data());
+    assert(*moved->ptr == 17);
+    assert(Handle::destroyed == 0);
+    mystl::destroy_at(moved);
+    assert(Handle::destroyed == 1);
+
+    RawBuffer<Tracked> tsrc;
+    RawBuffer<Tracked> tdst;
+    Tracked* t = mystl::construct_at(tsrc.data(), "payload");
+    Tracked::moves = Tracked::destroyed = 0;
+    Tracked* tmoved = mystl::relocate_at(t, tdst.data());
+    assert(tmoved->val == "payload");
+    assert(Tracked::moves == 1 && Tracked::destroyed == 1);
+    mystl::destroy_at(tmoved);
+
+    TEST_CASE_PASS("relocate_at");
+}
+
+void test_uninitialized_relocate() {
+    TEST_CASE("uninitialized_relocate");
+
+    RawBuffer<mystl::pair<Handle, int>> src;
+    RawBuffer<mystl::pair<Handle, int>> dst;
+    for (int i = 0; i < 5; ++i) {
+        mystl::construct_at(src.data() + i, Handle(i * 10), i);
+    }
+    Handle::destroyed = 0;
+    auto* end = mystl::uninitialized_relocate(src.data(), src.data() + 5, dst.data());
+    assert(end == dst.data() + 5);
+    assert(Handle::destroyed == 0);
+    for (int i = 0; i < 5; ++i) {
+        assert(*dst.data()[i].first.ptr == i * 10 && dst.data()[i].second == i);
+    }
+    mystl::destroy(dst.data(), end);
+
+    RawBuffer<Tracked> tsrc;
+    RawBuffer<Tracked> tdst;
+    for (int i = 0; i < 3; ++i) {
+        mystl::construct_at(tsrc.data() + i, std::string(20, static_cast<char>('a' + i)));
+    }
+    Tracked::moves = Tracked::destroyed = 0;
+    Tracked* tend = mystl::uninitialized_relocate_n(tsrc.data(), 3, tdst.data());
+    assert(tend == tdst.data() + 3);
+    assert(Tracked::moves == 3 && Tracked::destroyed == 3);
+    assert(tdst.data()[2].val == std::string(20, 'c'));
+    mystl::destroy(tdst.data(), tend);
+
+    TEST_CASE_PASS("uninitialized_relocate");
+}
+
+template <typename T>
+struct MinimalAllocator {
+    using value_type = T;
+
+    int id = 0;
+
+    MinimalAllocator() = default;
+    explicit MinimalAllocator(int i) : id(i) {}
+    template <typename U>
+    MinimalAllocator(const MinimalAllocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    void deallocate(T* p, size_t) { ::operator delete(p); }
+};
+
+struct alignas(64) OverAligned {
+    char data[64];
+};
+
+void test_pointer_traits() {
+    TEST_CASE("pointer_traits");
+
+    using traits = mystl::pointer_traits<int*>;
+    static_assert(mystl::is_same_v<traits::element_type, int>);
+    static_assert(mystl::is_same_v<traits::difference_type, std::ptrdiff_t>);
+    static_assert(mystl::is_same_v<traits::rebind<double>, double*>);
+
+    using fancy = mystl::pointer_traits<MinimalAllocator<int>>;
+    static_assert(mystl::is_same_v<fancy::element_type, int>);
+    static_assert(mystl::is_same_v<fancy::difference_type, std::ptrdiff_t>);
+
+    [[maybe_unused]] int x = 3;
+    assert(traits::pointer_to(x) == &x);
+
+    TEST_CASE_PASS("pointer_traits");
+}
+
+void test_allocator_traits_defaults() {
+    TEST_CASE("allocator_traits defaults");
+
+    using traits = mystl::allocator_traits<MinimalAllocator<int>>;
+    static_assert(mystl::is_same_v<traits::pointer, int*>);
+    static_assert(mystl::is_same_v<traits::const_pointer, const int*>);
+    static_assert(mystl::is_same_v<traits::void_pointer, void*>);
+    static_assert(mystl::is_same_v<traits::const_void_pointer, const void*>);
+    static_assert(mystl::is_same_v<traits::difference_type, std::ptrdiff_t>);
+    static_assert(mystl::is_same_v<traits::size_type, size_t>);
+    static_assert(!traits::propagate_on_container_copy_assignment::value);
+    static_assert(!traits::is_always_equal::value);
+    static_assert(mystl::is_same_v<traits::rebind_alloc<double>, MinimalAllocator<double>>);
+
+    MinimalAllocator<int> alloc(7);
+    auto [p, count] = traits::allocate_at_least(alloc, 4);
+    assert(count == 4);
+    traits::construct(alloc, p, 11);
+    assert(*p == 11);
+    traits::destroy(alloc, p);
+    traits::deallocate(alloc, p, count);
+
+    assert(traits::max_size(alloc) == std::numeric_limits<size_t>::max() / sizeof(int));
+    assert(traits::select_on_container_copy_construction(alloc).id == 7);
+
+    TEST_CASE_PASS("allocator_traits defaults");
+}
+
+void test_allocator() {
+    TEST_CASE("allocator");
+
+    using traits = mystl::allocator_traits<mystl::allocator<std::string>>;
+    static_assert(traits::propagate_on_container_move_assignment::value);
+    static_assert(traits::is_always_equal::value);
+    static_assert(mystl::is_same_v<traits::rebind_alloc<int>, mystl::allocator<int>>);
+
+    mystl::allocator<std::string> alloc;
+    std::string* p = traits::allocate(alloc, 3);
+    for (int i = 0; i < 3; ++i) {
+        traits::construct(alloc, p + i, std::string("s").append(std::to_string(i)));
+    }
+    assert(p[2] == "s2");
+    mystl::destroy(p, p + 3);
+    traits::deallocate(alloc, p, 3);
+
+    mystl::allocator<char> char_alloc;
+    auto [chars, capacity] = char_alloc.allocate_at_least(5);
+    assert(capacity >= 5 && capacity % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0);
+    chars[capacity - 1] = 'x';
+    char_alloc.deallocate(chars, capacity);
+
+    mystl::allocator<OverAligned> aligned_alloc;
+    OverAligned* q = aligned_alloc.allocate(2);
+    assert(reinterpret_cast<uintptr_t>(q) % 64 == 0);
+    aligned_alloc.deallocate(q, 2);
+
+    assert(mystl::allocator<int>() == mystl::allocator<double>());
+
+    TEST_CASE_PASS("allocator");
+}
+
+// Counts the allocations made through any of its rebound copies.
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    static inline int allocations = 0;
+    static inline int live = 0;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++CountingAllocator<char>::allocations;
+        ++CountingAllocator<char>::live;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        --CountingAllocator<char>::live;
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+};
+
+struct Base {
+    virtual ~Base() = default;
+    int base_value = 1;
+};
+
+struct Derived : Base {
+    explicit Derived(int v) : value(v) {}
+    int value;
+};
+
+struct Node : mystl::enable_shared_from_this<Node> {
+    int value = 0;
+};
+
+struct LocalNode : mystl::enable_local_shared_from_this<LocalNode> {};
+
+void test_unique_ptr() {
+    TEST_CASE("unique_ptr");
+
+    static_assert(sizeof(mystl::unique_ptr<int>) == sizeof(int*));
+    static_assert(sizeof(mystl::unique_ptr<int[]>) == sizeof(int*));
+    static_assert(mystl::is_trivially_relocatable_v<mystl::unique_ptr<std::string>>);
+
+    Tracked::destroyed = 0;
+    {
+        auto p = mystl::make_unique<Tracked>("a");
+        assert(p && p->val == "a" && (*p).val == "a");
+        mystl::unique_ptr<Tracked> q = mystl::move(p);
+        assert(!p && q != nullptr);
+        q.reset(new Tracked("b"));
+        assert(Tracked::destroyed == 1 && q->val == "b");
+        Tracked* raw = q.release();
+        assert(!q);
+        q.reset(raw);
+    }
+    assert(Tracked::destroyed == 2);
+
+    auto arr = mystl::make_unique<int[]>(4);
+    assert(arr[0] == 0 && arr[3] == 0);
+    arr[2] = 7;
+    assert(arr[2] == 7);
+
+    mystl::unique_ptr<Base> base = mystl::make_unique<Derived>(3);
+    assert(base->base_value == 1);
+
+    int deleted = 0;
+    auto deleter = [&deleted](int* p) {
+        ++deleted;
+        delete p;
+    };
+    {
+        mystl::unique_ptr<int, decltype(deleter)> d(new int(5), deleter);
+        assert(*d == 5);
+    }
+    assert(deleted == 1);
+
+    TEST_CASE_PASS("unique_ptr");
+}
+
+void test_shared_ptr() {
+    TEST_CASE("shared_ptr / weak_ptr");
+
+    using alloc = CountingAllocator<char>;
+    alloc::allocations = 0;
+    Tracked::destroyed = 0;
+    {
+        auto p = mystl::allocate_shared<Tracked>(alloc(), "x");
+        assert(alloc::allocations == 1 && p.use_count() == 1 && p->val == "x");
+
+        mystl::shared_ptr<Tracked> q = p;
+        assert(p.use_count() == 2 && q == p);
+
+        mystl::weak_ptr<Tracked> w = p;
+        assert(!w.expired() && w.lock()->val == "x");
+
+        mystl::shared_ptr<std::string> member(p, &p->val);
+        assert(*member == "x" && p.use_count() == 3);
+        assert(!member.owner_before(p) && !p.owner_before(member));
+
+        p.reset();
+        q.reset();
+        assert(Tracked::destroyed == 0 && member.use_count() == 1);
+        member.reset();
+        assert(Tracked::destroyed == 1 && w.expired() && !w.lock());
+        assert(alloc::live == 1);
+
+        [[maybe_unused]] bool threw = false;
+        try {
+            mystl::shared_ptr<Tracked> dead(w);
+        } catch (const mystl::bad_weak_ptr&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    assert(alloc::live == 0);
+
+    mystl::shared_ptr<Base> base = mystl::make_shared<Derived>(4);
+    auto derived = mystl::dynamic_pointer_cast<Derived>(base);
+    assert(derived && derived->value == 4 && base.use_count() == 2);
+    assert(!mystl::dynamic_pointer_cast<Node>(mystl::shared_ptr<Base>(new Base)));
+
+    int deleted = 0;
+    {
+        mystl::shared_ptr<int> d(new int(1), [&deleted](int* p) {
+            ++deleted;
+            delete p;
+        });
+        mystl::shared_ptr<int> e = d;
+    }
+    assert(deleted == 1);
+
+    mystl::shared_ptr<int> from_unique = mystl::make_unique<int>(9);
+    assert(*from_unique == 9 && from_unique.use_count() == 1);
+
+    // If the control block cannot be allocated, the unique_ptr keeps its object.
+    deleted = 0;
+    auto counted = [&deleted](int* p) {
+        ++deleted;
+        delete p;
+    };
+    mystl::unique_ptr<int, decltype(counted)> owner(new int(4), counted);
+    [[maybe_unused]] bool threw = false;
+    fail_next_new = true;
+    try {
+        mystl::shared_ptr<int> shared(mystl::move(owner));
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    assert(threw && owner && *owner == 4 && deleted == 0);
+    owner.reset();
+    assert(deleted == 1);
+
+    mystl::shared_ptr<int[]> arr(new int[3]{1, 2, 3});
+    assert(arr[2] == 3);
+
+    TEST_CASE_PASS("shared_ptr / weak_ptr");
+}
+
+void test_enable_shared_from_this() {
+    TEST_CASE("enable_shared_from_this");
+
+    auto p = mystl::make_shared<Node>();
+    mystl::shared_ptr<Node> self = p->shared_from_this();
+    assert(self == p && p.use_count() == 2);
+
+    mystl::shared_ptr<Node> raw(new Node);
+    assert(raw->weak_from_this().lock() == raw);
+
+    Node unowned;
+    assert(unowned.weak_from_this().expired());
+    [[maybe_unused]] bool threw = false;
+    try {
+        unowned.shared_from_this();
+    } catch (const mystl::bad_weak_ptr&) {
+        threw = true;
+    }
+    assert(threw);
+
+    auto local = mystl::make_local_shared<LocalNode>();
+    assert(local->shared_from_this() == local);
+
+    // Owning the object again after its first group expired frees that group's block.
+    [[maybe_unused]] const int live_blocks = CountingAllocator<char>::live;
+    {
+        Node reused;
+        auto no_delete = [](Node*) {};
+        mystl::shared_ptr<Node> first(&reused, no_delete, CountingAllocator<Node>());
+        first.reset();
+        assert(CountingAllocator<char>::live == live_blocks + 1);
+        assert(reused.weak_from_this().expired());
+        mystl::shared_ptr<Node> second(&reused, no_delete, CountingAllocator<Node>());
+        assert(CountingAllocator<char>::live == live_blocks + 1);
+        assert(reused.shared_from_this() == second);
+    }
+    assert(CountingAllocator<char>::live == live_blocks);
+
+    TEST_CASE_PASS("enable_shared_from_this");
+}
+
+void test_shared_ptr_threads() {
+    TEST_CASE("shared_ptr across threads");
+
+    Tracked::destroyed = 0;
+    auto p = mystl::make_shared<Tracked>("shared");
+    mystl::weak_ptr<Tracked> w = p;
+    std::thread threads[4];
+    for (auto& t : threads) {
+        t = std::thread([copy = p, w] {
+            for (int i = 0; i < 2000; ++i) {
+                mystl::shared_ptr<Tracked> a = copy;
+                mystl::shared_ptr<Tracked> b = w.lock();
+                assert(b && b->val == "shared");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    assert(p.use_count() == 1 && Tracked::destroyed == 0);
+    p.reset();
+    assert(Tracked::destroyed == 1 && w.expired());
+
+    TEST_CASE_PASS("shared_ptr across threads");
+}
+
+void test_local_shared_ptr() {
+    TEST_CASE("local_shared_ptr");
+
+    using alloc = CountingAllocator<char>;
+    alloc::allocations = 0;
+    {
+        auto p = mystl::allocate_local_shared<int>(alloc(), 3);
+        assert(alloc::allocations == 1 && *p == 3);
+        mystl::local_weak_ptr<int> w = p;
+        mystl::local_shared_ptr<int> q = w.lock();
+        assert(q.use_count() == 2);
+        mystl::local_shared_ptr<const int> c = mystl::const_pointer_cast<const int>(q);
+        assert(*c == 3 && c.use_count() == 3);
+    }
+    assert(alloc::live == 0);
+
+    TEST_CASE_PASS("local_shared_ptr");
+}
+
+int main() {
+    test_trivially_relocatable_trait();
+    test_relocate_at();
+    test_uninitialized_relocate();
+    test_pointer_traits();
+    test_allocator_traits_defaults();
+    test_allocator();
+    test_unique_ptr();
+    test_shared_ptr();
+    test_enable_shared_from_this();
+    test_shared_ptr_threads();
+    test_local_shared_ptr();
+
+    return 0;
+}
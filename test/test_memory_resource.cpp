@@ -0,0 +1,248 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "memory.h"
+#include "memory_resource.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+// Forwards to new_delete_resource and records how much traffic reaches it.
+class CountingResource : public mystl::pmr::memory_resource {
+public:
+    int allocations = 0;
+    int deallocations = 0;
+    size_t bytes_in_use = 0;
+    size_t last_request = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        bytes_in_use += bytes;
+        last_request = bytes;
+        return mystl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        bytes_in_use -= bytes;
+        mystl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+bool is_aligned(void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+void test_default_resources() {
+    TEST_CASE("default resources");
+
+    using namespace mystl::pmr;
+    assert(get_default_resource() == new_delete_resource());
+
+    CountingResource counting;
+    [[maybe_unused]] memory_resource* previous = set_default_resource(&counting);
+    assert(previous == new_delete_resource());
+    assert(get_default_resource() == &counting);
+    set_default_resource(nullptr);
+    assert(get_default_resource() == new_delete_resource());
+
+    [[maybe_unused]] bool thrown = false;
+    try {
+        (void)null_memory_resource()->allocate(8);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    TEST_CASE_PASS("default resources");
+}
+
+void test_monotonic_buffer_resource() {
+    TEST_CASE("monotonic_buffer_resource");
+
+    CountingResource upstream;
+    alignas(16) unsigned char stack_buffer[256];
+    {
+        mystl::pmr::monotonic_buffer_resource arena(stack_buffer, sizeof(stack_buffer),
+                                                    &upstream);
+        [[maybe_unused]] void* a = arena.allocate(100, 8);
+        [[maybe_unused]] void* b = arena.allocate(100, 8);
+        assert(a >= stack_buffer && b < stack_buffer + sizeof(stack_buffer));
+        assert(upstream.allocations == 0);
+
+        [[maybe_unused]] void* c = arena.allocate(100, 64);
+        assert(is_aligned(c, 64));
+        assert(upstream.allocations == 1);
+
+        [[maybe_unused]] size_t previous = upstream.last_request;
+        for (int i = 0; i < 200; ++i) {
+            arena.deallocate(arena.allocate(64, 16), 64, 16);
+        }
+        assert(upstream.allocations > 1 && upstream.allocations < 10);
+        assert(upstream.last_request >= 2 * previous);
+
+        arena.release();
+        assert(upstream.bytes_in_use == 0);
+        [[maybe_unused]] void* reused = arena.allocate(16);
+        assert(reused >= static_cast<void*>(stack_buffer));
+        assert(upstream.allocations == upstream.deallocations);
+    }
+    assert(upstream.bytes_in_use == 0);
+
+    // Sizes that would wrap around when the chunk header is added are refused, not truncated.
+    int refused = 0;
+    mystl::pmr::monotonic_buffer_resource arena(&upstream);
+    mystl::pmr::unsynchronized_pool_resource pool(&upstream);
+    for (mystl::pmr::memory_resource* r : {static_cast<mystl::pmr::memory_resource*>(&arena),
+                                           static_cast<mystl::pmr::memory_resource*>(&pool)}) {
+        for (size_t bytes : {SIZE_MAX, SIZE_MAX - 8}) {
+            try {
+                static_cast<void>(r->allocate(bytes));
+            } catch (const std::bad_alloc&) {
+                ++refused;
+            }
+        }
+    }
+    assert(refused == 4 && upstream.allocations == upstream.deallocations);
+
+    TEST_CASE_PASS("monotonic_buffer_resource");
+}
+
+void test_unsynchronized_pool_resource() {
+    TEST_CASE("unsynchronized_pool_resource");
+
+    CountingResource upstream;
+    {
+        mystl::pmr::unsynchronized_pool_resource pool({0, 256}, &upstream);
+        assert(pool.options().largest_required_pool_block == 256);
+
+        void* blocks[64];
+        for (void*& block : blocks) {
+            block = pool.allocate(24, 8);
+            assert(is_aligned(block, 8));
+        }
+        [[maybe_unused]] const int after_first_round = upstream.allocations;
+        for (void* block : blocks) {
+            pool.deallocate(block, 24, 8);
+        }
+        for (void*& block : blocks) {
+            block = pool.allocate(20, 8);
+        }
+        assert(upstream.allocations == after_first_round);
+        for (void* block : blocks) {
+            pool.deallocate(block, 20, 8);
+        }
+
+        void* big = pool.allocate(4096, 128);
+        assert(is_aligned(big, 128));
+        void* big2 = pool.allocate(1000);
+        pool.deallocate(big, 4096, 128);
+        pool.deallocate(big2, 1000);
+        assert(upstream.deallocations == 2);
+    }
+    assert(upstream.bytes_in_use == 0);
+    assert(upstream.allocations == upstream.deallocations);
+
+    TEST_CASE_PASS("unsynchronized_pool_resource");
+}
+
+void test_synchronized_pool_resource() {
+    TEST_CASE("synchronized_pool_resource");
+
+    CountingResource upstream;
+    {
+        mystl::pmr::synchronized_pool_resource pool(&upstream);
+        void* p = pool.allocate(48);
+        pool.deallocate(p, 48);
+        [[maybe_unused]] void* again = pool.allocate(48);
+        assert(again == p);
+    }
+    assert(upstream.bytes_in_use == 0);
+
+    // Threads allocate from their own shards and free each other's blocks. CountingResource is
+    // not thread-safe, so this pool draws on new_delete_resource directly.
+    {
+        mystl::pmr::synchronized_pool_resource pool;
+        constexpr int per_thread = 2000;
+        std::vector<void*> blocks[4];
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&pool, &blocks, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    void* p = pool.allocate(16 + i % 200);
+                    std::memset(p, t, 16);
+                    blocks[t].push_back(p);
+                }
+            });
+        }
+        for (std::thread& th : threads) {
+            th.join();
+        }
+        threads.clear();
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&pool, &blocks, t] {
+                const std::vector<void*>& theirs = blocks[(t + 1) % 4];
+                for (int i = 0; i < per_thread; ++i) {
+                    pool.deallocate(theirs[i], 16 + i % 200);
+                }
+                void* big = pool.allocate(1 << 16);
+                pool.deallocate(big, 1 << 16);
+            });
+        }
+        for (std::thread& th : threads) {
+            th.join();
+        }
+    }
+
+    TEST_CASE_PASS("synchronized_pool_resource");
+}
+
+void test_polymorphic_allocator() {
+    TEST_CASE("polymorphic_allocator");
+
+    CountingResource upstream;
+    mystl::pmr::monotonic_buffer_resource arena(&upstream);
+    mystl::pmr::polymorphic_allocator<int> alloc(&arena);
+
+    using traits = mystl::allocator_traits<mystl::pmr::polymorphic_allocator<int>>;
+    static_assert(!traits::propagate_on_container_copy_assignment::value);
+    static_assert(!traits::is_always_equal::value);
+
+    int* p = traits::allocate(alloc, 10);
+    traits::construct(alloc, p, 5);
+    assert(*p == 5);
+    traits::deallocate(alloc, p, 10);
+
+    mystl::pmr::polymorphic_allocator<std::string> rebound(alloc);
+    assert(rebound.resource() == &arena);
+    assert(rebound == alloc);
+
+    std::string* s = rebound.new_object<std::string>("arena string");
+    assert(*s == "arena string");
+    rebound.delete_object(s);
+
+    assert(traits::select_on_container_copy_construction(alloc).resource() ==
+           mystl::pmr::get_default_resource());
+
+    TEST_CASE_PASS("polymorphic_allocator");
+}
+
+int main() {
+    test_default_resources();
+    test_monotonic_buffer_resource();
+    test_unsynchronized_pool_resource();
+    test_synchronized_pool_resource();
+    test_polymorphic_allocator();
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "mpmc_queue.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_single_thread() {
+    TEST_CASE("single thread");
+
+    mystl::mpmc_queue<std::string> q(3);
+    assert(q.capacity() == 4 && q.empty_approx());
+    bool ok = q.try_push("a");
+    ok = q.try_emplace(3, 'b') && ok;
+    std::string s = "c";
+    ok = q.try_push(s) && ok;
+    ok = q.try_push(std::string("d")) && ok;
+    assert(ok);
+    ok = q.try_push("full");
+    assert(!ok && q.size_approx() == 4);
+
+    std::string out;
+    ok = q.try_pop(out);
+    assert(ok && out == "a");
+    ok = q.try_pop(out);
+    assert(ok && out == "bbb");
+
+    mystl::vector<std::string> batch = {"x", "y", "z"};
+    [[maybe_unused]] size_t n = q.try_push_n(batch.begin(), batch.size());
+    assert(n == 2);
+
+    mystl::vector<std::string> popped(8);
+    n = q.try_pop_n(popped.begin(), 8);
+    assert(n == 4);
+    assert(popped[0] == "c" && popped[1] == "d" && popped[2] == "x" && popped[3] == "y");
+    ok = q.try_pop(out);
+    n = q.try_pop_n(popped.begin(), 8);
+    assert(!ok && n == 0);
+
+    mystl::mpmc_queue<int> ints(8);
+    int values[] = {1, 2, 3, 4, 5};
+    [[maybe_unused]] const size_t first = ints.try_push_n(values, 5);
+    [[maybe_unused]] const size_t second = ints.try_push_n(values, 5);
+    [[maybe_unused]] const size_t none = ints.try_push_n(values, 0);
+    assert(first == 5 && second == 3 && none == 0);
+    int sink[8];
+    [[maybe_unused]] const size_t taken = ints.try_pop_n(sink, 3);
+    assert(taken == 3 && sink[2] == 3);
+
+    // Elements left in the queue are destroyed with it.
+    mystl::mpmc_queue<std::string> leftover(4);
+    leftover.try_push(std::string(100, 'x'));
+
+    TEST_CASE_PASS("single thread");
+}
+
+void test_concurrent() {
+    TEST_CASE("concurrent producers / consumers");
+
+    constexpr int producers = 3;
+    constexpr int consumers = 3;
+    constexpr long per_producer = 5000;
+    mystl::mpmc_queue<long> q(64);
+    std::atomic<long> sum{0};
+    std::atomic<long> count{0};
+
+    mystl::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, p] {
+            long next = p * per_producer;
+            const long end = next + per_producer;
+            while (next < end) {
+                long batch[4];
+                long n = 0;
+                for (; n < 4 && next + n < end; ++n) {
+                    batch[n] = next + n;
+                }
+                const size_t pushed = next % 3 == 0 ? q.try_push_n(batch, static_cast<size_t>(n))
+                                                    : (q.try_push(batch[0]) ? 1 : 0);
+                next += static_cast<long>(pushed);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            long local[8];
+            while (count.load() < producers * per_producer) {
+                const size_t n = q.try_pop_n(local, 8);
+                for (size_t i = 0; i < n; ++i) {
+                    sum.fetch_add(local[i]);
+                }
+                count.fetch_add(static_cast<long>(n));
+                long one;
+                if (q.try_pop(one)) {
+                    sum.fetch_add(one);
+                    count.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    [[maybe_unused]] const long total = producers * per_producer;
+    assert(count.load() == total && sum.load() == total * (total - 1) / 2);
+    assert(q.empty_approx());
+
+    TEST_CASE_PASS("concurrent producers / consumers");
+}
+
+int main() {
+    test_single_thread();
+    test_concurrent();
+
+    std::cout << "All mpmc_queue tests passed!" << std::endl;
+    return 0;
+}
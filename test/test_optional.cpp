@@ -0,0 +1,228 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "optional.h"
+#include "type_traits.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+enum class color : unsigned char { red, green, blue, none = 255 };
+
+template <>
+struct mystl::niche_traits<color> : mystl::niche_value<color, color::none> {};
+
+struct account_id {
+    int value;
+    friend constexpr bool operator==(account_id, account_id) = default;
+};
+
+template <>
+struct mystl::niche_traits<account_id> : mystl::niche_value<account_id, account_id{-1}> {};
+
+struct Counter {
+    static inline int live = 0;
+
+    int value;
+
+    explicit Counter(int v) : value(v) { ++live; }
+    Counter(const Counter& other) : value(other.value) { ++live; }
+    Counter(Counter&& other) noexcept : value(other.value) { ++live; }
+    Counter& operator=(const Counter&) = default;
+    Counter& operator=(Counter&&) = default;
+    ~Counter() { --live; }
+};
+
+// Neither copyable nor movable: transform() must construct it in place.
+struct Pinned {
+    explicit Pinned(int v) : value(v) {}
+    Pinned(const Pinned&) = delete;
+
+    int value;
+};
+
+// Copying is not trivial, so optional's copy and assignment take the construct_at path.
+struct Literal {
+    int v;
+    constexpr Literal(int x) : v(x) {}
+    constexpr Literal(const Literal& other) : v(other.v + 1) {}
+    constexpr Literal& operator=(const Literal& other) {
+        v = other.v + 10;
+        return *this;
+    }
+};
+
+constexpr bool constexpr_copy_and_assign() {
+    mystl::optional<Literal> a(Literal(0));
+    mystl::optional<Literal> b = a;
+    mystl::optional<Literal> c;
+    c = b;
+    c = a;
+    mystl::optional<long> widened = mystl::optional<int>(5);
+    // a holds a copy of the temporary (1), b a copy of that (2); c is built from b (3), then
+    // assigned from a (11).
+    return a->v == 1 && b->v == 2 && c->v == 11 && *widened == 5;
+}
+
+void test_basics() {
+    TEST_CASE("construction and access");
+
+    mystl::optional<std::string> empty;
+    assert(!empty && !empty.has_value() && empty == mystl::nullopt);
+    assert(empty.value_or("fallback") == "fallback");
+
+    mystl::optional<std::string> s(mystl::in_place, 3, 'x');
+    assert(s && *s == "xxx" && s->size() == 3 && s.value() == "xxx");
+
+    mystl::optional<std::vector<int>> v(mystl::in_place, {1, 2, 3});
+    assert(v->size() == 3);
+    v.emplace({4, 5});
+    assert(v->size() == 2 && (*v)[0] == 4);
+
+    [[maybe_unused]] mystl::optional<long> widened = mystl::optional<int>(7);
+    assert(widened == 7L);
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        static_cast<void>(empty.value());
+    } catch (const mystl::bad_optional_access&) {
+        threw = true;
+    }
+    assert(threw);
+
+    Counter::live = 0;
+    {
+        mystl::optional<Counter> a(mystl::in_place, 1);
+        mystl::optional<Counter> b = a;
+        assert(Counter::live == 2);
+        b = mystl::nullopt;
+        assert(Counter::live == 1);
+        b = mystl::move(a);
+        assert(Counter::live == 2 && b->value == 1);
+        a.reset();
+        swap(a, b);
+        assert(a->value == 1 && !b && Counter::live == 1);
+        b = Counter(5);
+        assert(b->value == 5 && Counter::live == 2);
+    }
+    assert(Counter::live == 0);
+
+    constexpr mystl::optional<int> ce(4);
+    static_assert(*ce == 4 && ce.value_or(0) == 4);
+    static_assert(mystl::make_optional(2).transform([](int x) { return x * 3; }) == 6);
+    static_assert(constexpr_copy_and_assign());
+
+    assert(mystl::optional<int>(1) < mystl::optional<int>(2));
+    assert(mystl::optional<int>() < mystl::optional<int>(0));
+    assert(mystl::optional<int>(3) > 2 && mystl::optional<int>() != 3);
+
+    TEST_CASE_PASS("construction and access");
+}
+
+void test_monadic() {
+    TEST_CASE("and_then / transform / or_else");
+
+    auto parse = [](const std::string& text) -> mystl::optional<int> {
+        if (text.empty() || text[0] < '0' || text[0] > '9') {
+            return mystl::nullopt;
+        }
+        return std::stoi(text);
+    };
+
+    mystl::optional<std::string> text("42");
+    mystl::optional<int> n = text.and_then(parse);
+    assert(n == 42);
+    assert(mystl::optional<std::string>("x").and_then(parse) == mystl::nullopt);
+    assert(mystl::optional<std::string>().and_then(parse) == mystl::nullopt);
+
+    mystl::optional<std::string> doubled = n.transform([](int x) { return std::to_string(x * 2); });
+    assert(doubled == std::string("84"));
+
+    [[maybe_unused]] mystl::optional<Pinned> pinned = n.transform([](int x) { return Pinned(x); });
+    assert(pinned->value == 42);
+
+    mystl::optional<std::string> moved =
+        mystl::move(text).transform([](std::string&& s) { return mystl::move(s) + "!"; });
+    assert(moved == std::string("42!"));
+
+    mystl::optional<int> none;
+    assert(none.or_else([] { return mystl::optional<int>(9); }) == 9);
+    assert(n.or_else([] { return mystl::optional<int>(9); }) == 42);
+
+    TEST_CASE_PASS("and_then / transform / or_else");
+}
+
+void test_triviality() {
+    TEST_CASE("triviality");
+
+    struct pod {
+        int a;
+        double b;
+    };
+    static_assert(mystl::is_trivially_copyable_v<mystl::optional<int>>);
+    static_assert(mystl::is_trivially_copyable_v<mystl::optional<pod>>);
+    static_assert(mystl::is_trivially_destructible_v<mystl::optional<pod>>);
+    static_assert(!mystl::is_trivially_copyable_v<mystl::optional<std::string>>);
+    static_assert(!mystl::is_trivially_destructible_v<mystl::optional<std::string>>);
+    static_assert(mystl::is_trivially_copy_constructible_v<mystl::optional<int*>>);
+    static_assert(!mystl::is_copy_constructible_v<mystl::optional<Pinned>>);
+
+    TEST_CASE_PASS("triviality");
+}
+
+void test_niche() {
+    TEST_CASE("niche storage");
+
+    static_assert(sizeof(mystl::optional<bool>) == sizeof(bool));
+    static_assert(sizeof(mystl::optional<int*>) == sizeof(int*));
+    static_assert(sizeof(mystl::optional<void (*)()>) == sizeof(void (*)()));
+    static_assert(sizeof(mystl::optional<color>) == sizeof(color));
+    static_assert(sizeof(mystl::optional<account_id>) == sizeof(account_id));
+    static_assert(sizeof(mystl::optional<int>) == 2 * sizeof(int));
+
+    mystl::optional<bool> flags[3] = {true, false, mystl::nullopt};
+    assert(flags[0] == true && flags[1] == false && !flags[2]);
+    flags[2] = false;
+    flags[0].reset();
+    assert(!flags[0] && flags[2].has_value() && !*flags[2]);
+
+    int x = 1;
+    mystl::optional<int*> p;
+    assert(!p);
+    p = nullptr;
+    assert(p && *p == nullptr);
+    p = &x;
+    assert(**p == 1);
+    mystl::optional<int*> q = p;
+    assert(q == &x);
+    p.reset();
+    swap(p, q);
+    assert(p == &x && !q);
+
+    mystl::optional<color> c;
+    assert(!c);
+    c = color::blue;
+    assert(c == color::blue && c.value_or(color::red) == color::blue);
+    c = mystl::nullopt;
+    assert(c.value_or(color::red) == color::red);
+
+    mystl::optional<account_id> id(account_id{17});
+    assert(id->value == 17);
+    assert(id.transform([](account_id a) { return a.value > 10; }) == true);
+    id.reset();
+    assert(!id);
+
+    TEST_CASE_PASS("niche storage");
+}
+
+int main() {
+    test_basics();
+    test_monadic();
+    test_triviality();
+    test_niche();
+
+    std::cout << "All optional tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "scheduler.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_deque() {
+    TEST_CASE("chase_lev_deque");
+
+    mystl::detail::chase_lev_deque dq(4);
+    mystl::detail::sched_task tasks[100];
+    for (auto& t : tasks) {
+        dq.push(&t);
+    }
+    // The owner pops newest first, thieves take oldest first; growth keeps the order.
+    [[maybe_unused]] mystl::detail::sched_task* popped = dq.pop();
+    [[maybe_unused]] mystl::detail::sched_task* stolen = dq.steal();
+    [[maybe_unused]] mystl::detail::sched_task* stolen_next = dq.steal();
+    assert(popped == &tasks[99] && stolen == &tasks[0] && stolen_next == &tasks[1]);
+    int left = 0;
+    while (dq.pop() != nullptr) {
+        ++left;
+    }
+    stolen = dq.steal();
+    assert(left == 97 && dq.empty() && stolen == nullptr);
+
+    TEST_CASE_PASS("chase_lev_deque");
+}
+
+void test_spawn_wait() {
+    TEST_CASE("submit / spawn / wait_for");
+
+    mystl::scheduler sched(3);
+    std::atomic<int> sum{0};
+    mystl::task_group group;
+    for (int i = 0; i < 1000; ++i) {
+        sched.spawn(group, [&sum, i] { sum.fetch_add(i); });
+    }
+    sched.wait_for(group);
+    assert(group.done() && sum.load() == 499500);
+
+    // Tasks spawning into a group from inside workers.
+    mystl::task_group outer;
+    std::atomic<int> leaves{0};
+    for (int i = 0; i < 10; ++i) {
+        sched.spawn(outer, [&] {
+            mystl::task_group inner;
+            for (int j = 0; j < 50; ++j) {
+                sched.spawn(inner, [&leaves] { leaves.fetch_add(1); });
+            }
+            sched.wait_for(inner);
+        });
+    }
+    sched.wait_for(outer);
+    assert(leaves.load() == 500);
+
+    std::atomic<int> detached{0};
+    {
+        mystl::scheduler short_lived(2);
+        for (int i = 0; i < 100; ++i) {
+            short_lived.submit([&detached] { detached.fetch_add(1); });
+        }
+    }
+    assert(detached.load() == 100);
+
+    TEST_CASE_PASS("submit / spawn / wait_for");
+}
+
+long fib(mystl::scheduler& sched, int n) {
+    if (n < 12) {
+        return n < 2 ? n : fib(sched, n - 1) + fib(sched, n - 2);
+    }
+    long a = 0;
+    long b = 0;
+    sched.parallel_invoke([&] { a = fib(sched, n - 1); }, [&] { b = fib(sched, n - 2); });
+    return a + b;
+}
+
+void test_parallel_invoke() {
+    TEST_CASE("parallel_invoke");
+
+    mystl::scheduler sched(3);
+    assert(fib(sched, 25) == 75025);
+
+    int x = 0;
+    int y = 0;
+    int z = 0;
+    mystl::parallel_invoke([&x] { x = 1; }, [&y] { y = 2; }, [&z] { z = 3; });
+    assert(x == 1 && y == 2 && z == 3);
+
+    // A throwing first callable still waits for the spawned ones, which use this frame.
+    std::atomic<bool> finished{false};
+    [[maybe_unused]] bool threw = false;
+    try {
+        sched.parallel_invoke([] { throw std::runtime_error("first"); },
+                              [&finished] {
+                                  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                                  finished.store(true);
+                              });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && finished.load());
+
+    mystl::scheduler single(0);
+    int w = 0;
+    single.parallel_invoke([&w] { w += 1; }, [&z] { z += 1; });
+    assert(w == 1 && z == 4);
+
+    TEST_CASE_PASS("parallel_invoke");
+}
+
+void test_parallel_for() {
+    TEST_CASE("parallel_for");
+
+    mystl::scheduler sched(3);
+    mystl::vector<int> hits(1000, 0);
+    sched.parallel_for(hits.size(), [&hits](size_t i) { ++hits[i]; });
+    for ([[maybe_unused]] int h : hits) {
+        assert(h == 1);
+    }
+
+    // Nested loops must not deadlock even when every worker is inside the outer loop.
+    std::atomic<long> total{0};
+    sched.parallel_for(16, [&](size_t) {
+        sched.parallel_for(100, [&](size_t j) { total.fetch_add(static_cast<long>(j)); });
+    });
+    assert(total.load() == 16 * 4950);
+
+    int calls = 0;
+    sched.parallel_for(0, [&calls](size_t) { ++calls; });
+    sched.parallel_for(1, [&calls](size_t) { ++calls; });
+    assert(calls == 1);
+
+    TEST_CASE_PASS("parallel_for");
+}
+
+// Copying it into a task fails the way an exhausted heap would.
+struct FailingCopy {
+    FailingCopy() = default;
+    FailingCopy(const FailingCopy&) { throw std::bad_alloc(); }
+    void operator()() const noexcept {}
+};
+
+void test_spawn_failure() {
+    TEST_CASE("spawn failure");
+
+    mystl::scheduler sched(2);
+    mystl::task_group group;
+    std::atomic<int> ran{0};
+    sched.spawn(group, [&ran] { ran.fetch_add(1); });
+    FailingCopy failing;
+    [[maybe_unused]] bool threw = false;
+    try {
+        sched.spawn(group, failing);
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    // The failed spawn is not counted, so this returns once the first task is done.
+    sched.wait_for(group);
+    assert(threw && group.done() && ran.load() == 1);
+
+    TEST_CASE_PASS("spawn failure");
+}
+
+int main() {
+    test_deque();
+    test_spawn_wait();
+    test_parallel_invoke();
+    test_parallel_for();
+    test_spawn_failure();
+
+    std::cout << "All scheduler tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "memory_resource.h"
+#include "small_vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+static_assert(sizeof(mystl::small_vector<int>) == 64);
+static_assert(mystl::small_vector<int>::inline_capacity == 10);
+
+struct FailingCopy {
+    static inline bool fail = false;
+    int val;
+
+    FailingCopy(int v) : val(v) {}
+    FailingCopy(const FailingCopy& other) : val(other.val) {
+        if (fail) {
+            throw std::runtime_error("copy");
+        }
+    }
+    FailingCopy(FailingCopy&& other) : val(other.val) {}
+    FailingCopy& operator=(const FailingCopy&) = default;
+};
+
+// Counts the blocks it has handed out and not yet taken back.
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    static inline int live = 0;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++live;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        --live;
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+};
+
+// Blocks outstanding per PropagatingAllocator id; propagates on move assignment.
+int propagating_live[2] = {0, 0};
+
+template <typename T>
+struct PropagatingAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = mystl::true_type;
+
+    int id;
+
+    explicit PropagatingAllocator(int i) : id(i) {}
+    template <typename U>
+    PropagatingAllocator(const PropagatingAllocator<U>& other) : id(other.id) {}
+
+    T* allocate(size_t n) {
+        ++propagating_live[id];
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        --propagating_live[id];
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PropagatingAllocator<U>& other) const {
+        return id == other.id;
+    }
+};
+
+void test_inline_to_heap() {
+    TEST_CASE("inline to heap");
+
+    mystl::small_vector<int, 4> v;
+    assert(v.is_small() && v.capacity() == 4);
+    for (int i = 0; i < 4; ++i) {
+        v.push_back(i);
+    }
+    assert(v.is_small());
+    v.push_back(4);
+    assert(!v.is_small() && v.capacity() >= 8);
+    for (int i = 0; i < 5; ++i) {
+        assert(v[i] == i);
+    }
+
+    v.resize(3);
+    v.shrink_to_fit();
+    assert(v.is_small() && v.size() == 3 && v[2] == 2);
+
+    v.reserve(100);
+    assert(!v.is_small() && v.capacity() >= 100);
+    v.clear();
+    assert(!v.is_small() && v.empty());
+
+    mystl::small_vector<std::string, 2> s(5, "abc");
+    assert(!s.is_small() && s.size() == 5 && s[4] == "abc");
+
+    TEST_CASE_PASS("inline to heap");
+}
+
+void test_insert_erase() {
+    TEST_CASE("insert / erase");
+
+    mystl::small_vector<std::string, 4> v = {"a", "b"};
+    v.insert(v.begin() + 1, 3, v[1]);
+    assert((v == mystl::small_vector<std::string, 4>{"a", "b", "b", "b", "b"}));
+    v.emplace(v.begin(), "front");
+    v.insert(v.end(), {"y", "z"});
+    assert(v.front() == "front" && v.back() == "z" && v.size() == 8);
+    v.erase(v.begin() + 1, v.begin() + 5);
+    assert((v == mystl::small_vector<std::string, 4>{"front", "b", "y", "z"}));
+    [[maybe_unused]] const size_t erased = mystl::erase(v, "y");
+    assert(erased == 1);
+
+    mystl::small_vector<int, 8> ints = {5, 6, 7};
+    ints.insert(ints.begin(), ints.back());
+    assert(ints.front() == 7 && ints.size() == 4 && ints.is_small());
+    [[maybe_unused]] const size_t odd = mystl::erase_if(ints, [](int x) { return x % 2 != 0; });
+    assert(odd == 3 && ints.size() == 1 && ints[0] == 6);
+    assert((ints <=> mystl::small_vector<int, 8>{6, 1}) < 0);
+
+    TEST_CASE_PASS("insert / erase");
+}
+
+void test_copy_move_swap() {
+    TEST_CASE("copy / move / swap");
+
+    mystl::small_vector<std::string, 2> small = {"x"};
+    mystl::small_vector<std::string, 2> big = {"1", "2", "3"};
+
+    mystl::small_vector<std::string, 2> moved_small = mystl::move(small);
+    assert(moved_small.size() == 1 && small.empty() && small.is_small());
+
+    [[maybe_unused]] const std::string* heap_data = big.data();
+    mystl::small_vector<std::string, 2> moved_big = mystl::move(big);
+    assert(moved_big.data() == heap_data && big.empty() && big.is_small());
+
+    moved_small.swap(moved_big);
+    assert(moved_small.size() == 3 && moved_big.size() == 1 && moved_big[0] == "x");
+    assert(moved_small.data() == heap_data);
+
+    mystl::small_vector<std::string, 2> copy = moved_small;
+    assert(copy == moved_small && copy.data() != heap_data);
+
+    copy = moved_big;
+    assert(copy.size() == 1 && copy[0] == "x");
+    copy = mystl::move(moved_small);
+    assert(copy.size() == 3 && copy.data() == heap_data);
+
+    mystl::small_vector<int, 4> a = {1, 2};
+    mystl::small_vector<int, 4> b = {3, 4, 5};
+    mystl::swap(a, b);
+    assert(a.size() == 3 && b.size() == 2 && b[1] == 2 && a.is_small() && b.is_small());
+
+    TEST_CASE_PASS("copy / move / swap");
+}
+
+void test_allocator() {
+    TEST_CASE("allocator");
+
+    mystl::pmr::monotonic_buffer_resource arena;
+    using alloc_t = mystl::pmr::polymorphic_allocator<int>;
+    mystl::small_vector<int, 4, alloc_t> v{alloc_t(&arena)};
+    for (int i = 0; i < 64; ++i) {
+        v.push_back(i);
+    }
+    assert(v.back() == 63 && v.get_allocator().resource() == &arena);
+
+    // A copy that throws while shrinking on the heap frees the new block and leaves the vector
+    // as it was.
+    {
+        mystl::small_vector<FailingCopy, 2, CountingAllocator<FailingCopy>> h;
+        h.reserve(32);
+        for (int i = 0; i < 4; ++i) {
+            h.push_back(i);
+        }
+        FailingCopy::fail = true;
+        [[maybe_unused]] bool threw = false;
+        try {
+            h.shrink_to_fit();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        FailingCopy::fail = false;
+        assert(threw && h.size() == 4 && h.capacity() == 32 && h[3].val == 3);
+        assert(CountingAllocator<FailingCopy>::live == 1);
+        h.shrink_to_fit();
+        assert(h.capacity() == 4 && h[0].val == 0 && CountingAllocator<FailingCopy>::live == 1);
+    }
+    assert(CountingAllocator<FailingCopy>::live == 0);
+
+    // Move assignment takes the allocator even when other's elements are still inline.
+    {
+        using prop_vec = mystl::small_vector<int, 4, PropagatingAllocator<int>>;
+        prop_vec heap(PropagatingAllocator<int>(0));
+        for (int i = 0; i < 10; ++i) {
+            heap.push_back(i);
+        }
+        prop_vec small({7, 8}, PropagatingAllocator<int>(1));
+        heap = mystl::move(small);
+        assert(heap.get_allocator().id == 1 && heap.size() == 2 && heap[1] == 8);
+        assert(propagating_live[0] == 0 && propagating_live[1] == 0);
+        heap.resize(20);
+        assert(propagating_live[1] == 1);
+    }
+    assert(propagating_live[0] == 0 && propagating_live[1] == 0);
+
+    TEST_CASE_PASS("allocator");
+}
+
+int main() {
+    test_inline_to_heap();
+    test_insert_erase();
+    test_copy_move_swap();
+    test_allocator();
+
+    return 0;
+}
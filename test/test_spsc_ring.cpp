@@ -0,0 +1,148 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "spsc_ring.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_push_pop() {
+    TEST_CASE("push / pop");
+
+    mystl::spsc_ring<std::string> r(3);
+    assert(r.capacity() == 4 && r.empty_approx());
+    std::string s = "b";
+    bool ok = r.try_push("a");
+    ok = r.try_push(s) && ok;
+    ok = r.try_push("c") && ok;
+    ok = r.try_push("d") && ok;
+    assert(ok);
+    ok = r.try_push("e");
+    assert(!ok && r.size_approx() == 4);
+
+    std::string out;
+    for (int round = 0; round < 10; ++round) {
+        [[maybe_unused]] const bool popped = r.try_pop(out);
+        [[maybe_unused]] const bool pushed = r.try_push(std::to_string(round));
+        assert(popped && pushed);
+    }
+    ok = r.try_pop(out);
+    assert(ok && out == "6");
+    for (int i = 0; i < 3; ++i) {
+        ok = r.try_pop(out) && ok;
+    }
+    assert(ok && out == "9");
+    ok = r.try_pop(out);
+    assert(!ok && r.empty_approx());
+
+    TEST_CASE_PASS("push / pop");
+}
+
+void test_spans() {
+    TEST_CASE("acquire_write / peek spans");
+
+    mystl::spsc_ring<int> r(8);
+    std::span<int> w = r.acquire_write(5);
+    assert(w.size() == 5);
+    for (int i = 0; i < 5; ++i) {
+        w[static_cast<size_t>(i)] = i;
+    }
+    r.commit(5);
+    assert(r.acquire_write(8).size() == 3);
+
+    std::span<int> p = r.peek(4);
+    assert(p.size() == 4 && p[0] == 0 && p[3] == 3);
+    r.release(4);
+
+    // Free space is [5, 12): the span stops at the end of the buffer.
+    w = r.acquire_write(7);
+    assert(w.size() == 3);
+    w[0] = 5, w[1] = 6, w[2] = 7;
+    r.commit(3);
+    w = r.acquire_write(7);
+    assert(w.size() == 4 && w.data() == r.peek(0).data() - 4);
+    w[0] = 8;
+    r.commit(1);
+
+    p = r.peek(8);
+    assert(p.size() == 4 && p[0] == 4 && p[3] == 7);
+    r.release(4);
+    p = r.peek(8);
+    assert(p.size() == 1 && p[0] == 8);
+    r.release(1);
+    assert(r.peek(8).empty() && r.empty_approx());
+
+    TEST_CASE_PASS("acquire_write / peek spans");
+}
+
+void test_concurrent() {
+    TEST_CASE("producer / consumer threads");
+
+    constexpr long total = 50000;
+    mystl::spsc_ring<long> r(64);
+
+    std::thread producer([&r] {
+        long next = 0;
+        while (next < total) {
+            if (next % 2 == 0) {
+                std::span<long> w = r.acquire_write(16);
+                size_t n = 0;
+                for (; n < w.size() && next < total; ++n) {
+                    w[n] = next++;
+                }
+                r.commit(n);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            } else if (r.try_push(next)) {
+                ++next;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // A third thread watching the size never sees it wrap or exceed the capacity.
+    std::atomic<bool> done{false};
+    std::thread observer([&r, &done] {
+        while (!done.load(std::memory_order_relaxed)) {
+            assert(r.size_approx() <= r.capacity());
+        }
+    });
+
+    long expected = 0;
+    long value;
+    while (expected < total) {
+        std::span<long> p = r.peek(32);
+        for ([[maybe_unused]] long v : p) {
+            assert(v == expected);
+            ++expected;
+        }
+        r.release(p.size());
+        if (r.try_pop(value)) {
+            assert(value == expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    done.store(true, std::memory_order_relaxed);
+    observer.join();
+    assert(r.empty_approx());
+
+    TEST_CASE_PASS("producer / consumer threads");
+}
+
+int main() {
+    test_push_pop();
+    test_spans();
+    test_concurrent();
+
+    std::cout << "All spsc_ring tests passed!" << std::endl;
+    return 0;
+}
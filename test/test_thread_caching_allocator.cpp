@@ -0,0 +1,206 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "memory.h"
+#include "thread_caching_allocator.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+// Route every allocation in this binary through the thread-caching allocator.
+MYSTL_DEFINE_GLOBAL_OPERATOR_NEW()
+
+void test_size_classes() {
+    TEST_CASE("size classes");
+
+    using namespace mystl::tc::detail;
+    for (size_t bytes = 1; bytes <= mystl::tc::max_small_size; ++bytes) {
+        [[maybe_unused]] const size_t cls = size_to_class(bytes);
+        assert(cls < mystl::tc::num_classes);
+        assert(class_to_size(cls) >= bytes);
+        assert(cls == 0 || class_to_size(cls - 1) < bytes);
+        assert(class_to_size(cls) % mystl::tc::min_alignment == 0);
+    }
+    static_assert(mystl::tc::good_size(17) == 32);
+    static_assert(mystl::tc::good_size(300) == 320);
+
+    // Aligned requests land in a class whose objects are all aligned enough.
+    for (size_t align = 32; align <= mystl::tc::max_small_alignment; align *= 2) {
+        for (size_t bytes = 1; bytes <= mystl::tc::max_small_size; bytes += 7) {
+            [[maybe_unused]] const size_t cls = size_to_class(bytes, align);
+            assert(class_to_size(cls) >= bytes && class_alignment(cls) >= align);
+            assert(class_offset(cls) % align == 0);
+            assert(size_to_class(mystl::tc::good_size(bytes, align), align) == cls);
+        }
+    }
+    static_assert(mystl::tc::good_size(40, 64) == 64);
+    // Just past the small limit, a request is rounded to pages, not to a whole span.
+    static_assert(mystl::tc::good_size(mystl::tc::max_small_size + 1) ==
+                  9 * mystl::tc::page_size - mystl::tc::span_header_size);
+
+    TEST_CASE_PASS("size classes");
+}
+
+void test_allocate_deallocate() {
+    TEST_CASE("allocate / deallocate");
+
+    std::vector<std::pair<void*, size_t>> blocks;
+    for (size_t bytes = 1; bytes < 100000; bytes = bytes * 3 / 2 + 1) {
+        void* p = mystl::tc::allocate(bytes);
+        assert(reinterpret_cast<uintptr_t>(p) % mystl::tc::min_alignment == 0);
+        std::memset(p, 0xab, bytes);
+        blocks.emplace_back(p, bytes);
+    }
+    for (auto [p, bytes] : blocks) {
+        mystl::tc::deallocate(p, bytes);
+    }
+
+    void* a = mystl::tc::allocate(64);
+    mystl::tc::deallocate(a, 64);
+    void* b = mystl::tc::allocate(60);
+    assert(a == b);
+    mystl::tc::deallocate(b);
+
+    // Cache-line-aligned nodes come from the size classes, not from their own mapping.
+    std::vector<void*> lines;
+    for (int i = 0; i < 100; ++i) {
+        void* p = mystl::tc::allocate(72, 64);
+        assert(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+        assert(mystl::tc::detail::span_of(p)->kind == mystl::tc::detail::span_kind::small);
+        lines.push_back(p);
+    }
+    for (void* p : lines) {
+        mystl::tc::deallocate(p, 72, 64);
+    }
+    void* line = mystl::tc::allocate(100, 128);
+    assert(reinterpret_cast<uintptr_t>(line) % 128 == 0);
+    mystl::tc::deallocate(line, 100, 128);
+
+    void* aligned = mystl::tc::allocate(40, 256);
+    assert(reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+    mystl::tc::deallocate(aligned, 40, 256);
+
+    void* wide = mystl::tc::allocate(40, mystl::tc::span_size / 2);
+    assert(reinterpret_cast<uintptr_t>(wide) % (mystl::tc::span_size / 2) == 0);
+    mystl::tc::deallocate(wide, 40, mystl::tc::span_size / 2);
+
+    // Sizes whose mapping would wrap around, and span-sized alignments, are refused.
+    int refused = 0;
+    for (size_t bytes : {SIZE_MAX, SIZE_MAX - 100, SIZE_MAX - mystl::tc::span_size}) {
+        try {
+            static_cast<void>(mystl::tc::allocate(bytes));
+        } catch (const std::bad_alloc&) {
+            ++refused;
+        }
+    }
+    try {
+        static_cast<void>(mystl::tc::allocate(64, size_t{1} << 20));
+    } catch (const std::bad_alloc&) {
+        ++refused;
+    }
+    assert(refused == 4);
+    assert(mystl::tc::good_size(SIZE_MAX - 100) == SIZE_MAX - 100);
+
+    TEST_CASE_PASS("allocate / deallocate");
+}
+
+void test_allocator_interface() {
+    TEST_CASE("thread_caching_allocator");
+
+    using alloc_t = mystl::thread_caching_allocator<double>;
+    using traits = mystl::allocator_traits<alloc_t>;
+    static_assert(traits::is_always_equal::value);
+
+    alloc_t alloc;
+    auto [p, count] = traits::allocate_at_least(alloc, 5);
+    assert(count == 6);
+    for (size_t i = 0; i < count; ++i) {
+        traits::construct(alloc, p + i, 1.5 * i);
+    }
+    assert(p[5] == 7.5);
+    traits::deallocate(alloc, p, count);
+
+    TEST_CASE_PASS("thread_caching_allocator");
+}
+
+void test_cross_thread() {
+    TEST_CASE("cross-thread allocate / free");
+
+    constexpr int threads = 8;
+    constexpr int per_thread = 20000;
+    std::vector<std::vector<void*>> produced(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&produced, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                const size_t bytes = 8 + (i % 37) * 8;
+                auto* p = static_cast<unsigned char*>(mystl::tc::allocate(bytes));
+                p[0] = static_cast<unsigned char>(t);
+                produced[t].push_back(p);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    workers.clear();
+
+    // Free every block on a different thread than the one that allocated it.
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&produced, t] {
+            auto& blocks = produced[(t + 1) % threads];
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                assert(static_cast<unsigned char*>(blocks[i])[0] == (t + 1) % threads);
+                mystl::tc::deallocate(blocks[i], 8 + (i % 37) * 8);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    mystl::tc::trim();
+    void* p = mystl::tc::allocate(48);
+    mystl::tc::deallocate(p, 48);
+
+    TEST_CASE_PASS("cross-thread allocate / free");
+}
+
+void test_global_operator_new() {
+    TEST_CASE("global operator new replacement");
+
+    std::string s(1000, 'x');
+    auto* n = new int(3);
+    assert(mystl::tc::detail::span_of(n)->kind == mystl::tc::detail::span_kind::small);
+    delete n;
+    std::vector<int> big(100000, 1);
+    assert(mystl::tc::detail::span_of(big.data())->kind == mystl::tc::detail::span_kind::large);
+
+    // Volatile, so the compiler does not reject the size at compile time.
+    volatile size_t huge = SIZE_MAX - 100;
+    [[maybe_unused]] bool threw = false;
+    try {
+        ::operator delete(::operator new(huge));
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    assert(threw && ::operator new(huge, std::nothrow) == nullptr);
+
+    TEST_CASE_PASS("global operator new replacement");
+}
+
+int main() {
+    test_size_classes();
+    test_allocate_deallocate();
+    test_allocator_interface();
+    test_cross_thread();
+    test_global_operator_new();
+
+    return 0;
+}
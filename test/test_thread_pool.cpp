@@ -0,0 +1,58 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+
+#include "thread_pool.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+void test_submit() {
+    TEST_CASE("submit");
+
+    std::atomic<int> done{0};
+    {
+        mystl::thread_pool pool(3);
+        assert(pool.size() == 3);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&done, i] { done.fetch_add(i); });
+        }
+    }
+    // The destructor drains the queue before joining.
+    assert(done.load() == 4950);
+
+    TEST_CASE_PASS("submit");
+}
+
+void test_parallel_for() {
+    TEST_CASE("parallel_for");
+
+    mystl::thread_pool pool(3);
+    mystl::vector<int> hits(1000, 0);
+    pool.parallel_for(hits.size(), [&hits](size_t i) { ++hits[i]; });
+    for ([[maybe_unused]] int h : hits) {
+        assert(h == 1);
+    }
+
+    // Nested loops must not deadlock even when every worker is inside the outer loop.
+    std::atomic<long> total{0};
+    pool.parallel_for(16, [&](size_t) {
+        pool.parallel_for(100, [&](size_t j) { total.fetch_add(static_cast<long>(j)); });
+    });
+    assert(total.load() == 16 * 4950);
+
+    mystl::thread_pool inline_pool(0);
+    int sum = 0;
+    inline_pool.parallel_for(10, [&sum](size_t i) { sum += static_cast<int>(i); });
+    assert(sum == 45);
+
+    TEST_CASE_PASS("parallel_for");
+}
+
+int main() {
+    test_submit();
+    test_parallel_for();
+
+    std::cout << "All thread_pool tests passed!" << std::endl;
+    return 0;
+}
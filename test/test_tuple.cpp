@@ -0,0 +1,182 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+
+#include "tuple.h"
+#include "utility.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct empty_a {};
+struct empty_b {};
+struct final_empty final {};
+
+struct counted {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    int v = 0;
+    counted() = default;
+    explicit counted(int x) : v(x) {}
+    counted(const counted& o) : v(o.v) { ++copies; }
+    counted(counted&& o) noexcept : v(o.v) { ++moves; }
+    counted& operator=(const counted&) = default;
+    counted& operator=(counted&&) = default;
+    static void reset() { copies = moves = 0; }
+};
+
+static_assert(sizeof(mystl::tuple<int, empty_a, empty_b>) == sizeof(int));
+static_assert(sizeof(mystl::tuple<empty_a, long, final_empty>) == sizeof(long));
+static_assert(mystl::is_empty_v<mystl::tuple<empty_a, empty_b>>);
+static_assert(mystl::is_trivially_copyable_v<mystl::tuple<int, double, empty_a>>);
+static_assert(mystl::is_trivially_relocatable_v<mystl::tuple<int, char*>>);
+static_assert(!mystl::is_trivially_copyable_v<mystl::tuple<int, std::string>>);
+static_assert(mystl::is_same_v<mystl::tuple_element_t<1, mystl::tuple<int, char, long>>, char>);
+static_assert(mystl::tuple_size<mystl::tuple<int, char, long>>::value == 3);
+
+void test_construction_and_get() {
+    TEST_CASE("construction and get");
+
+    mystl::tuple<int, std::string, double> t(1, "two", 3.0);
+    assert(mystl::get<0>(t) == 1 && mystl::get<1>(t) == "two" && mystl::get<2>(t) == 3.0);
+    assert(mystl::get<std::string>(t) == "two");
+    mystl::get<int>(t) = 10;
+    assert(mystl::get<0>(t) == 10);
+
+    mystl::tuple<int, std::string> d;
+    assert(mystl::get<0>(d) == 0 && mystl::get<1>(d).empty());
+
+    mystl::tuple<long, std::string> converted = mystl::tuple<int, const char*>(5, "x");
+    assert(mystl::get<0>(converted) == 5 && mystl::get<1>(converted) == "x");
+
+    [[maybe_unused]] mystl::tuple<int, int> from_pair = mystl::make_pair(1, 2);
+    assert(mystl::get<1>(from_pair) == 2);
+
+    mystl::tuple ctad(1, 2.5);
+    static_assert(mystl::is_same_v<decltype(ctad), mystl::tuple<int, double>>);
+
+    mystl::tuple<std::string> moved_from("abc");
+    std::string s = mystl::get<0>(mystl::move(moved_from));
+    assert(s == "abc");
+
+    auto [a, b, c] = t;
+    assert(a == 10 && b == "two" && c == 3.0);
+
+    [[maybe_unused]] mystl::tuple<> nothing;
+    assert(nothing == mystl::tuple<>());
+
+    TEST_CASE_PASS("construction and get");
+}
+
+void test_assignment_and_references() {
+    TEST_CASE("assignment and references");
+
+    int x = 0;
+    std::string y;
+    mystl::tie(x, y) = mystl::make_tuple(7, std::string("seven"));
+    assert(x == 7 && y == "seven");
+
+    mystl::tie(x, mystl::ignore) = mystl::make_pair(8, 9);
+    assert(x == 8);
+
+    mystl::tuple<int&, std::string&> refs(x, y);
+    mystl::tuple<int&, std::string&> other = refs;
+    int z = 1;
+    std::string w = "w";
+    mystl::tuple<int&, std::string&>(z, w) = refs;
+    assert(z == 8 && w == "seven");
+    other = mystl::tuple<int, std::string>(3, "three");
+    assert(x == 3 && y == "three");
+
+    mystl::tuple<int, std::string> p(1, "a");
+    mystl::tuple<int, std::string> q(2, "b");
+    swap(p, q);
+    assert(mystl::get<0>(p) == 2 && mystl::get<1>(q) == "a");
+    p = q;
+    assert(p == q);
+
+    int n = 5;
+    auto fwd = mystl::forward_as_tuple(n, 6);
+    static_assert(mystl::is_same_v<decltype(fwd), mystl::tuple<int&, int&&>>);
+
+    TEST_CASE_PASS("assignment and references");
+}
+
+void test_comparison() {
+    TEST_CASE("comparison");
+
+    mystl::tuple<int, std::string> a(1, "b");
+    mystl::tuple<int, std::string> b(1, "c");
+    mystl::tuple<long, std::string> c(1, "b");
+    assert(a < b && b > a && a != b && a == c);
+    assert((a <=> b) == std::strong_ordering::less);
+    mystl::tuple<double> nan(0.0 / 0.0);
+    assert((nan <=> nan) == std::partial_ordering::unordered);
+
+    TEST_CASE_PASS("comparison");
+}
+
+void test_apply_and_make_from_tuple() {
+    TEST_CASE("apply / make_from_tuple");
+
+    assert(mystl::apply([](int a, int b, int c) { return a * 100 + b * 10 + c; },
+                        mystl::make_tuple(1, 2, 3)) == 123);
+    assert(mystl::apply([](int a, int b) { return a - b; }, mystl::make_pair(5, 3)) == 2);
+
+    counted::reset();
+    mystl::tuple<counted, counted> src(counted(1), counted(2));
+    counted::reset();
+    [[maybe_unused]] int sum =
+        mystl::apply([](counted a, const counted& b) { return a.v + b.v; }, mystl::move(src));
+    assert(sum == 3 && counted::copies == 0 && counted::moves == 1);
+
+    struct point {
+        int x;
+        std::string label;
+        point(int px, std::string l) : x(px), label(mystl::move(l)) {}
+    };
+    point p = mystl::make_from_tuple<point>(mystl::make_tuple(4, std::string("four")));
+    assert(p.x == 4 && p.label == "four");
+
+    TEST_CASE_PASS("apply / make_from_tuple");
+}
+
+void test_tuple_cat() {
+    TEST_CASE("tuple_cat");
+
+    auto t = mystl::tuple_cat(mystl::make_tuple(1, 'a'), mystl::tuple<>(), mystl::make_pair(2.5, 3L),
+                              mystl::make_tuple(std::string("s")));
+    static_assert(
+        mystl::is_same_v<decltype(t), mystl::tuple<int, char, double, long, std::string>>);
+    assert(mystl::get<0>(t) == 1 && mystl::get<1>(t) == 'a' && mystl::get<2>(t) == 2.5 &&
+           mystl::get<3>(t) == 3L && mystl::get<4>(t) == "s");
+
+    // Each element is moved (or copied from an lvalue) exactly once, straight into the result.
+    mystl::tuple<counted, counted> moved(counted(1), counted(2));
+    mystl::tuple<counted> copied(counted(3));
+    counted::reset();
+    [[maybe_unused]] auto joined = mystl::tuple_cat(mystl::move(moved), copied);
+    assert(counted::moves == 2 && counted::copies == 1);
+    assert(mystl::get<2>(joined).v == 3);
+
+    int x = 1;
+    auto refs = mystl::tuple_cat(mystl::tie(x), mystl::make_tuple(2));
+    static_assert(mystl::is_same_v<decltype(refs), mystl::tuple<int&, int>>);
+    mystl::get<0>(refs) = 5;
+    assert(x == 5);
+
+    assert(mystl::tuple_cat() == mystl::tuple<>());
+
+    TEST_CASE_PASS("tuple_cat");
+}
+
+int main() {
+    test_construction_and_get();
+    test_assignment_and_references();
+    test_comparison();
+    test_apply_and_make_from_tuple();
+    test_tuple_cat();
+
+    std::cout << "All tuple tests passed!" << std::endl;
+    return 0;
+}
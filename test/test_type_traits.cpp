@@ -88,6 +88,21 @@ int main() {
 
     std::cout << "decay tests passed!" << std::endl;
 
+    static_assert(mystl::is_same_v<mystl::make_unsigned_t<long>, unsigned long>,
+                  "make_unsigned<long> should be unsigned long");
+    static_assert(mystl::is_same_v<mystl::make_unsigned_t<const int>, const unsigned int>,
+                  "make_unsigned should keep cv-qualifiers");
+    static_assert(mystl::is_same_v<mystl::make_unsigned_t<unsigned char>, unsigned char>,
+                  "make_unsigned<unsigned char> should be unsigned char");
+    static_assert(mystl::is_same_v<mystl::make_signed_t<unsigned short>, short>,
+                  "make_signed<unsigned short> should be short");
+    static_assert(mystl::is_signed_v<int> && !mystl::is_signed_v<unsigned int>,
+                  "is_signed test failed");
+    static_assert(mystl::is_unsigned_v<unsigned long> && !mystl::is_unsigned_v<float>,
+                  "is_unsigned test failed");
+
+    std::cout << "make_unsigned / make_signed tests passed!" << std::endl;
+
     std::cout << "Testing forward and move semantics..." << std::endl;
     int x = 42;
     wrapper(x);
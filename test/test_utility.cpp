@@ -28,7 +28,7 @@ void test_move() {
     static_assert(mystl::is_const_v<mystl::remove_reference_t<decltype(mystl::move(cx))>>);
 
     int y = 100;
-    int&& ry = mystl::move(y);
+    [[maybe_unused]] int&& ry = mystl::move(y);
     assert(ry == 100);
 
     TEST_CASE_PASS("move");
@@ -69,7 +69,7 @@ void test_exchange() {
     TEST_CASE("exchange");
 
     int a = 1;
-    int b = mystl::exchange(a, 2);
+    [[maybe_unused]] int b = mystl::exchange(a, 2);
     assert(a == 2);
     assert(b == 1);
 
@@ -186,9 +186,9 @@ void test_make_index_sequence() {
 void test_in_place() {
     TEST_CASE("in_place");
 
-    auto tag1 = mystl::in_place;
-    auto tag2 = mystl::in_place_type<int>;
-    auto tag3 = mystl::in_place_index<0>;
+    [[maybe_unused]] auto tag1 = mystl::in_place;
+    [[maybe_unused]] auto tag2 = mystl::in_place_type<int>;
+    [[maybe_unused]] auto tag3 = mystl::in_place_index<0>;
 
     static_assert(sizeof(mystl::in_place_t) == 1, "in_place_t should be empty");
     static_assert(sizeof(mystl::in_place_type_t<int>) == 1, "in_place_type_t should be empty");
@@ -233,7 +233,7 @@ void test_pair_conversion() {
     TEST_CASE("pair_conversions");
 
     mystl::pair<int, int> p1(10, 20);
-    mystl::pair<double, double> p2 = p1;
+    [[maybe_unused]] mystl::pair<double, double> p2 = p1;
     assert(p2.first == 10.0 && p2.second == 20.0);
 
     static_assert(!mystl::is_convertible_v<int, ExplicitType>,
@@ -331,6 +331,58 @@ void test_pair_swap() {
     TEST_CASE_PASS("pair_swap");
 }
 
+struct stateless {};
+struct final_stateless final {
+    bool operator()(int a, int b) const { return a < b; }
+};
+
+struct relocatable_handle {
+    using trivially_relocatable = mystl::true_type;
+    int* p = nullptr;
+    relocatable_handle() = default;
+    relocatable_handle(relocatable_handle&& o) noexcept : p(o.p) { o.p = nullptr; }
+    relocatable_handle& operator=(relocatable_handle&&) = default;
+    ~relocatable_handle() {}
+};
+
+void test_compressed_pair() {
+    TEST_CASE("compressed_pair");
+
+    static_assert(sizeof(mystl::compressed_pair<stateless, int*>) == sizeof(int*));
+    static_assert(sizeof(mystl::compressed_pair<long, final_stateless>) == sizeof(long));
+    static_assert(sizeof(mystl::compressed_pair<stateless, final_stateless>) == 1);
+    static_assert(mystl::is_trivially_copyable_v<mystl::compressed_pair<stateless, int>>);
+    static_assert(!mystl::is_trivially_copyable_v<mystl::compressed_pair<int, std::string>>);
+    static_assert(mystl::is_trivially_relocatable_v<mystl::compressed_pair<stateless, int*>>);
+    static_assert(!mystl::is_trivially_copyable_v<mystl::compressed_pair<relocatable_handle, int>>);
+    static_assert(mystl::is_trivially_relocatable_v<mystl::compressed_pair<relocatable_handle, int>>);
+    static_assert(mystl::is_same_v<mystl::tuple_element_t<1, mystl::compressed_pair<char, int>>, int>);
+
+    mystl::compressed_pair<final_stateless, std::string> p({}, "data");
+    assert(p.first(1, 2) && p.second == "data");
+    assert(mystl::get<1>(p) == "data" && mystl::get<std::string>(p) == "data");
+
+    auto& [cmp, str] = p;
+    str += "!";
+    assert(!cmp(2, 1) && p.second == "data!");
+
+    mystl::compressed_pair<int, std::string> q = mystl::make_pair(1, std::string("x"));
+    mystl::compressed_pair<int, std::string> r(2, "y");
+    assert(q < r && q != r);
+    swap(q, r);
+    assert(q.first == 2 && r.second == "x");
+    std::string moved = mystl::get<1>(mystl::move(r));
+    assert(moved == "x");
+
+    mystl::compressed_pair ctad(1, 2.0);
+    static_assert(mystl::is_same_v<decltype(ctad), mystl::compressed_pair<int, double>>);
+    mystl::compressed_pair<long, double> widened;
+    widened = ctad;
+    assert(widened.first == 1 && widened.second == 2.0);
+
+    TEST_CASE_PASS("compressed_pair");
+}
+
 int main() {
     test_move();
     test_forward();
@@ -350,6 +402,7 @@ int main() {
     test_pair_tuple_interface();
     test_pair_make_pair();
     test_pair_swap();
+    test_compressed_pair();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "type_traits.h"
+#include "utility.h"
+#include "variant.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+struct Counter {
+    static inline int live = 0;
+
+    int value;
+
+    explicit Counter(int v) : value(v) { ++live; }
+    Counter(const Counter& other) : value(other.value) { ++live; }
+    Counter(Counter&& other) noexcept : value(other.value) { ++live; }
+    Counter& operator=(const Counter&) = default;
+    Counter& operator=(Counter&&) = default;
+    ~Counter() { --live; }
+};
+
+// Construction from an int throws; its move constructor may throw too, so emplace cannot
+// build it on the side and a failed emplace leaves the variant valueless.
+struct Thrower {
+    explicit Thrower(int) { throw std::runtime_error("no"); }
+    Thrower(Thrower&&) noexcept(false) {}
+};
+
+template <size_t I>
+struct Tag {
+    static constexpr size_t value = I;
+};
+
+template <typename>
+struct many_tags;
+
+template <size_t... Is>
+struct many_tags<mystl::index_sequence<Is...>> {
+    using type = mystl::variant<Tag<Is>...>;
+};
+
+void test_construction() {
+    TEST_CASE("construction and access");
+
+    mystl::variant<int, std::string> def;
+    assert(def.index() == 0 && mystl::get<0>(def) == 0);
+
+    // The converting constructor never narrows: a double does not go into the int.
+    mystl::variant<int, double> d = 1.5;
+    assert(d.index() == 1 && mystl::get<double>(d) == 1.5);
+    mystl::variant<std::string, bool> s = "text";
+    assert(mystl::holds_alternative<std::string>(s));
+
+    mystl::variant<int, std::string, std::vector<int>> v(mystl::in_place_index<1>, 3, 'a');
+    assert(mystl::get<1>(v) == "aaa");
+    mystl::variant<int, std::string, std::vector<int>> w(mystl::in_place_type<std::vector<int>>,
+                                                         {1, 2});
+    assert(mystl::get<2>(w).size() == 2);
+
+    w.emplace<std::string>("emplaced");
+    assert(w.index() == 1 && mystl::get<std::string>(w) == "emplaced");
+    w.emplace<2>({4, 5, 6});
+    assert(mystl::get<2>(w)[2] == 6);
+
+    assert((mystl::get_if<0>(&w) == nullptr && mystl::get_if<std::vector<int>>(&w) != nullptr));
+    [[maybe_unused]] bool threw = false;
+    try {
+        static_cast<void>(mystl::get<int>(w));
+    } catch (const mystl::bad_variant_access&) {
+        threw = true;
+    }
+    assert(threw);
+
+    using maybe_int = mystl::variant<mystl::monostate, int>;
+    maybe_int m;
+    assert(m.index() == 0 && m == maybe_int() && m < maybe_int(0));
+
+    constexpr mystl::variant<int, double> ce(2.5);
+    static_assert(ce.index() == 1 && mystl::get<1>(ce) == 2.5);
+
+    TEST_CASE_PASS("construction and access");
+}
+
+// Switches the active alternative back and forth, which must stay a constant expression.
+constexpr int switch_alternatives() {
+    mystl::variant<int, double, char> v(1);
+    v.emplace<double>(2.5);
+    v = 'c';
+    v.emplace<0>(4);
+    int sum = mystl::get<int>(v);
+    v.emplace<char>('\5');
+    return sum + mystl::get<char>(v);
+}
+
+void test_assignment() {
+    TEST_CASE("assignment, swap and lifetime");
+
+    Counter::live = 0;
+    {
+        using V = mystl::variant<int, Counter, std::string>;
+        V a(mystl::in_place_type<Counter>, 1);
+        V b = a;
+        assert(Counter::live == 2 && mystl::get<Counter>(b).value == 1);
+        b = 5;
+        assert(Counter::live == 1 && mystl::get<int>(b) == 5);
+        b = mystl::move(a);
+        assert(Counter::live == 2);
+        a = std::string("s");
+        assert(Counter::live == 1);
+        swap(a, b);
+        assert(mystl::get<Counter>(a).value == 1 && mystl::get<std::string>(b) == "s");
+        V c(mystl::in_place_type<Counter>, 2);
+        a.swap(c);
+        assert(mystl::get<Counter>(a).value == 2 && mystl::get<Counter>(c).value == 1);
+        assert(Counter::live == 2);
+    }
+    assert(Counter::live == 0);
+
+    mystl::variant<int, Thrower> t = 7;
+    try {
+        t.emplace<Thrower>(1);
+    } catch (const std::runtime_error&) {
+    }
+    assert(t.valueless_by_exception() && t.index() == mystl::variant_npos);
+    [[maybe_unused]] bool threw = false;
+    try {
+        mystl::visit([](auto&) {}, t);
+    } catch (const mystl::bad_variant_access&) {
+        threw = true;
+    }
+    assert(threw);
+    t = 3;
+    assert(!t.valueless_by_exception() && mystl::get<0>(t) == 3);
+
+    static_assert(switch_alternatives() == 9);
+
+    TEST_CASE_PASS("assignment, swap and lifetime");
+}
+
+void test_visit() {
+    TEST_CASE("visit");
+
+    struct describe {
+        std::string operator()(int i) const { return "int " + std::to_string(i); }
+        std::string operator()(const std::string& s) const { return "string " + s; }
+    };
+
+    mystl::variant<int, std::string> v = 4;
+    assert(mystl::visit(describe{}, v) == "int 4");
+    v = "x";
+    assert(mystl::visit(describe{}, v) == "string x");
+
+    // Mutating through the visitor.
+    mystl::visit([](auto& alt) { alt += alt; }, v);
+    assert(mystl::get<1>(v) == "xx");
+
+    // Two variants: 2 x 3 combinations in one table.
+    mystl::variant<int, double> a = 2;
+    mystl::variant<char, int, long> b = 10L;
+    [[maybe_unused]] auto sum = [](auto x, auto y) {
+        return static_cast<long>(x) + static_cast<long>(y);
+    };
+    assert(mystl::visit(sum, a, b) == 12);
+    a = 0.5;
+    b = 'a';
+    assert(mystl::visit(sum, a, b) == 97);
+    [[maybe_unused]] auto product = [](auto x, auto y) { return x * y; };
+    assert(mystl::visit<double>(product, a, b) == 48.5);
+
+    // Moves out of an rvalue variant.
+    mystl::variant<std::string> owned(std::string(32, 'q'));
+    std::string taken = mystl::visit([](std::string&& s) { return mystl::move(s); },
+                                     mystl::move(owned));
+    assert(taken.size() == 32);
+
+    using big = many_tags<mystl::make_index_sequence<200>>::type;
+    big tags(mystl::in_place_index<137>);
+    assert(mystl::visit([](auto tag) { return decltype(tag)::value; }, tags) == 137);
+
+    constexpr mystl::variant<int, long> ce(3L);
+    static_assert(mystl::visit([](auto x) { return static_cast<int>(x) * 2; }, ce) == 6);
+
+    TEST_CASE_PASS("visit");
+}
+
+void test_layout_and_comparison() {
+    TEST_CASE("layout, triviality and comparison");
+
+    static_assert(sizeof(mystl::variant<char, bool>) == 2);
+    static_assert(sizeof(mystl::variant<int, float>) == 2 * sizeof(int));
+    using many = many_tags<mystl::make_index_sequence<300>>::type;
+    static_assert(sizeof(many) == 2 * sizeof(unsigned short));
+
+    using pod = mystl::variant<int, double, char>;
+    static_assert(mystl::is_trivially_copyable_v<pod>);
+    static_assert(mystl::is_trivially_destructible_v<pod>);
+    static_assert(!mystl::is_trivially_copyable_v<mystl::variant<int, std::string>>);
+    static_assert(mystl::is_trivially_relocatable_v<pod>);
+
+    using V = mystl::variant<int, std::string>;
+    V a = 1, b = 2, c = "a";
+    assert(a != b && a == V(1));
+    assert(a < b && b < c && (c <=> c) == 0);
+
+    TEST_CASE_PASS("layout, triviality and comparison");
+}
+
+int main() {
+    test_construction();
+    test_assignment();
+    test_visit();
+    test_layout_and_comparison();
+
+    std::cout << "All variant tests passed!" << std::endl;
+    return 0;
+}
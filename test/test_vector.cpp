@@ -0,0 +1,398 @@
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+
+#include "memory_resource.h"
+#include "thread_caching_allocator.h"
+#include "vector.h"
+
+#define TEST_CASE(name) std::cout << "[RUNNING] " << name << "..." << std::endl;
+#define TEST_CASE_PASS(name) std::cout << "[PASSED] " << name << std::endl;
+
+// Owns heap memory and opts into trivial relocation, so growth goes through memcpy.
+struct Boxed {
+    using trivially_relocatable = mystl::true_type;
+
+    static int live;
+    int* ptr;
+
+    Boxed() : Boxed(0) {}
+    Boxed(int v) : ptr(new int(v)) { ++live; }
+    Boxed(const Boxed& other) : ptr(new int(*other.ptr)) { ++live; }
+    Boxed(Boxed&& other) noexcept : ptr(mystl::exchange(other.ptr, nullptr)) { ++live; }
+    Boxed& operator=(const Boxed& other) {
+        *ptr = *other.ptr;
+        return *this;
+    }
+    Boxed& operator=(Boxed&& other) noexcept {
+        mystl::swap(ptr, other.ptr);
+        return *this;
+    }
+    ~Boxed() {
+        --live;
+        delete ptr;
+    }
+
+    bool operator==(const Boxed& other) const { return *ptr == *other.ptr; }
+};
+
+int Boxed::live = 0;
+
+// Copyable with a throwing move: reallocation must copy to keep the strong guarantee.
+struct CopyOnGrow {
+    static int copies;
+    static int moves;
+    int val;
+
+    CopyOnGrow(int v) : val(v) {}
+    CopyOnGrow(const CopyOnGrow& other) : val(other.val) { ++copies; }
+    CopyOnGrow(CopyOnGrow&& other) : val(other.val) { ++moves; }
+    CopyOnGrow& operator=(const CopyOnGrow&) = default;
+    CopyOnGrow& operator=(CopyOnGrow&&) = default;
+};
+
+int CopyOnGrow::copies = 0;
+int CopyOnGrow::moves = 0;
+
+// Copying throws on demand and moving may throw, so reallocation copies.
+struct FailingCopy {
+    static bool fail;
+    int val;
+
+    FailingCopy(int v) : val(v) {}
+    FailingCopy(const FailingCopy& other) : val(other.val) {
+        if (fail) {
+            throw std::runtime_error("copy");
+        }
+    }
+    FailingCopy(FailingCopy&& other) : val(other.val) {}
+    FailingCopy& operator=(const FailingCopy&) = default;
+};
+
+bool FailingCopy::fail = false;
+
+// Move-only with a move that throws after a set number of moves, so reallocation has to move.
+struct FailingMove {
+    static int live;
+    static int moves_left;
+    int val;
+
+    FailingMove(int v) : val(v) { ++live; }
+    FailingMove(FailingMove&& other) : val(other.val) {
+        if (moves_left-- == 0) {
+            throw std::runtime_error("move");
+        }
+        ++live;
+    }
+    ~FailingMove() { --live; }
+};
+
+int FailingMove::live = 0;
+int FailingMove::moves_left = -1;
+
+// Counts the blocks it has handed out and not yet taken back. The construct hook keeps vector on
+// its per-element path.
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    static inline int live = 0;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++live;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        --live;
+        ::operator delete(p);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(mystl::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+};
+
+struct SmallStartGrowth {
+    static constexpr size_t initial_bytes = 0;
+    static constexpr size_t growth_numerator = 3;
+    static constexpr size_t growth_denominator = 2;
+};
+
+void test_construct_and_access() {
+    TEST_CASE("construct / access");
+
+    mystl::vector<int> empty;
+    assert(empty.empty() && empty.capacity() == 0 && empty.data() == nullptr);
+
+    mystl::vector<int> zeros(5);
+    assert(zeros.size() == 5 && zeros[4] == 0);
+
+    mystl::vector<std::string> filled(3, "hi");
+    assert(filled.size() == 3 && filled.back() == "hi");
+
+    mystl::vector<int> list = {1, 2, 3, 4};
+    assert(list.front() == 1 && list.at(3) == 4);
+
+    [[maybe_unused]] bool thrown = false;
+    try {
+        (void)list.at(4);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::list<int> source = {7, 8, 9};
+    mystl::vector<int> from_list(source.begin(), source.end());
+    assert(from_list.size() == 3 && from_list[1] == 8);
+
+    mystl::vector<int> copy = list;
+    assert(copy == list);
+    mystl::vector<int> moved = mystl::move(copy);
+    assert(moved == list && copy.empty());
+
+    assert((mystl::vector<int>{1, 2} < mystl::vector<int>{1, 3}));
+    assert((mystl::vector<int>{1, 2} < mystl::vector<int>{1, 2, 0}));
+
+    TEST_CASE_PASS("construct / access");
+}
+
+void test_growth() {
+    TEST_CASE("growth");
+
+    mystl::vector<int> v;
+    v.push_back(1);
+    assert(v.capacity() >= 64 / sizeof(int));
+
+    mystl::vector<int, mystl::allocator<int>, SmallStartGrowth> slow;
+    slow.push_back(1);
+    assert(slow.capacity() < 8);
+    for (int i = 0; i < 1000; ++i) {
+        slow.push_back(i);
+    }
+    assert(slow.size() == 1001 && slow.back() == 999);
+
+    mystl::vector<Boxed> boxes;
+    for (int i = 0; i < 100; ++i) {
+        boxes.emplace_back(i);
+    }
+    assert(Boxed::live == 100);
+    for (int i = 0; i < 100; ++i) {
+        assert(*boxes[i].ptr == i);
+    }
+    boxes.shrink_to_fit();
+    assert(boxes.capacity() < 128);
+    assert(Boxed::live == 100);
+
+    mystl::vector<CopyOnGrow> strong;
+    for (int i = 0; i < 20; ++i) {
+        strong.push_back(CopyOnGrow(i));
+    }
+    [[maybe_unused]] const int moves_after_push = CopyOnGrow::moves;
+    assert(moves_after_push == 20);
+    assert(CopyOnGrow::copies > 0);
+
+    v.reserve(1000);
+    assert(v.capacity() >= 1000 && v.size() == 1 && v[0] == 1);
+
+    TEST_CASE_PASS("growth");
+}
+
+void test_push_back_self_reference() {
+    TEST_CASE("push_back self reference");
+
+    mystl::vector<std::string> v = {"first"};
+    for (int i = 0; i < 20; ++i) {
+        v.push_back(v[0]);
+    }
+    assert(v.size() == 21 && v[20] == "first");
+
+    mystl::vector<Boxed> boxes;
+    boxes.emplace_back(5);
+    for (int i = 0; i < 20; ++i) {
+        boxes.push_back(boxes.front());
+    }
+    assert(*boxes.back().ptr == 5);
+
+    TEST_CASE_PASS("push_back self reference");
+}
+
+template <typename T>
+void check_insert_erase(T make(int)) {
+    mystl::vector<T> v;
+    for (int i = 0; i < 5; ++i) {
+        v.push_back(make(i));
+    }
+    v.reserve(50);
+
+    [[maybe_unused]] auto it = v.insert(v.begin() + 2, make(100));
+    assert(it == v.begin() + 2 && v[2] == make(100) && v[3] == make(2) && v.size() == 6);
+
+    it = v.insert(v.begin(), 3, make(7));
+    assert(it == v.begin() && v[0] == make(7) && v[2] == make(7) && v[3] == make(0));
+
+    T extra[] = {make(40), make(41)};
+    it = v.insert(v.end() - 1, extra, extra + 2);
+    assert(*it == make(40) && v[v.size() - 2] == make(41) && v.back() == make(4));
+
+    it = v.emplace(v.begin() + 1, make(55));
+    assert(*it == make(55));
+
+    it = v.erase(v.begin(), v.begin() + 2);
+    assert(*it == make(7) && v.size() == 10);
+
+    it = v.erase(v.begin() + 3);
+    assert(*it == make(100) && v.size() == 9);
+
+    // Reallocating inserts.
+    v.shrink_to_fit();
+    v.insert(v.begin() + 1, 40, make(9));
+    assert(v[1] == make(9) && v[40] == make(9) && v[41] == make(7));
+    v.insert(v.begin(), v.back());
+    assert(v.front() == make(4));
+
+    v.resize(3);
+    assert(v.size() == 3);
+    v.resize(6, make(12));
+    assert(v[5] == make(12));
+    v.clear();
+    assert(v.empty());
+}
+
+int make_int(int v) {
+    return v;
+}
+std::string make_string(int v) {
+    return std::string(20, static_cast<char>('a' + v % 26)) + std::to_string(v);
+}
+Boxed make_boxed(int v) {
+    return Boxed(v);
+}
+
+void test_insert_erase() {
+    TEST_CASE("insert / erase");
+
+    check_insert_erase<int>(make_int);
+    check_insert_erase<std::string>(make_string);
+    check_insert_erase<Boxed>(make_boxed);
+    assert(Boxed::live == 0);
+
+    mystl::vector<int> v = {1, 2, 3, 2, 4, 2};
+    [[maybe_unused]] const size_t erased = mystl::erase(v, 2);
+    assert(erased == 3);
+    assert((v == mystl::vector<int>{1, 3, 4}));
+
+    std::list<int> source = {5, 6};
+    v.insert(v.begin() + 1, source.begin(), source.end());
+    assert((v == mystl::vector<int>{1, 5, 6, 3, 4}));
+
+    TEST_CASE_PASS("insert / erase");
+}
+
+void test_assign_and_swap() {
+    TEST_CASE("assign / swap");
+
+    mystl::vector<std::string> a = {"a", "b", "c"};
+    mystl::vector<std::string> b;
+    b = a;
+    assert(b == a);
+    b.assign(5, "x");
+    assert(b.size() == 5 && b[4] == "x");
+    b.assign({"q"});
+    assert(b.size() == 1 && b[0] == "q");
+
+    a.swap(b);
+    assert(a.size() == 1 && b.size() == 3);
+    mystl::swap(a, b);
+    assert(a.size() == 3 && b.size() == 1);
+
+    b = mystl::move(a);
+    assert(b.size() == 3 && a.empty());
+
+    TEST_CASE_PASS("assign / swap");
+}
+
+void test_allocators() {
+    TEST_CASE("allocators");
+
+    mystl::pmr::monotonic_buffer_resource arena;
+    mystl::pmr::polymorphic_allocator<int> alloc(&arena);
+    mystl::vector<int, mystl::pmr::polymorphic_allocator<int>> pv(alloc);
+    for (int i = 0; i < 100; ++i) {
+        pv.push_back(i);
+    }
+    assert(pv[99] == 99 && pv.get_allocator().resource() == &arena);
+
+    // Large buffers from the thread-caching allocator grow in place when the address space
+    // after the mapping is free; either way the contents must survive.
+    mystl::vector<long, mystl::thread_caching_allocator<long>> big;
+    for (long i = 0; i < 200000; ++i) {
+        big.push_back(i);
+    }
+    for (long i = 0; i < 200000; i += 997) {
+        assert(big[i] == i);
+    }
+
+    // A copy that throws while shrinking frees the new block and leaves the vector as it was.
+    {
+        mystl::vector<FailingCopy, CountingAllocator<FailingCopy>> v;
+        v.reserve(32);
+        for (int i = 0; i < 4; ++i) {
+            v.push_back(i);
+        }
+        FailingCopy::fail = true;
+        [[maybe_unused]] bool threw = false;
+        try {
+            v.shrink_to_fit();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        FailingCopy::fail = false;
+        assert(threw && v.size() == 4 && v.capacity() == 32 && v[3].val == 3);
+        assert(CountingAllocator<FailingCopy>::live == 1);
+    }
+    assert(CountingAllocator<FailingCopy>::live == 0);
+
+    // A move that throws while growing destroys the elements already moved into the new block.
+    {
+        mystl::vector<FailingMove, CountingAllocator<FailingMove>> v;
+        v.reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.emplace_back(i);
+        }
+        FailingMove::moves_left = 2;
+        [[maybe_unused]] bool threw = false;
+        try {
+            v.emplace_back(4);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        FailingMove::moves_left = -1;
+        assert(threw && FailingMove::live == 4 && v.size() == 4 && v.capacity() == 4);
+        assert(CountingAllocator<FailingMove>::live == 1);
+    }
+    assert(FailingMove::live == 0 && CountingAllocator<FailingMove>::live == 0);
+
+    TEST_CASE_PASS("allocators");
+}
+
+int main() {
+    test_construct_and_access();
+    test_growth();
+    test_push_back_self_reference();
+    test_insert_erase();
+    test_assign_and_swap();
+    test_allocators();
+
+    return 0;
+}